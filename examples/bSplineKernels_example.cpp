@@ -0,0 +1,68 @@
+/** @file bSplineKernels_example.cpp
+
+    @brief Benchmark of the fixed-degree evaluation kernels of
+    B-spline bases against the algorithm for arbitrary degrees
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+int main(int argc, char *argv[])
+{
+    index_t numPoints = 10000;
+    index_t numElements = 64;
+    index_t reps = 10;
+
+    gsCmdLine cmd("Points per second of the B-spline evaluation kernels.");
+    cmd.addInt("n", "points", "Number of evaluation points", numPoints);
+    cmd.addInt("e", "elements", "Number of knot spans", numElements);
+    cmd.addInt("r", "reps", "Number of repetitions", reps);
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+
+    // Random points, some of them outside the domain
+    gsMatrix<> u(1, numPoints);
+    u.setRandom();
+    u.array() = 0.5 + 0.55 * u.array();
+
+    bool ok = true;
+    std::vector<gsMatrix<> > values, valuesGeneric;
+    gsStopwatch timer;
+    gsInfo << "Mpoints/s (kernel vs. generic):\n";
+    for (short_t p = 1; p <= 5; ++p)
+    {
+        gsKnotVector<> kv(0, 1, numElements - 1, p + 1);
+        const gsBSplineBasis<> basis(kv);
+        gsInfo << "p=" << p;
+        for (int n = 0; n <= 2; ++n)
+        {
+            timer.restart();
+            for (index_t r = 0; r != reps; ++r)
+                basis.evalAllDers_into(u, n, values);
+            const real_t time = timer.stop();
+
+            timer.restart();
+            for (index_t r = 0; r != reps; ++r)
+                basis.evalAllDersGeneric_into(u, n, valuesGeneric);
+            const real_t timeGeneric = timer.stop();
+
+            real_t err = 0;
+            for (int k = 0; k <= n; ++k)
+                err = math::max(err, (values[k] - valuesGeneric[k]).cwiseAbs().maxCoeff()
+                                / (1 + valuesGeneric[k].cwiseAbs().maxCoeff()) );
+            ok = ok && err < 1e-12;
+
+            const real_t mpts = 1e-6 * static_cast<real_t>(numPoints * reps);
+            gsInfo << "   n=" << n << ": " << mpts / time << " vs. " << mpts / timeGeneric;
+        }
+        gsInfo << "\n";
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,135 @@
+/** @file bezierExtraction_example.cpp
+
+    @brief Evaluation of spline bases by their element-wise Bezier
+    extraction operators
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+// Compares the evaluation by the extraction operators with the one
+// of the basis on all elements, returns the largest difference
+real_t compare(const gsBasis<> & basis, const gsBezierExtraction<> & be,
+               real_t & time, real_t & timeBe)
+{
+    const gsVector<index_t> numNodes = be.degree().array() + 1;
+    const gsGaussRule<> rule(numNodes);
+    std::vector<gsMatrix<> > table, values, valuesBe;
+    be.bernsteinTable(rule, 2, table);
+
+    gsMatrix<> nodes;
+    gsVector<> weights;
+    gsMatrix<index_t> actives;
+    real_t err = 0;
+    time = timeBe = 0;
+    gsStopwatch timer;
+    index_t e = 0;
+    typename gsBasis<>::domainIter domIt = basis.source().makeDomainIterator();
+    for (; domIt->good(); domIt->next(), ++e)
+    {
+        rule.mapTo(domIt->lowerCorner(), domIt->upperCorner(), nodes, weights);
+        timer.restart();
+        basis.active_into(nodes.col(0), actives);
+        basis.evalAllDers_into(nodes, 2, values);
+        time += timer.stop();
+
+        timer.restart();
+        be.evalAllDers_into(e, table, 2, valuesBe);
+        timeBe += timer.stop();
+
+        if ( actives != be.actives(e) )
+            return 1;
+        for (index_t k = 0; k != 3; ++k)
+        {
+            const index_t rows = valuesBe[k].rows();
+            err = math::max(err, (values[k].topRows(rows) - valuesBe[k]).cwiseAbs().maxCoeff()
+                            / (1 + values[k].cwiseAbs().maxCoeff()) );
+        }
+    }
+    return err;
+}
+
+int main(int argc, char *argv[])
+{
+    index_t degree    = 3;
+    index_t numRefine = 3;
+
+    gsCmdLine cmd("Bezier extraction of B-spline, NURBS and THB-spline bases.");
+    cmd.addInt("p", "degree", "Polynomial degree", degree);
+    cmd.addInt("r", "refine", "Number of uniform h-refinement steps", numRefine);
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+
+    // A B-spline basis and NURBS bases of a circle and an annulus
+    gsKnotVector<> kv(0, 1, (1 << numRefine) - 1, degree + 1);
+    gsBSplineBasis<> bsp(kv);
+    gsNurbsBasis<> circle = static_cast<const gsNurbsBasis<>&>(
+        gsNurbsCreator<>::NurbsCircle()->basis() );
+    circle.degreeElevate(degree - 2);
+    circle.uniformRefine(2);
+    gsTensorNurbsBasis<2> annulus = static_cast<const gsTensorNurbsBasis<2>&>(
+        gsNurbsCreator<>::NurbsQuarterAnnulus()->basis() );
+    annulus.degreeElevate(degree - 2);
+    annulus.uniformRefine(2);
+
+    // Tensor-product and truncated hierarchical bases
+    gsTensorBSplineBasis<2> tbsp(kv, kv);
+    gsTHBSplineBasis<2> thb(tbsp);
+    gsMatrix<> box(2, 2);
+    box << 0, 0.5, 0, 0.5;
+    thb.refine(box);
+    box << 0, 0.25, 0.25, 0.5;
+    thb.refine(box);
+
+    const gsBasis<> * bases[5] = {&bsp, &circle, &tbsp, &annulus, &thb};
+    const char * names[5] = {"B-spline", "NURBS", "Tensor B-spline", "Tensor NURBS", "THB-spline"};
+
+    bool ok = true;
+    real_t time, timeBe;
+    for (index_t i = 0; i != 5; ++i)
+    {
+        gsBezierExtraction<> be(*bases[i]);
+        const real_t err = compare(*bases[i], be, time, timeBe);
+        ok = ok && err < 1e-10;
+        gsInfo << names[i] << " basis, " << be
+               << "  difference " << err << ", evaluation " << time
+               << " s by the basis, " << timeBe << " s by the operators\n";
+    }
+
+    // Assembly with the operators: the assembler keeps them between
+    // assemblies and recomputes them after refinement
+    gsMultiPatch<> mp(*gsNurbsCreator<>::BSplineSquare());
+    gsOptionList opt = gsAssembler<>::defaultOptions();
+    gsGenericAssembler<> ga(mp, gsMultiBasis<>(thb));
+    opt.setSwitch("BezierExtraction", true);
+    gsGenericAssembler<> gaBe(mp, gsMultiBasis<>(thb), opt);
+    for (index_t r = 0; r != 2; ++r)
+    {
+        gsStopwatch timer;
+        gsSparseMatrix<> K = ga.assembleStiffness();
+        K += ga.assembleMass();
+        time = timer.stop();
+        timer.restart();
+        gsSparseMatrix<> Kbe = gaBe.assembleStiffness();
+        Kbe += gaBe.assembleMass();
+        timeBe = timer.stop();
+
+        const real_t err = (K - Kbe).norm() / K.norm();
+        ok = ok && err < 1e-12;
+        gsInfo << "Assembly on " << ga.multiBasis().basis(0).numElements()
+               << " elements, difference " << err << ", " << time << " s by the basis, "
+               << timeBe << " s by the operators\n";
+
+        box << 0.5, 0.75, 0.5, 0.75;
+        ga  .multiBasis().basis(0).refine(box);
+        gaBe.multiBasis().basis(0).refine(box);
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
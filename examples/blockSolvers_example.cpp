@@ -0,0 +1,134 @@
+/** @file blockSolvers_example.cpp
+
+    @brief Benchmark of the block Krylov solvers for several
+    right-hand sides against solving for one right-hand side after
+    the other
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+// Stiffness plus mass matrix of a B-spline discretization of the unit
+// cube, the matrix of a reaction-diffusion problem
+void stiffnessMatrix(gsSparseMatrix<> & mat, index_t degree, index_t numRefine)
+{
+    gsMultiPatch<> mp(*gsNurbsCreator<>::BSplineCube(degree));
+    gsMultiBasis<> mb(mp);
+    for (index_t r = 0; r != numRefine; ++r)
+        mb.uniformRefine();
+
+    gsGenericAssembler<> ga(mp, mb);
+    mat = ga.assembleStiffness();
+    mat += ga.assembleMass();
+    mat.makeCompressed();
+}
+
+// Solves for the columns of rhs one after the other
+template<class Solver>
+real_t solveSequentially(Solver & solver, const gsMatrix<> & rhs,
+                         gsMatrix<> & x, index_t & iter)
+{
+    gsMatrix<> xj;
+    x.setZero(rhs.rows(), rhs.cols());
+    iter = 0;
+    gsStopwatch timer;
+    for (index_t j = 0; j != rhs.cols(); ++j)
+    {
+        xj.setZero(rhs.rows(), 1);
+        solver.solve(rhs.col(j), xj);
+        x.col(j) = xj;
+        iter += solver.iterations();
+    }
+    return timer.stop();
+}
+
+// Largest relative residual of the columns
+real_t maxResidual(const gsSparseMatrix<> & mat, const gsMatrix<> & rhs,
+                   const gsMatrix<> & x)
+{
+    const gsMatrix<> res = mat * x - rhs;
+    return ( res.colwise().norm().array() / rhs.colwise().norm().array() ).maxCoeff();
+}
+
+int main(int argc, char *argv[])
+{
+    index_t degree = 2;
+    index_t numRefine = 4;
+    index_t numRhs = 16;
+    index_t restart = 50;
+    real_t tol = 1e-8;
+
+    gsCmdLine cmd("Block Krylov solvers against sequential solves.");
+    cmd.addInt ("p", "degree", "Polynomial degree", degree);
+    cmd.addInt ("u", "refine", "Number of uniform refinements", numRefine);
+    cmd.addInt ("s", "rhs", "Number of right-hand sides", numRhs);
+    cmd.addInt ("r", "restart", "Restart length of block GMRES", restart);
+    cmd.addReal("t", "tol", "Tolerance", tol);
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+
+    gsSparseMatrix<> mat;
+    stiffnessMatrix(mat, degree, numRefine);
+    const index_t maxIter = mat.rows();
+    gsMatrix<> rhs(mat.rows(), numRhs), x;
+    rhs.setRandom();
+
+    gsInfo << "Stiffness matrix with " << mat.rows() << " unknowns, "
+           << mat.nonZeros() / mat.rows() << " non-zeros per row, "
+           << numRhs << " right-hand sides\n";
+
+    bool ok = true;
+    index_t iter;
+    gsStopwatch timer;
+
+    // Conjugate gradients, Jacobi preconditioned
+    gsLinearOperator<>::Ptr jacobi = makeJacobiOp(mat);
+    gsConjugateGradient<> cg(mat, jacobi);
+    cg.setTolerance(tol);
+    cg.setMaxIterations(maxIter);
+    const real_t tCg = solveSequentially(cg, rhs, x, iter);
+    ok = ok && maxResidual(mat, rhs, x) < 10 * tol;
+    gsInfo << "CG:          " << tCg << " s, " << iter << " operator applications\n";
+
+    gsBlockConjugateGradient<> bcg(mat, jacobi);
+    bcg.setTolerance(tol);
+    bcg.setMaxIterations(maxIter);
+    x.setZero(rhs.rows(), rhs.cols());
+    timer.restart();
+    bcg.solve(rhs, x);
+    const real_t tBcg = timer.stop();
+    ok = ok && maxResidual(mat, rhs, x) < 10 * tol;
+    gsInfo << "Block CG:    " << tBcg << " s, " << bcg.iterations()
+           << " block applications, speedup " << tCg / tBcg << "\n";
+
+    // GMRES, Gauss-Seidel preconditioned
+    gsLinearOperator<>::Ptr gs = makeGaussSeidelOp(mat);
+    gsGMRes<> gmres(mat, gs);
+    gmres.setTolerance(tol);
+    gmres.setMaxIterations(maxIter);
+    const real_t tGmres = solveSequentially(gmres, rhs, x, iter);
+    gsInfo << "GMRES:       " << tGmres << " s, " << iter << " operator applications\n";
+
+    gsBlockGMRes<> bgmres(mat, gs);
+    bgmres.setTolerance(tol);
+    bgmres.setMaxIterations(maxIter);
+    bgmres.setRestart(restart);
+    x.setZero(rhs.rows(), rhs.cols());
+    timer.restart();
+    bgmres.solve(rhs, x);
+    const real_t tBgmres = timer.stop();
+    ok = ok && bgmres.error() < tol;
+    gsInfo << "Block GMRES: " << tBgmres << " s, " << bgmres.iterations()
+           << " block applications, speedup " << tGmres / tBgmres << "\n"
+           << "Iterations until convergence per column: "
+           << bgmres.columnIterations().transpose() << "\n";
+
+    gsInfo << (ok ? "All systems solved.\n" : "Some systems not solved!\n");
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
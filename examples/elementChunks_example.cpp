@@ -0,0 +1,107 @@
+/** @file elementChunks_example.cpp
+
+    @brief Assembly with the basis and the geometry evaluated on
+    chunks of elements at once (option ChunkSize)
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+// Assembles the mass and the stiffness matrix and a right-hand side
+// with the expression assembler, and the stiffness and the mass
+// matrix with the visitors
+void assemble(const gsMultiPatch<> & mp, const gsMultiBasis<> & mb, index_t chunk,
+              gsSparseMatrix<> & K, gsMatrix<> & f, gsSparseMatrix<> & Kv,
+              real_t & time, real_t & timeV)
+{
+    typedef gsExprAssembler<>::geometryMap geometryMap;
+    typedef gsExprAssembler<>::variable    variable;
+    typedef gsExprAssembler<>::space       space;
+
+    gsFunctionExpr<> ff("sin(x)*y", 2);
+
+    gsExprAssembler<> A(1,1);
+    A.options().setInt("ChunkSize", chunk);
+    A.setIntegrationElements(mb);
+    geometryMap G = A.getMap(mp);
+    space u = A.getSpace(mb);
+    variable rhs = A.getCoeff(ff, G);
+
+    gsStopwatch timer;
+    A.initSystem();
+    A.assemble( igrad(u, G) * igrad(u, G).tr() * meas(G) + u * u.tr() * meas(G),
+                u * rhs * meas(G) );
+    time = timer.stop();
+    K = A.matrix();
+    f = A.rhs();
+
+    gsOptionList opt = gsAssembler<>::defaultOptions();
+    opt.setInt("ChunkSize", chunk);
+    gsGenericAssembler<> ga(mp, mb, opt);
+    timer.restart();
+    Kv = ga.assembleStiffness();
+    Kv += ga.assembleMass();
+    timeV = timer.stop();
+}
+
+int main(int argc, char *argv[])
+{
+    index_t degree    = 2;
+    index_t numRefine = 4;
+    index_t chunk     = 16;
+
+    gsCmdLine cmd("Assembly on chunks of elements.");
+    cmd.addInt("p", "degree", "Polynomial degree", degree);
+    cmd.addInt("r", "refine", "Number of uniform h-refinement steps", numRefine);
+    cmd.addInt("c", "chunk", "Number of elements evaluated together", chunk);
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+
+    gsMultiPatch<> mp(*gsNurbsCreator<>::NurbsQuarterAnnulus());
+    mp.degreeElevate(degree - 2);
+
+    // Tensor-product and hierarchical bases; the latter are
+    // evaluated element by element where their number of active
+    // functions changes
+    gsMultiBasis<> mb[2];
+    mb[0] = gsMultiBasis<>(mp);
+    for (index_t r = 1; r < numRefine; ++r)
+        mb[0].uniformRefine();
+    gsTHBSplineBasis<2> thb( static_cast<const gsTensorBSplineBasis<2>&>(mb[0].basis(0)) );
+    gsMatrix<> box(2, 2);
+    box << 0, 0.5, 0, 0.5;
+    thb.refine(box);
+    mb[1] = gsMultiBasis<>(thb);
+    mb[0].uniformRefine();
+
+    bool ok = true;
+    for (index_t i = 0; i != 2; ++i)
+    {
+        gsSparseMatrix<> K0, K1, Kv0, Kv1;
+        gsMatrix<> f0, f1;
+        real_t t0, tv0, t1, tv1;
+        assemble(mp, mb[i], 1    , K0, f0, Kv0, t0, tv0); // warm-up
+        assemble(mp, mb[i], 1    , K0, f0, Kv0, t0, tv0);
+        assemble(mp, mb[i], chunk, K1, f1, Kv1, t1, tv1);
+
+        const real_t errK = (K1  - K0 ).norm() / K0 .norm();
+        const real_t errF = (f1  - f0 ).norm() / f0 .norm();
+        const real_t errV = (Kv1 - Kv0).norm() / Kv0.norm();
+        ok = ok && errK < 1e-12 && errF < 1e-12 && errV < 1e-12;
+
+        gsInfo << (0 == i ? "Tensor-product" : "Hierarchical") << " basis, "
+               << mb[i].size() << " DoFs\n"
+               << "  expressions: " << t0  << " s element-wise, " << t1
+               << " s in chunks of " << chunk << ", diff. " << errK << " / " << errF << "\n"
+               << "  visitors   : " << tv0 << " s element-wise, " << tv1
+               << " s in chunks of " << chunk << ", diff. " << errV << "\n";
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
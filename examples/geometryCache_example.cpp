@@ -0,0 +1,85 @@
+/** @file geometryCache_example.cpp
+
+    @brief Repeated assembly with the geometry evaluations kept
+    between the assemblies (option CacheGeometry)
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+// Assembles the stiffness matrix \a numSteps times with the
+// expression assembler and with the visitors
+void assemble(const gsMultiPatch<> & mp, const gsMultiBasis<> & mb, bool cache,
+              index_t numSteps, gsSparseMatrix<> & K, gsSparseMatrix<> & Kv,
+              real_t & time, real_t & timeV)
+{
+    typedef gsExprAssembler<>::geometryMap geometryMap;
+    typedef gsExprAssembler<>::space       space;
+
+    gsExprAssembler<> A(1,1);
+    A.options().setSwitch("CacheGeometry", cache);
+    A.setIntegrationElements(mb);
+    geometryMap G = A.getMap(mp);
+    space u = A.getSpace(mb);
+
+    gsStopwatch timer;
+    for (index_t s = 0; s != numSteps; ++s)
+    {
+        A.initSystem();
+        A.assemble( igrad(u, G) * igrad(u, G).tr() * meas(G) );
+    }
+    time = timer.stop();
+    K = A.matrix();
+    if ( cache )
+        gsInfo << "  expressions: " << A.mapDataCache();
+
+    gsOptionList opt = gsAssembler<>::defaultOptions();
+    opt.setSwitch("CacheGeometry", cache);
+    gsGenericAssembler<> ga(mp, mb, opt);
+    timer.restart();
+    for (index_t s = 0; s != numSteps; ++s)
+        Kv = ga.assembleStiffness();
+    timeV = timer.stop();
+    if ( cache )
+        gsInfo << "  visitors   : " << ga.mapDataCache();
+}
+
+int main(int argc, char *argv[])
+{
+    index_t degree   = 3;
+    index_t numRefine = 3;
+    index_t numSteps = 4;
+
+    gsCmdLine cmd("Repeated assembly with and without the geometry cache.");
+    cmd.addInt("p", "degree", "Polynomial degree", degree);
+    cmd.addInt("r", "refine", "Number of uniform h-refinement steps", numRefine);
+    cmd.addInt("s", "steps", "Number of assemblies", numSteps);
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+
+    gsMultiPatch<> mp(*gsNurbsCreator<>::NurbsQuarterAnnulus());
+    gsMultiBasis<> mb(mp);
+    mb.setDegree(degree);
+    for (index_t r = 0; r < numRefine; ++r)
+        mb.uniformRefine();
+    gsInfo << "Degree " << degree << ", " << mb.size() << " DoFs, "
+           << numSteps << " assemblies\n";
+
+    gsSparseMatrix<> K0, Kv0, K1, Kv1;
+    real_t t0, tv0, t1, tv1;
+    assemble(mp, mb, false, numSteps, K0, Kv0, t0, tv0);
+    assemble(mp, mb, true , numSteps, K1, Kv1, t1, tv1);
+
+    const real_t err  = (K1  - K0 ).norm() / K0 .norm();
+    const real_t errV = (Kv1 - Kv0).norm() / Kv0.norm();
+    gsInfo << "Expressions: " << t0  << " s without, " << t1  << " s with the cache, diff. " << err  << "\n"
+           << "Visitors   : " << tv0 << " s without, " << tv1 << " s with the cache, diff. " << errV << "\n";
+
+    return ( err < 1e-12 && errV < 1e-12 ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,123 @@
+/** @file hDomain_example.cpp
+
+    @brief Benchmark of the insertions and queries of the kd-tree of
+    hierarchical domains, before and after makeCompressed()
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+// Random box of level lvl, at most width elements wide
+template<class point>
+void randomBox(index_t numElements, int lvl, index_t width,
+               point & lower, point & upper)
+{
+    const index_t n = numElements << lvl;
+    for (short_t k = 0; k != lower.size(); ++k)
+    {
+        lower[k] = std::rand() % n;
+        upper[k] = math::min(n, lower[k] + 1 + std::rand() % width);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    index_t numBoxes = 20000;
+    index_t numQueries = 200000;
+    index_t numElements = 16;
+    index_t numLevels = 8;
+
+    gsCmdLine cmd("Insertions and queries per second of gsHDomain.");
+    cmd.addInt("b", "boxes", "Number of inserted boxes", numBoxes);
+    cmd.addInt("q", "queries", "Number of queries", numQueries);
+    cmd.addInt("e", "elements", "Number of elements per direction on level 0", numElements);
+    cmd.addInt("l", "levels", "Number of levels", numLevels);
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+
+    typedef gsHDomain<2> hDomain;
+    typedef hDomain::point point;
+
+    std::srand(42);
+    point lower, upper;
+
+    point upp;
+    upp.setConstant(numElements);
+    hDomain tree(upp);
+    tree.init(upp, numLevels);
+
+    gsStopwatch timer;
+    for (index_t i = 0; i != numBoxes; ++i)
+    {
+        const int lvl = 1 + std::rand() % numLevels;
+        randomBox(numElements, lvl, 4 << (lvl/2), lower, upper);
+        tree.insertBox(lower, upper, lvl);
+    }
+    const real_t tInsert = timer.stop();
+
+    hDomain flat(tree);
+    timer.restart();
+    flat.makeCompressed();
+    const real_t tCompress = timer.stop();
+
+    gsInfo << "Tree with " << tree.size() << " nodes, " << tree.leafSize()
+           << " leaves, " << tree.memoryUsage() << " bytes\n"
+           << "Compressed: " << flat.size() << " nodes, " << flat.leafSize()
+           << " leaves, " << flat.memoryUsage() << " bytes, built in "
+           << tCompress << " s\n"
+           << "insertBox: " << 1e-6 * numBoxes / tInsert << " Mboxes/s\n";
+
+    // Random query boxes and points
+    std::vector<point> qlow(numQueries), qupp(numQueries);
+    std::vector<int> qlvl(numQueries);
+    for (index_t i = 0; i != numQueries; ++i)
+    {
+        qlvl[i] = std::rand() % (numLevels + 1);
+        randomBox(numElements, qlvl[i], 3, lower, upper);
+        qlow[i] = lower;
+        qupp[i] = upper;
+    }
+
+    bool ok = true;
+    const real_t mq = 1e-6 * static_cast<real_t>(numQueries);
+    const hDomain * trees[2] = {&tree, &flat};
+    std::vector<int> res[2];
+    real_t tQuery[2], tLevel[2];
+    for (int c = 0; c != 2; ++c)
+    {
+        const hDomain & t = *trees[c];
+        res[c].resize(3 * numQueries);
+
+        timer.restart();
+        for (index_t i = 0; i != numQueries; ++i)
+        {
+            res[c][3*i  ] = t.query3(qlow[i], qupp[i], qlvl[i]);
+            res[c][3*i+1] = t.query4(qlow[i], qupp[i], qlvl[i]);
+        }
+        tQuery[c] = timer.stop();
+
+        timer.restart();
+        for (index_t i = 0; i != numQueries; ++i)
+            res[c][3*i+2] = t.levelOf(qlow[i], qlvl[i]);
+        tLevel[c] = timer.stop();
+    }
+    ok = ( res[0] == res[1] );
+
+    gsInfo << "query3+query4: linked " << mq / tQuery[0]
+           << ", flat " << mq / tQuery[1] << " Mqueries/s\n"
+           << "levelOf:       linked " << mq / tLevel[0]
+           << ", flat " << mq / tLevel[1] << " Mqueries/s\n";
+
+    // Every leaf reports its own level
+    for (hDomain::literator it = flat.beginLeafIterator(); it.good(); it.next())
+        ok = ok && flat.levelOf(it.lowerCorner(), it.level()) == it.level();
+
+    gsInfo << (ok ? "Queries agree.\n" : "Queries differ!\n");
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,104 @@
+/** @file hierarchicalActives_example.cpp
+
+    @brief Benchmark of the lookup of active functions of
+    hierarchical bases at the quadrature points of all elements
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+int main(int argc, char *argv[])
+{
+    index_t degree = 2;
+    index_t numElements = 16;
+    index_t numLevels = 6;
+    index_t reps = 5;
+
+    gsCmdLine cmd("Active functions of a THB-spline basis at quadrature points.");
+    cmd.addInt("p", "degree", "Polynomial degree", degree);
+    cmd.addInt("e", "elements", "Number of elements per direction on level 0", numElements);
+    cmd.addInt("l", "levels", "Number of refinement levels", numLevels);
+    cmd.addInt("r", "reps", "Number of repetitions", reps);
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+
+    gsKnotVector<> kv(0, 1, numElements - 1, degree + 1);
+    gsTHBSplineBasis<2> thb( gsTensorBSplineBasis<2>(kv, kv) );
+
+    // Refine towards the corner at the origin
+    std::vector<index_t> box(5, 0);
+    for (index_t l = 1; l <= numLevels; ++l)
+    {
+        box[0] = l;
+        box[3] = box[4] = numElements << (l - 1);
+        thb.refineElements(box);
+    }
+
+    // Gauss nodes of all elements, grouped by element
+    gsVector<index_t> numNodes(2);
+    numNodes.setConstant(degree + 1);
+    const gsGaussRule<> rule(numNodes);
+    const index_t np = rule.numNodes();
+    gsMatrix<> nodes, points(2, np * thb.numElements());
+    gsVector<> weights;
+    index_t ne = 0;
+    gsBasis<>::domainIter domIt = thb.makeDomainIterator();
+    for (; domIt->good(); domIt->next(), ++ne)
+    {
+        rule.mapTo(domIt->lowerCorner(), domIt->upperCorner(), nodes, weights);
+        points.middleCols(ne * np, np) = nodes;
+    }
+    gsInfo << "THB-spline basis with " << thb.size() << " functions, "
+           << thb.maxLevel() + 1 << " levels, " << ne << " elements, "
+           << points.cols() << " points\n";
+
+    gsMatrix<index_t> actives, act;
+    gsStopwatch timer;
+    for (index_t r = 0; r != reps; ++r)
+        thb.active_into(points, actives);
+    const real_t tAll = timer.stop();
+
+    timer.restart();
+    for (index_t r = 0; r != reps; ++r)
+        for (index_t e = 0; e != ne; ++e)
+            thb.active_into(points.col(e * np), act);
+    const real_t tFirst = timer.stop();
+
+    // The actives of all points of an element agree with the ones
+    // cached by the domain iterator
+    gsVector<index_t> numAct;
+    thb.numActive_into(points, numAct);
+    bool ok = true;
+    timer.restart();
+    for (index_t r = 0; r != reps; ++r)
+    {
+        index_t e = 0;
+        for (domIt->reset(); domIt->good(); domIt->next(), ++e)
+        {
+            gsHDomainIterator<real_t,2> & hIt =
+                static_cast<gsHDomainIterator<real_t,2>&>(*domIt);
+            const gsMatrix<index_t> & cached = hIt.activeFunctions();
+            if ( r != 0 )
+                continue;
+            for (index_t k = 0; k != np; ++k)
+                ok = ok && cached.rows() == numAct[e * np + k]
+                    && actives.col(e * np + k).topRows(cached.rows()) == cached;
+        }
+    }
+    const real_t tIter = timer.stop();
+
+    const real_t mpts = 1e-6 * static_cast<real_t>(points.cols() * reps);
+    const real_t mels = 1e-6 * static_cast<real_t>(ne * reps);
+    gsInfo << "active_into on all points:      " << mpts / tAll << " Mpoints/s\n"
+           << "active_into per element:        " << mels / tFirst << " Melements/s\n"
+           << "domain iterator with actives:   " << mels / tIter << " Melements/s\n";
+
+    gsInfo << (ok ? "Active functions agree.\n" : "Active functions differ!\n");
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
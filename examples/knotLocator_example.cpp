@@ -0,0 +1,96 @@
+/** @file knotLocator_example.cpp
+
+    @brief Benchmark of the knot-span lookup of gsKnotLocator and of
+    the batched gsKnotVector::uFind_into against gsKnotVector::uFind
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+int main(int argc, char *argv[])
+{
+    index_t numPoints = 100000;
+    index_t numElements = 20000;
+    index_t reps = 10;
+
+    gsCmdLine cmd("Lookups per second of the knot-span searches.");
+    cmd.addInt("n", "points", "Number of lookups", numPoints);
+    cmd.addInt("e", "elements", "Number of knot spans", numElements);
+    cmd.addInt("r", "reps", "Number of repetitions", reps);
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+
+    // Uniform knots and knots graded towards zero
+    gsKnotVector<> kvs[2];
+    kvs[0] = gsKnotVector<>(0, 1, numElements - 1, 4);
+    gsKnotVector<>::knotContainer graded(numElements + 1);
+    for (index_t i = 0; i <= numElements; ++i)
+        graded[i] = math::pow( static_cast<real_t>(i) / numElements, 3 );
+    kvs[1] = gsKnotVector<>(graded, 3, 2);
+
+    // Random points and the same points sorted
+    gsMatrix<> u(1, numPoints);
+    u.setRandom();
+    u.array() = 0.5 + 0.5 * u.array();
+    gsMatrix<> us = u;
+    std::sort(us.data(), us.data() + us.size());
+
+    bool ok = true;
+    gsVector<index_t> idx(numPoints), ref(numPoints);
+    gsStopwatch timer;
+    const real_t mpts = 1e-6 * static_cast<real_t>(numPoints * reps);
+    const char * name[2] = {"uniform", "graded"};
+    gsInfo << "Mlookups/s:\n";
+    for (int c = 0; c != 2; ++c)
+    {
+        const gsKnotVector<> & kv = kvs[c];
+        const gsKnotLocator<> loc(kv);
+        gsInfo << name[c] << (loc.isUniform() ? " (detected uniform)" : "")
+               << ", locator memory " << loc.memoryUsage() << " bytes\n";
+
+        for (int sorted = 0; sorted != 2; ++sorted)
+        {
+            const gsMatrix<> & pts = ( sorted ? us : u );
+
+            timer.restart();
+            for (index_t r = 0; r != reps; ++r)
+                for (index_t j = 0; j != numPoints; ++j)
+                    ref[j] = kv.uFind(pts(0,j)).uIndex();
+            const real_t tFind = timer.stop();
+
+            timer.restart();
+            for (index_t r = 0; r != reps; ++r)
+                for (index_t j = 0; j != numPoints; ++j)
+                    idx[j] = loc.uIndex(pts(0,j));
+            const real_t tLoc = timer.stop();
+            ok = ok && (idx == ref);
+
+            timer.restart();
+            for (index_t r = 0; r != reps; ++r)
+                loc.uIndex_into(pts, idx);
+            const real_t tLocRow = timer.stop();
+            ok = ok && (idx == ref);
+
+            timer.restart();
+            for (index_t r = 0; r != reps; ++r)
+                kv.uFind_into(pts, idx);
+            const real_t tFindRow = timer.stop();
+            ok = ok && (idx == ref);
+
+            gsInfo << (sorted ? "  sorted:   " : "  random:   ")
+                   << "uFind " << mpts / tFind
+                   << ", locator " << mpts / tLoc
+                   << ", locator row " << mpts / tLocRow
+                   << ", uFind_into " << mpts / tFindRow << "\n";
+        }
+    }
+
+    gsInfo << (ok ? "All lookups agree with uFind.\n" : "Lookups differ from uFind!\n");
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,112 @@
+/** @file krylovThreads_example.cpp
+
+    @brief Benchmark of the multithreaded vector kernels and
+    matrix-vector product of the Krylov solvers
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+// Stiffness plus mass matrix of a B-spline discretization of the unit
+// cube, stored row-major
+void stiffnessMatrix(gsSparseMatrix<real_t,RowMajor> & mat, index_t degree,
+                     index_t numRefine)
+{
+    gsMultiPatch<> mp(*gsNurbsCreator<>::BSplineCube(degree));
+    gsMultiBasis<> mb(mp);
+    for (index_t r = 0; r != numRefine; ++r)
+        mb.uniformRefine();
+
+    gsGenericAssembler<> ga(mp, mb);
+    gsSparseMatrix<> A = ga.assembleStiffness();
+    A += ga.assembleMass();
+    mat = A;
+    mat.makeCompressed();
+}
+
+// Solves twice with nt threads; returns the time of one solve and
+// whether both solutions are identical
+template<class Solver>
+real_t timeSolve(Solver & solver, const gsMatrix<> & rhs, index_t nt,
+                 gsMatrix<> & x, bool & repeatable)
+{
+    solver.setNumThreads(nt, true); // the solver owns its matrix operator
+    gsMatrix<> y;
+    x.setZero(rhs.rows(), 1);
+    gsStopwatch timer;
+    solver.solve(rhs, x);
+    const real_t t = timer.stop();
+    y.setZero(rhs.rows(), 1);
+    solver.solve(rhs, y);
+    repeatable = (x == y);
+    return t;
+}
+
+int main(int argc, char *argv[])
+{
+    index_t degree = 2;
+    index_t numRefine = 5;
+    index_t maxThreads = 1;
+    real_t tol = 1e-8;
+#   ifdef _OPENMP
+    maxThreads = omp_get_max_threads();
+#   endif
+
+    gsCmdLine cmd("Multithreaded Krylov solvers.");
+    cmd.addInt ("p", "degree", "Polynomial degree", degree);
+    cmd.addInt ("u", "refine", "Number of uniform refinements", numRefine);
+    cmd.addInt ("n", "threads", "Largest number of threads", maxThreads);
+    cmd.addReal("t", "tol", "Tolerance", tol);
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+
+    gsSparseMatrix<real_t,RowMajor> mat;
+    stiffnessMatrix(mat, degree, numRefine);
+    gsMatrix<> rhs(mat.rows(), 1), x;
+    rhs.setRandom();
+
+    gsInfo << "Stiffness matrix with " << mat.rows() << " unknowns, "
+           << mat.nonZeros() / mat.rows() << " non-zeros per row\n";
+#   ifndef _OPENMP
+    gsInfo << "G+Smo is compiled without OpenMP, the kernels run serially.\n";
+#   endif
+
+    gsLinearOperator<>::Ptr jacobi = makeJacobiOp(mat);
+    gsConjugateGradient<> cg(mat, jacobi);
+    cg.setTolerance(tol);
+    cg.setMaxIterations(mat.rows());
+    gsMinimalResidual<> minres(mat, jacobi);
+    minres.setTolerance(tol);
+    minres.setMaxIterations(mat.rows());
+
+    bool ok = true, repeatable;
+    real_t tCg1 = 0, tMinres1 = 0;
+    for (index_t nt = 1; nt <= maxThreads; nt *= 2)
+    {
+        const real_t tCg = timeSolve(cg, rhs, nt, x, repeatable);
+        ok = ok && repeatable && cg.error() < tol;
+        const real_t tMinres = timeSolve(minres, rhs, nt, x, repeatable);
+        ok = ok && repeatable && minres.error() < tol;
+        if (1 == nt)
+        {
+            tCg1 = tCg;
+            tMinres1 = tMinres;
+        }
+
+        gsInfo << nt << " threads:\n"
+               << "  CG:     " << tCg << " s, " << cg.iterations()
+               << " iterations, speedup " << tCg1 / tCg << "\n"
+               << "  MinRes: " << tMinres << " s, " << minres.iterations()
+               << " iterations, speedup " << tMinres1 / tMinres << "\n";
+    }
+
+    gsInfo << (ok ? "All systems solved, results are repeatable.\n"
+                  : "Some systems not solved or results not repeatable!\n");
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
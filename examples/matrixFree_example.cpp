@@ -0,0 +1,171 @@
+/** @file matrixFree_example.cpp
+
+    @brief Solves a Poisson problem with a matrix-free operator and
+    compares it with the assembled stiffness matrix
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+// Relative difference of two vectors
+real_t relDiff(const gsMatrix<> & a, const gsMatrix<> & b)
+{ return (a - b).norm() / b.norm(); }
+
+int main(int argc, char *argv[])
+{
+    index_t degree = 2;
+    index_t numRefine = 4;
+    index_t numLevels = 3;
+    bool threeD = false;
+    real_t tol = 1e-8;
+
+    gsCmdLine cmd("Solves a Poisson problem with a matrix-free operator.");
+    cmd.addInt   ("p", "degree", "Polynomial degree", degree);
+    cmd.addInt   ("r", "refine", "Number of uniform h-refinement steps", numRefine);
+    cmd.addInt   ("l", "levels", "Number of multigrid levels", numLevels);
+    cmd.addSwitch("3", "3d", "Solve on a 3D domain", threeD);
+    cmd.addReal  ("t", "tolerance", "Stopping criterion of the iterative solvers", tol);
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+
+    gsMultiPatch<> mp;
+    if (threeD)
+        mp.addPatch( gsNurbsCreator<>::lift3D(*gsNurbsCreator<>::BSplineFatQuarterAnnulus()) );
+    else
+        mp.addPatch( gsNurbsCreator<>::BSplineFatQuarterAnnulus() );
+    mp.computeTopology();
+
+    gsMultiBasis<> coarse(mp);
+    coarse.setDegree(degree);
+    for (index_t r = 0; r + numLevels - 1 < numRefine; ++r)
+        coarse.uniformRefine();
+
+    gsConstantFunction<> zero(0.0, mp.geoDim()), one(1.0, mp.geoDim());
+    gsBoundaryConditions<> bc;
+    for (gsMultiPatch<>::const_biterator it = mp.bBegin(); it != mp.bEnd(); ++it)
+        bc.addCondition(*it, condition_type::dirichlet, &zero);
+
+    // Grid hierarchy for the multigrid solver
+    const gsOptionList asmOpt = gsAssembler<>::defaultOptions();
+    std::vector< gsMultiBasis<> > bases;
+    std::vector< gsSparseMatrix<real_t,RowMajor> > transfer;
+    gsGridHierarchy<>::buildByRefinement(coarse, bc, asmOpt, numLevels)
+        .moveMultiBasesTo(bases)
+        .moveTransferMatricesTo(transfer)
+        .clear();
+    const gsMultiBasis<> & mb = bases.back();
+
+    // Assembled system, for comparison
+    gsPoissonAssembler<> assembler(mp, mb, bc, one, dirichlet::elimination, iFace::glue);
+    gsStopwatch time;
+    assembler.assemble();
+    const real_t tAsm = time.stop();
+    const gsSparseMatrix<> & K = assembler.matrix();
+    const gsMatrix<> & f = assembler.rhs();
+    const gsDofMapper & mapper = assembler.system().colMapper(0);
+
+    gsMatrixFreeOp<>::Ptr A = gsMatrixFreeOp<>::make(mp, mb, mapper, gsMatrixFreeOp<>::stiffness);
+    gsInfo << "Degrees of freedom: " << A->rows() << ", non-zeros of K: " << K.nonZeros() << "\n";
+
+    bool ok = true;
+
+    // Products and diagonal
+    gsMatrix<> x = gsMatrix<>::Random(A->cols(), 2), y;
+    time.restart();
+    A->apply(x, y);
+    const real_t tApply = time.stop();
+    const real_t errApply = relDiff(y, K * x);
+    const real_t errDiag  = relDiff(A->diagonal(), K.diagonal());
+    gsInfo << "Assembly: " << tAsm << " s, two matrix-free products: " << tApply << " s\n"
+           << "Difference of the products: " << errApply << ", of the diagonals: " << errDiag << "\n";
+    ok = ok && errApply < 1e-10 && errDiag < 1e-10;
+
+    // Mass and elasticity operators, with and without sum factorization
+    gsOptionList mfOpt = gsMatrixFreeOp<>::defaultOptions();
+    mfOpt.setSwitch("SumFactorization", false);
+    gsDofMapper vmapper(mb, mp.parDim());
+    vmapper.finalize();
+    const gsMatrixFreeOp<>::operatorType type[2] = { gsMatrixFreeOp<>::mass, gsMatrixFreeOp<>::elasticity };
+    for (index_t i = 0; i != 2; ++i)
+    {
+        gsMatrixFreeOp<> op0(mp, mb, vmapper, type[i], mfOpt), op1(mp, mb, vmapper, type[i]);
+        x.setRandom(op0.cols(), 1);
+        gsMatrix<> y0, y1;
+        op0.apply(x, y0);
+        op1.apply(x, y1);
+        // A constant displacement is in the kernel of the elasticity operator
+        gsMatrix<> t = gsMatrix<>::Ones(op0.cols(), 1), z;
+        op1.apply(t, z);
+        real_t err = relDiff(y1, y0);
+        if ( op0.cols() <= 1000 ) // toMatrix() applies the operator to every unit vector
+        {
+            gsMatrix<> M;
+            op0.toMatrix(M);
+            err = math::max( err, relDiff(op1.diagonal(), M.diagonal()) );
+        }
+        gsInfo << (0 == i ? "Mass" : "Elasticity") << " operator, difference of the kernels and diagonals: " << err;
+        if ( 1 == i ) gsInfo << ", rigid motion: " << z.norm();
+        gsInfo << "\n";
+        ok = ok && err < 1e-10 && (0 == i || z.norm() < 1e-10);
+    }
+
+    // Solution with the assembled matrix
+    gsMatrix<> u0, u;
+    gsConjugateGradient<> solver0(K, makeJacobiOp(K));
+    solver0.setTolerance(tol);
+    solver0.solve(f, u0);
+
+    // Matrix-free Jacobi-preconditioned CG and MINRES
+    gsConjugateGradient<> cg(A, makeMatrixFreeJacobiOp(A));
+    cg.setTolerance(tol);
+    time.restart();
+    cg.solve(f, u);
+    gsInfo << "CG:     " << cg.iterations() << " iterations (assembled: " << solver0.iterations()
+           << "), " << time.stop() << " s, difference: " << relDiff(u, u0) << "\n";
+    ok = ok && relDiff(u, u0) < 100 * tol;
+
+    gsMinimalResidual<> minres(A, makeMatrixFreeJacobiOp(A));
+    minres.setTolerance(tol);
+    u.setZero(f.rows(), 1);
+    minres.solve(f, u);
+    gsInfo << "MINRES: " << minres.iterations() << " iterations, difference: " << relDiff(u, u0) << "\n";
+    ok = ok && relDiff(u, u0) < 100 * tol;
+
+    // Matrix-free multigrid as a preconditioner, with Jacobi smoothing
+    std::vector<gsLinearOperator<>::Ptr> ops(numLevels), prolong(numLevels-1), restrict(numLevels-1);
+    std::vector<gsMatrixFreeOp<>::Ptr> mfOps(numLevels);
+    std::vector<gsDofMapper> mappers(numLevels);
+    for (index_t l = 0; l < numLevels; ++l)
+    {
+        bases[l].getMapper(dirichlet::elimination, iFace::glue, bc, mappers[l], 0);
+        ops[l] = mfOps[l] = gsMatrixFreeOp<>::make(mp, bases[l], mappers[l], gsMatrixFreeOp<>::stiffness);
+        if ( l > 0 )
+        {
+            prolong [l-1] = makeMatrixOp(transfer[l-1]);
+            restrict[l-1] = makeMatrixOp(transfer[l-1].transpose());
+        }
+    }
+    gsMatrix<> coarseMat;
+    ops[0]->toMatrix(coarseMat);
+    gsMultiGridOp<>::Ptr mg = gsMultiGridOp<>::make(ops, prolong, restrict,
+                                                    makePartialPivLUSolver(coarseMat));
+    for (index_t l = 1; l < numLevels; ++l)
+        mg->setSmoother(l, makeMatrixFreeJacobiOp(mfOps[l], (real_t)0.5));
+
+    gsConjugateGradient<> mgcg(A, mg);
+    mgcg.setTolerance(tol);
+    time.restart();
+    u.setZero(f.rows(), 1);
+    mgcg.solve(f, u);
+    gsInfo << "MG-CG:  " << mgcg.iterations() << " iterations, " << time.stop()
+           << " s, difference: " << relDiff(u, u0) << "\n";
+    ok = ok && relDiff(u, u0) < 100 * tol;
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,112 @@
+/** @file multicolorGaussSeidel_example.cpp
+
+    @brief Compares the multicolor symmetric Gauss-Seidel (SSOR)
+    preconditioner with the sequential one
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+// Stiffness plus mass matrix of a B-spline discretization of the unit
+// cube
+void stiffnessMatrix(gsSparseMatrix<> & mat, index_t degree, index_t numRefine)
+{
+    gsMultiPatch<> mp(*gsNurbsCreator<>::BSplineCube(degree));
+    gsMultiBasis<> mb(mp);
+    for (index_t r = 0; r != numRefine; ++r)
+        mb.uniformRefine();
+
+    gsGenericAssembler<> ga(mp, mb);
+    mat = ga.assembleStiffness();
+    mat += ga.assembleMass();
+    mat.makeCompressed();
+}
+
+// Solves with the preconditioned conjugate gradient method and prints
+// time, iterations and residual; returns the time
+real_t solveCg(const std::string & name, const gsSparseMatrix<> & mat,
+               const gsLinearOperator<>::Ptr & precond, const gsMatrix<> & rhs,
+               real_t tol, gsMatrix<> & x)
+{
+    gsConjugateGradient<> cg(mat, precond);
+    cg.setTolerance(tol);
+    cg.setMaxIterations(mat.rows());
+    x.setZero(mat.rows(), 1);
+    gsStopwatch timer;
+    cg.solve(rhs, x);
+    const real_t t = timer.stop();
+    gsInfo << name << t << " s, " << cg.iterations() << " iterations, residual "
+           << (mat * x - rhs).norm() / rhs.norm() << "\n";
+    return t;
+}
+
+int main(int argc, char *argv[])
+{
+    index_t degree = 2;
+    index_t numRefine = 4;
+    index_t maxThreads = 1;
+    real_t omega = 1.2;
+    real_t tol = 1e-8;
+#   ifdef _OPENMP
+    maxThreads = omp_get_max_threads();
+#   endif
+
+    gsCmdLine cmd("Multicolor Gauss-Seidel preconditioners.");
+    cmd.addInt ("p", "degree", "Polynomial degree", degree);
+    cmd.addInt ("u", "refine", "Number of uniform refinements", numRefine);
+    cmd.addInt ("n", "threads", "Largest number of threads", maxThreads);
+    cmd.addReal("w", "omega", "Damping parameter of SSOR", omega);
+    cmd.addReal("t", "tol", "Tolerance", tol);
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+
+    gsSparseMatrix<> mat;
+    stiffnessMatrix(mat, degree, numRefine);
+    gsMatrix<> rhs(mat.rows(), 1), x, y;
+    rhs.setRandom();
+
+    gsInfo << "Stiffness matrix with " << mat.rows() << " unknowns, "
+           << mat.nonZeros() / mat.rows() << " non-zeros per row\n";
+#   ifndef _OPENMP
+    gsInfo << "G+Smo is compiled without OpenMP, the sweeps run serially.\n";
+#   endif
+
+    gsStopwatch timer;
+    gsMulticolorGaussSeidelOp<gsSparseMatrix<>,gsGaussSeidel::symmetric>::Ptr mcsgs
+        = gsMulticolorGaussSeidelOp<gsSparseMatrix<>,gsGaussSeidel::symmetric>::make(mat);
+    gsInfo << "Coloring: " << mcsgs->numColors() << " colors, " << timer.stop() << " s\n";
+
+    solveCg("CG, SGS:                   ", mat, makeSymmetricGaussSeidelOp(mat), rhs, tol, x);
+
+    bool ok = true;
+    real_t t1 = 0;
+    for (index_t nt = 1; nt <= maxThreads; nt *= 2)
+    {
+        mcsgs->setNumThreads(nt);
+        gsInfo << nt << " threads:\n";
+        const real_t t = solveCg("  CG, multicolor SGS:        ", mat, mcsgs, rhs, tol, y);
+        if (1 == nt)
+        {
+            t1 = t;
+            x = y;
+        }
+        else
+            ok = ok && (x == y);
+        gsInfo << "  speedup " << t1 / t << "\n";
+    }
+
+    mcsgs->setDamping(omega);
+    mcsgs->setNumThreads(maxThreads);
+    solveCg("CG, multicolor SSOR:       ", mat, mcsgs, rhs, tol, y);
+    ok = ok && (mat * y - rhs).norm() / rhs.norm() < tol;
+
+    gsInfo << (ok ? "All systems solved, results are repeatable.\n"
+                  : "Some systems not solved or results not repeatable!\n");
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,161 @@
+/** @file nurbsEval_example.cpp
+
+    @brief Benchmark of the single-sweep evaluation of rational bases
+    against the evaluation in separate passes
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+// Values, first and second derivatives in separate passes over the
+// source basis, as done before the single-sweep evaluation
+template<class Basis>
+void evalSeparately(const Basis & b, const gsMatrix<> & u,
+                    std::vector<gsMatrix<> > & result)
+{
+    static const int d   = Basis::Dim;
+    static const int str = d * (d+1) / 2;
+    const gsMatrix<> & w = b.weights();
+    result.resize(3);
+
+    // Values
+    b.source().eval_into(u, result[0]);
+    gsMatrix<index_t> act = b.source().active(u);
+    gsMatrix<> denom;
+    b.source().evalFunc_into(u, w, denom);
+    for (index_t j = 0; j < act.cols(); ++j)
+    {
+        result[0].col(j) /= denom(j);
+        for (index_t i = 0; i < act.rows(); ++i)
+            result[0](i,j) *= w(act(i,j));
+    }
+
+    // First derivatives
+    std::vector<gsMatrix<> > ev;
+    b.source().active_into(u, act);
+    b.source().evalAllDers_into(u, 1, ev);
+    result[1].resize(act.rows() * d, u.cols());
+    gsVector<> dW(d), ddW(str);
+    for (index_t i = 0; i != u.cols(); ++i)
+    {
+        real_t W = 0;
+        dW.setZero();
+        for (index_t k = 0; k != act.rows(); ++k)
+        {
+            W  += w(act(k,i)) * ev[0](k,i);
+            dW += w(act(k,i)) * ev[1].block(k*d, i, d, 1);
+        }
+        result[1].col(i) = W * ev[1].col(i);
+        for (index_t k = 0; k != act.rows(); ++k)
+        {
+            result[1].block(k*d, i, d, 1) -= ev[0](k,i) * dW;
+            result[1].block(k*d, i, d, 1) *= w(act(k,i)) / (W * W);
+        }
+    }
+
+    // Second derivatives
+    b.source().active_into(u, act);
+    b.source().evalAllDers_into(u, 2, ev);
+    result[2].resize(act.rows() * str, u.cols());
+    for (index_t i = 0; i != u.cols(); ++i)
+    {
+        real_t W = 0;
+        dW.setZero();
+        ddW.setZero();
+        for (index_t k = 0; k != act.rows(); ++k)
+        {
+            W   += w(act(k,i)) * ev[0](k,i);
+            dW  += w(act(k,i)) * ev[1].block(k*d, i, d, 1);
+            ddW += w(act(k,i)) * ev[2].block(k*str, i, str, 1);
+        }
+        result[2].col(i) = W * ev[2].col(i);
+        for (index_t k = 0; k != act.rows(); ++k)
+        {
+            const index_t ks = k * str, kd = k * d;
+            result[2].block(ks, i, str, 1) -= ev[0](k,i) * ddW;
+            result[2].block(ks, i, d, 1) += (2 * ev[0](k,i) / W) * dW.cwiseProduct(dW)
+                - 2 * ev[1].block(kd, i, d, 1).cwiseProduct(dW);
+            int m = d;
+            for (int a = 0; a != d; ++a)
+                for (int c = a + 1; c != d; ++c)
+                    result[2](ks + m++, i) += - ev[1](kd+a,i) * dW[c] - ev[1](kd+c,i) * dW[a]
+                        + 2 * ev[0](k,i) * dW[a] * dW[c] / W;
+            result[2].block(ks, i, str, 1) *= w(act(k,i)) / (W * W);
+        }
+    }
+}
+
+template<class Basis>
+bool benchmark(const Basis & b, const gsMatrix<> & u, index_t reps)
+{
+    std::vector<gsMatrix<> > sep, fused;
+    gsStopwatch timer;
+    for (index_t r = 0; r != reps; ++r)
+        evalSeparately(b, u, sep);
+    const real_t tSep = timer.stop();
+
+    timer.restart();
+    for (index_t r = 0; r != reps; ++r)
+        b.evalAllDers_into(u, 2, fused);
+    const real_t tFused = timer.stop();
+
+    bool ok = true;
+    for (int k = 0; k != 3; ++k)
+        ok = ok && (sep[k] - fused[k]).cwiseAbs().maxCoeff()
+            < 1e-10 * (1 + sep[k].cwiseAbs().maxCoeff());
+
+    const real_t mpts = 1e-6 * static_cast<real_t>(u.cols() * reps);
+    gsInfo << "dim " << Basis::Dim << ", " << b.size() << " functions: separate "
+           << mpts / tSep << ", single sweep " << mpts / tFused << " Mpoints/s\n";
+    return ok;
+}
+
+int main(int argc, char *argv[])
+{
+    index_t degree = 3;
+    index_t numElements = 16;
+    index_t numPoints = 20000;
+    index_t reps = 10;
+
+    gsCmdLine cmd("Values and derivatives of NURBS bases per second.");
+    cmd.addInt("p", "degree", "Polynomial degree", degree);
+    cmd.addInt("e", "elements", "Number of elements per direction", numElements);
+    cmd.addInt("n", "points", "Number of evaluation points", numPoints);
+    cmd.addInt("r", "reps", "Number of repetitions", reps);
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+
+    gsKnotVector<> kv(0, 1, numElements - 1, degree + 1);
+    std::srand(42);
+
+    gsNurbsBasis<> b1(kv);
+    gsTensorNurbsBasis<2> b2( gsTensorBSplineBasis<2>(kv, kv) );
+    gsTensorNurbsBasis<3> b3( gsTensorBSplineBasis<3>(kv, kv, kv) );
+    b1.weights().setRandom();
+    b1.weights().array() = 1.25 + 0.75 * b1.weights().array();
+    b2.weights().setRandom();
+    b2.weights().array() = 1.25 + 0.75 * b2.weights().array();
+    b3.weights().setRandom();
+    b3.weights().array() = 1.25 + 0.75 * b3.weights().array();
+
+    gsMatrix<> u;
+    bool ok = true;
+    u.setRandom(1, numPoints);
+    u.array() = 0.5 + 0.5 * u.array();
+    ok = benchmark(b1, u, 10 * reps) && ok;
+    u.setRandom(2, numPoints);
+    u.array() = 0.5 + 0.5 * u.array();
+    ok = benchmark(b2, u, reps) && ok;
+    u.setRandom(3, numPoints / 10);
+    u.array() = 0.5 + 0.5 * u.array();
+    ok = benchmark(b3, u, reps) && ok;
+
+    gsInfo << (ok ? "Evaluations agree.\n" : "Evaluations differ!\n");
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,78 @@
+/** @file parallelAssembly_example.cpp
+
+    @brief Strong scaling of the (element-colored) parallel assembly
+    of a Poisson problem on a 3D tensor B-spline patch
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+int main(int argc, char *argv[])
+{
+    index_t numRefine = 2;
+    index_t degree    = 2;
+    index_t numRuns   = 1;
+    index_t maxThreads= 0;
+
+    gsCmdLine cmd("Measures the strong scaling of the Poisson assembly on a 3D patch.");
+    cmd.addInt("r", "refine", "Number of uniform h-refinement steps", numRefine);
+    cmd.addInt("p", "degree", "Polynomial degree of the discretization", degree);
+    cmd.addInt("n", "runs", "Number of assembly runs per thread count", numRuns);
+    cmd.addInt("t", "threads", "Maximum number of threads (0: all available)", maxThreads);
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+
+    gsMultiPatch<> patches( *gsNurbsCreator<>::BSplineCube(1) );
+
+    gsMultiBasis<> bases(patches);
+    bases.setDegree(degree);
+    for (index_t i = 0; i < numRefine; ++i)
+        bases.uniformRefine();
+
+    gsConstantFunction<> f(1.0, 3), g(0.0, 3);
+    gsBoundaryConditions<> bcInfo;
+    for (gsMultiPatch<>::const_biterator
+             bit = patches.bBegin(); bit != patches.bEnd(); ++bit)
+        bcInfo.addCondition( *bit, condition_type::dirichlet, &g );
+
+    gsPoissonAssembler<real_t> assembler(patches, bases, bcInfo, f);
+    gsInfo << "Patch with " << bases[0].numElements() << " elements of degree "
+           << degree << " and " << assembler.numDofs() << " DoFs.\n";
+
+#ifdef _OPENMP
+    if (maxThreads <= 0)
+        maxThreads = omp_get_max_threads();
+#else
+    maxThreads = 1;
+    gsInfo << "Compiled without OpenMP, running sequentially.\n";
+#endif
+
+    gsStopwatch time;
+    real_t t1 = 0;
+    gsInfo << "threads      time [s]     speedup\n";
+    for (index_t nt = 1; nt <= maxThreads; nt *= 2)
+    {
+#ifdef _OPENMP
+        omp_set_num_threads(nt);
+#endif
+        time.restart();
+        for (index_t k = 0; k != numRuns; ++k)
+            assembler.assemble();
+        const real_t t = time.stop() / numRuns;
+        if (1 == nt) t1 = t;
+        gsInfo << std::setw(7) << nt << std::setw(14) << t
+               << std::setw(12) << t1 / t << "\n";
+    }
+
+    gsInfo << "Matrix: " << assembler.matrix().rows() << " x "
+           << assembler.matrix().cols() << ", " << assembler.matrix().nonZeros()
+           << " non-zeros.\n";
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,87 @@
+/** @file pipelinedCG_example.cpp
+
+    @brief Compares the pipelined conjugate gradient method with the
+    standard one
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+// Stiffness plus mass matrix of a B-spline discretization of the unit
+// cube
+void stiffnessMatrix(gsSparseMatrix<> & mat, index_t degree, index_t numRefine)
+{
+    gsMultiPatch<> mp(*gsNurbsCreator<>::BSplineCube(degree));
+    gsMultiBasis<> mb(mp);
+    for (index_t r = 0; r != numRefine; ++r)
+        mb.uniformRefine();
+
+    gsGenericAssembler<> ga(mp, mb);
+    mat = ga.assembleStiffness();
+    mat += ga.assembleMass();
+    mat.makeCompressed();
+}
+
+int main(int argc, char *argv[])
+{
+    index_t degree = 2;
+    index_t numRefine = 4;
+    index_t numThreads = 1;
+    index_t replace = 20;
+    real_t tol = 1e-10;
+
+    gsCmdLine cmd("Pipelined conjugate gradients.");
+    cmd.addInt ("p", "degree", "Polynomial degree", degree);
+    cmd.addInt ("u", "refine", "Number of uniform refinements", numRefine);
+    cmd.addInt ("n", "threads", "Number of threads", numThreads);
+    cmd.addInt ("r", "replace", "Steps between residual replacements (0: never)", replace);
+    cmd.addReal("t", "tol", "Tolerance", tol);
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+
+    gsSparseMatrix<> mat;
+    stiffnessMatrix(mat, degree, numRefine);
+    gsMatrix<> rhs(mat.rows(), 1), x;
+    rhs.setRandom();
+
+    gsInfo << "Stiffness matrix with " << mat.rows() << " unknowns, "
+           << mat.nonZeros() / mat.rows() << " non-zeros per row\n";
+
+    gsLinearOperator<>::Ptr jacobi = makeJacobiOp(mat);
+    gsStopwatch timer;
+
+    gsConjugateGradient<> cg(mat, jacobi);
+    cg.setTolerance(tol);
+    cg.setMaxIterations(mat.rows());
+    cg.setNumThreads(numThreads);
+    x.setZero(mat.rows(), 1);
+    timer.restart();
+    cg.solve(rhs, x);
+    const real_t tCg = timer.stop();
+    const real_t resCg = (mat * x - rhs).norm() / rhs.norm();
+    gsInfo << "CG:           " << tCg << " s, " << cg.iterations() << " iterations, "
+           << 2 * cg.iterations() << " blocking reductions, residual " << resCg << "\n";
+
+    gsPipelinedConjugateGradient<> pcg(mat, jacobi);
+    pcg.setTolerance(tol);
+    pcg.setMaxIterations(mat.rows());
+    pcg.setNumThreads(numThreads);
+    pcg.setResidualReplacement(replace);
+    x.setZero(mat.rows(), 1);
+    timer.restart();
+    pcg.solve(rhs, x);
+    const real_t tPcg = timer.stop();
+    const real_t resPcg = (mat * x - rhs).norm() / rhs.norm();
+    gsInfo << "Pipelined CG: " << tPcg << " s, " << pcg.iterations() << " iterations, "
+           << pcg.iterations() + 1 << " overlapped reductions, residual " << resPcg << "\n";
+
+    const bool ok = resCg < 10 * tol && resPcg < 10 * tol;
+    gsInfo << (ok ? "Both solvers converged.\n" : "Some solver did not converge!\n");
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,76 @@
+/** @file sumFactorization_example.cpp
+
+    @brief Compares the standard element assembly with the
+    sum-factorized kernels on tensor-product B-spline patches, in 2D
+    and 3D
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+// Assembles the stiffness and the mass matrix of \a mp, returns the time
+real_t assembleMatrices(const gsMultiPatch<> & mp, const gsMultiBasis<> & mb,
+                        const bool sumFact, gsSparseMatrix<> & K, gsSparseMatrix<> & M)
+{
+    gsOptionList opt = gsAssembler<>::defaultOptions();
+    opt.setSwitch("SumFactorization", sumFact);
+    gsGenericAssembler<> A(mp, mb, opt);
+
+    gsStopwatch time;
+    K = A.assembleStiffness();
+    M = A.assembleMass();
+    return time.stop();
+}
+
+int main(int argc, char *argv[])
+{
+    index_t minDegree = 2;
+    index_t maxDegree = 6;
+    index_t numRefine = 1;
+
+    gsCmdLine cmd("Benchmarks the sum-factorized element kernels against the standard assembly.");
+    cmd.addInt("p", "min-degree", "Smallest polynomial degree", minDegree);
+    cmd.addInt("q", "max-degree", "Largest polynomial degree", maxDegree);
+    cmd.addInt("r", "refine", "Number of uniform h-refinement steps", numRefine);
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+
+    // A curved 2D patch and its extrusion
+    gsMultiPatch<> domain[2];
+    domain[0] = gsMultiPatch<>(*gsNurbsCreator<>::BSplineFatQuarterAnnulus());
+    domain[1] = gsMultiPatch<>(*gsNurbsCreator<>::lift3D(
+                                   *gsNurbsCreator<>::BSplineFatQuarterAnnulus()));
+
+    gsSparseMatrix<> K0, M0, K1, M1;
+    bool ok = true;
+    for (index_t i = 0; i != 2; ++i)
+    {
+        gsInfo << "Dimension " << i+2 << "\n"
+               << "degree  elements     standard [s]  sum-fact. [s]  speedup   difference\n";
+        for (index_t p = minDegree; p <= maxDegree; ++p)
+        {
+            gsMultiBasis<> mb(domain[i]);
+            mb.setDegree(p);
+            for (index_t r = 0; r < numRefine; ++r)
+                mb.uniformRefine();
+
+            const real_t t0 = assembleMatrices(domain[i], mb, false, K0, M0);
+            const real_t t1 = assembleMatrices(domain[i], mb, true , K1, M1);
+            const real_t err = math::max( (K0-K1).norm() / K0.norm(),
+                                          (M0-M1).norm() / M0.norm() );
+            ok = ok && err < 1e-10;
+
+            gsInfo << std::setw(6) << p << std::setw(10) << mb.totalElements()
+                   << std::setw(17) << t0 << std::setw(15) << t1
+                   << std::setw(9) << t0 / t1 << std::setw(13) << err << "\n";
+        }
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
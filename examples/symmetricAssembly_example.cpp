@@ -0,0 +1,110 @@
+/** @file symmetricAssembly_example.cpp
+
+    @brief Assembly of symmetric matrices storing only their lower
+    triangular part (option Symmetric)
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+// Assembles the Poisson system and the mass and stiffness matrices
+void assemble(const gsMultiPatch<> & mp, const gsMultiBasis<> & mb,
+              const gsBoundaryConditions<> & bcInfo, const gsFunction<> & f,
+              bool symmetric, gsSparseMatrix<> & A, gsMatrix<> & b,
+              gsSparseMatrix<> & M, gsSparseMatrix<> & K, real_t & time)
+{
+    gsOptionList opt = gsAssembler<>::defaultOptions();
+    opt.setSwitch("Symmetric", symmetric);
+
+    gsStopwatch timer;
+    gsPoissonAssembler<> pa(mp, mb, bcInfo, f);
+    pa.options().setSwitch("Symmetric", symmetric);
+    pa.refresh();
+    pa.assemble();
+    A = pa.matrix();
+    b = pa.rhs();
+
+    gsGenericAssembler<> ga(mp, mb, opt);
+    M = ga.assembleMass();
+    K = ga.assembleStiffness();
+    time = timer.stop();
+}
+
+// Relative difference of the full matrix \a A0 and the symmetric
+// matrix whose lower triangular part is \a A1
+real_t difference(const gsSparseMatrix<> & A0, const gsSparseMatrix<> & A1)
+{
+    const gsSparseMatrix<> full = A1.selfadjointView<Lower>();
+    return (full - A0).norm() / A0.norm();
+}
+
+int main(int argc, char *argv[])
+{
+    index_t degree    = 3;
+    index_t numRefine = 3;
+
+    gsCmdLine cmd("Symmetric assembly storing only the lower triangular part.");
+    cmd.addInt("p", "degree", "Polynomial degree", degree);
+    cmd.addInt("r", "refine", "Number of uniform h-refinement steps", numRefine);
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+
+    gsMultiPatch<> mp(*gsNurbsCreator<>::BSplineFatQuarterAnnulus());
+    gsMultiBasis<> mb(mp);
+    mb.setDegree(degree);
+    for (index_t r = 0; r < numRefine; ++r)
+        mb.uniformRefine();
+
+    gsFunctionExpr<> f("2*pi^2*sin(pi*x)*sin(pi*y)", 2);
+    gsFunctionExpr<> g("sin(pi*x)*sin(pi*y)", 2);
+    gsBoundaryConditions<> bcInfo;
+    for (gsMultiPatch<>::const_biterator it = mp.bBegin(); it != mp.bEnd(); ++it)
+        bcInfo.addCondition(*it, condition_type::dirichlet, &g);
+
+    gsSparseMatrix<> A0, M0, K0, A1, M1, K1;
+    gsMatrix<> b0, b1;
+    real_t t0, t1;
+    assemble(mp, mb, bcInfo, f, false, A0, b0, M0, K0, t0);
+    assemble(mp, mb, bcInfo, f, true , A1, b1, M1, K1, t1);
+
+    const real_t errA = difference(A0, A1);
+    const real_t errM = difference(M0, M1);
+    const real_t errK = difference(K0, K1);
+    const real_t errB = (b1 - b0).norm() / b0.norm();
+    gsInfo << "Degree " << degree << ", " << mb.size() << " DoFs\n"
+           << "Full storage : " << A0.nonZeros() << " non-zeros, " << t0 << " s\n"
+           << "Lower part   : " << A1.nonZeros() << " non-zeros, " << t1 << " s\n"
+           << "Difference   : " << errA << " (Poisson), " << errB << " (rhs), "
+           << errM << " (mass), " << errK << " (stiffness)\n";
+
+    // The lower triangular part is used directly by the LDLT
+    // factorization and by the operators of the iterative solvers
+    gsSparseSolver<>::SimplicialLDLT ldlt0(A0), ldlt1(A1);
+    const gsMatrix<> x0 = ldlt0.solve(b0), x1 = ldlt1.solve(b1);
+    const real_t errX = (x1 - x0).norm() / x0.norm();
+
+    gsMatrix<> y0, y1;
+    makeMatrixOp(A0)->apply(x0, y0);
+    makeSymmetricMatrixOp(A1)->apply(x0, y1);
+    const real_t errY = (y1 - y0).norm() / y0.norm();
+
+    gsMatrix<> x2;
+    x2.setZero(b1.rows(), 1);
+    gsConjugateGradient<> cg(A1.selfadjointView<Lower>(), makeJacobiOp(A1));
+    cg.setTolerance(1e-10);
+    cg.solve(b1, x2);
+    const real_t errCG = (x2 - x0).norm() / x0.norm();
+
+    gsInfo << "LDLT solution: " << errX << ", matrix-vector product: " << errY
+           << ", CG solution: " << errCG << " (" << cg.iterations() << " iterations)\n";
+
+    const bool ok = errA < 1e-12 && errB < 1e-12 && errM < 1e-12 && errK < 1e-12
+        && errX < 1e-10 && errY < 1e-12 && errCG < 1e-6;
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
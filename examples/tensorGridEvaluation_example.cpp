@@ -0,0 +1,119 @@
+/** @file tensorGridEvaluation_example.cpp
+
+    @brief Evaluation of tensor-product bases on Cartesian grids of
+    points, such as quadrature nodes and sampling grids
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+// Evaluates the basis on the grid and, point by point, on the same
+// points in a different order, returns the largest difference
+real_t compare(const gsBasis<> & basis, const std::vector<gsVector<> > & grid,
+               int reps, real_t & time, real_t & timeGrid)
+{
+    // Swapping two points destroys the grid structure
+    gsMatrix<> pts = gsPointGrid<real_t>(grid);
+    pts.col(0).swap(pts.col(1));
+
+    std::vector<gsMatrix<> > values, valuesGrid;
+    gsMatrix<index_t> actives, activesGrid;
+    gsStopwatch timer;
+    for (int r = 0; r != reps; ++r)
+        basis.evalAllDers_into(pts, 2, values);
+    time = timer.stop();
+
+    timer.restart();
+    for (int r = 0; r != reps; ++r)
+        basis.evalAllDersGrid_into(grid, 2, valuesGrid);
+    timeGrid = timer.stop();
+
+    basis.active_into(pts, actives);
+    basis.activeGrid_into(grid, activesGrid);
+    actives.col(0).swap(actives.col(1));
+    if ( actives != activesGrid )
+        return 1;
+
+    real_t err = 0;
+    for (index_t k = 0; k != 3; ++k)
+    {
+        values[k].col(0).swap(values[k].col(1));
+        err = math::max(err, (values[k] - valuesGrid[k]).cwiseAbs().maxCoeff()
+                        / (1 + values[k].cwiseAbs().maxCoeff()) );
+    }
+    return err;
+}
+
+int main(int argc, char *argv[])
+{
+    index_t degree    = 3;
+    index_t numRefine = 3;
+    index_t numPoints = 4000;
+    bool plot = false;
+
+    gsCmdLine cmd("Evaluation of tensor-product bases on grids of points.");
+    cmd.addInt("p", "degree", "Polynomial degree", degree);
+    cmd.addInt("r", "refine", "Number of uniform h-refinement steps", numRefine);
+    cmd.addInt("s", "samples", "Number of sampling points", numPoints);
+    cmd.addSwitch("plot", "Write the volume to ParaView", plot);
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+
+    gsKnotVector<> kv(0, 1, (1 << numRefine) - 1, degree + 1);
+    gsTensorBSplineBasis<3> basis(kv, kv, kv);
+
+    // The nodes of a Gauss rule on one element
+    gsVector<index_t> numNodes(3);
+    numNodes.setConstant(degree + 1);
+    const gsGaussRule<> rule(numNodes);
+    gsVector<> lower(3), upper(3);
+    lower.setConstant(0.25);
+    upper.setConstant(0.375);
+    gsMatrix<> nodes;
+    gsVector<> weights, weightsGrid;
+    std::vector<gsVector<> > nodesGrid;
+    rule.mapTo(lower, upper, nodes, weights);
+    bool ok = rule.mapToGrid(lower, upper, nodesGrid, weightsGrid)
+        && gsPointGrid<real_t>(nodesGrid) == nodes && weightsGrid == weights;
+
+    // A sampling grid on the whole domain
+    const gsMatrix<> supp = basis.support();
+    const gsVector<> a = supp.col(0), b = supp.col(1);
+    const gsVector<unsigned> np = uniformSampleCount(a, b, numPoints);
+    std::vector<gsVector<> > samples;
+    uniformGridCoordinates(a, b, np, samples);
+
+    real_t time, timeGrid;
+    real_t err = compare(basis, nodesGrid, 200, time, timeGrid);
+    ok = ok && err < 1e-12;
+    gsInfo << "Quadrature nodes (" << nodes.cols() << " points): difference " << err
+           << ", " << time << " s point-wise, " << timeGrid << " s on the grid\n";
+
+    err = compare(basis, samples, 1, time, timeGrid);
+    ok = ok && err < 1e-12;
+    gsInfo << "Sampling grid (" << np.prod() << " points): difference " << err
+           << ", " << time << " s point-wise, " << timeGrid << " s on the grid\n";
+
+    // Geometries are evaluated on grids as well, e.g. for plotting
+    gsGeometry<>::uPtr geo = basis.makeGeometry(basis.anchors().transpose());
+    gsMatrix<> values, valuesGrid;
+    geo->eval_into(gsPointGrid<real_t>(samples), values);
+    geo->evalGrid_into(samples, valuesGrid);
+    err = (values - valuesGrid).cwiseAbs().maxCoeff();
+    ok = ok && err < 1e-12;
+    gsInfo << "Geometry on the sampling grid: difference " << err << "\n";
+
+    if ( plot )
+    {
+        gsInfo << "Writing the volume to volume.pvd\n";
+        gsWriteParaview(*geo, "volume", numPoints);
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -72,14 +72,15 @@ int main(int argc, char *argv[])
     if (numTr < 1000)
         gsInfo <<"\nCoefficient count for each truncated function: \n";
     unsigned ccount = 0;
-    typedef std::map<index_t, gsSparseVector<> >::const_iterator trIter;
-    for( trIter it = thb.truncatedBegin(); it != thb.truncatedEnd(); ++it)
+    for( index_t i = 0; i != thb.size(); ++i)
     {
-        const int lvl = thb.levelOf(it->first);
+        if ( !thb.isTruncated(i) )
+            continue;
+        const index_t nz = thb.truncation().row(i).nonZeros();
         if (numTr < 1000)
-            gsInfo << it->second.nonZeros() <<", ";
-        trcount[lvl]++;
-        ccount += it->second.nonZeros();
+            gsInfo << nz <<", ";
+        trcount[thb.levelOf(i)]++;
+        ccount += nz;
     }
     gsInfo<<"\n\n";
 
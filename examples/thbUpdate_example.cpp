@@ -0,0 +1,78 @@
+/** @file thbUpdate_example.cpp
+
+    @brief Benchmark of the update of a THB-spline basis during
+    adaptive refinement, against the construction from all boxes
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+int main(int argc, char *argv[])
+{
+    index_t degree = 2;
+    index_t numElements = 8;
+    index_t numSteps = 20;
+    index_t maxLevel = 4;
+    real_t radius = 0.15;
+
+    gsCmdLine cmd("Adaptive refinement of a trivariate THB-spline basis.");
+    cmd.addInt("p", "degree", "Polynomial degree", degree);
+    cmd.addInt("e", "elements", "Number of elements per direction on level 0", numElements);
+    cmd.addInt("s", "steps", "Number of refinement steps", numSteps);
+    cmd.addInt("l", "levels", "Maximum level", maxLevel);
+    cmd.addReal("r", "radius", "Radius of the refined region", radius);
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+
+    gsKnotVector<> kv(0, 1, numElements - 1, degree + 1);
+    gsTensorBSplineBasis<3> tp(kv, kv, kv);
+    gsTHBSplineBasis<3> thb(tp);
+
+    // All boxes inserted so far, in the format of refineElements()
+    std::vector<index_t> boxes, allBoxes;
+    gsVector<> ctr(3);
+    real_t tUpdate = 0, tFull = 0;
+    gsStopwatch timer;
+    for (index_t s = 0; s != numSteps; ++s)
+    {
+        // Mark the elements close to a point moving along the diagonal
+        ctr.setConstant( 0.1 + 0.8 * s / math::max(numSteps - 1, (index_t)1) );
+        boxes.clear();
+        gsBasis<>::domainIter domIt = thb.makeDomainIterator();
+        for (; domIt->good(); domIt->next())
+        {
+            const gsVector<> & c = domIt->centerPoint();
+            const int lvl = thb.getLevelAtPoint(c);
+            if ( lvl >= maxLevel || (c - ctr).norm() > radius )
+                continue;
+            boxes.push_back(lvl + 1);
+            for (short_t i = 0; i != 3; ++i)
+                boxes.push_back( 2 * thb.tensorLevel(lvl).knots(i).uFind(c[i]).uIndex() );
+            for (short_t i = 0; i != 3; ++i)
+                boxes.push_back( boxes[boxes.size() - 3] + 2 );
+        }
+        allBoxes.insert(allBoxes.end(), boxes.begin(), boxes.end());
+
+        timer.restart();
+        thb.refineElements(boxes);
+        const real_t t1 = timer.stop();
+        tUpdate += t1;
+
+        timer.restart();
+        gsTHBSplineBasis<3> full(tp, allBoxes);
+        const real_t t2 = timer.stop();
+        tFull += t2;
+
+        gsInfo << "Step " << s << ": " << boxes.size() / 7 << " elements marked, "
+               << thb.size() << " functions, update " << t1 << " s, full " << t2 << " s\n";
+    }
+
+    gsInfo << "Total: update " << tUpdate << " s, full " << tFull << " s\n";
+    return EXIT_SUCCESS;
+}
@@ -49,6 +49,7 @@ namespace internal
 #include <gsCore/gsFunctionSet.h>
 #include <gsCore/gsFuncData.h>
 #include <gsCore/gsFunction.h>
+#include <gsCore/gsMapDataCache.h>
 #include <gsCore/gsPiecewiseFunction.h>
 #include <gsCore/gsBoundary.h>
 
@@ -85,6 +86,7 @@ namespace internal
 
 /* ----------- Nurbs ----------- */
 #include <gsNurbs/gsKnotVector.h>
+#include <gsNurbs/gsKnotLocator.h>
 #include <gsNurbs/gsBSplineBasis.h>
 #include <gsNurbs/gsBSpline.h>
 #include <gsNurbs/gsNurbsBasis.h>
@@ -136,6 +138,8 @@ namespace internal
 /* ----------- Quadrature ----------- */
 #include <gsAssembler/gsQuadRule.h>
 #include <gsAssembler/gsQuadrature.h>
+#include <gsAssembler/gsWeightedQuadRule.h>
+#include <gsAssembler/gsBezierExtraction.h>
 
 /* ----------- Assembler ----------- */
 #include <gsAssembler/gsAssembler.h>
@@ -143,6 +147,8 @@ namespace internal
 #include <gsAssembler/gsPoissonAssembler.h>
 #include <gsAssembler/gsCDRAssembler.h>
 #include <gsAssembler/gsHeatEquation.h>
+#include <gsAssembler/gsMatrixFreeOp.h>
+#include <gsAssembler/gsWeightedQuadAssembler.h>
 
 #include <gsAssembler/gsExprHelper.h>
 #include <gsAssembler/gsExprAssembler.h>
@@ -150,16 +156,21 @@ namespace internal
 
 /* ----------- Solver ----------- */
 #include <gsSolver/gsLinearOperator.h>
+#include <gsSolver/gsKrylovKernels.h>
 #include <gsSolver/gsMinimalResidual.h>
 #include <gsSolver/gsGMRes.h>
 #include <gsSolver/gsGradientMethod.h>
 #include <gsSolver/gsConjugateGradient.h>
+#include <gsSolver/gsBlockConjugateGradient.h>
+#include <gsSolver/gsPipelinedConjugateGradient.h>
+#include <gsSolver/gsBlockGMRes.h>
 #include <gsSolver/gsPreconditioner.h>
 #include <gsSolver/gsAdditiveOp.h>
 #include <gsSolver/gsBlockOp.h>
 #include <gsSolver/gsCompositePrecOp.h>
 #include <gsSolver/gsProductOp.h>
 #include <gsSolver/gsSimplePreconditioners.h>
+#include <gsSolver/gsChebyshevOp.h>
 #include <gsSolver/gsSumOp.h>
 #include <gsSolver/gsKroneckerOp.h>
 #include <gsSolver/gsPatchPreconditionersCreator.h>
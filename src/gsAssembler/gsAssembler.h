@@ -20,6 +20,7 @@
 #include <gsCore/gsMultiBasis.h>
 #include <gsCore/gsDomainIterator.h>
 #include <gsCore/gsAffineFunction.h>
+#include <gsCore/gsMapDataCache.h>
 
 #include <gsIO/gsOptionList.h>
 
@@ -27,6 +28,8 @@
 #include <gsPde/gsBoundaryConditions.h>
 
 #include <gsAssembler/gsQuadRule.h>
+#include <gsAssembler/gsQuadrature.h>
+#include <gsAssembler/gsBezierExtraction.h>
 #include <gsAssembler/gsSparseSystem.h>
 #include <gsAssembler/gsRemapInterface.h>
 
@@ -35,6 +38,122 @@
 namespace gismo
 {
 
+namespace internal
+{
+/// Lets the geometry evaluations of \a visitor use \a cache, if the
+/// visitor exposes them with a member mapData()
+template <class Visitor, class T>
+void setMapDataCache(Visitor & visitor, gsMapDataCache<T> * cache,
+                     char (*)[sizeof(&Visitor::mapData)])
+{ visitor.mapData().cache = cache; }
+
+template <class Visitor, class T>
+void setMapDataCache(Visitor &, gsMapDataCache<T> *, ...) { }
+
+/// Whether \a Visitor can evaluate its bases by Bezier extraction,
+/// i.e., has a member setBezierElement()
+template <class Visitor>
+bool hasBezierElement(char (*)[sizeof(&Visitor::setBezierElement)]) { return true; }
+
+template <class Visitor>
+bool hasBezierElement(...) { return false; }
+
+/// Lets \a visitor evaluate its bases on element \a e of \a be, if
+/// the visitor supports it
+template <class Visitor, class T>
+void setBezierElement(Visitor & visitor, const gsBezierExtraction<T> * be, index_t e,
+                      char (*)[sizeof(&Visitor::setBezierElement)])
+{ visitor.setBezierElement(be, e); }
+
+template <class Visitor, class T>
+void setBezierElement(Visitor &, const gsBezierExtraction<T> *, index_t, ...) { }
+
+/// Whether \a Visitor can evaluate chunks of elements at once, i.e.,
+/// has a member evaluateBlock()
+template <class Visitor>
+bool hasEvaluateBlock(char (*)[sizeof(&Visitor::evaluateBlock)]) { return true; }
+
+template <class Visitor>
+bool hasEvaluateBlock(...) { return false; }
+
+/// Lets \a visitor evaluate the chunk of elements with nodes \a
+/// nodes and offsets \a ptOffset, if the visitor supports it
+template <class Visitor, class T>
+bool evaluateBlock(Visitor & visitor, const gsBasis<T> & basis, const gsGeometry<T> & geo,
+                   const gsMatrix<T> & nodes, const gsVector<index_t> & ptOffset,
+                   char (*)[sizeof(&Visitor::evaluateBlock)])
+{ return visitor.evaluateBlock(basis, geo, nodes, ptOffset); }
+
+template <class Visitor, class T>
+bool evaluateBlock(Visitor &, const gsBasis<T> &, const gsGeometry<T> &,
+                   const gsMatrix<T> &, const gsVector<index_t> &, ...) { return false; }
+
+/// Lets \a visitor take element \a e of the chunk evaluated by
+/// evaluateBlock()
+template <class Visitor>
+void setBlockElement(Visitor & visitor, index_t e,
+                     char (*)[sizeof(&Visitor::setBlockElement)])
+{ visitor.setBlockElement(e); }
+
+template <class Visitor>
+void setBlockElement(Visitor &, index_t, ...) { }
+
+/// @brief Iterates over the elements \a first to \a last-1 of a list
+/// of elements, given by the columns of their corners \a lower and
+/// \a upper (see gsAssembler::elementColoring)
+template <class T>
+class gsElementListIterator : public gsDomainIterator<T>
+{
+public:
+    gsElementListIterator(const gsBasis<T> & basis,
+                          const gsMatrix<T> & lower, const gsMatrix<T> & upper,
+                          const index_t first, const index_t last)
+    : gsDomainIterator<T>(basis), m_lower(lower), m_upper(upper),
+      m_first(first), m_last(last)
+    { reset(); }
+
+    bool next() { return next(1); }
+
+    bool next(index_t increment)
+    {
+        m_cur += increment;
+        update();
+        return this->m_isGood;
+    }
+
+    void reset()
+    {
+        m_cur = m_first;
+        update();
+    }
+
+    const gsVector<T> & lowerCorner() const { return m_low; }
+
+    const gsVector<T> & upperCorner() const { return m_upp; }
+
+    size_t numElements() const { return m_last - m_first; }
+
+private:
+    void update()
+    {
+        this->m_isGood = m_cur < m_last;
+        if ( this->m_isGood )
+        {
+            m_low = m_lower.col(m_cur);
+            m_upp = m_upper.col(m_cur);
+            this->center = (m_low + m_upp) / 2;
+        }
+    }
+
+private:
+    const gsMatrix<T> & m_lower;
+    const gsMatrix<T> & m_upper;
+    const index_t m_first, m_last;
+    index_t m_cur;
+    gsVector<T> m_low, m_upp;
+};
+} // namespace internal
+
 template <class T>
 void transformGradients(const gsMapData<T> & md, index_t k, const gsMatrix<T>& allGrads, gsMatrix<T>& trfGradsK)
 {
@@ -292,6 +411,40 @@ protected: // *** Output data members ***
     /// must fit m_system.colBlocks().
     std::vector<gsMatrix<T> > m_ddof;
 
+    /// Geometry evaluations kept between assemblies (option CacheGeometry)
+    gsMapDataCache<T> m_mapCache;
+
+    /// Bezier extraction operators of the patches of the first basis,
+    /// kept between assemblies (option BezierExtraction)
+    std::vector< memory::shared_ptr< gsBezierExtraction<T> > > m_bezier;
+
+    /// The elements of a patch (or of a side of it), grouped by
+    /// colors, see elementColoring()
+    struct coloredElements
+    {
+        coloredElements() : colored(false) { }
+
+        /// Number of groups (colors) of elements
+        index_t numColors() const { return colorPtr.size() - 1; }
+
+        // The bases of the unknowns and the global indices of their
+        // free functions (-1 for the others), which identify the groups
+        std::vector<const gsBasis<T>*> bases;
+        std::vector<index_t> dofs;
+
+        bool colored;                   // false: a single group with all elements
+        std::vector<index_t> colors;    // group of every element, in the order of the domain iterator
+        std::vector<index_t> colorPtr;  // first position of every group in elements
+        std::vector<index_t> elements;  // the elements, sorted by groups
+        gsMatrix<T> lower, upper;       // corners of the elements, in the order of
+                                        // elements (volume elements only)
+        std::vector<index_t> colNz;     // non-zero entries per column of the matrix
+    };
+
+    /// Groups of the elements of the patches and their sides, kept
+    /// between assemblies
+    std::map<patchSide, coloredElements> m_coloring;
+
 public:
 
     gsAssembler() : m_options(defaultOptions())
@@ -620,6 +773,10 @@ public: // *** Accessors ***
     const gsSparseSystem<T> & system() const { return m_system; }
     gsSparseSystem<T> & system() { return m_system; }
 
+    /// @brief Returns the cache of the geometry evaluations (see
+    /// option CacheGeometry), e.g. for reporting its memory use
+    const gsMapDataCache<T> & mapDataCache() const { return m_mapCache; }
+
     /// @brief Swaps the actual sparse system with the given one
     void setSparseSystem(gsSparseSystem<T> & sys)
     {
@@ -659,6 +816,48 @@ protected:
     template<class InterfaceVisitor>
     void apply(InterfaceVisitor & visitor,
                const boundaryInterface & bi);
+
+    /// @brief Returns a greedy coloring of the elements of patch \a
+    /// patchIndex (or of its boundary \a side), such that two
+    /// elements of the same color do not share any free degree of
+    /// freedom. The elements of one color can therefore be pushed to
+    /// the global system concurrently, without locking.
+    ///
+    /// The elements are listed by colors, together with their
+    /// corners for the volume, so that the threads can pick their
+    /// elements directly. If the structure of the sparse system does
+    /// not allow a coloring (eg. different row and column mappers),
+    /// all elements form a single group which is not colored.
+    ///
+    /// The coloring is computed anew only if the bases or the
+    /// numbering of their free functions have changed since the last
+    /// call.
+    const coloredElements & elementColoring(const gsBasisRefs<T> & bases,
+                                            const size_t patchIndex,
+                                            const boxSide side);
+
+    /// @brief Returns the Bezier extraction operators of the basis of
+    /// patch \a patchIndex (first unknown), which are recomputed if
+    /// the basis has changed since the last call
+    const gsBezierExtraction<T> & bezierExtraction(const size_t patchIndex);
+
+    /// @brief Assembles the volume elements \a elements of patch \a
+    /// patchIndex, with corners \a lower and \a upper (first columns),
+    /// by evaluating \a visitor on all of them at once (option
+    /// ChunkSize). The elements are evaluated one by one if the
+    /// visitor can not evaluate them at once. The contributions are
+    /// pushed in a critical section if \a locked is true. The list
+    /// of elements is cleared afterwards.
+    template<class ElementVisitor>
+    void assembleChunk(ElementVisitor & visitor,
+                       const gsBasisRefs<T> & bases,
+                       const size_t patchIndex,
+                       const gsQuadRule<T> & quRule,
+                       std::vector<index_t> & elements,
+                       const gsMatrix<T> & lower,
+                       const gsMatrix<T> & upper,
+                       const index_t elOffset,
+                       const bool locked);
 };
 
 template <class T>
@@ -671,12 +870,67 @@ void gsAssembler<T>::apply(ElementVisitor & visitor,
 
     const gsBasisRefs<T> bases(m_bases, patchIndex);
 
+#ifdef _OPENMP
+    // Group the elements in colors with disjoint DoF supports, so
+    // that each color is pushed to the global system without locking
+    const coloredElements * groups = NULL;
+    if ( omp_get_max_threads() > 1 )
+    {
+        groups = &elementColoring(bases, patchIndex, side);
+        // Conflict-free pushes must not reallocate the matrix storage
+        if ( groups->colored && !m_system.hasPattern() )
+            m_system.matrix().reserve(groups->colNz);
+    }
+    // Elements of different threads may share DoFs, unless colored
+    const bool locked = ( NULL == groups || !groups->colored );
+#else
+    const bool locked = false;
+#endif
+
+    // Volume elements are pushed using the cached scatter map, if any
+    const index_t elOffset = ( boundary::none == side && m_system.hasPattern() ) ?
+        m_system.elementOffset(patchIndex) : -1;
+
+    // Evaluate the bases by their Bezier extraction operators, if
+    // requested and supported by the visitor; the operators map the
+    // Bernstein polynomials on the reference nodes of the rule, hence
+    // the spline rules are excluded
+    const gsBezierExtraction<T> * bezier = NULL;
+    if ( boundary::none == side && m_options.askSwitch("BezierExtraction", false) &&
+         gsQuadrature::Spline != m_options.askInt("quRule", gsQuadrature::GaussLegendre) &&
+         internal::hasBezierElement<ElementVisitor>(0) )
+        bezier = &bezierExtraction(patchIndex);
+
+    // Evaluate the bases and the geometry on chunks of volume
+    // elements at once, if requested and supported by the visitor
+    const index_t chunk = ( boundary::none == side && NULL == bezier &&
+                            internal::hasEvaluateBlock<ElementVisitor>(0) ) ?
+        m_options.askInt("ChunkSize", 1) : 1;
+
+    // Keep the geometry evaluations between assemblies, if requested
+    const bool cacheGeo = m_options.askSwitch("CacheGeometry", false);
+    if ( cacheGeo )
+    {
+        m_mapCache.setCapacity( static_cast<size_t>(m_options.askInt("CacheSize", 256)) << 20 );
+        m_mapCache.activate(m_pde_ptr->patches(), &m_bases[0], patchIndex);
+    }
+
 #pragma omp parallel
 {
     gsQuadRule<T> quRule ; // Quadrature rule
     gsMatrix<T> quNodes  ; // Temp variable for mapped nodes
     gsVector<T> quWeights; // Temp variable for mapped weights
 
+    // Elements of the current chunk and their corners
+    std::vector<index_t> blkElements;
+    gsMatrix<T> blkLower, blkUpper;
+    if ( chunk > 1 )
+    {
+        blkElements.reserve(chunk);
+        blkLower.resize(bases[0].dim(), chunk);
+        blkUpper.resize(bases[0].dim(), chunk);
+    }
+
     ElementVisitor
 #ifdef _OPENMP
     // Create thread-private visitor
@@ -689,34 +943,187 @@ void gsAssembler<T>::apply(ElementVisitor & visitor,
 
     // Initialize reference quadrature rule and visitor data
     visitor_.initialize(bases, patchIndex, m_options, quRule);
+    internal::setMapDataCache(visitor_, cacheGeo ? &m_mapCache : NULL, 0);
 
     const gsGeometry<T> & patch = m_pde_ptr->patches()[patchIndex];
 
-    // Initialize domain element iterator -- using unknown 0
-    typename gsBasis<T>::domainIter domIt = bases[0].makeDomainIterator(side);
+#ifdef _OPENMP
+    // One sweep per color (or a single sweep if there are no groups)
+    const index_t numSweeps = NULL != groups ? groups->numColors() : 1;
+    for (index_t c = 0; c < numSweeps; ++c)
+    {
+        // Initialize domain element iterator -- using unknown 0
+        typename gsBasis<T>::domainIter domIt;
+        const index_t * listed = NULL; // the elements of domIt, if listed
+        if ( NULL != groups && 0 != groups->lower.cols() )
+        {
+            // A contiguous part of the listed elements of the color
+            const index_t b = groups->colorPtr[c], n = groups->colorPtr[c+1] - b;
+            const index_t k0 = b + n * tid / nt, k1 = b + n * (tid + 1) / nt;
+            domIt.reset( new internal::gsElementListIterator<T>(
+                             bases[0], groups->lower, groups->upper, k0, k1) );
+            if ( k0 != k1 )
+                listed = &groups->elements[k0];
+        }
+        else
+            domIt = bases[0].makeDomainIterator(side);
+
+        // Distribute the elements of the current color over the threads
+        for (index_t i = 0, k = 0; domIt->good(); domIt->next(), ++i)
+        {
+            index_t e = i;
+            if ( NULL != listed )
+                e = listed[i];
+            else if ( ( NULL != groups && groups->colors[i] != c ) || k++ % nt != tid )
+                continue;
+#else
+    {
+        // Initialize domain element iterator -- using unknown 0
+        typename gsBasis<T>::domainIter domIt = bases[0].makeDomainIterator(side);
 
-    // Start iteration over elements
+        // Start iteration over elements
+        for (index_t e = 0; domIt->good(); domIt->next(), ++e )
+        {
+#endif
+            if ( chunk > 1 )
+            {
+                // Collect the elements of the chunk
+                blkLower.col(blkElements.size()) = domIt->lowerCorner();
+                blkUpper.col(blkElements.size()) = domIt->upperCorner();
+                blkElements.push_back(e);
+                if ( static_cast<index_t>(blkElements.size()) == chunk )
+                    assembleChunk(visitor_, bases, patchIndex, quRule, blkElements,
+                                  blkLower, blkUpper, elOffset, locked);
+                continue;
+            }
+
+            if ( -1 != elOffset )
+                m_system.setElement(elOffset + e);
+
+            // Map the Quadrature rule to the element
+            quRule.mapTo( domIt->lowerCorner(), domIt->upperCorner(), quNodes, quWeights );
+
+            // Skip elements without quadrature nodes (e.g. of a rule
+            // defined on the whole domain)
+            if ( 0 == quWeights.size() )
+                continue;
+
+            if ( NULL != bezier )
+                internal::setBezierElement(visitor_, bezier, e, 0);
+
+            // Perform required evaluations on the quadrature nodes
+            visitor_.evaluate(bases, patch, quNodes);
+
+            // Assemble on element
+            visitor_.assemble(*domIt, quWeights);
+
+            // Push to global matrix and right-hand side vector
 #ifdef _OPENMP
-    for ( domIt->next(tid); domIt->good(); domIt->next(nt) )
+            if ( !locked ) // no other thread touches these DoFs
+                visitor_.localToGlobal(patchIndex, m_ddof, m_system);
+            else
+            {
+#pragma omp critical(localToGlobal)
+                visitor_.localToGlobal(patchIndex, m_ddof, m_system);
+            }
 #else
-    for (; domIt->good(); domIt->next() )
+            visitor_.localToGlobal(patchIndex, m_ddof, m_system);
 #endif
+        }
+
+        // The remaining elements of the last chunk
+        if ( !blkElements.empty() )
+            assembleChunk(visitor_, bases, patchIndex, quRule, blkElements,
+                          blkLower, blkUpper, elOffset, locked);
+#pragma omp barrier
+    }
+
+    if ( -1 != elOffset )
+        m_system.setElement(-1);
+}//omp parallel
+
+    if ( cacheGeo )
+        m_mapCache.deactivate();
+}
+
+template <class T>
+template<class ElementVisitor>
+void gsAssembler<T>::assembleChunk(ElementVisitor & visitor,
+                                   const gsBasisRefs<T> & bases,
+                                   const size_t patchIndex,
+                                   const gsQuadRule<T> & quRule,
+                                   std::vector<index_t> & elements,
+                                   const gsMatrix<T> & lower,
+                                   const gsMatrix<T> & upper,
+                                   const index_t elOffset,
+                                   const bool locked)
+{
+    const index_t n = elements.size();
+    internal::gsElementListIterator<T> elIt(bases[0], lower, upper, 0, n);
+
+    // Map the Quadrature rule to all elements of the chunk
+    gsMatrix<T> quNodes, blkNodes(bases[0].dim(), n * quRule.numNodes());
+    gsVector<T> quWeights, blkWeights(blkNodes.cols());
+    gsVector<index_t> blkOffset(n + 1);
+    blkOffset[0] = 0;
+    for (index_t j = 0; elIt.good(); elIt.next(), ++j)
     {
-        // Map the Quadrature rule to the element
-        quRule.mapTo( domIt->lowerCorner(), domIt->upperCorner(), quNodes, quWeights );
+        quRule.mapTo( elIt.lowerCorner(), elIt.upperCorner(), quNodes, quWeights );
+        const index_t k0 = blkOffset[j], nk = quWeights.size();
+        if ( k0 + nk > blkNodes.cols() ) // e.g. a rule defined on the whole domain
+        {
+            blkNodes  .conservativeResize(Eigen::NoChange, 2 * (k0 + nk));
+            blkWeights.conservativeResize(2 * (k0 + nk));
+        }
+        if ( 0 != nk )
+        {
+            blkNodes.middleCols(k0, nk) = quNodes;
+            blkWeights.segment (k0, nk) = quWeights;
+        }
+        blkOffset[j+1] = k0 + nk;
+    }
+    blkNodes  .conservativeResize(Eigen::NoChange, blkOffset[n]);
+    blkWeights.conservativeResize(blkOffset[n]);
 
-        // Perform required evaluations on the quadrature nodes
-        visitor_.evaluate(bases, patch, quNodes);
+    // Evaluate the bases and the geometry on all nodes at once
+    const gsGeometry<T> & patch = m_pde_ptr->patches()[patchIndex];
+    const bool block = 0 != blkOffset[n] &&
+        internal::evaluateBlock(visitor, bases[0], patch, blkNodes, blkOffset, 0);
+
+    elIt.reset();
+    for (index_t j = 0; elIt.good(); elIt.next(), ++j)
+    {
+        const index_t k0 = blkOffset[j], nk = blkOffset[j+1] - k0;
+
+        // Skip elements without quadrature nodes
+        if ( 0 == nk )
+            continue;
+
+        if ( -1 != elOffset )
+            m_system.setElement(elOffset + elements[j]);
+
+        if ( block )
+            internal::setBlockElement(visitor, j, 0);
+        else
+        {
+            quNodes = blkNodes.middleCols(k0, nk);
+            visitor.evaluate(bases, patch, quNodes);
+        }
 
         // Assemble on element
-        visitor_.assemble(*domIt, quWeights);
+        quWeights = blkWeights.segment(k0, nk);
+        visitor.assemble(elIt, quWeights);
 
         // Push to global matrix and right-hand side vector
+        if ( locked )
+        {
 #pragma omp critical(localToGlobal)
-        visitor_.localToGlobal(patchIndex, m_ddof, m_system); // omp_locks inside
+            visitor.localToGlobal(patchIndex, m_ddof, m_system);
+        }
+        else
+            visitor.localToGlobal(patchIndex, m_ddof, m_system);
     }
-}//omp parallel
-
+    elements.clear();
 }
 
 
@@ -35,9 +35,17 @@ gsOptionList gsAssembler<T>::defaultOptions()
     opt.addInt("InterfaceStrategy", "Method of treatment of patch interfaces [0..3]", 1  );
     opt.addReal("quA", "Number of quadrature points: quA*deg + quB", 1.0  );
     opt.addInt ("quB", "Number of quadrature points: quA*deg + quB", 1    );
+    opt.addInt ("quRule", "Quadrature rule [1:GaussLegendre,2:GaussLobatto,3:Spline]", 1);
     opt.addReal("bdA", "Estimated nonzeros per column of the matrix: bdA*deg + bdB", 2.0  );
     opt.addInt ("bdB", "Estimated nonzeros per column of the matrix: bdA*deg + bdB", 1    );
     opt.addReal("bdO", "Overhead of sparse mem. allocation: (1+bdO)(bdA*deg + bdB) [0..1]", 0.333);
+    opt.addSwitch("SumFactorization", "Use sum-factorized element kernels on tensor-product bases", false);
+    opt.addSwitch("ExactPattern", "Compute the exact sparsity pattern and cache the element scatter map", false);
+    opt.addSwitch("CacheGeometry", "Keep the geometry evaluations of the elements between assemblies", false);
+    opt.addInt ("CacheSize", "Memory limit of the geometry cache in MB", 256);
+    opt.addInt ("ChunkSize", "Number of volume elements evaluated together (1: one by one)", 1);
+    opt.addSwitch("BezierExtraction", "Evaluate the bases by their Bezier extraction operators (mass, stiffness and Poisson visitors)", false);
+    opt.addSwitch("Symmetric", "Store only the lower triangular part of the matrix (symmetric problems only)", false);
     return opt;
 }
 
@@ -121,6 +129,7 @@ void gsAssembler<T>::scalarProblemGalerkinRefresh()
 
     // 2. Create the sparse system
     m_system = gsSparseSystem<T>(mapper);//1,1
+    m_system.setSymmetric( m_options.askSwitch("Symmetric", false) );
 }
 
 template<class T>
@@ -676,4 +685,177 @@ void gsAssembler<T>::updateSolution(const gsMatrix<T>& solVector,
     }
 }
 
+template<class T>
+const gsBezierExtraction<T> & gsAssembler<T>::bezierExtraction(const size_t patchIndex)
+{
+    const gsBasis<T> & basis = m_bases[0][patchIndex];
+    if ( m_bezier.size() <= patchIndex )
+        m_bezier.resize(m_bases[0].nBases());
+    memory::shared_ptr< gsBezierExtraction<T> > & be = m_bezier[patchIndex];
+    if ( !be || &be->basis() != &basis ) // e.g. a copy of the assembler
+        be.reset( new gsBezierExtraction<T>(basis) );
+    else
+        be->update();
+    return *be;
+}
+
+template<class T>
+const typename gsAssembler<T>::coloredElements &
+gsAssembler<T>::elementColoring(const gsBasisRefs<T> & bases,
+                                const size_t patchIndex,
+                                const boxSide side)
+{
+    coloredElements & groups = m_coloring[patchSide(patchIndex, side)];
+
+    // Rows and columns must be indexed by the same mappers
+    const index_t numBlocks = m_system.numColBlocks();
+    bool colored = ( numBlocks == m_system.numRowBlocks() );
+    for (index_t c = 0; colored && c != numBlocks; ++c)
+        colored = ( &m_system.rowMapper(c) == &m_system.colMapper(c) );
+
+    // The bases, their number of (volume) elements and the global
+    // indices of their free functions identify the coloring
+    const index_t numDofs = m_system.matrix().cols();
+    std::vector<const gsBasis<T>*> bs(numBlocks);
+    std::vector<index_t> dofs(1, static_cast<index_t>(bases[0].numElements()));
+    dofs.push_back(colored ? numDofs : -1);
+    index_t gl;
+    for (index_t c = 0; c != numBlocks; ++c)
+    {
+        bs[c] = &bases[m_system.colBasis(c)];
+        if ( !colored )
+            continue;
+        const gsDofMapper & mapper = m_system.colMapper(c);
+        for (index_t i = 0; i != bs[c]->size(); ++i)
+        {
+            if ( mapper.is_free(i, patchIndex) )
+            {
+                m_system.mapToGlobalColIndex(i, patchIndex, gl, c);
+                dofs.push_back(gl);
+            }
+            else
+                dofs.push_back(-1);
+        }
+    }
+    if ( !groups.colorPtr.empty() && groups.bases == bs && groups.dofs == dofs )
+        return groups;
+    groups.bases.swap(bs);
+    groups.dofs .swap(dofs);
+    groups.colored = colored;
+
+    // Global indices of the free DoFs of every element (CSR format),
+    // and the corners of the volume elements
+    const short_t d = bases[0].dim();
+    std::vector<index_t> elPtr(1, 0), elDofs;
+    std::vector<T> lower, upper;
+    gsMatrix<index_t> act;
+    typename gsBasis<T>::domainIter domIt = bases[0].makeDomainIterator(side);
+    for (; domIt->good(); domIt->next() )
+    {
+        if ( boundary::none == side )
+        {
+            lower.insert(lower.end(), domIt->lowerCorner().data(), domIt->lowerCorner().data() + d);
+            upper.insert(upper.end(), domIt->upperCorner().data(), domIt->upperCorner().data() + d);
+        }
+        for (index_t c = 0; colored && c != numBlocks; ++c)
+        {
+            const gsDofMapper & mapper = m_system.colMapper(c);
+            groups.bases[c]->active_into(domIt->centerPoint(), act);
+            for (index_t i = 0; i != act.rows(); ++i)
+            {
+                if ( mapper.is_free(act(i,0), patchIndex) )
+                {
+                    m_system.mapToGlobalColIndex(act(i,0), patchIndex, gl, c);
+                    elDofs.push_back(gl);
+                }
+            }
+        }
+        elPtr.push_back(elDofs.size());
+    }
+    const index_t numEl = elPtr.size() - 1;
+
+    // Elements supporting every DoF (CSR format)
+    std::vector<index_t> dofPtr(numDofs + 1, 0), dofEls(elDofs.size());
+    for (size_t k = 0; k != elDofs.size(); ++k)
+        ++dofPtr[elDofs[k] + 1];
+    for (index_t i = 0; i != numDofs; ++i)
+        dofPtr[i+1] += dofPtr[i];
+    std::vector<index_t> pos(dofPtr.begin(), dofPtr.end() - 1);
+    for (index_t e = 0; e != numEl; ++e)
+        for (index_t k = elPtr[e]; k != elPtr[e+1]; ++k)
+            dofEls[pos[elDofs[k]]++] = e;
+
+    // Greedy coloring: every element takes the first color which is
+    // not used by an element sharing a DoF with it (a single color
+    // if the elements are not colored)
+    index_t numColors = colored ? 0 : 1;
+    std::vector<index_t> taken; // taken[c]==e: color c is used by a neighbor of e
+    std::vector<index_t> & colors = groups.colors;
+    colors.assign(numEl, colored ? -1 : 0);
+    for (index_t e = 0; colored && e != numEl; ++e)
+    {
+        for (index_t k = elPtr[e]; k != elPtr[e+1]; ++k)
+            for (index_t l = dofPtr[elDofs[k]]; l != dofPtr[elDofs[k]+1]; ++l)
+            {
+                const index_t c = colors[dofEls[l]];
+                if ( -1 != c )
+                    taken[c] = e;
+            }
+
+        index_t c = 0;
+        while ( c != numColors && taken[c] == e ) ++c;
+        if ( c == numColors )
+        {
+            ++numColors;
+            taken.push_back(-1);
+        }
+        colors[e] = c;
+    }
+
+    // The elements sorted by colors, keeping their order within a color
+    groups.colorPtr.assign(numColors + 1, 0);
+    for (index_t e = 0; e != numEl; ++e)
+        ++groups.colorPtr[colors[e] + 1];
+    for (index_t c = 0; c != numColors; ++c)
+        groups.colorPtr[c+1] += groups.colorPtr[c];
+    groups.elements.resize(numEl);
+    pos.assign(groups.colorPtr.begin(), groups.colorPtr.end() - 1);
+    for (index_t e = 0; e != numEl; ++e)
+        groups.elements[pos[colors[e]]++] = e;
+
+    if ( boundary::none == side )
+    {
+        groups.lower.resize(d, numEl);
+        groups.upper.resize(d, numEl);
+        for (index_t k = 0; k != numEl; ++k)
+        {
+            const index_t e = groups.elements[k];
+            groups.lower.col(k) = gsAsConstVector<T>(&lower[e * d], d);
+            groups.upper.col(k) = gsAsConstVector<T>(&upper[e * d], d);
+        }
+    }
+    else
+    {
+        groups.lower.resize(0, 0);
+        groups.upper.resize(0, 0);
+    }
+
+    // Exact number of entries per column, coupled through the elements
+    groups.colNz.assign(colored ? numDofs : 0, 0);
+    std::vector<index_t> stamp(groups.colNz.size(), -1);
+    for (index_t i = 0; colored && i != numDofs; ++i)
+        for (index_t l = dofPtr[i]; l != dofPtr[i+1]; ++l)
+        {
+            const index_t e = dofEls[l];
+            for (index_t k = elPtr[e]; k != elPtr[e+1]; ++k)
+                if ( stamp[elDofs[k]] != i )
+                {
+                    stamp[elDofs[k]] = i;
+                    ++groups.colNz[i];
+                }
+        }
+
+    return groups;
+}
+
 }// namespace gismo
@@ -0,0 +1,180 @@
+/** @file gsBezierExtraction.h
+
+    @brief Element-wise Bezier extraction operators of spline bases
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsBasis.h>
+#include <gsAssembler/gsQuadRule.h>
+
+namespace gismo
+{
+
+/**
+    @brief Bezier extraction operators of the elements of a spline
+    basis
+
+    On every element, the active functions of a (tensor-product,
+    hierarchical or truncated hierarchical) B-spline basis are
+    polynomials of the basis degree, hence linear combinations of the
+    tensor-product Bernstein polynomials on the element. The
+    extraction operator of element \a e is the sparse matrix \f$C_e\f$
+    with \f$N_i = \sum_b (C_e)_{ib} B_b\f$, where \f$N_i\f$ is the
+    i-th active function of the element (see actives()) and \f$B_b\f$
+    the b-th Bernstein polynomial in lexicographic order, the first
+    direction running fastest. For rational bases (gsNurbsBasis,
+    gsTensorNurbsBasis) the operators refer to the source basis, and
+    the weights of the active functions are stored alongside.
+
+    The basis functions are evaluated on an element by one product of
+    \f$C_e\f$ with a table of the Bernstein polynomials, which only
+    depends on the reference nodes of a quadrature rule (see
+    bernsteinTable() and evalAllDers_into()). Therefore the
+    evaluation costs of hierarchical bases are the ones of a
+    tensor-product basis. The operators of all elements, together
+    with their corners, are also a compact element-wise
+    representation of the basis for Bezier-based tools.
+
+    The elements are numbered in the order of the domain iterator of
+    the (source) basis. The operators are computed on construction and
+    recomputed by update() if the basis has been refined. gsAssembler
+    keeps the operators of its bases with the option
+    "BezierExtraction" and updates them before every assembly, so
+    that the visitors supporting it (gsVisitorMass, gsVisitorGradGrad,
+    gsVisitorPoisson) evaluate the bases by the operators.
+
+    \ingroup Assembler
+*/
+template<class T = real_t>
+class gsBezierExtraction
+{
+public:
+
+    /// Type of the extraction operators
+    typedef gsSparseMatrix<T, RowMajor> operatorType;
+
+    /// Computes the extraction operators of all elements of \a basis
+    explicit gsBezierExtraction(const gsBasis<T> & basis);
+
+public:
+
+    /// Recomputes the operators if the basis has changed (size,
+    /// degree or number of elements) since they were computed, and
+    /// returns true in this case
+    bool update();
+
+    /// The basis
+    const gsBasis<T> & basis() const { return *m_basis; }
+
+    /// Whether the basis is rational, see weights()
+    bool isRational() const { return m_rational; }
+
+    /// Number of elements
+    index_t numElements() const { return static_cast<index_t>(m_elements.size()); }
+
+    /// Degrees of the Bernstein polynomials in every direction
+    const gsVector<index_t> & degree() const { return m_degree; }
+
+    /// Number of Bernstein polynomials on an element
+    index_t numBernstein() const { return (m_degree.array() + 1).prod(); }
+
+    /// Lower corner of element \a e
+    const gsVector<T> & lowerCorner(index_t e) const { return m_elements[e].lower; }
+
+    /// Upper corner of element \a e
+    const gsVector<T> & upperCorner(index_t e) const { return m_elements[e].upper; }
+
+    /// Indices of the active functions of element \a e (one column)
+    const gsMatrix<index_t> & actives(index_t e) const { return m_elements[e].actives; }
+
+    /// Extraction operator of element \a e, one row per active function
+    const operatorType & extractionOperator(index_t e) const { return m_elements[e].op; }
+
+    /// Weights of the active functions of element \a e (rational
+    /// bases only)
+    const gsMatrix<T> & weights(index_t e) const { return m_elements[e].weights; }
+
+    /// Number of non-zero entries of all operators
+    index_t nonZeros() const;
+
+    /**
+     * @brief Computes the Bernstein polynomials of degree() and their
+     * derivatives up to order \a n at the reference nodes of \a rule
+     *
+     * Entry \a table[k] holds the derivatives of order \a k, one
+     * block of numBernstein() rows per partial derivative (in the
+     * order of gsBasis::evalAllDers_into) and one column per node.
+     * The table serves all elements for evalAllDers_into().
+     */
+    void bernsteinTable(const gsQuadRule<T> & rule, int n,
+                        std::vector<gsMatrix<T> > & table) const;
+
+    /**
+     * @brief Evaluates the active functions of element \a e and their
+     * derivatives up to order \a n (at most 2) at the nodes of the
+     * rule of \a table mapped to the element
+     *
+     * The result has the format of gsBasis::evalAllDers_into, with
+     * the functions of actives(). \a table must contain at least the
+     * orders up to \a n.
+     */
+    void evalAllDers_into(index_t e, const std::vector<gsMatrix<T> > & table, int n,
+                          std::vector<gsMatrix<T> > & result) const;
+
+    /// Prints the number of elements and the size of the operators
+    std::ostream & print(std::ostream & os) const;
+
+private:
+
+    // Computes the operators of all elements
+    void compute();
+
+    // Orders of the partial derivatives of order k (one column each)
+    void derivativeOrders(int k, gsMatrix<index_t> & orders) const;
+
+    // Derivatives up to order n of the univariate Bernstein
+    // polynomials of degree p at t (one column per point)
+    static void bernstein_into(index_t p, const gsMatrix<T> & t, int n,
+                               std::vector<gsMatrix<T> > & result);
+
+private:
+
+    struct elementData
+    {
+        gsVector<T> lower, upper;
+        gsMatrix<index_t> actives;
+        operatorType op;
+        gsMatrix<T> weights;
+    };
+
+    const gsBasis<T> * m_basis;
+
+    // The weights of a rational basis, NULL otherwise
+    const gsMatrix<T> * m_weightsPtr;
+    bool m_rational;
+
+    gsVector<index_t> m_degree;
+
+    // Size of the basis and number of elements at the last compute()
+    index_t m_size, m_numElements;
+
+    std::vector<elementData> m_elements;
+};
+
+/// Print (as string) operator
+template<class T>
+std::ostream &operator<<(std::ostream &os, const gsBezierExtraction<T>& be)
+{return be.print(os); }
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsBezierExtraction.hpp)
+#endif
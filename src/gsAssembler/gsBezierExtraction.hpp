@@ -0,0 +1,308 @@
+/** @file gsBezierExtraction.hpp
+
+    @brief Provides implementation of the Bezier extraction operators
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsDomainIterator.h>
+#include <gsCore/gsRationalBasis.h>
+#include <gsNurbs/gsTensorBSplineBasis.h>
+#include <gsAssembler/gsGaussRule.h>
+
+namespace gismo
+{
+
+template<class T>
+gsBezierExtraction<T>::gsBezierExtraction(const gsBasis<T> & basis)
+: m_basis(&basis), m_weightsPtr(NULL), m_rational(false), m_size(-1), m_numElements(-1)
+{
+    compute();
+}
+
+template<class T>
+bool gsBezierExtraction<T>::update()
+{
+    const gsBasis<T> & src = m_basis->source();
+    bool changed = ( m_basis->size() != m_size || src.dim() != m_degree.size() ||
+                     static_cast<index_t>(m_basis->numElements()) != m_numElements );
+    for (short_t i = 0; !changed && i != src.dim(); ++i)
+        changed = ( src.degree(i) != m_degree[i] );
+    if ( !changed )
+        return false;
+    compute();
+    return true;
+}
+
+template<class T>
+index_t gsBezierExtraction<T>::nonZeros() const
+{
+    index_t result = 0;
+    for (size_t e = 0; e != m_elements.size(); ++e)
+        result += m_elements[e].op.nonZeros();
+    return result;
+}
+
+template<class T>
+void gsBezierExtraction<T>::compute()
+{
+    const gsBasis<T> & src = m_basis->source();
+    const short_t d = src.dim();
+
+    // The weights of the NURBS bases
+    m_rational = ( &src != m_basis );
+    m_weightsPtr = NULL;
+    if ( m_rational )
+    {
+        typedef gsRationalBasis<typename gsBSplineTraits<1,T>::Basis> rat1;
+        typedef gsRationalBasis<typename gsBSplineTraits<2,T>::Basis> rat2;
+        typedef gsRationalBasis<typename gsBSplineTraits<3,T>::Basis> rat3;
+        typedef gsRationalBasis<typename gsBSplineTraits<4,T>::Basis> rat4;
+        if      ( const rat1 * r = dynamic_cast<const rat1*>(m_basis) ) m_weightsPtr = &r->weights();
+        else if ( const rat2 * r = dynamic_cast<const rat2*>(m_basis) ) m_weightsPtr = &r->weights();
+        else if ( const rat3 * r = dynamic_cast<const rat3*>(m_basis) ) m_weightsPtr = &r->weights();
+        else if ( const rat4 * r = dynamic_cast<const rat4*>(m_basis) ) m_weightsPtr = &r->weights();
+        GISMO_ENSURE( NULL != m_weightsPtr, "Bezier extraction is not available for "<< *m_basis );
+    }
+
+    m_degree.resize(d);
+    for (short_t i = 0; i != d; ++i)
+        m_degree[i] = src.degree(i);
+
+    // Interpolation at p+1 Gauss nodes per direction: the Bernstein
+    // coefficients of the functions are their values times the
+    // inverse of the Bernstein table on the nodes, which is the same
+    // on all elements
+    const gsVector<index_t> numNodes = m_degree.array() + 1;
+    const gsGaussRule<T> rule(numNodes);
+    std::vector<gsMatrix<T> > table;
+    bernsteinTable(rule, 0, table);
+    const gsMatrix<T> tableInv = table[0].partialPivLu().inverse();
+
+    m_elements.clear();
+    gsMatrix<T> nodes, values;
+    gsVector<T> quWeights;
+    const T tol = 1000 * std::numeric_limits<T>::epsilon();
+    typename gsBasis<T>::domainIter domIt = src.makeDomainIterator();
+    for (; domIt->good(); domIt->next())
+    {
+        m_elements.push_back(elementData());
+        elementData & el = m_elements.back();
+        el.lower = domIt->lowerCorner();
+        el.upper = domIt->upperCorner();
+        rule.mapTo(el.lower, el.upper, nodes, quWeights);
+
+        // The active functions are the same at all interior nodes
+        src.active_into(nodes.col(0), el.actives);
+        src.eval_into(nodes, values);
+        values.conservativeResize(el.actives.rows(), values.cols());
+        el.op = (values * tableInv).sparseView(T(1), tol);
+        el.op.makeCompressed();
+
+        if ( m_rational )
+        {
+            el.weights.resize(el.actives.rows(), 1);
+            for (index_t i = 0; i != el.actives.rows(); ++i)
+                el.weights(i, 0) = (*m_weightsPtr)(el.actives(i, 0), 0);
+        }
+    }
+
+    m_size = m_basis->size();
+    m_numElements = static_cast<index_t>(m_elements.size());
+}
+
+template<class T>
+void gsBezierExtraction<T>::bernsteinTable(const gsQuadRule<T> & rule, int n,
+                                           std::vector<gsMatrix<T> > & table) const
+{
+    const index_t d = m_degree.size(), nB = numBernstein();
+    const gsMatrix<T> & refNodes = rule.referenceNodes();
+    GISMO_ENSURE( rule.numNodes() > 0 && refNodes.rows() == d,
+                  "The rule needs reference nodes in dimension "<< d );
+
+    // Univariate tables on [0,1], the reference interval of the rule
+    // is [-1,1]
+    std::vector<std::vector<gsMatrix<T> > > uni(d);
+    for (index_t i = 0; i != d; ++i)
+    {
+        const gsMatrix<T> t = (refNodes.row(i).array() + 1) / 2;
+        bernstein_into(m_degree[i], t, n, uni[i]);
+    }
+
+    table.resize(n + 1);
+    gsMatrix<index_t> orders;
+    gsVector<index_t> b(d), numB = m_degree.array() + 1;
+    for (int k = 0; k <= n; ++k)
+    {
+        derivativeOrders(k, orders);
+        table[k].resize(nB * orders.cols(), refNodes.cols());
+        for (index_t c = 0; c != orders.cols(); ++c)
+        {
+            b.setZero();
+            index_t r = c * nB;
+            do
+            {
+                table[k].row(r) = uni[0][orders(0, c)].row(b[0]);
+                for (index_t i = 1; i != d; ++i)
+                    table[k].row(r).array() *= uni[i][orders(i, c)].row(b[i]).array();
+                ++r;
+            } while (nextLexicographic(b, numB));
+        }
+    }
+}
+
+template<class T>
+void gsBezierExtraction<T>::evalAllDers_into(index_t e, const std::vector<gsMatrix<T> > & table,
+                                             int n, std::vector<gsMatrix<T> > & result) const
+{
+    GISMO_ASSERT( n <= 2 && static_cast<int>(table.size()) > n,
+                  "Derivatives up to order "<< n <<" are not available" );
+    const elementData & el = m_elements[e];
+    const index_t d = m_degree.size(), nB = numBernstein();
+    const index_t numAct = el.actives.rows(), numPts = table[0].cols();
+    const gsVector<T> h = el.upper - el.lower;
+
+    result.resize(n + 1);
+    gsMatrix<index_t> orders;
+    gsMatrix<T> tmp;
+    for (int k = 0; k <= n; ++k)
+    {
+        derivativeOrders(k, orders);
+        const index_t numDers = orders.cols();
+        result[k].resize(numAct * numDers, numPts);
+        for (index_t c = 0; c != numDers; ++c)
+        {
+            T scale(1);
+            for (index_t i = 0; i != d; ++i)
+                scale /= math::pow(h[i], static_cast<int>(orders(i, c)));
+            tmp.noalias() = el.op * table[k].middleRows(c * nB, nB);
+            for (index_t j = 0; j != numAct; ++j)
+                result[k].row(j * numDers + c) = scale * tmp.row(j);
+        }
+    }
+
+    if ( !m_rational )
+        return;
+
+    // Quotient rule for R_j = w_j N_j / W with W = sum_j w_j N_j
+    const gsMatrix<T> & w = el.weights;
+    const gsMatrix<T> W = w.transpose() * result[0];
+    for (index_t j = 0; j != numAct; ++j)
+        result[0].row(j).array() *= w(j, 0) / W.array();
+    if ( n < 1 )
+        return;
+
+    gsMatrix<T> dW = gsMatrix<T>::Zero(d, numPts);
+    for (index_t j = 0; j != numAct; ++j)
+        dW += w(j, 0) * result[1].middleRows(j * d, d);
+    for (index_t j = 0; j != numAct; ++j)
+        for (index_t i = 0; i != d; ++i)
+            result[1].row(j * d + i) = ( w(j, 0) * result[1].row(j * d + i).array()
+                - result[0].row(j).array() * dW.row(i).array() ) / W.array();
+    if ( n < 2 )
+        return;
+
+    derivativeOrders(2, orders);
+    const index_t numDers = orders.cols();
+    gsMatrix<T> ddW = gsMatrix<T>::Zero(numDers, numPts);
+    for (index_t j = 0; j != numAct; ++j)
+        ddW += w(j, 0) * result[2].middleRows(j * numDers, numDers);
+    for (index_t c = 0; c != numDers; ++c)
+    {
+        // Directions of the partial derivative c
+        index_t a = 0, b;
+        while (0 == orders(a, c)) ++a;
+        b = ( 2 == orders(a, c) ? a : a + 1 );
+        while (0 == orders(b, c)) ++b;
+        for (index_t j = 0; j != numAct; ++j)
+            result[2].row(j * numDers + c) = ( w(j, 0) * result[2].row(j * numDers + c).array()
+                - result[1].row(j * d + a).array() * dW.row(b).array()
+                - result[1].row(j * d + b).array() * dW.row(a).array()
+                - result[0].row(j).array() * ddW.row(c).array() ) / W.array();
+    }
+}
+
+template<class T>
+std::ostream & gsBezierExtraction<T>::print(std::ostream & os) const
+{
+    os << "Bezier extraction: " << m_elements.size() << " elements, degree "
+       << m_degree.transpose() << ", " << nonZeros() << " non-zeros"
+       << (m_rational ? " (rational)\n" : "\n");
+    return os;
+}
+
+template<class T>
+void gsBezierExtraction<T>::derivativeOrders(int k, gsMatrix<index_t> & orders) const
+{
+    // Same order as in gsBasis::evalAllDers_into: first the pure
+    // second derivatives, then the mixed ones
+    const index_t d = m_degree.size();
+    switch (k)
+    {
+    case 0:
+        orders.setZero(d, 1);
+        break;
+    case 1:
+        orders.setIdentity(d, d);
+        break;
+    case 2:
+    {
+        orders.setZero(d, d * (d + 1) / 2);
+        index_t c = 0;
+        for (index_t i = 0; i != d; ++i)
+            orders(i, c++) = 2;
+        for (index_t i = 0; i != d; ++i)
+            for (index_t j = i + 1; j < d; ++j, ++c)
+                orders(i, c) = orders(j, c) = 1;
+        break;
+    }
+    default:
+        GISMO_ERROR("Derivatives of order "<< k <<" are not available");
+    }
+}
+
+template<class T>
+void gsBezierExtraction<T>::bernstein_into(index_t p, const gsMatrix<T> & t, int n,
+                                           std::vector<gsMatrix<T> > & result)
+{
+    result.resize(n + 1);
+    const index_t numPts = t.cols();
+    gsMatrix<T> b;
+    for (int k = 0; k <= n; ++k)
+    {
+        b.setZero(p + 1, numPts);
+        if ( k > p )
+        {
+            result[k].swap(b);
+            continue;
+        }
+
+        // Bernstein polynomials of degree p-k (de Casteljau)
+        b.row(0).setOnes();
+        for (index_t q = 1; q <= p - k; ++q)
+        {
+            for (index_t i = q; i > 0; --i)
+                b.row(i) = b.row(i).cwiseProduct((1 - t.array()).matrix())
+                    + b.row(i - 1).cwiseProduct(t);
+            b.row(0) = b.row(0).cwiseProduct((1 - t.array()).matrix());
+        }
+
+        // k-fold derivation: the derivative of B_{i,q} is
+        // q ( B_{i-1,q-1} - B_{i,q-1} )
+        for (index_t q = p - k + 1; q <= p; ++q)
+        {
+            for (index_t i = q; i > 0; --i)
+                b.row(i) = q * (b.row(i - 1) - b.row(i));
+            b.row(0) *= -q;
+        }
+        result[k].swap(b);
+    }
+}
+
+} // namespace gismo
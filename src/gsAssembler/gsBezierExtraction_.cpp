@@ -0,0 +1,11 @@
+#include <gsCore/gsTemplateTools.h>
+
+#include <gsAssembler/gsBezierExtraction.h>
+#include <gsAssembler/gsBezierExtraction.hpp>
+
+namespace gismo
+{
+
+    CLASS_TEMPLATE_INST gsBezierExtraction<real_t> ;
+
+}
@@ -100,9 +100,14 @@ void gsBiharmonicAssembler<T,bhVisitor>::assemble()
 {
     GISMO_ASSERT(m_system.initialized(), "Sparse system is not initialized, call refresh()");
 
-    // Reserve sparse system
-    const index_t nz = gsAssemblerOptions::numColNz(m_bases[0][0],2,1,0.333333);
-    m_system.reserve(nz, this->pde().numRhs());
+    // Reserve sparse system, or compute its exact pattern
+    if ( m_options.askSwitch("ExactPattern", false) )
+        m_system.reserve(m_bases, m_options, this->pde().numRhs());
+    else
+    {
+        const index_t nz = gsAssemblerOptions::numColNz(m_bases[0][0],2,1,0.333333);
+        m_system.reserve(nz, this->pde().numRhs());
+    }
 
     // Compute the Dirichlet Degrees of freedom (if needed by m_options)
     Base::computeDirichletDofs();
@@ -129,7 +129,7 @@ public:
                      "Sparse system is not initialized, call initialize() or refresh()");
 
         // Reserve sparse system
-        m_system.reserve(m_bases[0], m_options, this->pde().numRhs());
+        m_system.reserve(m_bases, m_options, this->pde().numRhs());
 
         // Compute the Dirichlet Degrees of freedom (if needed by m_options)
         Base::computeDirichletDofs();
@@ -16,6 +16,8 @@
 #include <gsUtils/gsPointGrid.h>
 #include <gsAssembler/gsQuadrature.h>
 #include <gsAssembler/gsExprHelper.h>
+#include <gsAssembler/gsSparsityPattern.h>
+#include <gsCore/gsMapDataCache.h>
 
 namespace gismo
 {
@@ -40,6 +42,13 @@ private:
     std::vector<expr::gsFeSpace<T>*> m_vrow;
     std::vector<expr::gsFeSpace<T>*> m_vcol;
 
+    // Exact sparsity pattern and element scatter map (option ExactPattern)
+    gsSparsityPattern<T> m_pattern;
+    std::vector<index_t> m_elOffset;
+
+    // Geometry evaluations kept between assemblies (option CacheGeometry)
+    gsMapDataCache<T> m_mapCache;
+
     typedef typename gsExprHelper<T>::nullExpr    nullExpr;
 
 public:
@@ -112,6 +121,10 @@ public:
     /// Returns a reference to the options structure
     gsOptionList & options() {return m_options;}
 
+    /// @brief Returns the cache of the geometry evaluations (see
+    /// option CacheGeometry), e.g. for reporting its memory use
+    const gsMapDataCache<T> & mapDataCache() const { return m_mapCache; }
+
     /// @brief Returns the left-hand global matrix
     const gsSparseMatrix<T> & matrix() const { return m_matrix; }
 
@@ -253,6 +266,8 @@ public:
 
         if ( 0 == m_matrix.rows() || 0 == m_matrix.cols() )
             gsWarn << " No internal DOFs, zero sized system.\n";
+        else if ( m_options.askSwitch("ExactPattern", false) )
+            computePattern();
         else
         {
             // Pick up values from options
@@ -268,6 +283,15 @@ public:
         }
     }
 
+    /// \brief Sets the values of the matrix to zero, keeping its
+    /// sparsity pattern. With the option ExactPattern, re-assembly
+    /// on the same spaces then adds directly to the existing entries.
+    void clearMatrix()
+    {
+        m_matrix.makeCompressed();
+        std::fill(m_matrix.valuePtr(), m_matrix.valuePtr() + m_matrix.nonZeros(), T(0));
+    }
+
     /// \brief Initializes the right-hand side vector only
     void initVector(const index_t numRhs = 1)
     {
@@ -407,6 +431,16 @@ private:
     /// Called internally by the init* functions
     void resetDimensions();
 
+    /// \brief Computes the exact pattern of the matrix, and the
+    /// scatter map of all (test space, trial space) blocks of the
+    /// integration elements
+    void computePattern();
+
+    /// \brief Identifies the discretization of the pattern: the
+    /// number of integration elements of every patch and the global
+    /// indices of all basis functions of the spaces
+    std::vector<index_t> patternKey() const;
+
     // template<bool left, bool right, class E1, class E2>
     // void assembleLhsRhs_impl(const expr::_expr<E1> & exprLhs,
     //                          const expr::_expr<E2> & exprRhs,
@@ -424,6 +458,63 @@ private:
                                 space rvar, space cvar,
                                 const ifContainer & iFaces);
 
+    /// \brief Prepares thread-private evaluation data for all the
+    /// threads of the following parallel region (\a on = true), or
+    /// releases it after the region (\a on = false)
+    void setThreadData(const bool on)
+    {
+#       ifdef _OPENMP
+        const index_t nt = on ? omp_get_max_threads() : 1;
+        m_exprdata->setNumThreads(nt);
+        m_element.setNumThreads(nt);
+#       else
+        GISMO_UNUSED(on);
+#       endif
+        useMapCache(on);
+    }
+
+    /// \brief Activates the cache of the geometry evaluations for the
+    /// following region (\a on = true), if the option CacheGeometry
+    /// is set, or deactivates it (\a on = false)
+    void useMapCache(const bool on)
+    {
+        if ( on && m_options.askSwitch("CacheGeometry", false) && m_exprdata->hasMap() )
+        {
+            m_mapCache.setCapacity( static_cast<size_t>(m_options.askInt("CacheSize", 256)) << 20 );
+            m_mapCache.activate(m_exprdata->getMap().source(),
+                                m_exprdata->multiBasisSet() ? &m_exprdata->multiBasis() : NULL);
+            m_exprdata->setMapCache(&m_mapCache);
+        }
+        else
+        {
+            m_exprdata->setMapCache(NULL);
+            m_mapCache.deactivate();
+        }
+    }
+
+    // The following routines are executed by every thread of a
+    // parallel region. The expressions are passed by value, so that
+    // every thread evaluates its own copy (with its own temporaries)
+
+#if __cplusplus >= 201103L || _MSC_VER >= 1600 // c++11
+    template<class... expr> void assembleThread(expr... args);
+
+    template<class... expr> void assembleThread(const bcRefList & BCs, expr... args);
+#else
+    template <class E1, class E2, class E3, class E4, class E5>
+    void assembleThread(const expr::_expr<E1> & a1, const expr::_expr<E2> & a2,
+                        const expr::_expr<E3> & a3, const expr::_expr<E4> & a4,
+                        const expr::_expr<E5> & a5 );
+
+    template<class E1> void assembleThread(const bcRefList & BCs, const expr::_expr<E1> & a1);
+#endif
+
+    template<class E1, class E2>
+    void assembleBcThread(const E1 exprLhs, const E2 exprRhs, const bcContainer & BCs);
+
+    template<class E1, class E2>
+    void assembleInterfaceThread(const E1 exprLhs, const E2 exprRhs, const ifContainer & iFaces);
+
 #if __cplusplus >= 201103L || _MSC_VER >= 1600 // c++11
     template <class op, class E1>
     void _apply(op _op, const expr::_expr<E1> & firstArg) {_op(firstArg);}
@@ -454,28 +545,50 @@ private:
         index_t       m_patchInd;
         gsMatrix<T>         localMat;
 
+        // Scatter map of the current element, if any
+        const gsSparsityPattern<T> * m_pattern;
+        index_t m_elem, m_numCol;
+
+        // Column of the first point of the element in the evaluated data
+        index_t m_pt0;
+
         _eval(gsSparseMatrix<T> & _matrix,
               gsMatrix<T>       & _rhs,
               const gsVector<>  & _quWeights)
         : m_matrix(_matrix), m_rhs(_rhs),
-          m_quWeights(_quWeights), m_patchInd(0)
+          m_quWeights(_quWeights), m_patchInd(0),
+          m_pattern(NULL), m_elem(-1), m_numCol(0), m_pt0(0)
         { }
 
         void setPatch(const index_t p) { m_patchInd=p; }
 
+        /// Uses the scatter map of \a pattern, with \a numCol trial spaces
+        void setPattern(const gsSparsityPattern<T> & pattern, const index_t numCol)
+        { m_pattern = &pattern; m_numCol = numCol; }
+
+        /// Sets the current element in the numbering of the scatter map
+        void setElement(const index_t e) { m_elem = e; }
+
+        /// Sets the column of the first quadrature point of the current
+        /// element, if a block of elements was evaluated
+        void setFirstPoint(const index_t k0) { m_pt0 = k0; }
+
         template <typename E> void operator() (const gismo::expr::_expr<E> & ee)
         {
             // ------- Compute  -------
             const T * w = m_quWeights.data();
-            localMat.noalias() = (*w) * ee.eval(0);
+            localMat.noalias() = (*w) * ee.eval(m_pt0);
             for (index_t k = 1; k != m_quWeights.rows(); ++k)
-                localMat.noalias() += (*(++w)) * ee.eval(k);
+                localMat.noalias() += (*(++w)) * ee.eval(m_pt0 + k);
 
             //  ------- Accumulate  -------
-            if (E::isMatrix())
-                push<true>(ee.rowVar(), ee.colVar(), m_patchInd);
-            else
-                push<false>(ee.rowVar(), ee.colVar(), m_patchInd);
+#           pragma omp critical (gsExprAssembler_push)
+            {
+                if (E::isMatrix())
+                    push<true>(ee.rowVar(), ee.colVar(), m_patchInd);
+                else
+                    push<false>(ee.rowVar(), ee.colVar(), m_patchInd);
+            }
         }// operator()
 
         void operator() (const expr::_expr<expr::gsNullExpr<T> > &) {}
@@ -495,6 +608,12 @@ private:
             const gsMatrix<index_t> & rowInd0 = v.data().actives;
             const gsMatrix<T>  & fixedDofs = static_cast<const expr::gsFeSpace<T>&>(u).fixedPart();
 
+            const index_t nr = rd * rowInd0.rows();
+            const index_t * pos = ( isMatrix && -1 != m_elem && m_pattern->matches(m_matrix) ) ?
+                m_pattern->positions(m_elem + static_cast<const expr::gsFeSpace<T>&>(v).id() * m_numCol
+                                     + static_cast<const expr::gsFeSpace<T>&>(u).id(),
+                                     nr, cd * colInd0.rows()) : NULL;
+
             for (index_t r = 0; r != rd; ++r)
             {
                 const index_t rls = r * rowInd0.rows();     //local stride
@@ -519,7 +638,11 @@ private:
                                         // If matrix is symmetric, we could
                                         // store only lower triangular part
                                         //if ( (!symm) || jj <= ii )
-                                        m_matrix.coeffRef(ii, jj) += localMat(rls+i,cls+j);
+                                        const index_t k = pos ? pos[rls+i + (cls+j)*nr] : -1;
+                                        if ( k >= 0 )
+                                            m_matrix.valuePtr()[k] += localMat(rls+i,cls+j);
+                                        else
+                                            m_matrix.coeffRef(ii, jj) += localMat(rls+i,cls+j);
                                     }
                                     else // colMap.is_boundary_index(jj) )
                                     {
@@ -551,9 +674,14 @@ gsOptionList gsExprAssembler<T>::defaultOptions()
     opt.addInt("DirichletValues"  , "Method for computation of Dirichlet DoF values [100..103]", 101);
     opt.addReal("quA", "Number of quadrature points: quA*deg + quB", 1.0  );
     opt.addInt ("quB", "Number of quadrature points: quA*deg + quB", 1    );
+    opt.addInt ("quRule", "Quadrature rule [1:GaussLegendre,2:GaussLobatto,3:Spline]", 1);
     opt.addReal("bdA", "Estimated nonzeros per column of the matrix: bdA*deg + bdB", 2.0  );
     opt.addInt ("bdB", "Estimated nonzeros per column of the matrix: bdA*deg + bdB", 1    );
     opt.addReal("bdO", "Overhead of sparse mem. allocation: (1+bdO)(bdA*deg + bdB) [0..1]", 0.333);
+    opt.addSwitch("ExactPattern", "Compute the exact sparsity pattern and cache the element scatter map", false);
+    opt.addSwitch("CacheGeometry", "Keep the geometry evaluations of the elements between assemblies", false);
+    opt.addInt ("CacheSize", "Memory limit of the geometry cache in MB", 256);
+    opt.addInt ("ChunkSize", "Number of elements evaluated together (1: one by one)", 1);
     return opt;
 }
 
@@ -699,6 +827,70 @@ template<class T> void gsExprAssembler<T>::resetDimensions()
     }
 }
 
+template<class T> void gsExprAssembler<T>::computePattern()
+{
+    const gsMultiBasis<T> & mesh = m_exprdata->multiBasis();
+    const size_t nr = m_vrow.size(), nc = m_vcol.size();
+    m_pattern.init(m_matrix.rows(), m_matrix.cols());
+    m_elOffset.resize(mesh.nBases()+1);
+    m_elOffset[0] = 0;
+
+    gsMatrix<index_t> act;
+    std::vector<std::vector<index_t> > rowInd(nr), colInd(nc);
+    for (size_t p = 0; p != mesh.nBases(); ++p)
+    {
+        typename gsBasis<T>::domainIter domIt = mesh.basis(p).makeDomainIterator();
+        index_t ne = 0;
+        for (; domIt->good(); domIt->next(), ++ne)
+        {
+            // Global indices of the components of the spaces, -1 if eliminated
+            for (size_t s = 0; s != nr + nc; ++s)
+            {
+                const expr::gsFeSpace<T> & u = s < nr ? *m_vrow[s] : *m_vcol[s-nr];
+                std::vector<index_t> & ind = s < nr ? rowInd[s] : colInd[s-nr];
+                u.source().piece(p).active_into(domIt->centerPoint(), act);
+                ind.resize(u.dim() * act.rows());
+                for (index_t r = 0; r != u.dim(); ++r)
+                    for (index_t i = 0; i != act.rows(); ++i)
+                    {
+                        const index_t ii = u.mapper().index(act.at(i), p, r);
+                        ind[r * act.rows() + i] = u.mapper().is_free_index(ii) ? ii : -1;
+                    }
+            }
+            for (size_t r = 0; r != nr; ++r)
+                for (size_t c = 0; c != nc; ++c)
+                    m_pattern.addBlock(rowInd[r], colInd[c]);
+        }
+        m_elOffset[p+1] = m_elOffset[p] + ne;
+    }
+
+    m_pattern.compute(m_matrix, patternKey());
+}
+
+template<class T> std::vector<index_t> gsExprAssembler<T>::patternKey() const
+{
+    const gsMultiBasis<T> & mesh = m_exprdata->multiBasis();
+    const size_t nr = m_vrow.size(), nc = m_vcol.size();
+    std::vector<index_t> key;
+    for (size_t p = 0; p != mesh.nBases(); ++p)
+    {
+        key.push_back(mesh.basis(p).numElements());
+        for (size_t s = 0; s != nr + nc; ++s)
+        {
+            const expr::gsFeSpace<T> & u = s < nr ? *m_vrow[s] : *m_vcol[s-nr];
+            const index_t n = u.source().piece(p).size();
+            key.push_back(n);
+            for (index_t r = 0; r != u.dim(); ++r)
+                for (index_t i = 0; i != n; ++i)
+                {
+                    const index_t ii = u.mapper().index(i, p, r);
+                    key.push_back( u.mapper().is_free_index(ii) ? ii : -1 );
+                }
+        }
+    }
+    return key;
+}
+
 template<class T>
 #if(__cplusplus >= 201103L || _MSC_VER >= 1600 || defined(__DOXYGEN__)) // c++11
 template<class... expr>
@@ -719,11 +911,61 @@ void gsExprAssembler<T>::assemble(expr... args)
 #   else
     _setFlag(a1);_setFlag(a1);_setFlag(a2);_setFlag(a4);_setFlag(a5);
 #   endif
+
+    // Drop the scatter map if the spaces or the elements have changed
+    if ( m_pattern.matches(m_matrix) && !m_pattern.matches(m_matrix, patternKey()) )
+        m_pattern.clear();
+
+#   if __cplusplus >= 201103L || _MSC_VER >= 1600
+    setThreadData(true);
+#   pragma omp parallel
+    assembleThread(args...);
+    setThreadData(false);
+#   else
+    assembleThread(a1,a2,a3,a4,a5);
+#   endif
+
+    m_matrix.makeCompressed();
+}
+
+template<class T>
+#if(__cplusplus >= 201103L || _MSC_VER >= 1600 || defined(__DOXYGEN__)) // c++11
+template<class... expr>
+void gsExprAssembler<T>::assembleThread(expr... args)
+#else
+    template <class E1, class E2, class E3, class E4, class E5>
+    void gsExprAssembler<T>::assembleThread( const expr::_expr<E1> & a1, const expr::_expr<E2> & a2,
+    const expr::_expr<E3> & a3, const expr::_expr<E4> & a4, const expr::_expr<E5> & a5)
+#endif
+{
     gsQuadRule<T> QuRule;  // Quadrature rule
     gsVector<T> quWeights; // quadrature weights
 
     _eval ee(m_matrix, m_rhs, quWeights);
 
+    // Elements evaluated together (option ChunkSize)
+    const index_t chunk = m_options.askInt("ChunkSize", 1);
+    gsMatrix<T> blkNodes;
+    gsVector<T> blkWeights;
+    gsVector<index_t> blkOffset;
+    index_t blkPos = 0;
+    bool block = false, useBlocks = false;
+
+    // Use the scatter map, if it is still valid
+    const bool cached = m_pattern.matches(m_matrix) &&
+        m_elOffset.size() == m_exprdata->multiBasis().nBases() + 1;
+    const index_t numBlocks = m_vrow.size() * m_vcol.size();
+    if ( cached )
+        ee.setPattern(m_pattern, m_vcol.size());
+
+#   ifdef _OPENMP
+    const int tid = omp_get_thread_num();
+    const int nt  = omp_get_num_threads();
+#   else
+    const int tid = 0;
+    const int nt  = 1;
+#   endif
+
     for (unsigned patchInd = 0; patchInd < m_exprdata->multiBasis().nBases(); ++patchInd)
     {
         ee.setPatch(patchInd);
@@ -734,16 +976,71 @@ void gsExprAssembler<T>::assemble(expr... args)
             m_exprdata->multiBasis().basis(patchInd).makeDomainIterator();
         m_element.set(*domIt);
 
+        // Iterator running ahead over the elements of the next block
+        typename gsBasis<T>::domainIter blkIt;
+        block = false;
+        if ( (useBlocks = chunk > 1) )
+        {
+            blkIt = m_exprdata->multiBasis().basis(patchInd).makeDomainIterator();
+            blkIt->next(tid);
+            blkOffset.resize(1);
+            blkPos = 0;
+        }
+
         // Start iteration over elements of patchInd
-        for (; domIt->good(); domIt->next() )
+        index_t e = tid;
+        for ( domIt->next(tid); domIt->good(); domIt->next(nt), e += nt )
         {
-            // Map the Quadrature rule to the element
-            QuRule.mapTo( domIt->lowerCorner(), domIt->upperCorner(),
-                          m_exprdata->points(), quWeights);
+            if ( cached )
+                ee.setElement( (m_elOffset[patchInd] + e) * numBlocks );
 
-            // Perform required pre-computations on the quadrature nodes
-            m_exprdata->precompute(patchInd);
-            //m_exprdata->precompute(QuRule, *domIt); // todo
+            if ( useBlocks && blkPos + 1 == blkOffset.size() )
+            {
+                // Map the Quadrature rule to the next elements and
+                // evaluate on all of them at once
+                std::vector<T> nodes, weights;
+                blkOffset.resize(chunk + 1);
+                blkOffset[0] = blkPos = 0;
+                index_t n = 0;
+                for (; n != chunk && blkIt->good(); ++n, blkIt->next(nt))
+                {
+                    QuRule.mapTo( blkIt->lowerCorner(), blkIt->upperCorner(),
+                                  blkNodes, quWeights);
+                    nodes  .insert(nodes  .end(), blkNodes.data(), blkNodes.data() + blkNodes.size());
+                    weights.insert(weights.end(), quWeights.data(), quWeights.data() + quWeights.size());
+                    blkOffset[n+1] = weights.size();
+                }
+                blkOffset.conservativeResize(n + 1);
+                blkWeights = gsAsConstVector<T>(weights.data(), weights.size());
+                m_exprdata->points() = gsAsConstMatrix<T>(nodes.data(), blkNodes.rows(), weights.size());
+                block = 0 != weights.size() && m_exprdata->precomputeBlock(blkOffset, patchInd);
+                // If not possible (e.g. for hierarchical bases), the
+                // remaining elements of the patch are evaluated one by one
+                useBlocks = block || 0 == weights.size();
+            }
+
+            if ( block )
+            {
+                // Select the element from the evaluated block
+                const index_t k0 = blkOffset[blkPos], nk = blkOffset[++blkPos] - k0;
+                if ( 0 == nk ) continue; // no quadrature points
+                quWeights = blkWeights.segment(k0, nk);
+                m_exprdata->setBlockElement(blkPos - 1);
+                ee.setFirstPoint(k0);
+            }
+            else
+            {
+                // Map the Quadrature rule to the element
+                QuRule.mapTo( domIt->lowerCorner(), domIt->upperCorner(),
+                              m_exprdata->points(), quWeights);
+                ++blkPos;
+                if ( 0 == quWeights.rows() ) continue; // no quadrature points
+
+                // Perform required pre-computations on the quadrature nodes
+                m_exprdata->precompute(patchInd);
+                //m_exprdata->precompute(QuRule, *domIt); // todo
+                ee.setFirstPoint(0);
+            }
 
             // Assemble contributions of the element
 #           if __cplusplus >= 201103L || _MSC_VER >= 1600
@@ -753,8 +1050,6 @@ void gsExprAssembler<T>::assemble(expr... args)
 #           endif
         }
     }
-
-    m_matrix.makeCompressed();
 }
 
 template<class T>
@@ -774,20 +1069,52 @@ void gsExprAssembler<T>::assemble(const bcRefList & BCs, const expr::_expr<E1> &
     _setFlag(a1);
 #   endif
 
+#   if __cplusplus >= 201103L || _MSC_VER >= 1600
+    setThreadData(true);
+#   pragma omp parallel
+    assembleThread(BCs, args...);
+    setThreadData(false);
+#   else
+    assembleThread(BCs, a1);
+#   endif
+
+    //this->finalize();
+    m_matrix.makeCompressed();
+    //g_bd.clear();
+    //mutVar.clear();
+}
+
+template<class T>
+#if __cplusplus >= 201103L || _MSC_VER >= 1600 // c++11
+template<class... expr>
+void gsExprAssembler<T>::assembleThread(const bcRefList & BCs, expr... args)
+#else
+template <class E1>
+void gsExprAssembler<T>::assembleThread(const bcRefList & BCs, const expr::_expr<E1> & a1)
+#endif
+{
     gsVector<T> quWeights;// quadrature weights
     gsQuadRule<T>  QuRule;
 
     _eval ee(m_matrix, m_rhs, quWeights);
 
+#   ifdef _OPENMP
+    const int tid = omp_get_thread_num();
+    const int nt  = omp_get_num_threads();
+#   endif
+
     for (typename bcRefList::const_iterator iit = BCs.begin(); iit!= BCs.end(); ++iit)
     {
         const boundary_condition<T> * it = &iit->get();
 
         QuRule = gsQuadrature::get(m_exprdata->multiBasis().basis(it->patch()), m_options, it->side().direction());
 
-        m_exprdata->mapData.side = it->side();
+        m_exprdata->threadMapData().side = it->side();
 
-        // Update boundary function source
+        // Update boundary function source, once all threads are
+        // done with the previous one
+#       pragma omp barrier
+#       pragma omp single
         m_exprdata->setMutSource(*it->function(), it->parametric());
         //mutVar.registerVariable(func, mutData);
 
@@ -796,11 +1123,16 @@ void gsExprAssembler<T>::assemble(const bcRefList & BCs, const expr::_expr<E1> &
         m_element.set(*domIt);
 
         // Start iteration over elements
+#       ifdef _OPENMP
+        for ( domIt->next(tid); domIt->good(); domIt->next(nt) )
+#       else
         for (; domIt->good(); domIt->next() )
+#       endif
         {
             // Map the Quadrature rule to the element
             QuRule.mapTo( domIt->lowerCorner(), domIt->upperCorner(),
                           m_exprdata->points(), quWeights);
+            if ( 0 == quWeights.rows() ) continue; // no quadrature points
 
             // Perform required pre-computations on the quadrature nodes
             m_exprdata->precompute(it->patch());
@@ -813,11 +1145,6 @@ void gsExprAssembler<T>::assemble(const bcRefList & BCs, const expr::_expr<E1> &
 #           endif
         }
     }
-
-    //this->finalize();
-    m_matrix.makeCompressed();
-    //g_bd.clear();
-    //mutVar.clear();
 }
 
 
@@ -835,17 +1162,43 @@ void gsExprAssembler<T>::assembleLhsRhsBc_impl(const expr::_expr<E1> & exprLhs,
     if (left ) exprLhs.setFlag();
     if (right) exprRhs.setFlag();
 
+    setThreadData(true);
+#   pragma omp parallel
+    assembleBcThread(static_cast<const E1&>(exprLhs),
+                     static_cast<const E2&>(exprRhs), BCs);
+    setThreadData(false);
+
+    //this->finalize();
+    m_matrix.makeCompressed();
+    //g_bd.clear();
+    //mutVar.clear();
+}
+
+template<class T>
+template<class E1, class E2>
+void gsExprAssembler<T>::assembleBcThread(const E1 exprLhs,
+                                          const E2 exprRhs,
+                                          const bcContainer & BCs)
+{
     gsVector<T> quWeights;// quadrature weights
     gsQuadRule<T>  QuRule;
     _eval ee(m_matrix, m_rhs, quWeights);
 
+#   ifdef _OPENMP
+    const int tid = omp_get_thread_num();
+    const int nt  = omp_get_num_threads();
+#   endif
+
     for (typename bcContainer::const_iterator it = BCs.begin(); it!= BCs.end(); ++it)
     {
         QuRule = gsQuadrature::get(m_exprdata->multiBasis().basis(it->patch()), m_options, it->side().direction());
 
-        m_exprdata->mapData.side = it->side();
+        m_exprdata->threadMapData().side = it->side();
 
-        // Update boundary function source
+        // Update boundary function source, once all threads are
+        // done with the previous one
+#       pragma omp barrier
+#       pragma omp single
         m_exprdata->setMutSource(*it->function(), it->parametric());
         //mutVar.registerVariable(func, mutData);
 
@@ -854,11 +1207,16 @@ void gsExprAssembler<T>::assembleLhsRhsBc_impl(const expr::_expr<E1> & exprLhs,
         m_element.set(*domIt);
 
         // Start iteration over elements
+#       ifdef _OPENMP
+        for ( domIt->next(tid); domIt->good(); domIt->next(nt) )
+#       else
         for (; domIt->good(); domIt->next() )
+#       endif
         {
             // Map the Quadrature rule to the element
             QuRule.mapTo( domIt->lowerCorner(), domIt->upperCorner(),
                           m_exprdata->points(), quWeights);
+            if ( 0 == quWeights.rows() ) continue; // no quadrature points
 
             // Perform required pre-computations on the quadrature nodes
             m_exprdata->precompute(it->patch());
@@ -867,11 +1225,6 @@ void gsExprAssembler<T>::assembleLhsRhsBc_impl(const expr::_expr<E1> & exprLhs,
 	    ee(exprRhs);
         }
     }
-
-    //this->finalize();
-    m_matrix.makeCompressed();
-    //g_bd.clear();
-    //mutVar.clear();
 }
 
 template<class T>
@@ -891,10 +1244,30 @@ void gsExprAssembler<T>::assembleInterface_impl(const expr::_expr<E1> & exprLhs,
     //m_exprdata->parse(exprLhs,exprRhs);
     //m_exprdata->parse(exprRhs);
 
+    setThreadData(true);
+#   pragma omp parallel
+    assembleInterfaceThread(static_cast<const E1&>(exprLhs),
+                            static_cast<const E2&>(exprRhs), iFaces);
+    setThreadData(false);
+
+    m_matrix.makeCompressed();
+}
+
+template<class T>
+template<class E1, class E2>
+void gsExprAssembler<T>::assembleInterfaceThread(const E1 exprLhs,
+                                                 const E2 exprRhs,
+                                                 const ifContainer & iFaces)
+{
     gsVector<T> quWeights;// quadrature weights
     gsQuadRule<T>  QuRule;
     _eval ee(m_matrix, m_rhs, quWeights);
 
+#   ifdef _OPENMP
+    const int tid = omp_get_thread_num();
+    const int nt  = omp_get_num_threads();
+#   endif
+
     //gsMatrix<T> tmp;
 
     for (gsBoxTopology::const_iiterator it = iFaces.begin();
@@ -908,18 +1281,23 @@ void gsExprAssembler<T>::assembleInterface_impl(const expr::_expr<E1> & exprLhs,
         QuRule = gsQuadrature::get(m_exprdata->multiBasis().basis(patch1),
                                    m_options, iFace.first().side().direction());
 
-        m_exprdata->mapData.side = iFace.first().side(); // (!)
+        m_exprdata->threadMapData().side = iFace.first().side(); // (!)
 
         typename gsBasis<T>::domainIter domIt =
             m_exprdata->multiBasis().basis(patch1).makeDomainIterator(iFace.first().side());
         m_element.set(*domIt);
 
         // Start iteration over elements
+#       ifdef _OPENMP
+        for ( domIt->next(tid); domIt->good(); domIt->next(nt) )
+#       else
         for (; domIt->good(); domIt->next() )
+#       endif
         {
             // Map the Quadrature rule to the element
             QuRule.mapTo( domIt->lowerCorner(), domIt->upperCorner(),
                           m_exprdata->points(), quWeights);
+            if ( 0 == quWeights.rows() ) continue; // no quadrature points
 
             // Perform required pre-computations on the quadrature nodes
             m_exprdata->precompute(patch1);
@@ -935,8 +1313,6 @@ void gsExprAssembler<T>::assembleInterface_impl(const expr::_expr<E1> & exprLhs,
 	    ee(exprRhs);
         }
     }
-
-    m_matrix.makeCompressed();
 }
 
 
@@ -1176,6 +1552,7 @@ void gsExprAssembler<T>::computeDirichletDofsL2Proj(const expr::gsFeSpace<T>& u)
         {
             bdQuRule.mapTo(bdryIter->lowerCorner(), bdryIter->upperCorner(),
                            md.points, quWeights);
+            if ( 0 == quWeights.rows() ) continue; // no quadrature points
 
             patch.computeMap(md);
 
@@ -66,6 +66,7 @@ public:
         gsOptionList opt;
         opt.addReal("quA", "Number of quadrature points: quA*deg + quB", 1.0  );
         opt.addInt ("quB", "Number of quadrature points: quA*deg + quB", 1    );
+        opt.addInt ("quRule", "Quadrature rule [1:GaussLegendre,2:GaussLobatto,3:Spline]", 1);
         opt.addInt ("plot.npts", "Number of sampling points for plotting", 3000 );
         opt.addSwitch("plot.elements", "Include the element mesh in plot (when applicable)", false);
         //opt.addSwitch("plot.cnet", "Include the control net in plot (when applicable)", false);
@@ -355,13 +356,17 @@ T gsExprEvaluator<T>::compute_impl(const expr::_expr<E> & expr)
             QuRule.mapTo( domIt->lowerCorner(), domIt->upperCorner(),
                           m_exprdata->points(), quWeights);
 
-            // Perform required pre-computations on the quadrature nodes
-            m_exprdata->precompute(patchInd);
-
-            // Compute on element
+            // Perform required pre-computations on the quadrature nodes,
+            // if any (the element then contributes zero)
             elVal = _op::init();
-            for (index_t k = 0; k != quWeights.rows(); ++k) // loop over quadrature nodes
-                _op::acc(expr.val().eval(k), quWeights[k], elVal);
+            if ( 0 != quWeights.rows() )
+            {
+                m_exprdata->precompute(patchInd);
+
+                // Compute on element
+                for (index_t k = 0; k != quWeights.rows(); ++k) // loop over quadrature nodes
+                    _op::acc(expr.val().eval(k), quWeights[k], elVal);
+            }
 
             //gsDebugVar(elVal);
             _op::acc(elVal, 1, m_value);
@@ -412,13 +417,17 @@ T gsExprEvaluator<T>::computeBdr_impl(const expr::_expr<E> & expr)
             QuRule.mapTo( domIt->lowerCorner(), domIt->upperCorner(),
                           m_exprdata->points(), quWeights);
 
-            // Perform required pre-computations on the quadrature nodes
-            m_exprdata->precompute(bit->patch);
-
-            // Compute on element
+            // Perform required pre-computations on the quadrature nodes,
+            // if any (the element then contributes zero)
             elVal = _op::init();
-            for (index_t k = 0; k != quWeights.rows(); ++k) // loop over quadrature nodes
-                _op::acc(expr.val().eval(k), quWeights[k], elVal);
+            if ( 0 != quWeights.rows() )
+            {
+                m_exprdata->precompute(bit->patch);
+
+                // Compute on element
+                for (index_t k = 0; k != quWeights.rows(); ++k) // loop over quadrature nodes
+                    _op::acc(expr.val().eval(k), quWeights[k], elVal);
+            }
 
             _op::acc(elVal, 1, m_value);
             //if ( storeElWise ) m_elWise.push_back( elVal );
@@ -473,13 +482,17 @@ T gsExprEvaluator<T>::computeInterface_impl(const expr::_expr<E> & expr, const i
             QuRule.mapTo( domIt->lowerCorner(), domIt->upperCorner(),
                           m_exprdata->points(), quWeights);
 
-            // Perform required pre-computations on the quadrature nodes
-            m_exprdata->precompute(patch1);
-
-            // Compute on element
+            // Perform required pre-computations on the quadrature nodes,
+            // if any (the element then contributes zero)
             elVal = _op::init();
-            for (index_t k = 0; k != quWeights.rows(); ++k) // loop over quadrature nodes
-                _op::acc(expr.val().eval(k), quWeights[k], elVal);
+            if ( 0 != quWeights.rows() )
+            {
+                m_exprdata->precompute(patch1);
+
+                // Compute on element
+                for (index_t k = 0; k != quWeights.rows(); ++k) // loop over quadrature nodes
+                    _op::acc(expr.val().eval(k), quWeights[k], elVal);
+            }
 
             _op::acc(elVal, 1, m_value);
             //if ( storeElWise ) m_elWise.push_back( elVal );
@@ -34,6 +34,9 @@ private:
     typedef typename FunctionTable::iterator ftIterator;
     typedef typename FunctionTable::const_iterator const_ftIterator;
 
+    // actives of the elements of a block, see precomputeBlock
+    typedef std::map<const gsFunctionSet<T>*,gsMatrix<index_t> > ActivesTable;
+
     // variable/space list
     std::deque<expr::gsFeVariable<T> > m_vlist;
     std::deque<expr::gsFeSpace<T> >    m_slist;
@@ -41,6 +44,7 @@ private:
     // background functions
     FunctionTable m_itable;
     FunctionTable m_ptable;
+    ActivesTable  m_pactives;
     //FunctionTable i_map;
 
     // geometry map
@@ -59,6 +63,18 @@ private:
 
     const gsMultiBasis<T> * mesh_ptr;
 
+    // thread-private copies of the evaluation data, used by the
+    // threads 1,2,.. of a parallel region (thread 0 uses the members above)
+    struct threadData
+    {
+        FunctionTable ptable;
+        FunctionTable itable;
+        ActivesTable  pactives;
+        gsMapData<T>  mapData;
+        gsFuncData<T> mutData;
+    };
+    std::deque<threadData> m_tdata;
+
 public:
     typedef const expr::gsGeometryMap<T> & geometryMap;
     typedef const expr::gsFeElement<T>   & element;
@@ -74,13 +90,67 @@ public:
     typedef memory::shared_ptr<gsExprHelper>  Ptr;
 public:
 
-    gsMatrix<T> & points() { return mapData.points; }
+    /// Returns the evaluation points of the calling thread
+    gsMatrix<T> & points() { return threadMapData().points; }
+
+    /// Returns the geometry map data of the calling thread
+    gsMapData<T> & threadMapData()
+    {
+#       ifdef _OPENMP
+        const int tid = omp_get_thread_num();
+        if ( 0 != tid && !m_tdata.empty() )
+            return m_tdata[tid-1].mapData;
+#       endif
+        return mapData;
+    }
+
+    /// Lets the geometry evaluations of all threads use \a cache
+    /// (NULL: no cache), see gsMapDataCache
+    void setMapCache(gsMapDataCache<T> * cache)
+    {
+        mapData.cache = cache;
+        for (typename std::deque<threadData>::iterator
+                 it = m_tdata.begin(); it != m_tdata.end(); ++it)
+            it->mapData.cache = cache;
+    }
+
+    /// \brief Creates thread-private copies of the evaluation data
+    /// (including the flags set so far) for \a nt threads, and binds
+    /// all variables to them. Inside a parallel region, every thread
+    /// then evaluates the variables on its own data. Calling with
+    /// \a nt = 1 removes the copies.
+    void setNumThreads(const index_t nt)
+    {
+        m_tdata.clear();
+        if ( nt > 1 )
+        {
+            m_tdata.resize(nt-1);
+            for (typename std::deque<threadData>::iterator
+                     it = m_tdata.begin(); it != m_tdata.end(); ++it)
+            {
+                it->ptable  = m_ptable;
+                it->itable  = m_itable;
+                it->mapData = mapData;
+                it->mutData = mutData;
+            }
+        }
+
+        bindThreadData(mapVar);
+        bindThreadData(mutVar);
+        for (typename std::deque<expr::gsFeVariable<T> >::iterator
+                 it = m_vlist.begin(); it != m_vlist.end(); ++it)
+            bindThreadData(*it);
+        for (typename std::deque<expr::gsFeSpace<T> >::iterator
+                 it = m_slist.begin(); it != m_slist.end(); ++it)
+            bindThreadData(static_cast<expr::gsFeVariable<T>&>(*it));
+    }
 
     static uPtr make() { return uPtr(new gsExprHelper()); }
 
     void reset()
     {
         m_ptable.clear();
+        m_pactives.clear();
         m_itable.clear();
         points().clear();
         m_vlist .clear();
@@ -149,6 +219,8 @@ public:
         return mapVar;
     }
 
+    bool hasMap() const { return mapVar.isValid(); }
+
     geometryMap getMap() const
     {
         GISMO_ASSERT(mapVar.isValid(), "The Geometry map is not initialized)");
@@ -251,50 +323,179 @@ public:
 
     void precompute(const index_t patchIndex = 0)
     {
-        GISMO_ASSERT(0!=points().size(), "No points");
+#       ifdef _OPENMP
+        const int tid = omp_get_thread_num();
+        if ( 0 != tid && !m_tdata.empty() )
+        {
+            threadData & td = m_tdata[tid-1];
+            precompute(patchIndex, td.ptable, td.itable, td.mapData, td.mutData);
+            return;
+        }
+#       endif
+        precompute(patchIndex, m_ptable, m_itable, mapData, mutData);
+    }
 
-        //mapData.side
+    /// \brief Pre-computes on the points of a block of elements: the
+    /// points of element \a e are the columns \a ptOffset[e] to \a
+    /// ptOffset[e+1]-1 of points(). The elements are then selected
+    /// with setBlockElement(). Returns false if the variables can not
+    /// be evaluated on the block at once (see
+    /// gsFunctionSet::computeBlock), then precompute() must be used
+    /// on every element
+    bool precomputeBlock(const gsVector<index_t> & ptOffset, const index_t patchIndex = 0)
+    {
+#       ifdef _OPENMP
+        const int tid = omp_get_thread_num();
+        if ( 0 != tid && !m_tdata.empty() )
+        {
+            threadData & td = m_tdata[tid-1];
+            if ( !precomputeBlock(td.mapData.points, ptOffset, patchIndex, td.ptable, td.pactives) )
+                return false;
+            precompute(patchIndex, td.ptable, td.itable, td.mapData, td.mutData, true);
+            return true;
+        }
+#       endif
+        if ( !precomputeBlock(mapData.points, ptOffset, patchIndex, m_ptable, m_pactives) )
+            return false;
+        precompute(patchIndex, m_ptable, m_itable, mapData, mutData, true);
+        return true;
+    }
+
+    /// Selects the element \a e of the block evaluated by precomputeBlock()
+    void setBlockElement(const index_t e)
+    {
+#       ifdef _OPENMP
+        const int tid = omp_get_thread_num();
+        if ( 0 != tid && !m_tdata.empty() )
+        {
+            setBlockElement(e, m_tdata[tid-1].ptable, m_tdata[tid-1].pactives);
+            return;
+        }
+#       endif
+        setBlockElement(e, m_ptable, m_pactives);
+    }
+
+private:
+
+    bool precomputeBlock(const gsMatrix<T> & pts, const gsVector<index_t> & ptOffset,
+                         const index_t patchIndex, FunctionTable & ptable,
+                         ActivesTable & pactives)
+    {
+        for (ftIterator it = ptable.begin(); it != ptable.end(); ++it)
+        {
+            if ( !it->first->piece(patchIndex).computeBlock(pts, ptOffset, it->second) )
+                return false;
+            it->second.patchId = patchIndex;
+            if ( it->second.flags & NEED_ACTIVE )
+                pactives[it->first].swap(it->second.actives);
+        }
+        return true;
+    }
+
+    void setBlockElement(const index_t e, FunctionTable & ptable, ActivesTable & pactives)
+    {
+        for (ftIterator it = ptable.begin(); it != ptable.end(); ++it)
+            if ( it->second.flags & NEED_ACTIVE )
+                it->second.actives = pactives[it->first].col(e);
+    }
+
+    void precompute(const index_t patchIndex,
+                    FunctionTable & ptable, FunctionTable & itable,
+                    gsMapData<T> & md, gsFuncData<T> & mutd,
+                    const bool skipPtable = false)
+    {
+        GISMO_ASSERT(0!=md.points.size(), "No points");
+
+        //md.side
         if ( mapVar.isValid() ) // list ?
         {
             //gsDebugVar("MAPDATA-------***************");
-            mapData.flags |= NEED_VALUE;
-            mapVar.source().function(patchIndex).computeMap(mapData);
-            mapData.patchId = patchIndex;
+            md.flags |= NEED_VALUE;
+            mapVar.source().function(patchIndex).computeMap(md);
+            md.patchId = patchIndex;
         }
 
-        if ( mutVar.isValid() && 0!=mutData.flags)
+        if ( mutVar.isValid() && 0!=mutd.flags)
         {
-            GISMO_ASSERT( mutParametric || 0!=mapData.values.size(), "Map values not computed");
-            //mutVar.source().piece(patchIndex).compute(mapData.points, mutData);
+            GISMO_ASSERT( mutParametric || 0!=md.values.size(), "Map values not computed");
+            //mutVar.source().piece(patchIndex).compute(md.points, mutd);
             mutVar.source().piece(patchIndex)
-                .compute( mutParametric ? mapData.points : mapData.values[0], mutData);
+                .compute( mutParametric ? md.points : md.values[0], mutd);
         }
 
-        for (ftIterator it = m_ptable.begin(); it != m_ptable.end(); ++it)
+        if ( !skipPtable ) // (already evaluated by precomputeBlock)
+        for (ftIterator it = ptable.begin(); it != ptable.end(); ++it)
         {
             //gsDebugVar("-------");
             //gsDebugVar(&it->second);
             //gsDebugVar(it->second.dim.first);
-            it->first->piece(patchIndex).compute(mapData.points, it->second); // ! piece(.) ?
+            it->first->piece(patchIndex).compute(md.points, it->second); // ! piece(.) ?
             //gsDebugVar(&it->second);
             //gsDebugVar(it->second.dim.first);
             //gsDebugVar("-------");
             it->second.patchId = patchIndex;
         }
 
-        GISMO_ASSERT( m_itable.empty() || 0!=mapData.values.size(), "Map values not computed");
+        GISMO_ASSERT( itable.empty() || 0!=md.values.size(), "Map values not computed");
 
-        if ( 0!=mapData.values.size() && 0!= mapData.values[0].rows() ) // avoid left-over from previous expr.
-        for (ftIterator it = m_itable.begin(); it != m_itable.end(); ++it)
+        if ( 0!=md.values.size() && 0!= md.values[0].rows() ) // avoid left-over from previous expr.
+        for (ftIterator it = itable.begin(); it != itable.end(); ++it)
         {
             //gsDebugVar(&it->second);
             //gsDebugVar(it->second.dim.first);
-            it->first->piece(patchIndex).compute(mapData.values[0], it->second);
+            it->first->piece(patchIndex).compute(md.values[0], it->second);
             //gsDebugVar(it->second.dim.first);
             it->second.patchId = patchIndex;
         }
     }
 
+    // Returns the copy of the evaluation data \a fd owned by \a td
+    const gsFuncData<T> * threadTwin(const gsFuncData<T> * fd, threadData & td)
+    {
+        if ( fd == &mutData )
+            return &td.mutData;
+        for (ftIterator it = m_ptable.begin(); it != m_ptable.end(); ++it)
+            if ( fd == &it->second )
+                return &td.ptable[it->first];
+        for (ftIterator it = m_itable.begin(); it != m_itable.end(); ++it)
+            if ( fd == &it->second )
+                return &td.itable[it->first];
+        return fd; // not owned by this helper, shared by all threads
+    }
+
+    void bindThreadData(expr::gsFeVariable<T> & var)
+    {
+        var.m_tfd.clear();
+        var.m_tmd.clear();
+        if ( m_tdata.empty() || NULL == var.m_fd ) return;
+
+        var.m_tfd.push_back(var.m_fd);
+        for (typename std::deque<threadData>::iterator
+                 it = m_tdata.begin(); it != m_tdata.end(); ++it)
+            var.m_tfd.push_back( threadTwin(var.m_fd, *it) );
+
+        if ( NULL != var.m_md )
+        {
+            var.m_tmd.push_back(var.m_md);
+            for (typename std::deque<threadData>::iterator
+                     it = m_tdata.begin(); it != m_tdata.end(); ++it)
+                var.m_tmd.push_back(&it->mapData);
+        }
+    }
+
+    void bindThreadData(expr::gsGeometryMap<T> & var)
+    {
+        var.m_tfd.clear();
+        if ( m_tdata.empty() || NULL == var.m_fd ) return;
+
+        var.m_tfd.push_back(var.m_fd);
+        for (typename std::deque<threadData>::iterator
+                 it = m_tdata.begin(); it != m_tdata.end(); ++it)
+            var.m_tfd.push_back(&it->mapData);
+    }
+
+public:
+
     template<class E>
     void parse(const expr::_expr<E> & expr)
     {
@@ -376,6 +376,7 @@ class gsGeometryMap : public _expr<gsGeometryMap<T> >
 {
     const gsFunctionSet<T> * m_fs; ///< Evaluation source for this geometry map
     const gsMapData<T> *  m_fd;    ///< Temporary variable storing flags and evaluation data
+    std::vector<const gsMapData<T>*> m_tfd; ///< Thread-private evaluation data (if any)
     //index_t d, n;
 
 public:
@@ -383,8 +384,14 @@ public:
     /// Returns the function source
     const gsFunctionSet<T> & source() const {return *m_fs;}
 
-    /// Returns the function data
-    const gsMapData<T> & data() const  { return *m_fd; }
+    /// Returns the function data (of the calling thread)
+    const gsMapData<T> & data() const
+    {
+#       ifdef _OPENMP
+        if ( !m_tfd.empty() ) return *m_tfd[omp_get_thread_num()];
+#       endif
+        return *m_fd;
+    }
 
 public:
     typedef T Scalar;
@@ -393,7 +400,7 @@ public:
 
     void print(std::ostream &os) const { os << "G"; }
 
-    MatExprType eval(const index_t k) const { return m_fd->values[0].col(k); }
+    MatExprType eval(const index_t k) const { return data().values[0].col(k); }
 
     void setFlag() const
     {
@@ -415,7 +422,7 @@ protected:
     /// Returns true iff the source function has been set
     bool isValid() const { return NULL!=m_fs; }
 
-    index_t rows() const { return m_fd->dim.second; }
+    index_t rows() const { return data().dim.second; }
     index_t cols() const { return 1; }
 
     static bool rowSpan() {return false;}
@@ -447,16 +454,37 @@ class gsFeElement
 {
     friend class cdiam_expr<T>;
 
-    const gsDomainIterator<T> * m_di; ///< Pointer to the domain iterator
+    std::vector<const gsDomainIterator<T>*> m_di; ///< Domain iterator of each thread
 
     cdiam_expr<T> cd;
 public:
     typedef T Scalar;
 
-    gsFeElement() : m_di(NULL), cd(*this) { }
+    gsFeElement() : m_di(1, NULL), cd(*this) { }
 
+    /// Sets the domain iterator of the calling thread
     void set(const gsDomainIterator<T> & di)
-    { m_di = &di; }
+    {
+#       ifdef _OPENMP
+        m_di[omp_get_thread_num()] = &di;
+#       else
+        m_di.front() = &di;
+#       endif
+    }
+
+    /// Reserves one domain iterator slot per thread
+    void setNumThreads(const index_t nt)
+    { m_di.assign(std::max(nt, (index_t)1), NULL); }
+
+    /// Returns the domain iterator of the calling thread
+    const gsDomainIterator<T> & iterator() const
+    {
+#       ifdef _OPENMP
+        return *m_di[omp_get_thread_num()];
+#       else
+        return *m_di.front();
+#       endif
+    }
 
     /// The diameter of the element
     const cdiam_expr<T> & diam() const
@@ -483,7 +511,7 @@ public:
 
     explicit cdiam_expr(const gsFeElement<T> & el) : _e(el) { }
 
-    T eval(const index_t ) const { return _e.m_di->getCellSize(); }
+    T eval(const index_t ) const { return _e.iterator().getCellSize(); }
 
     inline cdiam_expr<T> val() const { return *this; }
     inline index_t rows() const { return 0; }
@@ -555,17 +583,32 @@ protected:
     const gsMapData<T>     * m_md; ///< If set, the variable is composed with a geometry map
     // comp(u,G)
 
+    std::vector<const gsFuncData<T>*> m_tfd; ///< Thread-private evaluation data (if any)
+    std::vector<const gsMapData<T>*>  m_tmd; ///< Thread-private mapping data (if any)
+
 public:
     typedef T Scalar;
 
     /// Returns the function source
     const gsFunctionSet<T> & source() const {return *m_fs;}
 
-    /// Returns the function data
-    const gsFuncData<T> & data() const {return *m_fd;}
+    /// Returns the function data (of the calling thread)
+    const gsFuncData<T> & data() const
+    {
+#       ifdef _OPENMP
+        if ( !m_tfd.empty() ) return *m_tfd[omp_get_thread_num()];
+#       endif
+        return *m_fd;
+    }
 
     /// Returns the mapping data (precondition: composed()==true)
-    const gsMapData<T> & mapData() const {return *m_md;}
+    const gsMapData<T> & mapData() const
+    {
+#       ifdef _OPENMP
+        if ( !m_tmd.empty() ) return *m_tmd[omp_get_thread_num()];
+#       endif
+        return *m_md;
+    }
 
     /// Returns true if the variable is a composition
     bool composed() const {return NULL!=m_md;}
@@ -611,7 +654,7 @@ public:
     // The evaluation return rows for (basis) functions and columns
     // for (coordinate) components
     MatExprType eval(const index_t k) const
-    { return m_fd->values[0].col(k).blockDiag(m_d); } //!!
+    { return data().values[0].col(k).blockDiag(m_d); } //!!
     //{ return m_fd->values[0].col(k); }
 
     const gsFeVariable<T> & rowVar() const {return *this;}
@@ -634,12 +677,13 @@ public:
         */
 
         // note: precomputation is needed
-        if (m_fd->flags & NEED_VALUE)
-        {return m_d * m_fd->values[0].rows();}
-        if (m_fd->flags & NEED_ACTIVE) // note: gsFunction coeff ??
-        {return m_d * m_fd->actives.rows();}
-        if (m_fd->flags & NEED_DERIV)
-        {return m_d * m_fd->values[0].rows();}
+        const gsFuncData<T> & fd = data();
+        if (fd.flags & NEED_VALUE)
+        {return m_d * fd.values[0].rows();}
+        if (fd.flags & NEED_ACTIVE) // note: gsFunction coeff ??
+        {return m_d * fd.actives.rows();}
+        if (fd.flags & NEED_DERIV)
+        {return m_d * fd.values[0].rows();}
         GISMO_ERROR("Cannot deduce row size.");
     }
 
@@ -674,7 +718,7 @@ public:
         //return m_fd->dim.first;
     }
 
-    index_t cSize()  const { return m_fd->values[0].rows(); } // coordinate size
+    index_t cSize()  const { return data().values[0].rows(); } // coordinate size
 
 };
 
@@ -914,7 +958,7 @@ public:
     gsMatrix<T> & fixedPart() {return _u.m_fixedDofs;}
 
     gsFuncData<T> & data() {return *_u.m_fd;}
-    const gsFuncData<T> & data() const {return *_u.m_fd;}
+    const gsFuncData<T> & data() const {return _u.data();}
 
     void setSolutionVector(const gsMatrix<T>& solVector)
     { _Sv = & solVector; }
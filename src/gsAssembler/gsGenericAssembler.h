@@ -83,11 +83,25 @@ public:
             (iFace::strategy)(m_options.getInt("InterfaceStrategy")),
             this->pde().bc(), mapper, 0);
         m_system = gsSparseSystem<T>(mapper);
+        m_system.setSymmetric( m_options.askSwitch("Symmetric", false) );
         //note: no allocation here
         //        const index_t nz = m_options.numColNz(m_bases[0][0]);
         //        m_system.reserve(nz, 1);
     }
 
+    /// Allocates the matrix, with its exact pattern if the option
+    /// ExactPattern is set
+    void reserveMatrix()
+    {
+        if ( m_options.askSwitch("ExactPattern", false) )
+            m_system.reserve(m_bases, m_options, 0);
+        else
+        {
+            const index_t nz = gsAssemblerOptions::numColNz(m_bases[0][0],2,1,0.333333);
+            m_system.matrix().reservePerColumn(nz);
+        }
+    }
+
     /// Mass assembly routine
     const gsSparseMatrix<T> & assembleMass()
     {
@@ -113,8 +127,7 @@ public:
 
         // Clean the sparse system
         gsGenericAssembler::refresh();
-        const index_t nz = gsAssemblerOptions::numColNz(m_bases[0][0],2,1,0.333333);
-        m_system.matrix().reservePerColumn(nz);
+        reserveMatrix();
         
         // Assemble mass integrals
         //this->template push<gsVisitorMass<T> >();
@@ -165,8 +178,7 @@ public:
     {
         // Clean the sparse system
         gsGenericAssembler::refresh();
-        const index_t nz = gsAssemblerOptions::numColNz(m_bases[0][0],2,1,0.333333);
-        m_system.matrix().reservePerColumn(nz);
+        reserveMatrix();
 
         // Assemble stiffness integrals
         this->template push<gsVisitorGradGrad<T> >();
@@ -207,8 +207,8 @@ void gsHeatEquation<T>::assembleMass()
     }
 
     // Pre-allocate non-zero elements for each column of the
-    // sparse matrix
-    m_system.reserve(m_bases[0], m_options, 0);// zero rhs's
+    // sparse matrix, or its exact pattern (option ExactPattern)
+    m_system.reserve(m_bases, m_options, 0);// zero rhs's
 
     // Assemble mass integrals
     gsVisitorMass<T> mass;
@@ -0,0 +1,486 @@
+/** @file gsMatrixFreeOp.h
+
+    @brief Matrix-free application of the mass, stiffness and linear
+    elasticity operators
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsDofMapper.h>
+#include <gsAssembler/gsQuadrature.h>
+#include <gsAssembler/gsSumFactorization.h>
+#include <gsSolver/gsLinearOperator.h>
+#include <gsSolver/gsMatrixOp.h>
+#include <gsSolver/gsPreconditioner.h>
+
+namespace gismo
+{
+
+/**
+    @brief Linear operator which applies an isogeometric mass,
+    stiffness (Laplace) or linear elasticity matrix without assembling it
+
+    The product is computed element by element: the input coefficients
+    are gathered on the element, the solution (or its gradient) is
+    evaluated at the quadrature nodes, multiplied by the coefficients
+    of the operator and tested against the active basis functions.
+    On tensor-product bases the evaluation and the testing are done by
+    sum factorization (see gsSumFactorization), which costs
+    \f$O(p^{d+1})\f$ operations per element and function.
+
+    The rows and columns of the operator are the free degrees of
+    freedom of the given gsDofMapper, i.e. the eliminated (Dirichlet)
+    DoFs are treated as zero. For the mass and the stiffness
+    operators, every component of the mapper is treated
+    independently; for the elasticity operator the mapper must have
+    as many components as the dimension of the domain.
+
+    The operator can be used in every iterative solver and in the
+    matrix-free variant of gsMultiGridOp. A Jacobi preconditioner or
+    smoother is obtained by makeMatrixFreeJacobiOp(), which computes the
+    diagonal without assembling the matrix.
+
+    \ingroup Assembler
+*/
+template<class T = real_t>
+class gsMatrixFreeOp GISMO_FINAL : public gsLinearOperator<T>
+{
+public:
+
+    /// Shared pointer for gsMatrixFreeOp
+    typedef memory::shared_ptr<gsMatrixFreeOp> Ptr;
+
+    /// Unique pointer for gsMatrixFreeOp
+    typedef memory::unique_ptr<gsMatrixFreeOp> uPtr;
+
+    /// The operators which can be applied
+    enum operatorType
+    {
+        mass       = 0, ///< \f$ (u, v) \f$
+        stiffness  = 1, ///< \f$ (\nabla u, \nabla v) \f$
+        elasticity = 2  ///< \f$ (\sigma(u), \varepsilon(v)) \f$ with \f$ \sigma(u) = \lambda\, \mathrm{tr}\,\varepsilon(u) I + 2\mu\, \varepsilon(u) \f$
+    };
+
+public:
+
+    /**
+     * @brief Constructor
+     * @param patches the computational domain (not copied)
+     * @param bases the discretization space, one basis per patch (not copied)
+     * @param mapper the numbering of the degrees of freedom, must be finalized
+     * @param type the operator to be applied
+     * @param opt options, see defaultOptions()
+     */
+    gsMatrixFreeOp(const gsMultiPatch<T> & patches,
+                   const gsMultiBasis<T> & bases,
+                   const gsDofMapper & mapper,
+                   const operatorType type,
+                   const gsOptionList & opt = defaultOptions())
+    : m_patches(patches), m_bases(bases), m_mapper(mapper), m_type(type),
+      m_options(defaultOptions())
+    {
+        GISMO_ASSERT( m_mapper.isFinalized(), "The DoF mapper must be finalized");
+        GISMO_ASSERT( m_patches.nPatches() == m_bases.nBases(),
+                      "The number of patches and bases differ");
+        GISMO_ENSURE( elasticity != m_type || (index_t)m_mapper.componentsSize()
+                      == m_patches.parDim(), "The elasticity operator needs one "
+                      "mapper component per space direction");
+        setOptions(opt);
+    }
+
+    /// Make function returning a smart pointer
+    static uPtr make(const gsMultiPatch<T> & patches,
+                     const gsMultiBasis<T> & bases,
+                     const gsDofMapper & mapper,
+                     const operatorType type,
+                     const gsOptionList & opt = defaultOptions())
+    { return uPtr( new gsMatrixFreeOp(patches, bases, mapper, type, opt) ); }
+
+    /// Returns a list of default options
+    static gsOptionList defaultOptions()
+    {
+        gsOptionList opt;
+        opt.addReal  ("quA", "Number of quadrature points: quA*deg + quB", 1.0);
+        opt.addInt   ("quB", "Number of quadrature points: quA*deg + quB", 1  );
+        opt.addInt   ("quRule", "Quadrature rule [1:GaussLegendre,2:GaussLobatto,3:Spline]", 1);
+        opt.addSwitch("SumFactorization", "Use sum factorization on tensor-product bases", true);
+        opt.addReal  ("YoungsModulus", "Young's modulus (elasticity operator)", 1.0);
+        opt.addReal  ("PoissonsRatio", "Poisson's ratio (elasticity operator)", 0.3);
+        return opt;
+    }
+
+    /// Sets the options, see defaultOptions()
+    virtual void setOptions(const gsOptionList & opt)
+    {
+        m_options.update(opt);
+        const T E  = m_options.getReal("YoungsModulus");
+        const T nu = m_options.getReal("PoissonsRatio");
+        m_lambda = E * nu / ( (1 + nu) * (1 - 2 * nu) );
+        m_mu     = E / ( 2 * (1 + nu) );
+    }
+
+    /// Computes \a x = A * \a input, column by column
+    void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const
+    {
+        GISMO_ASSERT( input.rows() == rows(), "Wrong number of rows: "
+                      << input.rows() << " instead of " << rows() );
+        x.setZero(rows(), input.cols());
+        loop(&input, x);
+    }
+
+    /// Returns the diagonal of the operator as a column vector,
+    /// without assembling the matrix
+    gsMatrix<T> diagonal() const
+    {
+        gsMatrix<T> diag = gsMatrix<T>::Zero(rows(), 1);
+        loop(NULL, diag);
+        return diag;
+    }
+
+    index_t rows() const { return m_mapper.freeSize(); }
+
+    index_t cols() const { return m_mapper.freeSize(); }
+
+    /// The DoF mapper of the operator
+    const gsDofMapper & mapper() const { return m_mapper; }
+
+private:
+
+    // Thread-private data of the element loop
+    struct workspace
+    {
+        gsSumFactorization<T> sumFact;
+        gsQuadRule<T>         rule;
+        gsMatrix<T>           quNodes;
+        gsVector<T>           quWeights;
+        std::vector<gsMatrix<T> > basisData;
+        gsMatrix<index_t>     actives;
+        gsMapData<T>          md;
+        gsMatrix<T>           u, r, vals, grads, flux;
+    };
+
+    // Loops over all elements and adds the element products
+    // A_e * input to x, or the diagonal of A_e to x if input is NULL
+    void loop(const gsMatrix<T> * input, gsMatrix<T> & x) const
+    {
+        const index_t nComp = m_mapper.componentsSize();
+        const bool sumFact = m_options.getSwitch("SumFactorization") && NULL != input;
+
+#pragma omp parallel
+{
+        workspace ws;
+        ws.md.flags = NEED_MEASURE | NEED_DERIV;
+
+#ifdef _OPENMP
+        const int tid = omp_get_thread_num();
+        const int nt  = omp_get_num_threads();
+        // Thread-private result, summed up at the end
+        gsMatrix<T> xloc = gsMatrix<T>::Zero(x.rows(), x.cols());
+#else
+        const int tid = 0, nt = 1;
+        gsMatrix<T> & xloc = x;
+#endif
+
+        for (size_t p = 0; p != m_patches.nPatches(); ++p)
+        {
+            const gsBasis<T>    & basis = m_bases[p];
+            const gsGeometry<T> & patch = m_patches.patch(p);
+
+            ws.rule = gsQuadrature::get(basis, m_options);
+            ws.sumFact = gsSumFactorization<T>();
+            if ( sumFact )
+            {
+                const gsVector<index_t> nq = gsQuadrature::numNodes(
+                    basis, m_options.getReal("quA"), m_options.getInt("quB") );
+                if ( nq.prod() == ws.rule.numNodes() )
+                    ws.sumFact.init(basis, nq);
+            }
+
+            typename gsBasis<T>::domainIter domIt = basis.makeDomainIterator();
+            for (index_t e = 0; domIt->good(); domIt->next(), ++e)
+            {
+                if ( e % nt != tid ) continue;
+
+                ws.rule.mapTo(domIt->lowerCorner(), domIt->upperCorner(),
+                              ws.quNodes, ws.quWeights);
+                if ( ws.sumFact.enabled() )
+                    ws.sumFact.evaluate(ws.quNodes, ws.actives);
+                else
+                {
+                    basis.active_into(ws.quNodes.col(0), ws.actives);
+                    basis.evalAllDers_into(ws.quNodes, 1, ws.basisData);
+                }
+                ws.md.points = ws.quNodes;
+                patch.computeMap(ws.md);
+
+                if ( NULL == input )
+                {
+                    diagonalElement(ws);
+                    scatter(ws, p, 0, xloc);
+                    continue;
+                }
+
+                for (index_t j = 0; j != input->cols(); ++j)
+                {
+                    // Gather the element coefficients, one column per component
+                    const index_t n = ws.actives.rows();
+                    ws.u.resize(n, nComp);
+                    for (index_t c = 0; c != nComp; ++c)
+                        for (index_t i = 0; i != n; ++i)
+                        {
+                            const index_t ii = ws.actives.at(i);
+                            ws.u(i, c) = m_mapper.is_free(ii, p, c) ?
+                                (*input)(m_mapper.index(ii, p, c), j) : T(0);
+                        }
+
+                    applyElement(ws);
+                    scatter(ws, p, j, xloc);
+                }
+            }
+        }
+
+#ifdef _OPENMP
+#pragma omp critical (gsMatrixFreeOp_sum)
+        x += xloc;
+#endif
+}//omp parallel
+    }
+
+    // Adds the element result ws.r to column j of x
+    void scatter(const workspace & ws, const size_t p, const index_t j,
+                 gsMatrix<T> & x) const
+    {
+        for (index_t c = 0; c != ws.r.cols(); ++c)
+            for (index_t i = 0; i != ws.actives.rows(); ++i)
+            {
+                const index_t ii = ws.actives.at(i);
+                if ( m_mapper.is_free(ii, p, c) )
+                    x(m_mapper.index(ii, p, c), j) += ws.r(i, c);
+            }
+    }
+
+    // Computes the element product ws.r = A_e * ws.u
+    void applyElement(workspace & ws) const
+    {
+        const index_t d  = ws.md.dim.first;
+        const index_t nq = ws.quWeights.rows();
+        const index_t nComp = ws.u.cols();
+        ws.r.setZero(ws.u.rows(), nComp);
+
+        if ( mass == m_type )
+        {
+            for (index_t c = 0; c != nComp; ++c)
+            {
+                values(ws, c);
+                for (index_t k = 0; k != nq; ++k)
+                    ws.vals(k) *= ws.quWeights[k] * ws.md.measure(k);
+                addValues(ws, c);
+            }
+            return;
+        }
+
+        gsMatrix<T> jacInv, P, sigma;
+        if ( stiffness == m_type )
+        {
+            for (index_t c = 0; c != nComp; ++c)
+            {
+                gradients(ws, c);
+                ws.flux.resize(d, nq);
+                for (index_t k = 0; k != nq; ++k)
+                {
+                    jacInv = ws.md.jacobian(k).cramerInverse();
+                    ws.flux.col(k).noalias() = ( ws.quWeights[k] * ws.md.measure(k) )
+                        * ( jacInv * ( jacInv.transpose() * ws.grads.col(k) ) );
+                }
+                addGradients(ws, c);
+            }
+            return;
+        }
+
+        // Elasticity: parametric gradients of all components,
+        // stored as d x d blocks per node (column c for component c)
+        gsMatrix<T> G(d, d * nq);
+        for (index_t c = 0; c != nComp; ++c)
+        {
+            gradients(ws, c);
+            for (index_t k = 0; k != nq; ++k)
+                G.col(k * d + c) = ws.grads.col(k);
+        }
+        for (index_t k = 0; k != nq; ++k)
+        {
+            jacInv = ws.md.jacobian(k).cramerInverse();
+            // Physical gradient P(c,b) = d u_c / d x_b
+            P.noalias() = G.middleCols(k * d, d).transpose() * jacInv;
+            sigma = m_mu * ( P + P.transpose() );
+            sigma.diagonal().array() += m_lambda * P.trace();
+            G.middleCols(k * d, d).noalias() =
+                ( ws.quWeights[k] * ws.md.measure(k) ) * jacInv * sigma;
+        }
+        for (index_t c = 0; c != nComp; ++c)
+        {
+            ws.flux.resize(d, nq);
+            for (index_t k = 0; k != nq; ++k)
+                ws.flux.col(k) = G.col(k * d + c);
+            addGradients(ws, c);
+        }
+    }
+
+    // Computes the diagonal of the element matrix into ws.r
+    void diagonalElement(workspace & ws) const
+    {
+        const index_t d  = ws.md.dim.first;
+        const index_t n  = ws.actives.rows();
+        const index_t nComp = m_mapper.componentsSize();
+        const gsMatrix<T> & bVals  = ws.basisData[0];
+        const gsMatrix<T> & bGrads = ws.basisData[1];
+        ws.r.setZero(n, nComp);
+
+        gsMatrix<T> jacInv, C, g;
+        for (index_t k = 0; k != ws.quWeights.rows(); ++k)
+        {
+            const T weight = ws.quWeights[k] * ws.md.measure(k);
+            if ( mass == m_type )
+            {
+                ws.r.col(0).array() += weight * bVals.col(k).array().square();
+                continue;
+            }
+
+            jacInv = ws.md.jacobian(k).cramerInverse();
+            C.noalias() = jacInv * jacInv.transpose();
+            for (index_t i = 0; i != n; ++i)
+            {
+                g = bGrads.block(i * d, k, d, 1);
+                const T gg = weight * (g.transpose() * C * g).value();
+                if ( stiffness == m_type )
+                    ws.r(i, 0) += gg;
+                else
+                    for (index_t c = 0; c != nComp; ++c)
+                        ws.r(i, c) += m_mu * gg + weight * (m_lambda + m_mu)
+                            * math::pow( (jacInv.col(c).transpose() * g).value(), 2);
+            }
+        }
+
+        // The scalar operators act on every component alike
+        if ( elasticity != m_type )
+            for (index_t c = 1; c != nComp; ++c)
+                ws.r.col(c) = ws.r.col(0);
+    }
+
+    // Values of component c at the quadrature nodes, into ws.vals
+    void values(workspace & ws, const index_t c) const
+    {
+        if ( ws.sumFact.enabled() )
+        {
+            const gsVector<short_t> alpha = gsVector<short_t>::Zero(ws.md.dim.first);
+            ws.sumFact.interpolate(ws.u.col(c), alpha, ws.vals);
+        }
+        else
+            ws.vals.noalias() = ws.basisData[0].transpose() * ws.u.col(c);
+    }
+
+    // Tests the values ws.vals, adds the result to column c of ws.r
+    void addValues(workspace & ws, const index_t c) const
+    {
+        if ( ws.sumFact.enabled() )
+        {
+            const gsVector<short_t> alpha = gsVector<short_t>::Zero(ws.md.dim.first);
+            ws.flux = ws.r.col(c);
+            ws.sumFact.integrate(ws.vals, alpha, ws.flux);
+            ws.r.col(c) = ws.flux;
+        }
+        else
+            ws.r.col(c).noalias() += ws.basisData[0] * ws.vals;
+    }
+
+    // Parametric gradients of component c at the quadrature nodes,
+    // into the columns of ws.grads
+    void gradients(workspace & ws, const index_t c) const
+    {
+        const index_t d  = ws.md.dim.first;
+        const index_t n  = ws.u.rows();
+        const index_t nq = ws.quWeights.rows();
+        ws.grads.resize(d, nq);
+        if ( ws.sumFact.enabled() )
+        {
+            gsVector<short_t> alpha(d);
+            for (index_t a = 0; a != d; ++a)
+            {
+                alpha.setZero(); alpha[a] = 1;
+                ws.sumFact.interpolate(ws.u.col(c), alpha, ws.vals);
+                ws.grads.row(a) = ws.vals.transpose();
+            }
+        }
+        else
+            for (index_t k = 0; k != nq; ++k)
+                ws.grads.col(k).noalias() =
+                    gsAsConstMatrix<T>(ws.basisData[1].col(k).data(), d, n) * ws.u.col(c);
+    }
+
+    // Tests the parametric fluxes ws.flux against the parametric
+    // gradients, adds the result to column c of ws.r
+    void addGradients(workspace & ws, const index_t c) const
+    {
+        const index_t d  = ws.md.dim.first;
+        const index_t n  = ws.u.rows();
+        const index_t nq = ws.quWeights.rows();
+        if ( ws.sumFact.enabled() )
+        {
+            gsVector<short_t> alpha(d);
+            gsMatrix<T> rc = ws.r.col(c);
+            for (index_t a = 0; a != d; ++a)
+            {
+                alpha.setZero(); alpha[a] = 1;
+                ws.vals = ws.flux.row(a).transpose();
+                ws.sumFact.integrate(ws.vals, alpha, rc);
+            }
+            ws.r.col(c) = rc;
+        }
+        else
+            for (index_t k = 0; k != nq; ++k)
+                ws.r.col(c).noalias() +=
+                    gsAsConstMatrix<T>(ws.basisData[1].col(k).data(), d, n).transpose()
+                    * ws.flux.col(k);
+    }
+
+private:
+
+    const gsMultiPatch<T> & m_patches;
+
+    const gsMultiBasis<T> & m_bases;
+
+    const gsDofMapper m_mapper;
+
+    const operatorType m_type;
+
+    gsOptionList m_options;
+
+    // Lame constants of the elasticity operator
+    T m_lambda, m_mu;
+};
+
+/// @brief Returns a (damped) Jacobi preconditioner for the
+/// matrix-free operator \a op, the diagonal is computed without
+/// assembling the matrix
+///
+/// \relates gsMatrixFreeOp
+template<class T>
+typename gsPreconditionerOp<T>::uPtr
+makeMatrixFreeJacobiOp(const memory::shared_ptr<gsMatrixFreeOp<T> > & op, const T tau = 1)
+{
+    const gsMatrix<T> diag = op->diagonal();
+    const index_t n = diag.rows();
+    gsSparseMatrix<T> invDiag(n, n);
+    invDiag.reserve(gsVector<index_t>::Ones(n));
+    for (index_t i = 0; i != n; ++i)
+        invDiag.insert(i, i) = 1 / diag(i, 0);
+    invDiag.makeCompressed();
+    return gsPreconditionerFromOp<T>::make(op, makeMatrixOp(invDiag.moveToPtr()), tau);
+}
+
+} // namespace gismo
@@ -100,7 +100,9 @@ public:
     // Reference element is [-1,1]^d
     //const gsMatrix<T> & referenceElement() { }
 
-    /// \brief Number of nodes in the currently kept rule
+    /// \brief Number of nodes in the currently kept rule (zero for
+    /// rules defined on the whole parameter domain, where the number
+    /// depends on the element)
     index_t numNodes() const { return m_weights.size(); }
 
     /// \brief Dimension of the rule
@@ -130,6 +132,21 @@ public:
     virtual inline void mapTo( const gsVector<T>& lower, const gsVector<T>& upper,
                        gsMatrix<T> & nodes, gsVector<T> & weights ) const;
 
+    /**\brief Maps a tensor-product rule to an element like mapTo(),
+     * but returns the nodes as coordinate vectors
+     *
+     * The Cartesian product of the coordinates \a nodes[i] in
+     * direction \a i (first direction running fastest, see
+     * gsPointGrid) are the nodes returned by mapTo(), and \a weights
+     * are the corresponding weights. The grid can be evaluated
+     * direction by direction, e.g. by
+     * gsBasis::evalAllDersGrid_into(). Returns false if the rule is
+     * not a tensor-product rule, in which case mapTo() has to be
+     * used.
+     */
+    bool mapToGrid(const gsVector<T>& lower, const gsVector<T>& upper,
+                   std::vector<gsVector<T> > & nodes, gsVector<T> & weights) const;
+
     /**\brief Maps a univariate quadrature rule (i.e., points and
      * weights) from the reference interval to an arbitrary interval.
      */
@@ -150,6 +167,18 @@ protected:
     void computeTensorProductRule(const std::vector<gsVector<T> > & nodes,
                                   const std::vector<gsVector<T> > & weights);
 
+    /// \brief Selects the nodes of a rule defined on the whole
+    /// parameter domain (see m_global) which lie in the box [\a lower,
+    /// \a upper)
+    void mapToGlobal(const gsVector<T>& lower, const gsVector<T>& upper,
+                     gsMatrix<T> & nodes, gsVector<T> & weights ) const;
+
+    /// \brief Coordinate-wise nodes and weights of a rule defined on
+    /// the whole parameter domain inside the box [\a lower, \a upper)
+    void selectGlobal(const gsVector<T>& lower, const gsVector<T>& upper,
+                      std::vector<gsVector<T> > & cnodes,
+                      std::vector<gsVector<T> > & cweights) const;
+
 protected:
 
     /// \brief Reference quadrature nodes (on the interval [-1,1]).
@@ -159,6 +188,20 @@ protected:
     /// [-1,1]).
     gsVector<T> m_weights;
 
+    /// \brief Univariate rules on the whole parameter domain, one per
+    /// direction, with the sorted nodes in the first and the weights
+    /// in the second column. A null entry stands for a direction with
+    /// a single node of weight one (see gsQuadrature::get with \a
+    /// fixDir). If non-empty, mapTo() selects the nodes inside the
+    /// element instead of mapping the reference rule. The tables are
+    /// shared, so they survive the copy into a gsQuadRule.
+    std::vector<memory::shared_ptr<const gsMatrix<T> > > m_global;
+
+    /// \brief Reference nodes of every direction if the rule is the
+    /// tensor product of univariate rules (see
+    /// computeTensorProductRule() and mapToGrid()), empty otherwise.
+    std::vector<gsVector<T> > m_cwiseNodes;
+
 }; // class gsQuadRule
 
 
@@ -167,6 +210,12 @@ template<class T> void
 gsQuadRule<T>::mapTo( const gsVector<T>& lower, const gsVector<T>& upper,
                       gsMatrix<T> & nodes, gsVector<T> & weights ) const
 {
+    if ( !m_global.empty() )
+    {
+        mapToGlobal(lower, upper, nodes, weights);
+        return;
+    }
+
     const index_t d = lower.size();
     GISMO_ASSERT( d == m_nodes.rows(), "Inconsistent quadrature mapping");
 
@@ -24,6 +24,15 @@ template<class T> void
 gsQuadRule<T>::mapTo( T startVal, T endVal,
                       gsMatrix<T> & nodes, gsVector<T> & weights ) const
 {
+    if ( !m_global.empty() )
+    {
+        gsVector<T> lower(1), upper(1);
+        lower[0] = startVal;
+        upper[0] = endVal;
+        mapToGlobal(lower, upper, nodes, weights);
+        return;
+    }
+
     GISMO_ASSERT( 1 == m_nodes.rows(), "Inconsistent quadrature mapping");
 
     const T h = (endVal-startVal) / T(2);
@@ -39,8 +48,13 @@ template<class T> void
 gsQuadRule<T>::mapToAll( const std::vector<T> & breaks,
                          gsMatrix<T> & nodes, gsVector<T> & weights ) const
 {
-    GISMO_ASSERT( 1 == m_nodes.rows(), "Inconsistent quadrature mapping.");
     GISMO_ASSERT( breaks.size()>1, "At least 2 breaks are needed.");
+    if ( !m_global.empty() )
+    {
+        mapTo(breaks.front(), breaks.back(), nodes, weights);
+        return;
+    }
+    GISMO_ASSERT( 1 == m_nodes.rows(), "Inconsistent quadrature mapping.");
 
     const size_t nint    = breaks.size() - 1;
     const index_t nnodes = numNodes();
@@ -73,6 +87,7 @@ gsQuadRule<T>::computeTensorProductRule(const std::vector<gsVector<T> > & nodes,
 
     // compute the tensor quadrature rule
     gsPointGrid(nodes, m_nodes);
+    m_cwiseNodes = nodes;
 
     gsVector<index_t> numNodes(d);
     for( short_t i=0; i<d; ++i )
@@ -94,5 +109,109 @@ gsQuadRule<T>::computeTensorProductRule(const std::vector<gsVector<T> > & nodes,
     } while (nextLexicographic(curr, numNodes));
 }
 
+template<class T> void
+gsQuadRule<T>::mapToGlobal(const gsVector<T>& lower, const gsVector<T>& upper,
+                           gsMatrix<T> & nodes, gsVector<T> & weights ) const
+{
+    const short_t d = static_cast<short_t>(m_global.size());
+    std::vector<gsVector<T> > cnodes, cweights;
+    selectGlobal(lower, upper, cnodes, cweights);
+    gsVector<index_t> numNodes(d);
+    for( short_t i=0; i<d; ++i )
+        numNodes[i] = cweights[i].size();
+
+    if ( 0 == numNodes.prod() ) // no nodes in this element
+    {
+        nodes.resize(d, 0);
+        weights.resize(0);
+        return;
+    }
+
+    gsPointGrid(cnodes, nodes);
+    weights.resize( nodes.cols() );
+    index_t r = 0;
+    gsVector<index_t> curr(d);
+    curr.setZero();
+    do {
+        weights[r] = cweights[0][curr[0]];
+        for (short_t i=1; i<d; ++i)
+            weights[r] *= cweights[i][curr[i]];
+        ++r;
+    } while (nextLexicographic(curr, numNodes));
+}
+
+
+template<class T> void
+gsQuadRule<T>::selectGlobal(const gsVector<T>& lower, const gsVector<T>& upper,
+                            std::vector<gsVector<T> > & cnodes,
+                            std::vector<gsVector<T> > & cweights) const
+{
+    const short_t d = static_cast<short_t>(m_global.size());
+    GISMO_ASSERT( d == lower.size(), "Inconsistent quadrature mapping");
+
+    cnodes.resize(d);
+    cweights.resize(d);
+    for( short_t i=0; i<d; ++i )
+    {
+        if ( !m_global[i] ) // fixed direction
+        {
+            cnodes  [i].setConstant(1, lower[i]);
+            cweights[i].setOnes(1);
+        }
+        else
+        {
+            const gsMatrix<T> & rule = *m_global[i];
+            const T * beg = rule.data(), * end = beg + rule.rows();
+            const index_t first = std::lower_bound(beg, end, lower[i]) - beg;
+            const index_t last  = std::lower_bound(beg, end, upper[i]) - beg;
+            cnodes  [i] = rule.block(first, 0, last - first, 1);
+            cweights[i] = rule.block(first, 1, last - first, 1);
+        }
+    }
+}
+
+template<class T> bool
+gsQuadRule<T>::mapToGrid(const gsVector<T>& lower, const gsVector<T>& upper,
+                         std::vector<gsVector<T> > & nodes, gsVector<T> & weights) const
+{
+    const short_t d = static_cast<short_t>(lower.size());
+    std::vector<gsVector<T> > cweights;
+    if ( !m_global.empty() )
+        selectGlobal(lower, upper, nodes, cweights);
+    else if ( static_cast<short_t>(m_cwiseNodes.size()) == d )
+    {
+        // Same linear map as mapTo
+        const gsVector<T> h = (upper-lower) / T(2) ;
+        nodes.resize(d);
+        for ( short_t i = 0; i!=d; ++i)
+            nodes[i] = (h[i] * (m_cwiseNodes[i].array()+1)) + lower[i];
+
+        T hprod(1.0);
+        for ( short_t i = 0; i!=d; ++i)
+            hprod *= ( 0 == h[i] ? T(0.5) : h[i] );
+        weights.noalias() = hprod * m_weights;
+        return true;
+    }
+    else
+        return false;
+
+    // Weights of the global rule
+    gsVector<index_t> numNodes(d);
+    for( short_t i=0; i<d; ++i )
+        numNodes[i] = cweights[i].size();
+    weights.resize( numNodes.prod() );
+    if ( 0 == weights.size() )
+        return true;
+    index_t r = 0;
+    gsVector<index_t> curr(d);
+    curr.setZero();
+    do {
+        weights[r] = cweights[0][curr[0]];
+        for (short_t i=1; i<d; ++i)
+            weights[r] *= cweights[i][curr[i]];
+        ++r;
+    } while (nextLexicographic(curr, numNodes));
+    return true;
+}
 
 } // namespace gismo
@@ -16,6 +16,7 @@
 #include <gsIO/gsOptionList.h>
 #include <gsAssembler/gsGaussRule.h>
 #include <gsAssembler/gsLobattoRule.h>
+#include <gsAssembler/gsSplineQuadRule.h>
 
 namespace gismo
 {
@@ -27,7 +28,8 @@ struct gsQuadrature
     enum rule
     {
         GaussLegendre = 1, ///< Gauss-Legendre quadrature
-        GaussLobatto  = 2  ///< Gauss-Lobatto quadrature
+        GaussLobatto  = 2, ///< Gauss-Lobatto quadrature
+        Spline        = 3  ///< Reduced quadrature for B-spline bases, see gsSplineQuadRule
     };
 
     /// Constructs a quadrature rule based on input \a options
@@ -35,7 +37,13 @@ struct gsQuadrature
     static gsQuadRule<T> get(const gsBasis<T> & basis,
                              const gsOptionList & options, short_t fixDir = -1)
     {
-        const index_t qu  = options.askInt("quRule", GaussLegendre);
+        index_t       qu  = options.askInt("quRule", GaussLegendre);
+        if ( Spline == qu )
+        {
+            if ( gsSplineQuadRule<T>::isApplicable(basis) )
+                return gsSplineQuadRule<T>(basis, fixDir);
+            qu = GaussLegendre; // e.g. for hierarchical bases
+        }
         const T       quA = options.getReal("quA");
         const index_t quB = options.getInt ("quB");
         const gsVector<index_t> nnodes = numNodes(basis,quA,quB,fixDir);
@@ -15,6 +15,7 @@
 #pragma once
 
 #include <gsCore/gsStdVectorRef.h>
+#include <gsAssembler/gsSparsityPattern.h>
 
 namespace gismo
 {
@@ -78,9 +79,26 @@ protected:
 
     gsVector<index_t> m_dims;
 
+    // -- Exact pattern
+
+    /// @brief the exact sparsity pattern of the matrix and the
+    /// cached scatter map of the elements (cf. setupPattern)
+    gsSparsityPattern<T> m_pattern;
+
+    /// @brief index of the first element of every patch in the
+    /// element numbering of \a m_pattern
+    std::vector<index_t> m_elOffset;
+
+    /// @brief the element currently pushed by each thread (-1: none)
+    std::vector<index_t> m_curEl;
+
+    /// @brief true if only the lower triangular part of the matrix
+    /// is stored (always if \a symm is true, cf. setSymmetric)
+    bool m_symmetric;
+
 public:
 
-    gsSparseSystem()
+    gsSparseSystem() : m_symmetric(symm)
     { }
 
     /**
@@ -95,7 +113,8 @@ public:
           m_rstr   (1),
           m_cstr   (1),
           m_cvar   (1),
-          m_dims   (1)
+          m_dims   (1),
+          m_symmetric(symm)
     {
         m_row [0] =  m_col [0] =
                 m_rstr[0] =  m_cstr[0] =
@@ -142,7 +161,8 @@ public:
           m_col(dims.sum()),
           m_rstr(dims.sum()),
           m_cstr(dims.sum()),
-          m_dims(dims.cast<index_t>())
+          m_dims(dims.cast<index_t>()),
+          m_symmetric(symm)
     {
         const index_t d = dims.size();
         const index_t s = dims.sum();
@@ -209,7 +229,8 @@ public:
           m_col (gsVector<index_t>::LinSpaced(cols,0,cols-1)),
           m_rstr(rows),
           m_cstr(cols),
-          m_dims(cols)
+          m_dims(cols),
+          m_symmetric(symm)
     {
         GISMO_ASSERT( rows > 0 && cols > 0, "Block dimensions must be positive");
 
@@ -280,7 +301,8 @@ public:
           m_col (colInd),
           m_rstr((index_t)rowInd.size()),
           m_cstr((index_t)colInd.size()),
-          m_dims(colInd.size())
+          m_dims(colInd.size()),
+          m_symmetric(symm)
         // ,m_cvar(colvar) //<< Bug
     {
         m_dims.setOnes();
@@ -317,6 +339,10 @@ public:
         m_cstr   .swap(other.m_cstr   );
         m_cvar   .swap(other.m_cvar   );
         m_dims   .swap(other.m_dims   );
+        m_pattern.swap(other.m_pattern);
+        m_elOffset.swap(other.m_elOffset);
+        m_curEl  .swap(other.m_curEl  );
+        std::swap(m_symmetric, other.m_symmetric);
     }
 
     /**
@@ -353,6 +379,111 @@ public:
         reserve(numColNz(mb,opt), numRhs);
     }
 
+    /**
+     * @brief Reserves the memory for the sparse matrix and the rhs.
+     *
+     * If the switch ExactPattern is set in \a opt, the exact pattern
+     * of the matrix is computed by setupPattern, or, if it is already
+     * available for the same elements and DoFs (cf. patternKey), the
+     * matrix values are set to zero keeping the pattern, so that
+     * re-assembly only adds to existing entries.
+     * Otherwise, this is the same as reserve(bases[0], opt, numRhs).
+     * @param bases the multi-bases of the unknowns
+     * @param opt
+     * @param [in] numRhs number of columns
+     */
+    void reserve(const std::vector<gsMultiBasis<T> > & bases,
+                 const gsOptionList & opt, const index_t numRhs)
+    {
+        if ( ! opt.askSwitch("ExactPattern", false) )
+            reserve(bases.front(), opt, numRhs);
+        else if ( m_pattern.matches(m_matrix, patternKey(bases)) )
+        {
+            std::fill(m_matrix.valuePtr(), m_matrix.valuePtr() + m_matrix.nonZeros(), T(0));
+            if ( 0 != numRhs )
+                m_rhs.setZero(m_matrix.cols(), numRhs);
+            resetElements();
+        }
+        else
+            setupPattern(bases, numRhs);
+    }
+
+    /**
+     * @brief Computes the exact sparsity pattern of the matrix from
+     * the supports of the basis functions and the mappers, and caches
+     * the positions of the local matrix entries of all elements.
+     *
+     * The elements are numbered patch-wise, in the order of the
+     * domain iterators of \a bases[0]. After setElement(), the
+     * contributions of the element given to push() are added directly
+     * at the cached positions. Only square block structures are
+     * supported.
+     * @param bases the multi-bases of the unknowns (cf. colBasis)
+     * @param [in] numRhs number of columns
+     */
+    void setupPattern(const std::vector<gsMultiBasis<T> > & bases,
+                      const index_t numRhs)
+    {
+        GISMO_ASSERT( 0 != m_mappers.size(), "Sparse system was not initialized");
+        const index_t nb = m_col.size();
+        GISMO_ENSURE( m_row.size() == nb, "The exact pattern requires square block structure");
+
+        m_pattern.init(m_matrix.rows(), m_matrix.cols(), m_symmetric);
+        const size_t np = bases.front().nBases();
+        m_elOffset.resize(np+1);
+        m_elOffset[0] = 0;
+
+        gsMatrix<index_t> act, mapped;
+        std::vector<std::vector<index_t> > rowInd(nb), colInd(nb);
+        for (size_t p = 0; p != np; ++p)
+        {
+            typename gsBasis<T>::domainIter domIt = bases.front()[p].makeDomainIterator();
+            index_t ne = 0;
+            for (; domIt->good(); domIt->next(), ++ne)
+            {
+                for (index_t b = 0; b != nb; ++b)
+                {
+                    bases[colBasis(b)][p].active_into(domIt->centerPoint(), act);
+                    globalIndices(act, p, rowMapper(b), m_rstr[b], mapped, rowInd[b]);
+                    globalIndices(act, p, colMapper(b), m_cstr[b], mapped, colInd[b]);
+                }
+                for (index_t r = 0; r != nb; ++r)
+                    for (index_t c = 0; c != nb; ++c)
+                        m_pattern.addBlock(rowInd[r], colInd[c]);
+            }
+            m_elOffset[p+1] = m_elOffset[p] + ne;
+        }
+
+        m_pattern.compute(m_matrix, patternKey(bases));
+        if ( 0 != numRhs )
+            m_rhs.setZero(m_matrix.cols(), numRhs);
+        resetElements();
+    }
+
+    /// @brief Returns true if the cached scatter map is valid for the
+    /// current matrix
+    bool hasPattern() const { return m_pattern.matches(m_matrix); }
+
+    /// @brief Returns the index of the first element of patch \a p
+    /// in the element numbering of setupPattern
+    index_t elementOffset(const index_t p) const { return m_elOffset[p]; }
+
+    /**
+     * @brief Sets the element whose contributions the calling thread
+     * pushes next, in the numbering of setupPattern. The value -1
+     * disables the cached scatter map for this thread.
+     */
+    void setElement(const index_t e)
+    {
+#       ifdef _OPENMP
+        const size_t tid = omp_get_thread_num();
+#       else
+        const size_t tid = 0;
+#       endif
+        if ( tid < m_curEl.size() )
+            m_curEl[tid] = e;
+    }
+
     /// @brief Provides an estimation of the number of non-zero matrix
     /// entries per column. This value can be used for sparse matrix
     /// memory allocation
@@ -369,6 +500,75 @@ public:
         return cast<T,short_t>(nz*(1.0+bdO));
     }
 
+private:
+
+    // Identifies the discretization of the pattern: the number of
+    // elements of every patch and the global row and column indices
+    // of all basis functions
+    std::vector<index_t> patternKey(const std::vector<gsMultiBasis<T> > & bases) const
+    {
+        const index_t nb = m_col.size();
+        const size_t np = bases.front().nBases();
+        std::vector<index_t> key, ind;
+        gsMatrix<index_t> act, mapped;
+        for (size_t p = 0; p != np; ++p)
+        {
+            key.push_back(bases.front()[p].numElements());
+            for (index_t b = 0; b != nb; ++b)
+            {
+                act.resize(bases[colBasis(b)][p].size(), 1);
+                for (index_t i = 0; i != act.rows(); ++i)
+                    act.at(i) = i;
+                key.push_back(act.rows());
+                globalIndices(act, p, rowMapper(b), m_rstr[b], mapped, ind);
+                key.insert(key.end(), ind.begin(), ind.end());
+                globalIndices(act, p, colMapper(b), m_cstr[b], mapped, ind);
+                key.insert(key.end(), ind.begin(), ind.end());
+            }
+        }
+        return key;
+    }
+
+    // Maps the patch-local indices \a act to global matrix indices
+    // (-1 for eliminated DoFs)
+    static void globalIndices(const gsMatrix<index_t> & act, const index_t p,
+                              const gsDofMapper & mapper, const index_t str,
+                              gsMatrix<index_t> & mapped, std::vector<index_t> & result)
+    {
+        mapper.localToGlobal(act, p, mapped);
+        result.resize(mapped.rows());
+        for (index_t i = 0; i != mapped.rows(); ++i)
+            result[i] = mapper.is_free_index(mapped.at(i)) ? str + mapped.at(i) : -1;
+    }
+
+    // Unsets the current element of all threads
+    void resetElements()
+    {
+#       ifdef _OPENMP
+        m_curEl.assign(omp_get_max_threads(), -1);
+#       else
+        m_curEl.assign(1, -1);
+#       endif
+    }
+
+    // Returns the cached positions of the (\a r,\a c) block of the
+    // current element of the calling thread, or NULL if not available
+    const index_t * cachedPositions(const size_t r, const size_t c,
+                                    const index_t nr, const index_t nc) const
+    {
+#       ifdef _OPENMP
+        const size_t tid = omp_get_thread_num();
+#       else
+        const size_t tid = 0;
+#       endif
+        if ( tid >= m_curEl.size() || m_curEl[tid] < 0 || !m_pattern.matches(m_matrix) )
+            return NULL;
+        const index_t nb = m_col.size();
+        return m_pattern.positions( (m_curEl[tid]*nb + r)*nb + c, nr, nc );
+    }
+
+public:
+
     /// @brief set everything to zero
     void setZero()
     {
@@ -537,7 +737,20 @@ public: /* Accessors */
     /// @brief returns true if only half of the matrix is stored, due to its symmetry
     bool symmetry() const
     {
-        return symm;
+        return m_symmetric;
+    }
+
+    /**
+     * @brief Stores only the lower triangular part of the matrix
+     * (\a on = true), e.g. for symmetric problems that are solved by
+     * gsSparseSolver<T>::SimplicialLDLT or applied with
+     * makeSymmetricMatrixOp(). The local matrices given to push()
+     * must be symmetric. Call before reserving the matrix.
+     */
+    void setSymmetric(const bool on)
+    {
+        GISMO_ASSERT( on || !symm, "The matrix of this system is always symmetric");
+        m_symmetric = symm || on;
     }
 
     /*
@@ -658,7 +871,7 @@ public: /* Add local contributions to system matrix */
                     {
                         // If matrix is symmetric, we store only lower
                         // triangular part
-                        if ( (!symm) || jj <= ii )
+                        if ( (!m_symmetric) || jj <= ii )
                             m_matrix.coeffRef(ii, jj) += localMat(i, j);
                     }
                     else if(0!=eliminatedDofs.size())
@@ -712,7 +925,7 @@ public: /* Add local contributions to system matrix */
                     {
                         // If matrix is symmetric, we store only lower
                         // triangular part
-                        if ( (!symm) || jj <= ii )
+                        if ( (!m_symmetric) || jj <= ii )
                             m_matrix.coeffRef(ii, jj) += localMat(i, j);
                     }
                     else
@@ -754,7 +967,7 @@ public: /* Add local contributions to system matrix */
 
                 // If matrix is symmetric, we store only lower
                 // triangular part
-                if ( (!symm) || jj <= ii )
+                if ( (!m_symmetric) || jj <= ii )
                     m_matrix.coeffRef(ii, jj) += localMat(i, j);
 
 
@@ -793,7 +1006,7 @@ public: /* Add local contributions to system matrix */
 
                 // If matrix is symmetric, we store only lower
                 // triangular part
-                if ( (!symm) || jj <= ii )
+                if ( (!m_symmetric) || jj <= ii )
                     m_matrix.coeffRef(ii, jj) += localMat(i, j);
             }
         }
@@ -852,7 +1065,7 @@ public: /* Add local contributions to system matrix */
                             {
                                 // If matrix is symmetric, we store only lower
                                 // triangular part
-                                if ( (!symm) || jj <= ii )
+                                if ( (!m_symmetric) || jj <= ii )
                                     m_matrix.coeffRef(ii, jj) += localMat(iiLocal, jjLocal);
                             }
                             else // Fixed DoF
@@ -977,6 +1190,7 @@ public: /* Add local contributions to system matrix and right-hand side */
     {
         const index_t numActive = actives.rows();
         const gsDofMapper & rowMap = m_mappers[m_row.at(r)];
+        const index_t * pos = cachedPositions(r, c, numActive, numActive);
 
         GISMO_ASSERT( &rowMap == &m_mappers[m_col.at(c)], "Error");
         GISMO_ASSERT( m_matrix.cols() == m_rhs.rows(), "gsSparseSystem is not allocated");
@@ -996,8 +1210,14 @@ public: /* Add local contributions to system matrix and right-hand side */
                     {
                         // If matrix is symmetric, we store only lower
                         // triangular part
-                        if ( (!symm) || jj <= ii )
-                            m_matrix.coeffRef(ii, jj) += localMat(i, j);
+                        if ( (!m_symmetric) || jj <= ii )
+                        {
+                            const index_t k = pos ? pos[i + j*numActive] : -1;
+                            if ( k >= 0 )
+                                m_matrix.valuePtr()[k] += localMat(i, j);
+                            else
+                                m_matrix.coeffRef(ii, jj) += localMat(i, j);
+                        }
                     }
                     else // if ( mapper.is_boundary_index(jj) ) // Fixed DoF?
                     {
@@ -1034,6 +1254,7 @@ public: /* Add local contributions to system matrix and right-hand side */
         const index_t numActive_j = actives_j.rows();
         const gsDofMapper & rowMap = m_mappers[m_row.at(r)];
         const gsDofMapper & colMap = m_mappers[m_col.at(c)];
+        const index_t * pos = cachedPositions(r, c, numActive_i, numActive_j);
 
         GISMO_ASSERT( m_matrix.cols() == m_rhs.rows(), "gsSparseSystem is not allocated");
         //Assert eliminatedDofs.rows() == rowMap.boundarySize()
@@ -1052,8 +1273,14 @@ public: /* Add local contributions to system matrix and right-hand side */
                     {
                         // If matrix is symmetric, we store only lower
                         // triangular part
-                        if ( (!symm) || jj <= ii )
-                            m_matrix.coeffRef(ii, jj) += localMat(i, j);
+                        if ( (!m_symmetric) || jj <= ii )
+                        {
+                            const index_t k = pos ? pos[i + j*numActive_i] : -1;
+                            if ( k >= 0 )
+                                m_matrix.valuePtr()[k] += localMat(i, j);
+                            else
+                                m_matrix.coeffRef(ii, jj) += localMat(i, j);
+                        }
                     }
                     else // if ( mapper.is_boundary_index(jj) ) // Fixed DoF?
                     {
@@ -1096,7 +1323,7 @@ public: /* Add local contributions to system matrix and right-hand side */
                 const unsigned ii = m_rstr.at(r) + actives(i);
                 // If matrix is symmetric, we store only lower
                 // triangular part
-                if ( (!symm) || jj <= ii )
+                if ( (!m_symmetric) || jj <= ii )
                     m_matrix( ii, jj ) += localMat(i,j);
             }
         }
@@ -1162,7 +1389,7 @@ public: /* Add local contributions to system matrix and right-hand side */
                             {
                                 // If matrix is symmetric, we store only lower
                                 // triangular part
-                                if ( (!symm) || jj <= ii )
+                                if ( (!m_symmetric) || jj <= ii )
                                     m_matrix.coeffRef(ii, jj) += localMat(iiLocal, jjLocal);
                             }
                             else // Fixed DoF
@@ -1229,7 +1456,7 @@ public: /* Add local contributions to system matrix and right-hand side */
                             {
                                 // If matrix is symmetric, we store only lower
                                 // triangular part
-                                if ( (!symm) || jj <= ii )
+                                if ( (!m_symmetric) || jj <= ii )
                                     m_matrix.coeffRef(ii, jj) += localMat(i + r * numRowActive,
                                                                           j + c * numRowActive); //  + c * ..
                             }
@@ -1305,7 +1532,7 @@ public: /* Add local contributions to system matrix and right-hand side */
                     if ( rowMap.is_free_index( actives.at(j)) )
                         // If matrix is symmetric, we store only lower
                         // triangular part
-                        if ( (!symm) || jj <= ii )
+                        if ( (!m_symmetric) || jj <= ii )
                             m_matrix.coeffRef(ii, jj) += localMat(i, j);
                 }
             }
@@ -1350,7 +1577,7 @@ public: /* Add local contributions to system matrix and right-hand side */
                     if ( colMap.is_free_index(actives_j.at(j)) )
                         // If matrix is symmetric, we store only lower
                         // triangular part
-                        if ( (!symm) || jj <= ii )
+                        if ( (!m_symmetric) || jj <= ii )
                             m_matrix.coeffRef(ii, jj) += localMat(i, j);
                 }
             }
@@ -1395,7 +1622,7 @@ public: /* Add local contributions to system matrix and right-hand side */
                     {
                         // If matrix is symmetric, we store only lower
                         // triangular part
-                        if ( (!symm) || jj <= ii )
+                        if ( (!m_symmetric) || jj <= ii )
                             m_matrix.coeffRef(ii, jj) += localMat(i, j);
                     }
                 }
@@ -1429,7 +1656,7 @@ public:
                     {
                         // If matrix is symmetric, we store only lower
                         // triangular part
-                        if ( (!symm) || jj <= ii )
+                        if ( (!m_symmetric) || jj <= ii )
                             m_matrix.coeffRef(ii, jj) += it.value();
                     }
                     else // if ( mapper.is_boundary_index(jj) ) // Fixed DoF?
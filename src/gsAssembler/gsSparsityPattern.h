@@ -0,0 +1,248 @@
+/** @file gsSparsityPattern.h
+
+    @brief Exact sparsity pattern of an assembled matrix and the
+    element-wise scatter map into its compressed storage
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+namespace gismo
+{
+
+/**
+    @brief Symbolic assembly of a sparse matrix
+
+    The element contributions are registered as dense blocks, given by
+    the global row and column indices that they couple (a negative
+    index marks a row or column which is not part of the matrix,
+    e.g. an eliminated DoF). The exact non-zero pattern is computed at
+    once, together with the position of every local entry in the value
+    array of the compressed matrix. Numerical assembly can then add
+    the local contributions at these positions, without searching the
+    columns and without reallocating the storage.
+
+    The map is only valid as long as the discretization is the same.
+    Therefore, compute() stores a key given by the caller, which
+    describes the discretization exactly (e.g. the number of elements
+    and the global indices of all basis functions), and matches()
+    compares it, together with the storage of the matrix.
+
+    \ingroup Assembler
+*/
+template<class T>
+class gsSparsityPattern
+{
+public:
+
+    gsSparsityPattern() : m_rows(0), m_cols(0), m_nnz(0), m_lower(false), m_inner(NULL)
+    { }
+
+    /// Starts the symbolic phase for a \a rows x \a cols matrix. If
+    /// \a lower is true, only the lower triangular part is stored
+    void init(const index_t rows, const index_t cols, const bool lower = false)
+    {
+        clear();
+        m_rows  = rows;
+        m_cols  = cols;
+        m_lower = lower;
+    }
+
+    /// Frees all the data
+    void clear()
+    {
+        m_rows = m_cols = m_nnz = 0;
+        m_inner = NULL;
+        m_key.clear();
+        m_ind.clear(); m_iptr.assign(1, 0);
+        m_nr .clear(); m_nc  .clear();
+        m_pos.clear(); m_ptr .assign(1, 0);
+    }
+
+    void swap(gsSparsityPattern & other)
+    {
+        std::swap(m_rows , other.m_rows );
+        std::swap(m_cols , other.m_cols );
+        std::swap(m_nnz  , other.m_nnz  );
+        std::swap(m_lower, other.m_lower);
+        std::swap(m_inner, other.m_inner);
+        m_key .swap(other.m_key );
+        m_ind .swap(other.m_ind );
+        m_iptr.swap(other.m_iptr);
+        m_nr  .swap(other.m_nr  );
+        m_nc  .swap(other.m_nc  );
+        m_pos .swap(other.m_pos );
+        m_ptr .swap(other.m_ptr );
+    }
+
+    /// Returns true if no scatter map has been computed
+    bool empty() const { return m_nr.empty() || m_ptr.size() != m_nr.size() + 1; }
+
+    /// Number of registered blocks
+    index_t numBlocks() const { return m_nr.size(); }
+
+    /// Number of non-zero entries of the computed pattern
+    index_t nonZeros() const { return m_nnz; }
+
+    /// \brief Registers a local block coupling the global \a rows
+    /// with the global \a cols, and returns its index
+    index_t addBlock(const std::vector<index_t> & rows,
+                     const std::vector<index_t> & cols)
+    {
+        m_ind.insert(m_ind.end(), rows.begin(), rows.end());
+        m_ind.insert(m_ind.end(), cols.begin(), cols.end());
+        m_iptr.push_back(m_ind.size());
+        m_nr.push_back(rows.size());
+        m_nc.push_back(cols.size());
+        return m_nr.size() - 1;
+    }
+
+    /// \brief Allocates \a mat (compressed, with zero values) with
+    /// the exact pattern of the registered blocks and computes the
+    /// scatter map. The \a key identifies the discretization for
+    /// which the pattern is valid (cf. matches)
+    void compute(gsSparseMatrix<T> & mat,
+                 const std::vector<index_t> & key = std::vector<index_t>())
+    {
+        const index_t nb = numBlocks();
+
+        // Incidence column -> blocks
+        std::vector<index_t> cptr(m_cols+1, 0), cblk;
+        for (index_t b = 0; b != nb; ++b)
+        {
+            const index_t * cc = colInd(b);
+            for (index_t j = 0; j != m_nc[b]; ++j)
+                if ( cc[j] >= 0 ) ++cptr[cc[j]+1];
+        }
+        for (index_t j = 0; j != m_cols; ++j)
+            cptr[j+1] += cptr[j];
+        cblk.resize(cptr.back());
+        std::vector<index_t> fill(cptr.begin(), cptr.end()-1);
+        for (index_t b = 0; b != nb; ++b)
+        {
+            const index_t * cc = colInd(b);
+            for (index_t j = 0; j != m_nc[b]; ++j)
+                if ( cc[j] >= 0 ) cblk[fill[cc[j]]++] = b;
+        }
+
+        // Row indices of every column
+        std::vector<index_t> outer(m_cols+1, 0), inner, stamp(m_rows, -1);
+        for (index_t j = 0; j != m_cols; ++j)
+        {
+            for (index_t k = cptr[j]; k != cptr[j+1]; ++k)
+            {
+                const index_t b = cblk[k];
+                const index_t * rr = rowInd(b);
+                for (index_t i = 0; i != m_nr[b]; ++i)
+                {
+                    const index_t ii = rr[i];
+                    if ( ii >= 0 && (!m_lower || ii >= j) && stamp[ii] != j )
+                    {
+                        stamp[ii] = j;
+                        inner.push_back(ii);
+                    }
+                }
+            }
+            std::sort(inner.begin() + outer[j], inner.end());
+            outer[j+1] = inner.size();
+        }
+        m_nnz = inner.size();
+
+        // Compressed matrix with explicit zeros
+        mat.resize(m_rows, m_cols);
+        mat.resizeNonZeros(m_nnz);
+        std::copy(outer.begin(), outer.end(), mat.outerIndexPtr());
+        std::copy(inner.begin(), inner.end(), mat.innerIndexPtr());
+        std::fill(mat.valuePtr(), mat.valuePtr() + m_nnz, T(0));
+        m_inner = mat.innerIndexPtr();
+        m_key   = key;
+
+        // Positions of the local entries, stored column-wise
+        m_ptr.resize(nb+1);
+        m_ptr[0] = 0;
+        for (index_t b = 0; b != nb; ++b)
+            m_ptr[b+1] = m_ptr[b] + m_nr[b] * m_nc[b];
+        m_pos.resize(m_ptr.back());
+        for (index_t b = 0; b != nb; ++b)
+        {
+            const index_t * rr = rowInd(b);
+            const index_t * cc = colInd(b);
+            index_t * pos = m_pos.data() + m_ptr[b];
+            for (index_t j = 0; j != m_nc[b]; ++j)
+                for (index_t i = 0; i != m_nr[b]; ++i, ++pos)
+                {
+                    const index_t ii = rr[i], jj = cc[j];
+                    if ( ii < 0 || jj < 0 || (m_lower && ii < jj) )
+                        *pos = -1;
+                    else
+                        *pos = std::lower_bound(inner.begin() + outer[jj],
+                                                inner.begin() + outer[jj+1], ii)
+                            - inner.begin();
+                }
+        }
+
+        // The index sets are not needed anymore
+        std::vector<index_t>().swap(m_ind);
+        m_iptr.assign(1, 0);
+    }
+
+    /// \brief Returns the positions (in the value array of the
+    /// matrix) of the entries of block \a b, stored column-wise, or
+    /// NULL if the block does not have size \a nr x \a nc. Entries
+    /// which are not stored in the matrix have position -1
+    const index_t * positions(const index_t b, const index_t nr, const index_t nc) const
+    {
+        return ( b < numBlocks() && m_nr[b] == nr && m_nc[b] == nc ) ?
+            m_pos.data() + m_ptr[b] : NULL;
+    }
+
+    /// \brief Returns true if \a mat is still the matrix allocated
+    /// by compute(), i.e. the scatter map is valid for \a mat
+    bool matches(const gsSparseMatrix<T> & mat) const
+    {
+        return !empty() && mat.isCompressed() && mat.nonZeros() == m_nnz
+            && mat.rows() == m_rows && mat.cols() == m_cols
+            && mat.innerIndexPtr() == m_inner;
+    }
+
+    /// \brief Returns true if the scatter map is valid for \a mat
+    /// and was computed for the discretization identified by \a key
+    bool matches(const gsSparseMatrix<T> & mat, const std::vector<index_t> & key) const
+    {
+        return matches(mat) && key == m_key;
+    }
+
+private:
+
+    const index_t * rowInd(const index_t b) const { return m_ind.data() + m_iptr[b]; }
+
+    const index_t * colInd(const index_t b) const { return rowInd(b) + m_nr[b]; }
+
+private:
+
+    index_t m_rows, m_cols, m_nnz;
+
+    bool m_lower;
+
+    // Storage of the matrix computed by compute()
+    const index_t * m_inner;
+
+    // Identifies the discretization of the pattern
+    std::vector<index_t> m_key;
+
+    // Index sets of the blocks (symbolic phase)
+    std::vector<index_t> m_ind, m_iptr;
+
+    // Sizes of the blocks
+    std::vector<index_t> m_nr, m_nc;
+
+    // Scatter map
+    std::vector<index_t> m_pos, m_ptr;
+};
+
+} // namespace gismo
@@ -0,0 +1,106 @@
+/** @file gsSplineQuadRule.h
+
+    @brief Provides reduced quadrature rules for tensor-product B-spline
+    spaces
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsAssembler/gsQuadRule.h>
+#include <gsNurbs/gsKnotVector.h>
+
+namespace gismo
+{
+
+/**
+    \brief Class that represents a reduced (tensor) quadrature rule for
+    a B-spline basis
+
+    In every direction the rule integrates exactly the products
+    \f$B_iB_j\f$ and \f$B_i'B_j'\f$ of the univariate basis
+    functions, that is, the splines of degree \f$2p\f$ whose
+    continuity at a knot is one less than the one of the basis. The
+    parameter interval is split into macro-elements of a few elements
+    (and at the knots where this space is discontinuous), and on every
+    macro-element the Gaussian rule of the space is computed by
+    Newton's method, see Bartoň & Calo, <em>Optimal quadrature rules
+    for odd-degree spline spaces and their application to
+    tensor-product-based isogeometric analysis</em>, CMAME 305, 2016.
+    Since the rule exploits the continuity of the integrands, it
+    needs roughly \f$(p+2)/2\f$ nodes per element instead of the
+    \f$p+1\f$ of the Gauss rule.
+
+    The nodes are global: for an element, mapTo() returns the nodes
+    which lie inside of it. The element contributions are not exact
+    individually, but their sum over the patch is. Hence the rule
+    must be used with the elements of the basis it was created for.
+
+    The univariate rules are cached per knot vector, so that the
+    rules of all patches and assemblers sharing a knot vector are
+    computed once. If Newton's method fails on a macro-element, the
+    Gauss rule with \f$p+1\f$ nodes is used on its elements.
+
+    \ingroup Assembler
+*/
+template<class T = real_t>
+class gsSplineQuadRule GISMO_FINAL : public gsQuadRule<T>
+{
+public:
+
+    /// Initialize the rule for the univariate B-spline basis with
+    /// the knot vector \a kv
+    explicit gsSplineQuadRule(const gsKnotVector<T> & kv);
+
+    /// Initialize the rule for the tensor-product B-spline \a basis,
+    /// with a single node in direction \a fixDir (if not -1)
+    explicit gsSplineQuadRule(const gsBasis<T> & basis, short_t fixDir = -1);
+
+    ~gsSplineQuadRule() { }
+
+    /// Returns true if \a basis is a tensor-product B-spline basis
+    static bool isApplicable(const gsBasis<T> & basis);
+
+    /// Returns the univariate rule for the knot vector \a kv, with
+    /// the nodes in the first and the weights in the second column
+    static memory::shared_ptr<const gsMatrix<T> > lookup(const gsKnotVector<T> & kv);
+
+private:
+
+    using gsQuadRule<T>::m_nodes;
+    using gsQuadRule<T>::m_global;
+
+    /// Computes the univariate rule for \a kv
+    static void compute(const gsKnotVector<T> & kv, gsMatrix<T> & rule);
+
+    /// Computes the Gaussian rule on [0,1] for the splines of degree
+    /// \a deg with the (open) knot vector \a knots, returns false if
+    /// Newton's method does not converge
+    static bool computeGaussian(const std::vector<T> & knots, short_t deg,
+                                gsMatrix<T> & rule);
+
+    /// Newton's method for the nodes \a x and the weights \a w of
+    /// a rule with the given \a integrals of the B-splines of \a
+    /// basis, returns false if it does not converge
+    static bool newton(const gsBSplineBasis<T> & basis, const gsVector<T> & integrals,
+                       bool fixFirst, gsMatrix<T> & x, gsVector<T> & w);
+
+    /// Residual \a res of the exactness conditions for the nodes \a
+    /// x and the weights \a w, and its Jacobian \a jac with respect
+    /// to the weights and the nodes (except the first node if \a
+    /// fixFirst is true), returns the norm of \a res
+    static T residual(const gsBSplineBasis<T> & basis, const gsVector<T> & integrals,
+                      const gsMatrix<T> & x, const gsVector<T> & w, bool fixFirst,
+                      gsVector<T> & res, gsMatrix<T> * jac);
+};
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsSplineQuadRule.hpp)
+#endif
@@ -0,0 +1,292 @@
+/** @file gsSplineQuadRule.hpp
+
+    @brief Provides implementation of the reduced quadrature rules for
+    B-spline spaces
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsNurbs/gsBSplineBasis.h>
+#include <gsAssembler/gsGaussRule.h>
+
+#include <numeric>
+
+namespace gismo
+{
+
+template<class T>
+gsSplineQuadRule<T>::gsSplineQuadRule(const gsKnotVector<T> & kv)
+{
+    m_nodes.resize(1, 0);
+    m_global.push_back( lookup(kv) );
+}
+
+template<class T>
+gsSplineQuadRule<T>::gsSplineQuadRule(const gsBasis<T> & basis, short_t fixDir)
+{
+    GISMO_ENSURE( isApplicable(basis), "The basis is not a tensor-product B-spline basis");
+    const short_t d = basis.dim();
+    m_nodes.resize(d, 0);
+    m_global.resize(d);
+    for (short_t k = 0; k != d; ++k)
+        if ( k != fixDir )
+            m_global[k] = lookup( static_cast<const gsBSplineBasis<T>&>(basis.component(k)).knots() );
+}
+
+template<class T>
+bool gsSplineQuadRule<T>::isApplicable(const gsBasis<T> & basis)
+{
+    // Hierarchical bases return the components of the coarsest level,
+    // so the number of elements is compared as well
+    index_t size = 1, numEl = 1;
+    for (short_t k = 0; k != basis.dim(); ++k)
+    {
+        const gsBSplineBasis<T> * comp =
+            dynamic_cast<const gsBSplineBasis<T>*>(&basis.component(k));
+        if ( NULL == comp ) return false;
+        size  *= comp->size();
+        numEl *= comp->numElements();
+    }
+    return size == basis.size() && numEl == static_cast<index_t>(basis.numElements());
+}
+
+template<class T> memory::shared_ptr<const gsMatrix<T> >
+gsSplineQuadRule<T>::lookup(const gsKnotVector<T> & kv)
+{
+    typedef std::map<std::vector<T>, memory::shared_ptr<const gsMatrix<T> > > cacheType;
+    static cacheType cache;
+
+    // The key is the knot vector followed by the degree
+    std::vector<T> key(kv.begin(), kv.end());
+    key.push_back( static_cast<T>(kv.degree()) );
+
+    memory::shared_ptr<const gsMatrix<T> > result;
+#   pragma omp critical (gsSplineQuadRule_cache)
+    {
+        typename cacheType::const_iterator it = cache.find(key);
+        if ( it != cache.end() )
+            result = it->second;
+        else
+        {
+            gsMatrix<T> * rule = new gsMatrix<T>;
+            compute(kv, *rule);
+            result = memory::shared_ptr<const gsMatrix<T> >(rule);
+            if ( cache.size() > 64 ) // keep the cache small, e.g. under adaptivity
+                cache.clear();
+            cache[key] = result;
+        }
+    }
+    return result;
+}
+
+template<class T>
+void gsSplineQuadRule<T>::compute(const gsKnotVector<T> & kv, gsMatrix<T> & rule)
+{
+    // Number of elements of a macro-element
+    const index_t maxMacro = 8;
+
+    const short_t p = kv.degree();
+    const short_t q = 2 * p; // degree of the products
+    const std::vector<T> br = kv.breaks();
+    const typename gsKnotVector<T>::multContainer mult = kv.multiplicities();
+    const index_t ne = br.size() - 1;
+
+    // Multiplicities of the interior breaks in the space of the products
+    std::vector<index_t> tm(ne + 1, q + 1);
+    for (index_t i = 1; i < ne; ++i)
+        tm[i] = std::min<index_t>(p + mult[i] + 1, q + 1);
+
+    std::vector<T> nodes, weights;
+    std::map<std::vector<T>, gsMatrix<T> > macroRules; // rules on [0,1]
+    const gsGaussRule<T> gauss(p + 1);
+    gsMatrix<T> gNodes;
+    gsVector<T> gWeights;
+    index_t s = 0;
+    while ( s < ne )
+    {
+        // Elements [s,e) where the space of the products is continuous
+        index_t e = s + 1;
+        while ( e < ne && tm[e] <= q ) ++e;
+
+        // Split into macro-elements of about equal size
+        const index_t nm = (e - s + maxMacro - 1) / maxMacro;
+        for (index_t m = 0; m != nm; ++m)
+        {
+            const index_t e0 = s + m * (e - s) / nm, e1 = s + (m + 1) * (e - s) / nm;
+            const T a = br[e0], h = br[e1] - a;
+
+            // Knot vector of the macro-element, mapped to [0,1]
+            std::vector<T> knots(q + 1, T(0));
+            for (index_t i = e0 + 1; i < e1; ++i)
+                knots.insert(knots.end(), tm[i], (br[i] - a) / h);
+            knots.insert(knots.end(), q + 1, T(1));
+
+            typename std::map<std::vector<T>, gsMatrix<T> >::iterator it = macroRules.find(knots);
+            if ( it == macroRules.end() )
+            {
+                it = macroRules.insert( std::make_pair(knots, gsMatrix<T>()) ).first;
+                if ( !computeGaussian(knots, q, it->second) )
+                    it->second.resize(0, 2);
+            }
+
+            if ( 0 != it->second.rows() )
+                for (index_t k = 0; k != it->second.rows(); ++k)
+                {
+                    nodes  .push_back( a + h * it->second(k, 0) );
+                    weights.push_back(     h * it->second(k, 1) );
+                }
+            else // fall back to the Gauss rule
+                for (index_t i = e0; i != e1; ++i)
+                {
+                    gauss.mapTo(br[i], br[i + 1], gNodes, gWeights);
+                    nodes  .insert(nodes  .end(), gNodes.data(), gNodes.data() + gNodes.size());
+                    weights.insert(weights.end(), gWeights.data(), gWeights.data() + gWeights.size());
+                }
+        }
+        s = e;
+    }
+
+    rule.resize(nodes.size(), 2);
+    rule.col(0) = gsAsConstVector<T>(nodes.data(), nodes.size());
+    rule.col(1) = gsAsConstVector<T>(weights.data(), weights.size());
+}
+
+template<class T>
+bool gsSplineQuadRule<T>::computeGaussian(const std::vector<T> & knots, short_t deg,
+                                          gsMatrix<T> & rule)
+{
+    const gsBSplineBasis<T> basis( gsKnotVector<T>(knots, deg) );
+    const index_t dim = basis.size();
+    const index_t n = (dim + 1) / 2;
+    // For an odd dimension the first node is fixed at 0
+    const bool fixFirst = ( 1 == dim % 2 );
+
+    // Exact integrals of the B-splines
+    gsVector<T> integrals(dim);
+    for (index_t j = 0; j != dim; ++j)
+        integrals[j] = (knots[j + deg + 1] - knots[j]) / (deg + 1);
+
+    // Initial rule: the nodes are the averages of the Greville
+    // abscissae of pairs of B-splines, the weights are the integrals
+    // of the pairs
+    gsMatrix<T> x(1, n), xn;
+    gsVector<T> w(n), wn, start, target;
+    for (index_t k = 0; k != n; ++k)
+    {
+        const index_t j = std::max<index_t>(2 * k - fixFirst, 0);
+        const index_t l = std::min<index_t>(2 * k + 1 - fixFirst, dim - 1);
+        x(0, k) = ( std::accumulate(knots.begin() + j + 1, knots.begin() + j + deg + 1, T(0)) +
+                    std::accumulate(knots.begin() + l + 1, knots.begin() + l + deg + 1, T(0)) )
+            / (2 * deg);
+        w[k] = integrals[j] + ( l != j ? integrals[l] : T(0) );
+    }
+    if ( fixFirst )
+        x(0, 0) = 0;
+
+    // Homotopy from the moments of the initial rule to the exact
+    // integrals, every intermediate rule is computed by Newton's
+    // method starting from the previous one
+    residual(basis, integrals, x, w, fixFirst, start, NULL);
+    start += integrals;
+    T t = 0, dt = 1;
+    while ( t < 1 )
+    {
+        const T tn = math::min(t + dt, T(1));
+        target = (1 - tn) * start + tn * integrals;
+        xn = x;
+        wn = w;
+        if ( newton(basis, target, fixFirst, xn, wn) )
+        {
+            t = tn;
+            x.swap(xn);
+            w.swap(wn);
+            dt *= 2;
+        }
+        else if ( (dt /= 4) < T(1e-6) )
+            return false;
+    }
+
+    if ( (w.array() <= 0).any() )
+        return false;
+
+    // The nodes may have changed their order
+    std::vector<std::pair<T,T> > sorted(n);
+    for (index_t k = 0; k != n; ++k)
+        sorted[k] = std::make_pair(x(0, k), w[k]);
+    std::sort(sorted.begin(), sorted.end());
+    rule.resize(n, 2);
+    for (index_t k = 0; k != n; ++k)
+    {
+        if ( k > 0 && sorted[k].first == sorted[k-1].first )
+            return false;
+        rule(k, 0) = sorted[k].first;
+        rule(k, 1) = sorted[k].second;
+    }
+    return true;
+}
+
+template<class T>
+bool gsSplineQuadRule<T>::newton(const gsBSplineBasis<T> & basis, const gsVector<T> & integrals,
+                                 bool fixFirst, gsMatrix<T> & x, gsVector<T> & w)
+{
+    const index_t n = x.cols();
+    const T tol = 10 * std::numeric_limits<T>::epsilon();
+    gsVector<T> res, dx;
+    gsMatrix<T> jac;
+    T err = residual(basis, integrals, x, w, fixFirst, res, &jac);
+    for (index_t iter = 0; iter != 20; ++iter)
+    {
+        dx = jac.partialPivLu().solve(res);
+        w -= dx.head(n);
+        x.rightCols(n - fixFirst) -= dx.tail(n - fixFirst).transpose();
+
+        // The nodes must stay inside the macro-element
+        if ( (x.rightCols(n - fixFirst).array() <= 0).any() || (x.array() >= 1).any() )
+            return false;
+
+        const T errOld = err;
+        err = residual(basis, integrals, x, w, fixFirst, res, &jac);
+        if ( err <= tol )
+            return true;
+        if ( err >= errOld ) // no convergence or round-off level
+            return err <= 100 * tol;
+    }
+    return false;
+}
+
+template<class T>
+T gsSplineQuadRule<T>::residual(const gsBSplineBasis<T> & basis, const gsVector<T> & integrals,
+                                const gsMatrix<T> & x, const gsVector<T> & w, bool fixFirst,
+                                gsVector<T> & res, gsMatrix<T> * jac)
+{
+    const index_t n = x.cols();
+    std::vector<gsMatrix<T> > ders;
+    gsMatrix<index_t> act;
+    basis.evalAllDers_into(x, 1, ders);
+    basis.active_into(x, act);
+
+    res = -integrals;
+    if ( jac )
+        jac->setZero(integrals.size(), 2 * n - fixFirst);
+    for (index_t k = 0; k != n; ++k)
+        for (index_t i = 0; i != act.rows(); ++i)
+        {
+            const index_t j = act(i, k);
+            res[j] += w[k] * ders[0](i, k);
+            if ( jac )
+            {
+                (*jac)(j, k) = ders[0](i, k);
+                if ( k >= fixFirst )
+                    (*jac)(j, n + k - fixFirst) = w[k] * ders[1](i, k);
+            }
+        }
+    return res.norm();
+}
+
+} // namespace gismo
@@ -0,0 +1,11 @@
+#include <gsCore/gsTemplateTools.h>
+
+#include <gsAssembler/gsSplineQuadRule.h>
+#include <gsAssembler/gsSplineQuadRule.hpp>
+
+namespace gismo
+{
+
+    CLASS_TEMPLATE_INST gsSplineQuadRule<real_t> ;
+
+}
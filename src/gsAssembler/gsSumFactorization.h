@@ -0,0 +1,350 @@
+/** @file gsSumFactorization.h
+
+    @brief Sum-factorized element integrals on tensor-product bases
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsTensor/gsTensorBasis.h>
+
+namespace gismo
+{
+
+/**
+    @brief Computes element matrices and vectors on a tensor-product
+    basis with a tensor-product quadrature rule by sum factorization.
+
+    The basis functions are products of univariate functions, and the
+    quadrature nodes form a tensor grid (first coordinate running
+    fastest, cf. gsQuadRule::computeTensorProductRule). An integral
+    \f$\sum_q c_q\, \partial^\alpha N_i(x_q)\, \partial^\beta N_j(x_q)\f$
+    is then computed by contracting the quadrature points one direction
+    at a time, which costs \f$O(p^{2d+1})\f$ operations per element
+    instead of the \f$O(p^{3d})\f$ of the point-wise rank-one updates.
+
+    The element-local numbering of the active functions is the one of
+    gsTensorBasis::active_into, see evaluate().
+
+    \ingroup Assembler
+*/
+template<class T>
+class gsSumFactorization
+{
+public:
+
+    gsSumFactorization() : m_dim(0) { }
+
+    /**
+     * @brief Prepares the kernels for \a basis.
+     *
+     * @param basis the basis of the element
+     * @param numNodes number of quadrature nodes in every direction
+     * @return false if \a basis is not a tensor-product basis, in
+     * which case the kernels cannot be used
+     */
+    bool init(const gsBasis<T> & basis, const gsVector<index_t> & numNodes)
+    {
+        m_dim = 0;
+        const short_t d = basis.dim();
+        bool tensor = false;
+        switch (d)
+        {
+        case 1: tensor = (NULL != dynamic_cast<const gsTensorBasis<1,T>*>(&basis)); break;
+        case 2: tensor = (NULL != dynamic_cast<const gsTensorBasis<2,T>*>(&basis)); break;
+        case 3: tensor = (NULL != dynamic_cast<const gsTensorBasis<3,T>*>(&basis)); break;
+        case 4: tensor = (NULL != dynamic_cast<const gsTensorBasis<4,T>*>(&basis)); break;
+        default: break;
+        }
+        if ( !tensor || numNodes.size() != d )
+            return false;
+
+        m_dim = d;
+        m_comp.resize(d);
+        for (short_t k = 0; k != d; ++k)
+            m_comp[k] = &basis.component(k);
+        m_nq = numNodes;
+        m_ders.resize(d);
+        return true;
+    }
+
+    /// Returns true if the kernels were initialized successfully
+    bool enabled() const { return 0 != m_dim; }
+
+    /**
+     * @brief Evaluates the univariate functions (and first derivatives)
+     * on the element with tensor quadrature nodes \a quNodes
+     *
+     * @param quNodes the mapped quadrature nodes of the element
+     * @param[out] actives the active functions on the element, in the
+     *             ordering of the computed element matrices
+     */
+    void evaluate(const gsMatrix<T> & quNodes, gsMatrix<index_t> & actives)
+    {
+        GISMO_ASSERT( quNodes.cols() == m_nq.prod(), "Expecting a tensor rule with "
+                      << m_nq.transpose() << " nodes");
+        gsMatrix<T> nodes;
+        gsVector<index_t> str(m_dim), num(m_dim);
+        std::vector<gsMatrix<index_t> > cact(m_dim);
+        index_t stride = 1;
+        for (short_t k = 0; k != m_dim; ++k)
+        {
+            // The nodes in direction k are found with stride m_nq[0]*..*m_nq[k-1]
+            const index_t qs = ( 0 == k ? 1 : m_nq.head(k).prod() );
+            nodes.resize(1, m_nq[k]);
+            for (index_t q = 0; q != m_nq[k]; ++q)
+                nodes(0,q) = quNodes(k, q * qs);
+            m_comp[k]->evalAllDers_into(nodes, 1, m_ders[k]);
+            m_comp[k]->active_into(nodes.col(0), cact[k]);
+            num[k] = cact[k].rows();
+            str[k] = stride;
+            stride *= m_comp[k]->size();
+        }
+
+        // Tensor-product indices, first direction running fastest
+        actives.resize(num.prod(), 1);
+        gsVector<index_t> cur(m_dim);
+        cur.setZero();
+        index_t r = 0;
+        do
+        {
+            index_t ind = 0;
+            for (short_t k = 0; k != m_dim; ++k)
+                ind += str[k] * cact[k].at(cur[k]);
+            actives.at(r++) = ind;
+        }
+        while ( nextLexicographic(cur, num) );
+    }
+
+    /// Number of active functions on the element
+    index_t numActive() const
+    {
+        index_t n = 1;
+        for (short_t k = 0; k != m_dim; ++k)
+            n *= m_ders[k][0].rows();
+        return n;
+    }
+
+    /**
+     * @brief Computes \f$ M_{ij} = \sum_q c_q N_i(x_q) N_j(x_q) \f$
+     * @param coefs the values \f$c_q\f$ (e.g. weight times measure) as a row vector
+     * @param[out] localMat the element matrix
+     */
+    void mass(const gsMatrix<T> & coefs, gsMatrix<T> & localMat)
+    {
+        const index_t n = numActive();
+        localMat.setZero(n, n);
+        gsVector<short_t> alpha = gsVector<short_t>::Zero(m_dim);
+        addTerm(coefs.data(), alpha, alpha, localMat);
+    }
+
+    /**
+     * @brief Computes \f$ K_{ij} = \sum_q \sum_{a,b} C_{ab}(x_q)\,
+     * \partial_a N_i(x_q)\, \partial_b N_j(x_q) \f$
+     * @param coefs the symmetric \f$d\times d\f$ matrices \f$C(x_q)\f$, stored
+     *              column-wise in the columns of \a coefs
+     * @param[out] localMat the element matrix
+     */
+    void stiffness(const gsMatrix<T> & coefs, gsMatrix<T> & localMat)
+    {
+        GISMO_ASSERT( coefs.rows() == m_dim * m_dim, "Expecting d x d coefficients");
+        const index_t n = numActive();
+        localMat.setZero(n, n);
+        m_offd.setZero(n, n);
+        gsVector<short_t> alpha(m_dim), beta(m_dim);
+        gsMatrix<T> c;
+        // C is symmetric: the terms (a,b) and (b,a) are transposes
+        for (short_t a = 0; a != m_dim; ++a)
+            for (short_t b = a; b != m_dim; ++b)
+            {
+                alpha.setZero(); alpha[a] = 1;
+                beta .setZero(); beta [b] = 1;
+                if ( a == b )
+                {
+                    c = coefs.row(a * m_dim + a);
+                    addTerm(c.data(), alpha, beta, localMat);
+                }
+                else
+                {
+                    c = ( coefs.row(b * m_dim + a) + coefs.row(a * m_dim + b) ) / 2;
+                    addTerm(c.data(), alpha, beta, m_offd);
+                }
+            }
+        localMat += m_offd + m_offd.transpose();
+    }
+
+    /**
+     * @brief Computes \f$ F_{ir} = \sum_q N_i(x_q) f_r(x_q) \f$
+     * @param vals the values \f$f_r(x_q)\f$ (already multiplied by the
+     *             quadrature weights), one row per right-hand side
+     * @param[out] localRhs the element vector(s)
+     */
+    void moments(const gsMatrix<T> & vals, gsMatrix<T> & localRhs)
+    {
+        const index_t n = numActive();
+        localRhs.resize(n, vals.rows());
+        std::vector<const gsMatrix<T>*> A(m_dim);
+        for (short_t k = 0; k != m_dim; ++k)
+            A[k] = &m_ders[k][0];
+        gsMatrix<T> f;
+        for (index_t r = 0; r != vals.rows(); ++r)
+        {
+            f = vals.row(r).transpose();
+            contract(f, A);
+            localRhs.col(r) = f;
+        }
+    }
+
+    /**
+     * @brief Evaluates \f$ u(x_q) = \sum_i u_i\, \partial^\alpha N_i(x_q) \f$
+     * at the quadrature nodes, in \f$O(p^{d+1})\f$ operations
+     * @param u the coefficients of the active functions (one column)
+     * @param alpha the (parametric) derivative orders, zero or one in every direction
+     * @param[out] vals the values at the nodes, as a column
+     */
+    void interpolate(const gsMatrix<T> & u, const gsVector<short_t> & alpha,
+                     gsMatrix<T> & vals)
+    {
+        GISMO_ASSERT( u.rows() == numActive() && u.cols() == 1, "Invalid coefficients");
+        std::vector<const gsMatrix<T>*> A(m_dim);
+        for (short_t k = 0; k != m_dim; ++k)
+            A[k] = &m_ders[k][alpha[k]];
+        vals = u;
+        contract(vals, A, true);
+    }
+
+    /**
+     * @brief Adds \f$ \sum_q v_q\, \partial^\alpha N_i(x_q) \f$ to \a r,
+     * this is the transpose of interpolate()
+     * @param v the values at the nodes (already multiplied by the
+     *          quadrature weights), as a column
+     * @param alpha the (parametric) derivative orders
+     * @param[in,out] r the element vector
+     */
+    void integrate(const gsMatrix<T> & v, const gsVector<short_t> & alpha,
+                   gsMatrix<T> & r)
+    {
+        GISMO_ASSERT( v.rows() == m_nq.prod() && v.cols() == 1, "Invalid values");
+        std::vector<const gsMatrix<T>*> A(m_dim);
+        for (short_t k = 0; k != m_dim; ++k)
+            A[k] = &m_ders[k][alpha[k]];
+        m_tmp = v;
+        contract(m_tmp, A);
+        r += m_tmp;
+    }
+
+private:
+
+    // Adds the term with derivative orders alpha (test) and beta
+    // (trial) and point coefficients c to localMat
+    void addTerm(const T * c, const gsVector<short_t> & alpha,
+                 const gsVector<short_t> & beta, gsMatrix<T> & localMat)
+    {
+        // Univariate products A_k(i + n_k j, q) = B_i^(alpha_k)(q) B_j^(beta_k)(q)
+        m_prod.resize(m_dim);
+        std::vector<const gsMatrix<T>*> A(m_dim);
+        gsVector<index_t> num(m_dim), str(m_dim);
+        for (short_t k = 0; k != m_dim; ++k)
+        {
+            const gsMatrix<T> & Bi = m_ders[k][alpha[k]];
+            const gsMatrix<T> & Bj = m_ders[k][beta [k]];
+            const index_t n = num[k] = Bi.rows();
+            str[k] = ( 0 == k ? 1 : str[k-1] * num[k-1] );
+            m_prod[k].resize(n * n, m_nq[k]);
+            for (index_t q = 0; q != m_nq[k]; ++q)
+                for (index_t j = 0; j != n; ++j)
+                    m_prod[k].col(q).segment(j * n, n) = Bi.col(q) * Bj(j, q);
+            A[k] = &m_prod[k];
+        }
+
+        m_tmp = gsAsConstMatrix<T>(c, m_nq.prod(), 1);
+        contract(m_tmp, A);
+
+        // The result is indexed by (i_0,j_0,...,i_{d-1},j_{d-1}),
+        // first index running fastest
+        const index_t n0 = num[0];
+        gsVector<index_t> cur(m_dim-1), dims(m_dim-1);
+        for (short_t k = 1; k != m_dim; ++k)
+            dims[k-1] = num[k] * num[k];
+        cur.setZero();
+        const T * v = m_tmp.data();
+        do
+        {
+            index_t ib = 0, jb = 0;
+            for (short_t k = 1; k != m_dim; ++k)
+            {
+                ib += (cur[k-1] % num[k]) * str[k];
+                jb += (cur[k-1] / num[k]) * str[k];
+            }
+            for (index_t j = 0; j != n0; ++j)
+                for (index_t i = 0; i != n0; ++i)
+                    localMat(ib + i, jb + j) += *(v++);
+        }
+        while ( m_dim > 1 && nextLexicographic(cur, dims) );
+    }
+
+    // Contracts the tensor t(q_0,..,q_{d-1}) with the matrices
+    // A[k](p_k, q_k) (or with their transposes, if trans is true),
+    // first direction first. On output, t holds t(p_0,..,p_{d-1}),
+    // first index running fastest.
+    void contract(gsMatrix<T> & t, const std::vector<const gsMatrix<T>*> & A,
+                  const bool trans = false)
+    {
+        index_t Q = 1; // size of the already contracted directions
+        for (short_t k = 0; k != m_dim; ++k)
+        {
+            const gsMatrix<T> & Ak = *A[k];
+            const index_t nq = trans ? Ak.rows() : Ak.cols();
+            const index_t P  = trans ? Ak.cols() : Ak.rows();
+            index_t R = 1; // size of the remaining directions
+            for (short_t j = k+1; j != m_dim; ++j)
+                R *= trans ? A[j]->rows() : A[j]->cols();
+            m_work.resize(Q * P * R, 1);
+            if ( 1 == Q )
+            {
+                if (trans)
+                    gsAsMatrix<T>(m_work.data(), P, R).noalias() =
+                        Ak.transpose() * gsAsConstMatrix<T>(t.data(), nq, R);
+                else
+                    gsAsMatrix<T>(m_work.data(), P, R).noalias() =
+                        Ak * gsAsConstMatrix<T>(t.data(), nq, R);
+            }
+            else
+                for (index_t r = 0; r != R; ++r)
+                {
+                    if (trans)
+                        gsAsMatrix<T>(m_work.data() + Q * P * r, Q, P).noalias() =
+                            gsAsConstMatrix<T>(t.data() + Q * nq * r, Q, nq) * Ak;
+                    else
+                        gsAsMatrix<T>(m_work.data() + Q * P * r, Q, P).noalias() =
+                            gsAsConstMatrix<T>(t.data() + Q * nq * r, Q, nq) * Ak.transpose();
+                }
+            t.swap(m_work);
+            Q *= P;
+        }
+    }
+
+private:
+
+    short_t m_dim;
+
+    // Univariate component bases
+    std::vector<const gsBasis<T>*> m_comp;
+
+    // Number of quadrature nodes per direction
+    gsVector<index_t> m_nq;
+
+    // Univariate values and derivatives on the current element
+    std::vector<std::vector<gsMatrix<T> > > m_ders;
+
+    // Workspace
+    std::vector<gsMatrix<T> > m_prod;
+    gsMatrix<T> m_tmp, m_work, m_offd;
+};
+
+} // namespace gismo
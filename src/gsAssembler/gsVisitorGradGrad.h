@@ -68,6 +68,24 @@ public:
 
         // Set Geometry evaluation flags
         md.flags = NEED_MEASURE|NEED_GRAD_TRANSFORM;
+
+        // Compute only the lower triangular part, if requested
+        symmetric = options.askSwitch("Symmetric", false);
+
+        // Use sum factorization on tensor-product bases, if requested
+        sumFact = gsSumFactorization<T>();
+        if ( options.askSwitch("SumFactorization", false) )
+        {
+            const gsVector<index_t> nq = gsQuadrature::numNodes(
+                basis, options.getReal("quA"), options.getInt("quB") );
+            if ( nq.prod() == rule.numNodes() && sumFact.init(basis, nq) )
+                md.flags |= NEED_DERIV;
+        }
+
+        // Evaluation by Bezier extraction, see setBezierElement()
+        bezier = NULL;
+        bezRule = rule;
+        bezOrder = 1;
     }
 
 
@@ -78,13 +96,31 @@ public:
                          gsMatrix<T>            & quNodes)
     {
         md.points = quNodes;
-        // Compute the active basis functions
-        // Assumes actives are the same for all quadrature points on the current element
-        basis.active_into(md.points.col(0), actives);
-        const index_t numActive = actives.rows();
+        if ( sumFact.enabled() )
+        {
+            // Evaluate the univariate factors of the basis functions
+            sumFact.evaluate(md.points, actives);
+            geo.computeMap(md);
+            return;
+        }
+
+        if ( NULL != bezier )
+        {
+            // Evaluate the derivatives by the extraction operator
+            actives = bezier->actives(bezElement);
+            bezier->evalAllDers_into(bezElement, bernstein, 1, bezValues);
+            basisData.swap(bezValues[1]);
+        }
+        else
+        {
+            // Compute the active basis functions
+            // Assumes actives are the same for all quadrature points on the current element
+            basis.active_into(md.points.col(0), actives);
 
-        // Evaluate basis functions on element
-        basis.deriv_into(md.points, basisData);
+            // Evaluate basis functions on element
+            basis.deriv_into(md.points, basisData);
+        }
+        const index_t numActive = actives.rows();
 
         // Compute geometry related values
         geo.computeMap(md);
@@ -96,6 +132,38 @@ public:
     inline void assemble(gsDomainIterator<T>    & /*element*/,
                          gsVector<T> const      & quWeights)
     {
+        if ( sumFact.enabled() )
+        {
+            // Coefficients of the gradients at the quadrature nodes
+            const index_t d = md.dim.first;
+            basisData.resize(d * d, quWeights.rows());
+            for (index_t k = 0; k < quWeights.rows(); ++k)
+            {
+                const gsMatrix<T> jacInv = md.jacobian(k).cramerInverse();
+                gsAsMatrix<T>(basisData.col(k).data(), d, d).noalias() =
+                    (quWeights[k] * md.measure(k)) * jacInv * jacInv.transpose();
+            }
+            sumFact.stiffness(basisData, localMat);
+            return;
+        }
+
+        if ( symmetric && quWeights.minCoeff() >= 0 )
+        {
+            // Stack the physical gradients of all nodes, scaled by
+            // the square roots of the weights, and compute the lower
+            // triangular part of their product at once
+            const index_t d = md.dim.second;
+            stackedGrads.resize(localMat.rows(), d * quWeights.rows());
+            for (index_t k = 0; k < quWeights.rows(); ++k)
+            {
+                transformGradients(md, k, basisData, basisPhGrads);
+                stackedGrads.middleCols(k * d, d).noalias() =
+                    math::sqrt(quWeights[k] * md.measure(k)) * basisPhGrads.transpose();
+            }
+            Base::symmetricProduct(stackedGrads, localMat);
+            return;
+        }
+
         for (index_t k = 0; k < quWeights.rows(); ++k) // loop over quadrature nodes
         {
             // Multiply quadrature weight by the geometry measure
@@ -114,9 +182,17 @@ public:
 private:
 
     // Gradient values
-    gsMatrix<T>  basisPhGrads;
+    gsMatrix<T>  basisPhGrads, stackedGrads;
     using Base:: basisData;
+    using Base::symmetric;
     using Base::actives;
+    using Base::sumFact;
+    using Base::bezier;
+    using Base::bezRule;
+    using Base::bernstein;
+    using Base::bezValues;
+    using Base::bezOrder;
+    using Base::bezElement;
     
     // Local matrix
     using Base::localMat;
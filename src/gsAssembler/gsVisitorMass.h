@@ -13,6 +13,9 @@
 
 #pragma once
 
+#include <gsAssembler/gsSumFactorization.h>
+#include <gsAssembler/gsBezierExtraction.h>
+
 namespace gismo
 {
 /** 
@@ -28,14 +31,14 @@ class gsVisitorMass
 {
 public:
 
-    gsVisitorMass()
+    gsVisitorMass() : bezier(NULL)
     { }
 
     /** \brief Visitor for assembling the mass matrix
      *  
      * \f[ (u, v) \f]  
      */
-    gsVisitorMass(const gsPde<T> & pde)
+    gsVisitorMass(const gsPde<T> & pde) : bezier(NULL)
     { GISMO_UNUSED(pde); }
 
     void initialize(const gsBasis<T> & basis,
@@ -48,6 +51,37 @@ public:
 
         // Set Geometry evaluation flags
         md.flags = NEED_MEASURE;
+
+        // Compute only the lower triangular part, if requested
+        symmetric = options.askSwitch("Symmetric", false);
+
+        // Use sum factorization on tensor-product bases, if requested
+        sumFact = gsSumFactorization<T>();
+        if ( options.askSwitch("SumFactorization", false) )
+        {
+            const gsVector<index_t> nq = gsQuadrature::numNodes(
+                basis, options.getReal("quA"), options.getInt("quB") );
+            if ( nq.prod() == rule.numNodes() )
+                sumFact.init(basis, nq);
+        }
+
+        // Evaluation by Bezier extraction, see setBezierElement()
+        bezier = NULL;
+        bezRule = rule;
+        bezOrder = 0;
+    }
+
+    /// Evaluates the basis in the following call of evaluate() on
+    /// element \a e of the Bezier extraction operators \a be (see
+    /// the option BezierExtraction of gsAssembler)
+    void setBezierElement(const gsBezierExtraction<T> * be, index_t e)
+    {
+        if ( be != bezier )
+        {
+            bezier = be;
+            be->bernsteinTable(bezRule, bezOrder, bernstein);
+        }
+        bezElement = e;
     }
 
     // Evaluate on element.
@@ -57,13 +91,31 @@ public:
                          gsMatrix<T>            & quNodes)
     {
         md.points = quNodes;
-        // Compute the active basis functions
-        // Assumes actives are the same for all quadrature points on the current element
-        basis.active_into(md.points.col(0), actives);
-        const index_t numActive = actives.rows();
+        if ( sumFact.enabled() )
+        {
+            // Evaluate the univariate factors of the basis functions
+            sumFact.evaluate(md.points, actives);
+            geo.computeMap(md);
+            return;
+        }
+
+        if ( NULL != bezier )
+        {
+            // Evaluate basis functions by the extraction operator
+            actives = bezier->actives(bezElement);
+            bezier->evalAllDers_into(bezElement, bernstein, 0, bezValues);
+            basisData.swap(bezValues[0]);
+        }
+        else
+        {
+            // Compute the active basis functions
+            // Assumes actives are the same for all quadrature points on the current element
+            basis.active_into(md.points.col(0), actives);
 
-        // Evaluate basis functions on element
-        basis.eval_into(md.points, basisData);
+            // Evaluate basis functions on element
+            basis.eval_into(md.points, basisData);
+        }
+        const index_t numActive = actives.rows();
 
         // Compute geometry related values
         geo.computeMap(md);
@@ -72,14 +124,80 @@ public:
         localMat.setZero(numActive, numActive);
     }
 
+    /// @brief Evaluates the basis and the geometry at once on the
+    /// nodes \a quNodes of a chunk of elements, where the nodes of
+    /// element \a e are the columns \a ptOffset[e] to \a
+    /// ptOffset[e+1]-1. The elements are then selected by
+    /// setBlockElement() instead of evaluate().
+    ///
+    /// Returns false if the chunk can not be evaluated at once (see
+    /// gsFunctionSet::computeBlock), then evaluate() must be used on
+    /// every element
+    bool evaluateBlock(const gsBasis<T>       & basis,
+                       const gsGeometry<T>    & geo,
+                       const gsMatrix<T>      & quNodes,
+                       const gsVector<index_t>& ptOffset)
+    {
+        if ( sumFact.enabled() || NULL != bezier )
+            return false;
+
+        blkData.flags = NEED_ACTIVE | ( 0 == bezOrder ? NEED_VALUE : NEED_DERIV );
+        if ( !basis.computeBlock(quNodes, ptOffset, blkData) )
+            return false;
+
+        blkMd.flags  = md.flags;
+        blkMd.cache  = md.cache;
+        blkMd.points = quNodes;
+        geo.computeMap(blkMd);
+        blkOffset = ptOffset;
+        return true;
+    }
+
+    /// Takes the evaluations of element \a e of the chunk evaluated
+    /// by evaluateBlock()
+    void setBlockElement(const index_t e)
+    {
+        const index_t k0 = blkOffset[e], n = blkOffset[e+1] - k0;
+        actives   = blkData.actives.col(e);
+        basisData = blkData.values[bezOrder].middleCols(k0, n);
+        blkMd.middlePoints(k0, n, md);
+
+        // Initialize local matrix
+        localMat.setZero(actives.rows(), actives.rows());
+    }
+
     inline void assemble(gsDomainIterator<T>    & ,
                          gsVector<T> const      & quWeights)
     {
+        if ( sumFact.enabled() )
+        {
+            sumFact.mass(quWeights.transpose().cwiseProduct(md.measures), localMat);
+            return;
+        }
+
+        if ( symmetric && quWeights.minCoeff() >= 0 )
+        {
+            // Lower triangular part of B * W * B^T, with the square
+            // roots of the weights moved into B
+            basisData.array().rowwise() *=
+                (quWeights.array() * md.measures.row(0).transpose().array()).sqrt().transpose();
+            symmetricProduct(basisData, localMat);
+            return;
+        }
+
         localMat.noalias() = 
             basisData * quWeights.asDiagonal() * 
             md.measures.asDiagonal() * basisData.transpose();
     }
 
+    /// Adds \a B * \a B^T to the symmetric matrix \a result, computing
+    /// only its lower triangular part and mirroring it afterwards
+    static void symmetricProduct(const gsMatrix<T> & B, gsMatrix<T> & result)
+    {
+        result.template selfadjointView<Lower>().rankUpdate(B);
+        result.template triangularView<Eigen::StrictlyUpper>() = result.transpose();
+    }
+
     inline void localToGlobal(const index_t                     patchIndex,
                               const std::vector<gsMatrix<T> > & ,
                               gsSparseSystem<T>               & system)
@@ -136,8 +254,26 @@ public:
     }
 
 
+    /// The geometry evaluation data (cf. gsMapDataCache)
+    gsMapData<T> & mapData() { return md; }
+
 protected:
 
+    // Sum-factorized kernels
+    gsSumFactorization<T> sumFact;
+
+    // Bezier extraction operators (NULL if not used), the Bernstein
+    // polynomials and their derivatives up to bezOrder on the
+    // reference nodes of bezRule, and the element
+    const gsBezierExtraction<T> * bezier;
+    gsQuadRule<T> bezRule;
+    std::vector<gsMatrix<T> > bernstein, bezValues;
+    int bezOrder;
+    index_t bezElement;
+
+    // Compute only the lower triangular part of the local matrix
+    bool symmetric;
+
     // Basis values
     gsMatrix<T>      basisData;
     gsMatrix<index_t> actives;
@@ -146,6 +282,11 @@ protected:
     gsMatrix<T> localMat;
 
     gsMapData<T> md;
+
+    // Evaluations on a chunk of elements, see evaluateBlock()
+    gsFuncData<T> blkData;
+    gsMapData<T> blkMd;
+    gsVector<index_t> blkOffset;
 };
 
 
@@ -127,6 +127,9 @@ public:
         }
     }
 
+    /// The geometry evaluation data (cf. gsMapDataCache)
+    gsMapData<T> & mapData() { return md; }
+
 protected:
     // Right hand side
     const gsFunction<T> * rhs_ptr;
@@ -144,6 +144,9 @@ public:
         }
     }
 
+    /// The geometry evaluation data (cf. gsMapDataCache)
+    gsMapData<T> & mapData() { return md; }
+
 protected:
 
     
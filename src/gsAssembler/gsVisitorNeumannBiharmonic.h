@@ -146,6 +146,9 @@ public:
     }
     */
 
+    /// The geometry evaluation data (cf. gsMapDataCache)
+    gsMapData<T> & mapData() { return md; }
+
 protected:
 
     
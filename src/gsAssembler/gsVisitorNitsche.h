@@ -180,6 +180,9 @@ public:
 
     }
 
+    /// The geometry evaluation data (cf. gsMapDataCache)
+    gsMapData<T> & mapData() { return md; }
+
 private:
     // Dirichlet function
     const gsFunction<T> * dirdata_ptr;
@@ -14,6 +14,8 @@
 #pragma once
 
 #include <gsAssembler/gsQuadrature.h>
+#include <gsAssembler/gsSumFactorization.h>
+#include <gsAssembler/gsBezierExtraction.h>
 
 namespace gismo
 {
@@ -33,7 +35,7 @@ public:
 
     /** \brief Constructor for gsVisitorPoisson.
      */
-    gsVisitorPoisson(const gsPde<T> & pde)
+    gsVisitorPoisson(const gsPde<T> & pde) : bezier(NULL)
     { 
         pde_ptr = static_cast<const gsPoissonPde<T>*>(&pde);
     }
@@ -51,6 +53,36 @@ public:
 
         // Set Geometry evaluation flags
         md.flags = NEED_VALUE | NEED_MEASURE | NEED_GRAD_TRANSFORM;
+
+        // Compute only the lower triangular part, if requested
+        symmetric = options.askSwitch("Symmetric", false);
+
+        // Use sum factorization on tensor-product bases, if requested
+        sumFact = gsSumFactorization<T>();
+        if ( options.askSwitch("SumFactorization", false) )
+        {
+            const gsVector<index_t> nq = gsQuadrature::numNodes(
+                basis, options.getReal("quA"), options.getInt("quB") );
+            if ( nq.prod() == rule.numNodes() && sumFact.init(basis, nq) )
+                md.flags |= NEED_DERIV;
+        }
+
+        // Evaluation by Bezier extraction, see setBezierElement()
+        bezier = NULL;
+        bezRule = rule;
+    }
+
+    /// Evaluates the basis in the following call of evaluate() on
+    /// element \a e of the Bezier extraction operators \a be (see
+    /// the option BezierExtraction of gsAssembler)
+    void setBezierElement(const gsBezierExtraction<T> * be, index_t e)
+    {
+        if ( be != bezier )
+        {
+            bezier = be;
+            be->bernsteinTable(bezRule, 1, bernstein);
+        }
+        bezElement = e;
     }
 
     // Evaluate on element.
@@ -59,13 +91,29 @@ public:
                          const gsMatrix<T>      & quNodes)
     {
         md.points = quNodes;
-        // Compute the active basis functions
-        // Assumes actives are the same for all quadrature points on the elements
-        basis.active_into(md.points.col(0), actives);
-        numActive = actives.rows();
-        
-        // Evaluate basis functions on element
-        basis.evalAllDers_into( md.points, 1, basisData);
+        if ( sumFact.enabled() )
+        {
+            // Evaluate the univariate factors of the basis functions
+            sumFact.evaluate(md.points, actives);
+            numActive = actives.rows();
+        }
+        else if ( NULL != bezier )
+        {
+            // Evaluate basis functions by the extraction operator
+            actives = bezier->actives(bezElement);
+            numActive = actives.rows();
+            bezier->evalAllDers_into(bezElement, bernstein, 1, basisData);
+        }
+        else
+        {
+            // Compute the active basis functions
+            // Assumes actives are the same for all quadrature points on the elements
+            basis.active_into(md.points.col(0), actives);
+            numActive = actives.rows();
+
+            // Evaluate basis functions on element
+            basis.evalAllDers_into( md.points, 1, basisData);
+        }
         
         // Compute image of Gauss nodes under geometry mapping as well as Jacobians
         geo.computeMap(md);
@@ -79,13 +127,99 @@ public:
         localMat.setZero(numActive, numActive      );
         localRhs.setZero(numActive, rhsVals.rows() );//multiple right-hand sides
     }
+
+    /// @brief Evaluates the basis, the geometry and the right-hand
+    /// side at once on the nodes \a quNodes of a chunk of elements,
+    /// where the nodes of element \a e are the columns \a ptOffset[e]
+    /// to \a ptOffset[e+1]-1. The elements are then selected by
+    /// setBlockElement() instead of evaluate().
+    ///
+    /// Returns false if the chunk can not be evaluated at once (see
+    /// gsFunctionSet::computeBlock), then evaluate() must be used on
+    /// every element
+    bool evaluateBlock(const gsBasis<T>       & basis,
+                       const gsGeometry<T>    & geo,
+                       const gsMatrix<T>      & quNodes,
+                       const gsVector<index_t>& ptOffset)
+    {
+        if ( sumFact.enabled() || NULL != bezier )
+            return false;
+
+        blkData.flags = NEED_ACTIVE | NEED_VALUE | NEED_DERIV;
+        if ( !basis.computeBlock(quNodes, ptOffset, blkData) )
+            return false;
+
+        blkMd.flags  = md.flags;
+        blkMd.cache  = md.cache;
+        blkMd.points = quNodes;
+        geo.computeMap(blkMd);
+        rhs_ptr->eval_into( (paramCoef ?  blkMd.points :  blkMd.values[0] ), blkRhsVals );
+        blkOffset = ptOffset;
+        return true;
+    }
+
+    /// Takes the evaluations of element \a e of the chunk evaluated
+    /// by evaluateBlock()
+    void setBlockElement(const index_t e)
+    {
+        const index_t k0 = blkOffset[e], n = blkOffset[e+1] - k0;
+        actives   = blkData.actives.col(e);
+        numActive = actives.rows();
+        basisData.resize(2);
+        basisData[0] = blkData.values[0].middleCols(k0, n);
+        basisData[1] = blkData.values[1].middleCols(k0, n);
+        blkMd.middlePoints(k0, n, md);
+        rhsVals = blkRhsVals.middleCols(k0, n);
+
+        // Initialize local matrix/rhs
+        localMat.setZero(numActive, numActive      );
+        localRhs.setZero(numActive, rhsVals.rows() );
+    }
     
     inline void assemble(gsDomainIterator<T>    & ,
                          gsVector<T> const      & quWeights)
     {
+        if ( sumFact.enabled() )
+        {
+            // Coefficients of the gradients at the quadrature nodes
+            const index_t d = md.dim.first;
+            sfCoefs.resize(d * d, quWeights.rows());
+            for (index_t k = 0; k < quWeights.rows(); ++k)
+            {
+                const T weight = quWeights[k] * md.measure(k);
+                const gsMatrix<T> jacInv = md.jacobian(k).cramerInverse();
+                gsAsMatrix<T>(sfCoefs.col(k).data(), d, d).noalias() =
+                    weight * jacInv * jacInv.transpose();
+                rhsVals.col(k) *= weight;
+            }
+            sumFact.stiffness(sfCoefs, localMat);
+            sumFact.moments(rhsVals, localRhs);
+            return;
+        }
+
         gsMatrix<T> & bVals  = basisData[0];
         gsMatrix<T> & bGrads = basisData[1];
 
+        if ( symmetric && quWeights.minCoeff() >= 0 )
+        {
+            // Stack the physical gradients of all nodes, scaled by
+            // the square roots of the weights, and compute the lower
+            // triangular part of their product at once
+            const index_t d = md.dim.second;
+            stackedGrads.resize(numActive, d * quWeights.rows());
+            for (index_t k = 0; k < quWeights.rows(); ++k)
+            {
+                const T weight = quWeights[k] * md.measure(k);
+                transformGradients(md, k, bGrads, physGrad);
+                stackedGrads.middleCols(k * d, d).noalias() =
+                    math::sqrt(weight) * physGrad.transpose();
+                localRhs.noalias() += weight * ( bVals.col(k) * rhsVals.col(k).transpose() ) ;
+            }
+            localMat.template selfadjointView<Lower>().rankUpdate(stackedGrads);
+            localMat.template triangularView<Eigen::StrictlyUpper>() = localMat.transpose();
+            return;
+        }
+
         for (index_t k = 0; k < quWeights.rows(); ++k) // loop over quadrature nodes
         {
             // Multiply weight by the geometry measure
@@ -110,14 +244,31 @@ public:
         system.push(localMat, localRhs, actives, eliminatedDofs.front(), 0, 0);
     }
 
+    /// The geometry evaluation data (cf. gsMapDataCache)
+    gsMapData<T> & mapData() { return md; }
+
 protected:
     // Pointer to the pde data
     const gsPoissonPde<T> * pde_ptr;
     
 protected:
+    // Sum-factorized kernels and their coefficients
+    gsSumFactorization<T> sumFact;
+    gsMatrix<T> sfCoefs;
+
+    // Bezier extraction operators (NULL if not used), the Bernstein
+    // polynomials on the reference nodes of bezRule and the element
+    const gsBezierExtraction<T> * bezier;
+    gsQuadRule<T> bezRule;
+    std::vector<gsMatrix<T> > bernstein;
+    index_t bezElement;
+
+    // Compute only the lower triangular part of the local matrix
+    bool symmetric;
+
     // Basis values
     std::vector<gsMatrix<T> > basisData;
-    gsMatrix<T>        physGrad;
+    gsMatrix<T>        physGrad, stackedGrads;
     gsMatrix<index_t> actives;
     index_t numActive;
 
@@ -134,6 +285,12 @@ protected:
     gsMatrix<T> localRhs;
 
     gsMapData<T> md;
+
+    // Evaluations on a chunk of elements, see evaluateBlock()
+    gsFuncData<T> blkData;
+    gsMapData<T> blkMd;
+    gsMatrix<T> blkRhsVals;
+    gsVector<index_t> blkOffset;
 };
 
 
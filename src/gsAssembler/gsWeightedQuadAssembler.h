@@ -0,0 +1,270 @@
+/** @file gsWeightedQuadAssembler.h
+
+    @brief Row-wise assembly of mass and stiffness matrices by
+    weighted quadrature
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsDofMapper.h>
+#include <gsTensor/gsTensorBasis.h>
+#include <gsUtils/gsPointGrid.h>
+#include <gsAssembler/gsWeightedQuadRule.h>
+
+namespace gismo
+{
+
+/**
+    @brief Assembles the mass matrix \f$(u,v)_\Omega\f$ and the
+    stiffness matrix \f$(\nabla u,\nabla v)_\Omega\f$ on tensor-product
+    B-spline patches by weighted quadrature
+
+    The geometry coefficients are evaluated once on the tensor grid
+    of the nodes of the univariate gsWeightedQuadRule's, about \f$2^d\f$
+    points per element. The matrix is then computed row by row: the
+    entries coupling a test function with all trial functions are
+    obtained by contracting the coefficients on the support of the
+    test function with the weighted univariate trial functions, one
+    direction at a time. This costs \f$O(p^{d+1})\f$ operations per
+    row, compared with \f$O(p^{2d})\f$ per row of the element-wise
+    Gauss assembly, so high degrees become affordable.
+
+    The rule is exact for constant coefficients (affine geometries)
+    and otherwise has the approximation order of the spline space.
+    Since test and trial functions are treated differently, the
+    assembled matrices are not exactly symmetric.
+
+    Rows and columns are numbered by the given gsDofMapper (only free
+    DoFs are assembled). Using the mapper of a gsExprAssembler space
+    the matrices replace the ones assembled from the expressions
+    <tt>u * u.tr() * meas(G)</tt> and
+    <tt>igrad(u,G) * igrad(u,G).tr() * meas(G)</tt>.
+
+    \ingroup Assembler
+*/
+template<class T>
+class gsWeightedQuadAssembler
+{
+public:
+
+    /**
+     * @brief Constructor
+     * @param patches the computational domain
+     * @param bases tensor-product B-spline bases, one per patch
+     * @param mapper the numbering of the degrees of freedom, must be finalized
+     */
+    gsWeightedQuadAssembler(const gsMultiPatch<T> & patches,
+                            const gsMultiBasis<T> & bases,
+                            const gsDofMapper & mapper)
+    : m_patches(patches), m_bases(bases), m_mapper(mapper)
+    {
+        GISMO_ASSERT( m_mapper.isFinalized(), "The DoF mapper must be finalized");
+        GISMO_ASSERT( m_patches.nPatches() == m_bases.nBases(),
+                      "The number of patches and bases differ");
+
+        // The univariate rules are shared by all matrices
+        m_rules.resize(m_bases.nBases());
+        for (size_t p = 0; p != m_bases.nBases(); ++p)
+        {
+            const gsBasis<T> & basis = m_bases[p];
+            index_t size = 1;
+            for (short_t k = 0; k != basis.dim(); ++k)
+            {
+                const gsBSplineBasis<T> * comp =
+                    dynamic_cast<const gsBSplineBasis<T>*>(&basis.component(k));
+                GISMO_ENSURE( NULL != comp, "Weighted quadrature needs tensor-product B-spline bases");
+                m_rules[p].push_back( memory::make_shared(new gsWeightedQuadRule<T>(*comp)) );
+                size *= comp->size();
+            }
+            GISMO_ENSURE( size == basis.size(), "Weighted quadrature needs tensor-product B-spline bases");
+        }
+    }
+
+    /// Assembles the mass matrix into \a mat
+    void assembleMass(gsSparseMatrix<T> & mat) const { assemble(false, mat); }
+
+    /// Assembles the stiffness matrix into \a mat
+    void assembleStiffness(gsSparseMatrix<T> & mat) const { assemble(true, mat); }
+
+private:
+
+    void assemble(const bool stiff, gsSparseMatrix<T> & mat) const
+    {
+        gsSparseEntries<T> entries;
+        for (size_t p = 0; p != m_patches.nPatches(); ++p)
+            assemblePatch(stiff, p, entries);
+
+        mat.resize(m_mapper.freeSize(), m_mapper.freeSize());
+        mat.setFrom(entries);
+        mat.makeCompressed();
+    }
+
+    void assemblePatch(const bool stiff, const size_t p, gsSparseEntries<T> & entries) const
+    {
+        const gsBasis<T> & basis = m_bases[p];
+        const short_t d = basis.dim();
+
+        const std::vector<memory::shared_ptr<gsWeightedQuadRule<T> > > & rule = m_rules[p];
+        std::vector<gsVector<T> > cwise(d);
+        gsVector<index_t> num(d), str(d), nqs(d), qstr(d);
+        for (short_t k = 0; k != d; ++k)
+        {
+            cwise[k] = rule[k]->nodes();
+            num[k]  = rule[k]->size();
+            nqs[k]  = rule[k]->numNodes();
+            str[k]  = ( 0 == k ? 1 : str [k-1] * num[k-1] );
+            qstr[k] = ( 0 == k ? 1 : qstr[k-1] * nqs[k-1] );
+        }
+
+        // Geometry coefficients on the node grid
+        gsMapData<T> md;
+        md.flags = NEED_MEASURE | (stiff ? NEED_DERIV : 0);
+        gsPointGrid(cwise, md.points);
+        m_patches.patch(p).computeMap(md);
+        const index_t nt = stiff ? d * d : 1;
+        gsMatrix<T> coefs(nt, md.points.cols());
+        for (index_t q = 0; q != coefs.cols(); ++q)
+        {
+            if ( stiff )
+            {
+                const gsMatrix<T> jacInv = md.jacobian(q).cramerInverse();
+                gsAsMatrix<T>(coefs.col(q).data(), d, d).noalias() =
+                    md.measure(q) * jacInv * jacInv.transpose();
+            }
+            else
+                coefs(0,q) = md.measure(q);
+        }
+
+#pragma omp parallel
+{
+        gsSparseEntries<T> myEntries;
+        std::vector<gsMatrix<T> > M(d);
+        std::vector<const gsMatrix<T>*> A(d);
+        for (short_t k = 0; k != d; ++k)
+            A[k] = &M[k];
+        gsVector<index_t> ti(d), jb(d), nj(d), qb(d), nq(d), cur(d);
+        gsVector<short_t> alpha(d), beta(d);
+        gsMatrix<T> t, work, row;
+
+#       pragma omp for schedule(dynamic, 64)
+        for (index_t i = 0; i < basis.size(); ++i)
+        {
+            if ( !m_mapper.is_free(i, p) ) continue;
+
+            // Tensor index, support and trial range of the test function
+            index_t r = i;
+            for (short_t k = 0; k != d; ++k)
+            {
+                ti[k] = r % num[k];
+                r /= num[k];
+                qb[k] = rule[k]->firstNode(ti[k]);
+                nq[k] = rule[k]->numNodes(ti[k]);
+                jb[k] = rule[k]->firstTrial(ti[k]);
+                nj[k] = rule[k]->lastTrial(ti[k]) - jb[k];
+            }
+
+            row.setZero(nj.prod(), 1);
+            for (index_t term = 0; term != nt; ++term)
+            {
+                alpha.setZero(); beta.setZero();
+                if ( stiff )
+                {
+                    alpha[term % d] = 1; // test
+                    beta [term / d] = 1; // trial
+                }
+
+                // Weighted trial functions M_k(j, q) = w_{i,q} B_j(x_q)
+                for (short_t k = 0; k != d; ++k)
+                {
+                    const T * w = rule[k]->weights(ti[k], alpha[k], beta[k]);
+                    M[k].resize(nj[k], nq[k]);
+                    for (index_t q = 0; q != nq[k]; ++q)
+                        for (index_t j = 0; j != nj[k]; ++j)
+                            M[k](j,q) = w[q] * rule[k]->value(jb[k] + j, qb[k] + q, beta[k]);
+                }
+
+                // Coefficients on the support of the test function
+                t.resize(nq.prod(), 1);
+                cur.setZero();
+                index_t s = 0;
+                do
+                {
+                    index_t q = 0;
+                    for (short_t k = 0; k != d; ++k)
+                        q += (qb[k] + cur[k]) * qstr[k];
+                    t(s++, 0) = coefs(term, q);
+                }
+                while ( nextLexicographic(cur, nq) );
+
+                contract(t, A, work);
+                row += t;
+            }
+
+            // Scatter the row
+            const index_t ii = m_mapper.index(i, p);
+            cur.setZero();
+            index_t s = 0;
+            do
+            {
+                const T val = row(s++, 0);
+                if ( 0 == val ) continue;
+                index_t j = 0;
+                for (short_t k = 0; k != d; ++k)
+                    j += (jb[k] + cur[k]) * str[k];
+                if ( m_mapper.is_free(j, p) )
+                    myEntries.add(ii, m_mapper.index(j, p), val);
+            }
+            while ( nextLexicographic(cur, nj) );
+        }
+
+#       pragma omp critical (gsWeightedQuadAssembler_entries)
+        entries.insert(entries.end(), myEntries.begin(), myEntries.end());
+}//omp parallel
+    }
+
+    // Contracts the tensor t(q_0,..,q_{d-1}) with the matrices
+    // A[k](j_k, q_k), first direction first, cf. gsSumFactorization
+    static void contract(gsMatrix<T> & t, const std::vector<const gsMatrix<T>*> & A,
+                         gsMatrix<T> & work)
+    {
+        const short_t d = A.size();
+        index_t Q = 1; // size of the already contracted directions
+        for (short_t k = 0; k != d; ++k)
+        {
+            const gsMatrix<T> & Ak = *A[k];
+            const index_t nq = Ak.cols(), P = Ak.rows();
+            index_t R = 1;
+            for (short_t j = k+1; j != d; ++j)
+                R *= A[j]->cols();
+            work.resize(Q * P * R, 1);
+            if ( 1 == Q )
+                gsAsMatrix<T>(work.data(), P, R).noalias() =
+                    Ak * gsAsConstMatrix<T>(t.data(), nq, R);
+            else
+                for (index_t r = 0; r != R; ++r)
+                    gsAsMatrix<T>(work.data() + Q * P * r, Q, P).noalias() =
+                        gsAsConstMatrix<T>(t.data() + Q * nq * r, Q, nq) * Ak.transpose();
+            t.swap(work);
+            Q *= P;
+        }
+    }
+
+private:
+
+    const gsMultiPatch<T> & m_patches;
+
+    const gsMultiBasis<T> & m_bases;
+
+    const gsDofMapper & m_mapper;
+
+    // Univariate rules of every patch and direction
+    std::vector<std::vector<memory::shared_ptr<gsWeightedQuadRule<T> > > > m_rules;
+};
+
+} // namespace gismo
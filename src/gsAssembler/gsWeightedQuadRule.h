@@ -0,0 +1,216 @@
+/** @file gsWeightedQuadRule.h
+
+    @brief Weighted quadrature rules for univariate B-spline bases
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsNurbs/gsBSplineBasis.h>
+#include <gsAssembler/gsGaussRule.h>
+
+namespace gismo
+{
+
+/**
+    @brief Weighted quadrature rule for a univariate B-spline basis
+
+    In contrast to gsQuadRule, the quadrature weights depend on the
+    test function: for every basis function \f$B_i\f$ and derivative
+    orders \f$a, b \in \{0,1\}\f$ the rule provides weights
+    \f$w^{ab}_{i,q}\f$ on the nodes \f$x_q\f$ in the support of
+    \f$B_i\f$, such that
+    \f[ \sum_q w^{ab}_{i,q}\, c(x_q)\, B_j^{(b)}(x_q) \approx
+    \int c\, B_i^{(a)} B_j^{(b)} \,\mathrm{d}x \f]
+    holds exactly for constant \f$c\f$ and all \f$j\f$.
+
+    The nodes are global: the end points and the midpoint of every
+    element, and \f$p+1\f$ equidistant points on the first and the
+    last \f$p\f$ elements. This gives about two nodes per element
+    instead of the \f$p+1\f$ of a Gauss rule, and an element matrix
+    row is obtained by a single pass over the nodes in the support of
+    the test function (see gsWeightedQuadAssembler).
+
+    The weights are computed once, as minimum-norm least-squares
+    solutions of the exactness conditions, with the exact integrals
+    given by a Gauss rule with \f$p+1\f$ nodes per element. The
+    basis has to be continuous, i.e. the interior knots have
+    multiplicity at most \f$p\f$.
+
+    \ingroup Assembler
+*/
+template<class T>
+class gsWeightedQuadRule
+{
+public:
+
+    /// Computes the nodes and the weights for \a basis
+    explicit gsWeightedQuadRule(const gsBSplineBasis<T> & basis)
+    { compute(basis); }
+
+    /// Number of nodes
+    index_t numNodes() const { return m_nodes.size(); }
+
+    /// Number of basis functions
+    index_t size() const { return m_first.size(); }
+
+    /// The nodes, in increasing order
+    const gsVector<T> & nodes() const { return m_nodes; }
+
+    /// Index of the first node in the support of basis function \a i
+    index_t firstNode(const index_t i) const { return m_first[i]; }
+
+    /// Number of nodes in the support of basis function \a i
+    index_t numNodes(const index_t i) const { return m_ptr[i+1] - m_ptr[i]; }
+
+    /// First basis function whose support can overlap the support
+    /// of basis function \a i
+    index_t firstTrial(const index_t i) const { return std::max(i - m_deg, (index_t)0); }
+
+    /// One past the last basis function whose support can overlap
+    /// the support of basis function \a i
+    index_t lastTrial(const index_t i) const { return std::min(i + m_deg + 1, size()); }
+
+    /// The values (\a b = 0) or derivatives (\a b = 1) of basis
+    /// function \a i at the nodes of its support
+    const T * values(const index_t i, const short_t b) const
+    { return m_vals[b].data() + m_ptr[i]; }
+
+    /// The weights \f$w^{ab}_{i,q}\f$ of test function \a i, for the
+    /// nodes of its support
+    const T * weights(const index_t i, const short_t a, const short_t b) const
+    { return m_wgts[2*a+b].data() + m_ptr[i]; }
+
+    /// Value (\a b = 0) or derivative (\a b = 1) of basis function
+    /// \a j at node \a q
+    T value(const index_t j, const index_t q, const short_t b) const
+    {
+        const index_t k = q - m_first[j];
+        return ( k >= 0 && k < numNodes(j) ) ? m_vals[b][m_ptr[j] + k] : T(0);
+    }
+
+private:
+
+    void compute(const gsBSplineBasis<T> & basis)
+    {
+        const gsKnotVector<T> & kv = basis.knots();
+        m_deg = basis.degree();
+        const index_t n = basis.size();
+        const std::vector<T> br = kv.breaks();
+        const index_t ne = br.size() - 1;
+        for (index_t e = 1; e < ne; ++e)
+            GISMO_ENSURE( kv.multiplicity(br[e]) <= m_deg,
+                          "Weighted quadrature requires a continuous basis");
+
+        // Nodes: end points and midpoints, p+1 points on the boundary elements
+        std::vector<T> nodes(1, br.front());
+        for (index_t e = 0; e != ne; ++e)
+        {
+            const index_t m = ( e < m_deg || e >= ne - m_deg ) ? m_deg : 2;
+            for (index_t k = 1; k <= m; ++k)
+                nodes.push_back( br[e] + (br[e+1] - br[e]) * k / m );
+        }
+        m_nodes = gsAsConstVector<T>(nodes.data(), nodes.size());
+        const index_t nq = nodes.size();
+
+        // Nodes in the closed support of every function
+        m_first.resize(n);
+        m_ptr.resize(n+1);
+        m_ptr[0] = 0;
+        for (index_t i = 0; i != n; ++i)
+        {
+            m_first[i] = std::lower_bound(nodes.begin(), nodes.end(), kv[i]) - nodes.begin();
+            const index_t last = std::upper_bound(nodes.begin(), nodes.end(), kv[i+m_deg+1])
+                - nodes.begin();
+            m_ptr[i+1] = m_ptr[i] + last - m_first[i];
+        }
+
+        // Values and derivatives at the nodes
+        std::vector<gsMatrix<T> > ders;
+        gsMatrix<index_t> act;
+        basis.evalAllDers_into(m_nodes.transpose(), 1, ders);
+        basis.active_into(m_nodes.transpose(), act);
+        for (short_t b = 0; b != 2; ++b)
+            m_vals[b].setZero(m_ptr[n]);
+        for (index_t q = 0; q != nq; ++q)
+            for (index_t k = 0; k != act.rows(); ++k)
+            {
+                const index_t j = act(k,q);
+                const index_t s = q - m_first[j];
+                if ( s >= 0 && s < numNodes(j) )
+                    for (short_t b = 0; b != 2; ++b)
+                        m_vals[b][m_ptr[j] + s] = ders[b](k,q);
+            }
+
+        // Exact integrals I^{ab}(i, j) = int B_i^(a) B_j^(b), stored
+        // as a band: column j - i + p
+        gsMatrix<T> I[4];
+        for (short_t ab = 0; ab != 4; ++ab)
+            I[ab].setZero(n, 2 * m_deg + 1);
+        gsGaussRule<T> gauss(m_deg + 1);
+        gsMatrix<T> gNodes;
+        gsVector<T> gWeights;
+        for (index_t e = 0; e != ne; ++e)
+        {
+            gauss.mapTo(br[e], br[e+1], gNodes, gWeights);
+            basis.evalAllDers_into(gNodes, 1, ders);
+            basis.active_into(gNodes.col(0), act);
+            for (index_t g = 0; g != gWeights.size(); ++g)
+                for (short_t a = 0; a != 2; ++a)
+                    for (short_t b = 0; b != 2; ++b)
+                        for (index_t ki = 0; ki != act.rows(); ++ki)
+                            for (index_t kj = 0; kj != act.rows(); ++kj)
+                                I[2*a+b](act(ki,0), act(kj,0) - act(ki,0) + m_deg) +=
+                                    gWeights[g] * ders[a](ki,g) * ders[b](kj,g);
+        }
+
+        // Weights: minimum-norm least-squares solutions of the
+        // exactness conditions. The trial functions are the rows, so
+        // the matrix has more rows than columns if the support of the
+        // test function contains only few nodes (e.g. at repeated
+        // knots); the derivatives (b = 1) are linearly dependent
+        gsMatrix<T> A, rhs;
+        for (short_t ab = 0; ab != 4; ++ab)
+            m_wgts[ab].resize(m_ptr[n]);
+        for (index_t i = 0; i != n; ++i)
+        {
+            const index_t jb = firstTrial(i), nj = lastTrial(i) - jb, ni = numNodes(i);
+            for (short_t b = 0; b != 2; ++b)
+            {
+                A.resize(nj, ni);
+                for (index_t j = 0; j != nj; ++j)
+                    for (index_t q = 0; q != ni; ++q)
+                        A(j,q) = value(jb + j, m_first[i] + q, b);
+                const Eigen::JacobiSVD<typename gsMatrix<T>::Base>
+                    svd(A, Eigen::ComputeThinU | Eigen::ComputeThinV);
+                for (short_t a = 0; a != 2; ++a)
+                {
+                    rhs = I[2*a+b].row(i).segment(jb - i + m_deg, nj).transpose();
+                    gsAsVector<T>(m_wgts[2*a+b].data() + m_ptr[i], ni) = svd.solve(rhs);
+                }
+            }
+        }
+    }
+
+private:
+
+    index_t m_deg;
+
+    gsVector<T> m_nodes;
+
+    // First node of every support, offsets into the value/weight arrays
+    std::vector<index_t> m_first, m_ptr;
+
+    // Values and derivatives of the functions on their supports
+    gsVector<T> m_vals[2];
+
+    // Weights w^{ab}, index 2*a+b
+    gsVector<T> m_wgts[4];
+};
+
+} // namespace gismo
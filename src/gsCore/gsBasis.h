@@ -677,6 +677,32 @@ public:
     virtual void evalAllDers_into(const gsMatrix<T> & u, int n,
                                   std::vector<gsMatrix<T> >& result) const;
 
+    /** @brief Evaluate the nonzero basis functions and their
+     derivatives up to order \a n on a Cartesian grid of points.
+
+     The points are the ones of gsPointGrid(\a grid), i.e., the tensor
+     product of the coordinates \a grid[i] in direction \a i, the
+     first direction running fastest. The format of \a result is the
+     one of evalAllDers_into(). The default implementation evaluates
+     at all points of the grid; tensor-product bases evaluate their
+     univariate factors only on the coordinates of every direction.
+    */
+    virtual void evalAllDersGrid_into(const std::vector<gsVector<T> > & grid, int n,
+                                      std::vector<gsMatrix<T> >& result) const;
+
+    /// @brief Returns the indices of the active basis functions at
+    /// the points of the Cartesian grid \a grid (see
+    /// evalAllDersGrid_into()) in the format of active_into().
+    virtual void activeGrid_into(const std::vector<gsVector<T> > & grid,
+                                 gsMatrix<index_t>& result) const;
+
+    /// @brief Evaluates the function described by \a coefs at the
+    /// points of the Cartesian grid \a grid (see
+    /// evalAllDersGrid_into()) in the format of evalFunc_into().
+    void evalGridFunc_into(const std::vector<gsVector<T> > & grid,
+                           const gsMatrix<T> & coefs,
+                           gsMatrix<T>& result) const;
+
     /// @brief Evaluate the basis function \a i and its derivatives up
     /// to order \a n at points \a u into \a result.
     virtual void evalAllDersSingle_into(index_t i, const gsMatrix<T> & u,
@@ -17,6 +17,7 @@
 #include <gsCore/gsDomainIterator.h>
 #include <gsCore/gsBoundary.h>
 #include <gsCore/gsGeometry.h>
+#include <gsUtils/gsPointGrid.h>
 
 namespace gismo
 {
@@ -488,6 +489,37 @@ void gsBasis<T>::evalAllDers_into(const gsMatrix<T> & u, int n,
     }
 }
 
+
+template<class T>
+void gsBasis<T>::evalAllDersGrid_into(const std::vector<gsVector<T> > & grid, int n,
+                                      std::vector<gsMatrix<T> >& result) const
+{
+    gsMatrix<T> pts;
+    gsPointGrid(grid, pts);
+    this->evalAllDers_into(pts, n, result);
+}
+
+template<class T>
+void gsBasis<T>::activeGrid_into(const std::vector<gsVector<T> > & grid,
+                                 gsMatrix<index_t>& result) const
+{
+    gsMatrix<T> pts;
+    gsPointGrid(grid, pts);
+    this->active_into(pts, result);
+}
+
+template<class T>
+void gsBasis<T>::evalGridFunc_into(const std::vector<gsVector<T> > & grid,
+                                   const gsMatrix<T> & coefs,
+                                   gsMatrix<T>& result) const
+{
+    std::vector<gsMatrix<T> > B;
+    gsMatrix<index_t> actives;
+    this->evalAllDersGrid_into(grid, 0, B);
+    this->activeGrid_into(grid, actives);
+    linearCombination_into( coefs, actives, B[0], result );
+}
+
 template<class T>
 void gsBasis<T>::evalAllDersSingle_into(index_t, const gsMatrix<T> &,
                                         int, gsMatrix<T>&) const
@@ -115,6 +115,7 @@ template <short_t d, class T=real_t>     class gsTensorBasis;
 template <short_t d, class T=real_t>     class gsHTensorBasis;
 
 template <class T=real_t>                class gsKnotVector;
+template <class T=real_t>                class gsKnotLocator;
 //template <class T=real_t>              class gsCompactKnotVector;
 template <class T=real_t>                class gsBSplineBasis;
 template <class T=real_t>                class gsNurbsBasis;
@@ -21,6 +21,7 @@ namespace gismo
 {
 
 template <typename T> class gsFunctionSet;
+template <typename T> class gsMapDataCache;
 
 /**
    @brief the gsFuncData is a cache of pre-computed function sets values.
@@ -232,7 +233,7 @@ public:
      * @param flags what to compute
      */
     explicit gsMapData(unsigned flags = 0)
-    : Base(flags), side(boundary::none)
+    : Base(flags), side(boundary::none), cache(NULL)
     { }
 
 public:
@@ -249,6 +250,10 @@ public:
     gsMatrix<T> normals;
     gsMatrix<T> outNormals; // only for the boundary
 
+    /// Cache of the evaluations on the elements, used by
+    /// gsFunction::computeMap() if not NULL (see gsMapDataCache)
+    gsMapDataCache<T> * cache;
+
 public:
     inline constColumn point(const index_t point) const { return points.col(point);}
 
@@ -286,6 +291,39 @@ public:
                   "jacobian access needs the computation of derivs: set the NEED_DERIV flag.");
        return gsAsConstMatrix<T, Dynamic, Dynamic>(&values[1].coeffRef(0,0), dim.first,dim.second*values[1].cols()).transpose();
     }
+
+    /// \brief Copies the data of the points \a k0 to \a k0+n-1 to
+    /// \a result, e.g. the data of one element out of a chunk of
+    /// elements evaluated at once. The cache of \a result is kept.
+    void middlePoints(const index_t k0, const index_t n, gsMapData & result) const
+    {
+        result.flags   = flags;
+        result.patchId = this->patchId;
+        result.dim     = dim;
+        result.side    = side;
+        result.values.resize(values.size());
+        for (size_t i = 0; i != values.size(); ++i)
+            middleCols(values[i], k0, n, result.values[i]);
+        middleCols(this->curls     , k0, n, result.curls     );
+        middleCols(this->divs      , k0, n, result.divs      );
+        middleCols(this->laplacians, k0, n, result.laplacians);
+        middleCols(points    , k0, n, result.points    );
+        middleCols(measures  , k0, n, result.measures  );
+        middleCols(fundForms , k0, n, result.fundForms );
+        middleCols(normals   , k0, n, result.normals   );
+        middleCols(outNormals, k0, n, result.outNormals);
+    }
+
+private:
+    // Columns k0 to k0+n-1 of in, or an empty matrix if in was not computed
+    static void middleCols(const gsMatrix<T> & in, const index_t k0, const index_t n,
+                           gsMatrix<T> & out)
+    {
+        if ( k0 + n <= in.cols() )
+            out = in.middleCols(k0, n);
+        else
+            out.resize(in.rows(), 0);
+    }
 };
 
 } // namespace gismo
@@ -111,6 +111,17 @@ public:
      */
     virtual void eval_into(const gsMatrix<T>& u, gsMatrix<T>& result) const = 0;
 
+    /** \brief Evaluate the function on a Cartesian grid of points into \a result.
+     *
+     * The points are the ones of gsPointGrid(\a grid), i.e., the tensor
+     * product of the coordinates \a grid[i] in direction \a i, the
+     * first direction running fastest, and \a result has the format
+     * of eval_into(). Functions with tensor-product structure override
+     * this to evaluate their univariate factors only once per
+     * coordinate.
+     */
+    virtual void evalGrid_into(const std::vector<gsVector<T> > & grid, gsMatrix<T>& result) const;
+
     /// Evaluate the function for component \a comp in the target dimension at points \a u into \a result.
     virtual void eval_component_into(const gsMatrix<T>& u, 
                                      const index_t comp, 
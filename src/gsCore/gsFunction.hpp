@@ -13,6 +13,8 @@
 
 #include <gsCore/gsLinearAlgebra.h>
 #include <gsCore/gsFuncData.h>
+#include <gsCore/gsMapDataCache.h>
+#include <gsUtils/gsPointGrid.h>
 #pragma once
 
 namespace gismo
@@ -291,6 +293,15 @@ int gsFunction<T>::targetDim() const
 { GISMO_NO_IMPLEMENTATION }
 */
 
+template <class T>
+void gsFunction<T>::evalGrid_into(const std::vector<gsVector<T> > & grid,
+                                  gsMatrix<T>& result) const
+{
+    gsMatrix<T> pts;
+    gsPointGrid(grid, pts);
+    this->eval_into(pts, result);
+}
+
 template <class T>
 void gsFunction<T>::eval_component_into(const gsMatrix<T>&,
                                         const index_t,
@@ -468,6 +479,11 @@ void gsFunction<T>::computeMap(gsMapData<T> & InOut) const
             InOut.flags & NEED_NORMAL         || InOut.flags & NEED_OUTER_NORMAL)
         InOut.flags = InOut.flags | NEED_GRAD;
 
+    // Take the data from the cache of the caller, if available
+    gsMapDataCache<T> * cache = InOut.cache;
+    if ( NULL != cache && cache->fetch(*this, InOut) )
+        return;
+
     this->compute(InOut.points, InOut);
 
     // Fill extra data
@@ -500,6 +516,8 @@ void gsFunction<T>::computeMap(gsMapData<T> & InOut) const
     default: computeAuxiliaryData<T,-1,-1>(InOut, Dim.first, Dim.second); break;
     }
 
+    if ( NULL != cache )
+        cache->store(*this, InOut);
 }
 
 
@@ -521,6 +521,31 @@ public:
      */
     virtual void compute(const gsMatrix<T> & in, gsFuncData<T> & out) const;
 
+    /**
+       @brief Computes function data on the points of a block of
+       elements
+
+       The points of element \a e are the columns \a ptOffset[e] to
+       \a ptOffset[e+1]-1 of \a in, hence a block of elements is
+       evaluated with one call instead of one call per element. The
+       values are written as by compute(), with one column per point
+       of the block. If NEED_ACTIVE is requested, column \a e of \a
+       out.actives contains the active functions of element \a e (in
+       the order of the rows of the values of its points); the column
+       of an element without points is unspecified.
+
+       Returns false if the number of active functions differs
+       between the elements, e.g. for hierarchical bases, since the
+       values do not have a common layout then. In this case the
+       elements must be evaluated one by one with compute().
+
+       @param[in] in
+       @param[in] ptOffset
+       @param[out] out
+     */
+    virtual bool computeBlock(const gsMatrix<T> & in, const gsVector<index_t> & ptOffset,
+                              gsFuncData<T> & out) const;
+
 public:
     /**
        @brief Dimension of the (source) domain.
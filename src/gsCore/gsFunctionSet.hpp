@@ -191,4 +191,38 @@ void gsFunctionSet<T>::compute(const gsMatrix<T> & in,
     }
 }
 
+template <typename T>
+bool gsFunctionSet<T>::computeBlock(const gsMatrix<T> & in,
+                                    const gsVector<index_t> & ptOffset,
+                                    gsFuncData<T> & out) const
+{
+    GISMO_ASSERT(0 < ptOffset.size() && 0 == ptOffset[0] &&
+                 ptOffset[ptOffset.size()-1] == in.cols(), "Invalid offsets of the elements.");
+    const index_t ne = ptOffset.size() - 1;
+    const unsigned flags = out.flags;
+
+    // The actives are taken at the first point of every element
+    if (flags & NEED_ACTIVE)
+    {
+        gsMatrix<index_t> act;
+        index_t numAct = -1;
+        for (index_t e = 0; e != ne; ++e)
+        {
+            if ( ptOffset[e] == ptOffset[e+1] ) continue;
+            active_into(in.col(ptOffset[e]), act);
+            if ( -1 == numAct )
+                out.actives.resize(numAct = act.rows(), ne);
+            else if ( act.rows() != numAct )
+                return false;
+            out.actives.col(e) = act;
+        }
+    }
+
+    // All values with a single evaluation
+    out.flags &= ~NEED_ACTIVE;
+    compute(in, out);
+    out.flags = flags;
+    return true;
+}
+
 } // namespace gismo
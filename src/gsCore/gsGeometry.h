@@ -191,6 +191,10 @@ public:
     void eval_into(const gsMatrix<T>& u, gsMatrix<T>& result) const
     { this->basis().evalFunc_into(u, m_coefs, result); }
 
+    // Look at gsFunction class for documentation
+    void evalGrid_into(const std::vector<gsVector<T> > & grid, gsMatrix<T>& result) const
+    { this->basis().evalGridFunc_into(grid, m_coefs, result); }
+
     /** \brief Evaluate derivatives of the function
      * \f$f:\mathbb{R}^d\rightarrow\mathbb{R}^n\f$
      * at points \a u into \a result.
@@ -0,0 +1,162 @@
+/** @file gsMapDataCache.h
+
+    @brief Provides a cache for the geometry evaluations on the
+    elements of a multi-patch
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsFuncData.h>
+
+namespace gismo
+{
+
+/**
+    @brief Cache of the geometry evaluations (gsMapData) on the
+    elements of the patches of a function set
+
+    The cache is owned by the caller, e.g. an assembler, and used by
+    the gsMapData objects which point to it (see gsMapData::cache).
+    While it is active for a gsMultiPatch (see activate()),
+    gsFunction::computeMap() on one of the patches with such a
+    gsMapData first looks for data computed on the same points (and
+    side) with at least the requested flags, and stores its results
+    otherwise. Elements are identified by their quadrature points,
+    which are compared exactly. This saves the repeated evaluation of
+    the geometry in time stepping or Newton iterations, where the
+    same matrices are assembled again and again on an unchanged
+    domain.
+
+    On activation, the entries of a patch are discarded if its
+    coefficients or the number of elements of its basis have
+    changed. New entries are not stored once memoryUsage() reaches
+    the capacity. Several threads can use the same cache.
+
+    The assemblers enable the cache with the option "CacheGeometry"
+    and set the capacity in megabytes with "CacheSize".
+
+    \ingroup Core
+*/
+template<class T = real_t>
+class gsMapDataCache
+{
+public:
+
+    /// Constructor, \a capacity is the memory limit in bytes
+    explicit gsMapDataCache(size_t capacity = 256 << 20)
+    : m_capacity(capacity), m_memory(0), m_hits(0), m_misses(0)
+    { }
+
+    gsMapDataCache(const gsMapDataCache & other);
+
+    gsMapDataCache & operator=(const gsMapDataCache & other);
+
+    ~gsMapDataCache() { deactivate(); }
+
+public:
+
+    /// Sets the memory limit in bytes
+    void setCapacity(size_t capacity) { m_capacity = capacity; }
+
+    /// The memory limit in bytes
+    size_t capacity() const { return m_capacity; }
+
+    /// Memory used by the stored evaluations, in bytes
+    size_t memoryUsage() const { return m_memory; }
+
+    /// Number of stored element evaluations
+    size_t numEntries() const;
+
+    /// Number of evaluations taken from the cache
+    size_t hits() const { return m_hits; }
+
+    /// Number of evaluations not found in the cache
+    size_t misses() const { return m_misses; }
+
+    /// Discards all stored evaluations
+    void clear();
+
+    /**
+     * @brief Activates the cache for the pieces of \a geo
+     *
+     * Must be called outside of parallel regions.
+     *
+     * @param geo the geometry, usually a gsMultiPatch
+     * @param bases the integration elements (optional); the entries
+     * of a patch are discarded if its number of elements changes
+     * @param patch activate only this piece (-1: all pieces)
+     */
+    void activate(const gsFunctionSet<T> & geo, const gsMultiBasis<T> * bases = NULL,
+                  index_t patch = -1);
+
+    /// Deactivates the cache, must be called outside of parallel regions
+    void deactivate();
+
+    /// Prints the memory use and the hit rate
+    std::ostream & print(std::ostream & os) const;
+
+public:
+
+    /// Copies the stored evaluation of \a f on the points of \a md
+    /// into \a md; returns false if there is none or if \a f is not
+    /// an active piece (used by gsFunction::computeMap)
+    bool fetch(const gsFunction<T> & f, gsMapData<T> & md);
+
+    /// Stores the evaluation \a md of \a f, if \a f is an active
+    /// piece and the capacity allows it
+    void store(const gsFunction<T> & f, const gsMapData<T> & md);
+
+private:
+
+    // Entries by the key of their points; different points may have
+    // the same key
+    typedef std::multimap<size_t, gsMapData<T> > entryMap;
+
+    // Key of the points of an element
+    static size_t hash(const gsMapData<T> & md);
+
+    // The entry with the points and the side of md, or end()
+    static typename entryMap::iterator find(entryMap & entries, size_t key,
+                                            const gsMapData<T> & md);
+
+    // Memory used by an evaluation
+    static size_t bytes(const gsMapData<T> & md);
+
+    // Index of the active piece \a f, -1 if \a f is not active
+    index_t pieceIndex(const gsFunction<T> & f) const;
+
+    struct patchData
+    {
+        patchData() : numElements(-1) { }
+
+        gsMatrix<T> coefs;   // coefficients at the last activation
+        index_t numElements; // number of elements at the last activation
+        entryMap entries;
+    };
+
+private:
+
+    size_t m_capacity, m_memory, m_hits, m_misses;
+
+    std::vector<patchData> m_patches;
+
+    // The active pieces, NULL for the inactive ones
+    std::vector<const gsFunction<T>*> m_functions;
+};
+
+/// Print (as string) operator
+template<class T>
+std::ostream &operator<<(std::ostream &os, const gsMapDataCache<T>& c)
+{return c.print(os); }
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsMapDataCache.hpp)
+#endif
@@ -0,0 +1,214 @@
+/** @file gsMapDataCache.hpp
+
+    @brief Provides implementation of the geometry evaluation cache
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsGeometry.h>
+#include <gsCore/gsMultiBasis.h>
+
+namespace gismo
+{
+
+template<class T>
+gsMapDataCache<T>::gsMapDataCache(const gsMapDataCache & other)
+: m_capacity(other.m_capacity), m_memory(other.m_memory),
+  m_hits(other.m_hits), m_misses(other.m_misses), m_patches(other.m_patches)
+{ }
+
+template<class T> gsMapDataCache<T> &
+gsMapDataCache<T>::operator=(const gsMapDataCache & other)
+{
+    // The activation is not copied
+    m_capacity = other.m_capacity;
+    m_memory   = other.m_memory;
+    m_hits     = other.m_hits;
+    m_misses   = other.m_misses;
+    m_patches  = other.m_patches;
+    return *this;
+}
+
+template<class T>
+size_t gsMapDataCache<T>::numEntries() const
+{
+    size_t result = 0;
+    for (size_t p = 0; p != m_patches.size(); ++p)
+        result += m_patches[p].entries.size();
+    return result;
+}
+
+template<class T>
+void gsMapDataCache<T>::clear()
+{
+    m_patches.clear();
+    m_memory = 0;
+}
+
+template<class T>
+void gsMapDataCache<T>::activate(const gsFunctionSet<T> & geo,
+                                 const gsMultiBasis<T> * bases, index_t patch)
+{
+    deactivate();
+    const index_t np = geo.nPieces();
+    if ( static_cast<index_t>(m_patches.size()) != np )
+        clear();
+    m_patches.resize(np);
+
+    m_functions.assign(np, NULL);
+    for (index_t p = (-1 == patch ? 0 : patch); p != (-1 == patch ? np : patch + 1); ++p)
+    {
+        // Only geometries are cached, since only their changes can
+        // be detected
+        const gsFunction<T> & f = geo.function(p);
+        const gsGeometry<T> * g = dynamic_cast<const gsGeometry<T>*>(&f);
+        if ( NULL == g ) continue;
+
+        patchData & pd = m_patches[p];
+        const index_t ne = ( bases && p < static_cast<index_t>(bases->nBases()) )
+            ? static_cast<index_t>((*bases)[p].numElements()) : -1;
+        const gsMatrix<T> & coefs = g->coefs();
+        if ( pd.numElements != ne || pd.coefs.rows() != coefs.rows() ||
+             pd.coefs.cols() != coefs.cols() || pd.coefs != coefs )
+        {
+            for (typename entryMap::const_iterator it = pd.entries.begin();
+                 it != pd.entries.end(); ++it)
+                m_memory -= bytes(it->second);
+            pd.entries.clear();
+            pd.coefs = coefs;
+            pd.numElements = ne;
+        }
+        m_functions[p] = &f;
+    }
+}
+
+template<class T>
+void gsMapDataCache<T>::deactivate()
+{
+    m_functions.clear();
+}
+
+template<class T>
+std::ostream & gsMapDataCache<T>::print(std::ostream & os) const
+{
+    os << "Geometry cache: " << numEntries() << " elements, "
+       << m_memory / 1048576. << " of " << m_capacity / 1048576. << " MB, "
+       << m_hits << " hits, " << m_misses << " misses\n";
+    return os;
+}
+
+template<class T>
+index_t gsMapDataCache<T>::pieceIndex(const gsFunction<T> & f) const
+{
+    for (size_t p = 0; p != m_functions.size(); ++p)
+        if ( m_functions[p] == &f )
+            return p;
+    return -1;
+}
+
+template<class T>
+bool gsMapDataCache<T>::fetch(const gsFunction<T> & f, gsMapData<T> & md)
+{
+    const index_t patch = pieceIndex(f);
+    if ( 0 == m_capacity || -1 == patch )
+        return false;
+
+    bool found = false;
+    const size_t key = hash(md);
+#   pragma omp critical (gsMapDataCache_access)
+    {
+        entryMap & entries = m_patches[patch].entries;
+        const typename entryMap::iterator it = find(entries, key, md);
+        if ( it != entries.end() && (it->second.flags & md.flags) == md.flags )
+        {
+            const gsMapData<T> & c = it->second;
+            md.dim        = c.dim;
+            md.values     = c.values;
+            md.measures   = c.measures;
+            md.fundForms  = c.fundForms;
+            md.normals    = c.normals;
+            md.outNormals = c.outNormals;
+            found = true;
+        }
+        ++( found ? m_hits : m_misses );
+    }
+    return found;
+}
+
+template<class T>
+void gsMapDataCache<T>::store(const gsFunction<T> & f, const gsMapData<T> & md)
+{
+    const index_t patch = pieceIndex(f);
+    if ( 0 == m_capacity || -1 == patch )
+        return;
+    const size_t key = hash(md), size = bytes(md);
+#   pragma omp critical (gsMapDataCache_access)
+    {
+        entryMap & entries = m_patches[patch].entries;
+        typename entryMap::iterator it = find(entries, key, md);
+        if ( it != entries.end() ) // replaced, e.g. by data with more flags
+        {
+            m_memory -= bytes(it->second);
+            entries.erase(it);
+        }
+        if ( m_memory + size <= m_capacity )
+        {
+            gsMapData<T> & c = entries.insert( std::make_pair(key, gsMapData<T>()) )->second;
+            c.flags      = md.flags;
+            c.side       = md.side;
+            c.dim        = md.dim;
+            c.points     = md.points;
+            c.values     = md.values;
+            c.measures   = md.measures;
+            c.fundForms  = md.fundForms;
+            c.normals    = md.normals;
+            c.outNormals = md.outNormals;
+            m_memory += size;
+        }
+    }
+}
+
+template<class T> typename gsMapDataCache<T>::entryMap::iterator
+gsMapDataCache<T>::find(entryMap & entries, const size_t key, const gsMapData<T> & md)
+{
+    const std::pair<typename entryMap::iterator, typename entryMap::iterator>
+        range = entries.equal_range(key);
+    for (typename entryMap::iterator it = range.first; it != range.second; ++it)
+    {
+        const gsMapData<T> & c = it->second;
+        if ( c.side == md.side && c.points.rows() == md.points.rows() &&
+             c.points.cols() == md.points.cols() && c.points == md.points )
+            return it;
+    }
+    return entries.end();
+}
+
+template<class T>
+size_t gsMapDataCache<T>::hash(const gsMapData<T> & md)
+{
+    // FNV-1a on the bytes of the points
+    const unsigned char * b = reinterpret_cast<const unsigned char*>(md.points.data());
+    const size_t n = md.points.size() * sizeof(T);
+    size_t h = static_cast<size_t>(2166136261u) ^ static_cast<size_t>(md.points.cols());
+    for (size_t i = 0; i != n; ++i)
+        h = (h ^ b[i]) * static_cast<size_t>(16777619u);
+    return h;
+}
+
+template<class T>
+size_t gsMapDataCache<T>::bytes(const gsMapData<T> & md)
+{
+    size_t n = md.points.size() + md.measures.size() + md.fundForms.size()
+        + md.normals.size() + md.outNormals.size();
+    for (size_t i = 0; i != md.values.size(); ++i)
+        n += md.values[i].size();
+    return n * sizeof(T) + sizeof(gsMapData<T>);
+}
+
+} // namespace gismo
@@ -0,0 +1,11 @@
+#include <gsCore/gsTemplateTools.h>
+
+#include <gsCore/gsMapDataCache.h>
+#include <gsCore/gsMapDataCache.hpp>
+
+namespace gismo
+{
+
+    CLASS_TEMPLATE_INST gsMapDataCache<real_t> ;
+
+}
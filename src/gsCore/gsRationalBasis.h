@@ -253,8 +253,13 @@ public:
 
     void evalFunc_into(const gsMatrix<T> & u, const gsMatrix<T> & coefs, gsMatrix<T>& result) const;
 
-    //void evalAllDers_into(const gsMatrix<T> & u, int n, 
-    //                      std::vector<gsMatrix<T> >& result) const;
+    /// @brief Evaluates the values and derivatives up to order \a n
+    /// <= 2 in one sweep: the source basis and its actives are
+    /// evaluated once and the quotient rule is applied in place,
+    /// with the weight function and its derivatives computed once per
+    /// point.
+    void evalAllDers_into(const gsMatrix<T> & u, int n,
+                          std::vector<gsMatrix<T> >& result) const;
     
     void deriv_into(const gsMatrix<T> & u, gsMatrix<T>& result ) const ;
     
@@ -368,18 +373,9 @@ void gsRationalBasis<SrcT>::evalSingle_into(index_t i, const gsMatrix<T> & u, gs
 template<class SrcT>
 void gsRationalBasis<SrcT>::eval_into(const gsMatrix<T> & u, gsMatrix<T>& result) const
 { 
-    m_src->eval_into(u, result);
-    const gsMatrix<index_t> act = m_src->active(u);
-    
-    gsMatrix<T> denom;
-    m_src->evalFunc_into(u, m_weights, denom); 
-    
-    for ( index_t j=0; j< act.cols(); ++j)
-    {
-        result.col(j) /= denom(j);
-        for ( index_t i=0; i< act.rows(); ++i)    
-            result(i,j) *=  m_weights( act(i,j) ) ;
-    }
+    std::vector<gsMatrix<T> > ev;
+    evalAllDers_into(u, 0, ev);
+    result.swap(ev[0]);
 }
   
   
@@ -406,164 +402,104 @@ void gsRationalBasis<SrcT>::evalFunc_into(const gsMatrix<T> & u, const gsMatrix<
 }
     
 
-/* TODO
 template<class SrcT>
 void gsRationalBasis<SrcT>::evalAllDers_into(const gsMatrix<T> & u, int n,
                                              std::vector<gsMatrix<T> >& result) const
 {
-    result.resize(n+1);
+    // Formulas, with W = sum_k w_k N_k the weight function:
+    // R_k  = w_k N_k / W
+    // R_k' = w_k ( N_k' W - N_k W' ) / W^2
+    // ( W^2 / w_k) * R_k'' = ( N_k'' W - N_k W'' ) - 2 N_k' W' + 2 N_k (W')^2 / W
+    // ( W^2 / w_k) * d_ud_vR_k = ( d_ud_vN_k W - N_k d_ud_vW ) 
+    //                          - d_uN_k d_vW - d_vN_k d_uW + 2 N_k d_uW d_vW / W
+    GISMO_ENSURE(n >= 0 && n < 3, "evalAllDers implemented for order up to 2<"
+                 <<n<< " for "<<*this);
+
+    static const int str = Dim * (Dim+1) / 2;
 
-    std::vector<gsMatrix<T> > ev(n+1);
+    // The source values are overwritten by the rational ones
+    m_src->evalAllDers_into(u, n, result);
 
-    m_src->evalAllDers_into(u, n, ev);
-    
-    // find active basis functions
     gsMatrix<index_t> act;
     m_src->active_into(u,act);
+    const index_t numAct = act.rows();
 
-    const int numAct = act.rows();
+    gsVector<T> lw(numAct);
+    gsVector<T,Dim> dW;
+    gsVector<T,str> ddW;
 
-    // evaluate weights and their derivatives
-    gsMatrix<T> Wval, Wder;
-    m_src->evalFunc_into (u,  m_weights, Wval);
-    m_src->derivFunc_into(u, m_weights, Wder);
-
-    for (index_t i = 0; i < u.cols(); ++i)// for all parametric points
+    for ( index_t i = 0; i!= u.cols(); ++i ) // for all points
     {
-        const T & Wval_i = Wval(0,i);
-        // compute derivatives first since they depend on the function
-        // values of the source basis
-        der.col(i) *= Wval_i;
-      
-        for (index_t k = 0; k < numAct; ++k)
+        // Weight function and its derivatives, from the local weights
+        T W = 0;
+        dW .setZero();
+        ddW.setZero();
+        for ( index_t k = 0; k != numAct; ++k ) // for all basis functions
         {
-            der.template block<Dim,1>(k*Dim,i).noalias() -=  
-                ev(k,i) * Wder.col(i);
-            
-            der.template block<Dim,1>(k*Dim,i) *=
-                m_weights( act(k,i), 0 ) / (Wval_i*Wval_i);
+            lw[k] = m_weights.at(act(k,i));
+            W += lw[k] * result[0](k,i);
+            if ( n > 0 )
+                dW  += lw[k] * result[1].template block<Dim,1>(k*Dim,i);
+            if ( n > 1 )
+                ddW += lw[k] * result[2].template block<str,1>(k*str,i);
         }
-        
-        // compute function values
-        ev.col(i) /= Wval_i;
-      
-        for (index_t k = 0; k < numAct; ++k)    
-            ev(k,i) *= m_weights( act(k,i), 0 ) ;
-    }
-}
-//*/
-
-template<class SrcT>
-void gsRationalBasis<SrcT>::deriv_into(const gsMatrix<T> & u, 
-                                       gsMatrix<T>& result) const
-{ 
-    // Formula:
-    // R_i' = (w_i N_i / W)' = w_i ( N_i'W - N_i W' ) / W^2 
-
-    gsMatrix<index_t> act;
-    m_src->active_into(u,act);
-
-    result.resize( act.rows()*Dim, u.cols() );
+        const T iW = 1 / W;
 
-    std::vector<gsMatrix<T> > ev(2);
-    m_src->evalAllDers_into(u, 1, ev); 
-
-    T W;
-    gsMatrix<T> dW(Dim,1);
-  
-    for ( index_t i = 0; i!= result.cols(); ++i )// for all parametric points
-    {  
-        // Start weight function computation
-        W = 0.0;
-        dW.setZero();
-        for ( index_t k = 0; k != act.rows(); ++k ) // for all basis functions
+        // Highest derivatives first, since they depend on the lower
+        // order derivatives of the source basis
+        if ( n > 1 )
         {
-            const T curw = m_weights.at(act(k,i));
-            W  += curw * ev[0](k,i);
-            dW += curw * ev[1].template block<Dim,1>(k*Dim,i);
+            for ( index_t k = 0; k != numAct; ++k )
+            {
+                const T   N  = result[0](k,i);
+                const T * dN = result[1].data() + result[1].rows() * i + k * Dim;
+                T * ddN      = result[2].data() + result[2].rows() * i + k * str;
+                const T c    = lw[k] * iW * iW;
+
+                for ( int _u = 0; _u != Dim; ++_u )
+                    ddN[_u] = c * ( ddN[_u] * W - N * ddW[_u]
+                                    - 2 * dN[_u] * dW[_u]
+                                    + 2 * N * dW[_u] * dW[_u] * iW );
+                int m = Dim;
+                for ( int _u=0; _u != Dim; ++_u ) // for all mixed derivatives
+                    for ( int _v=_u+1; _v != Dim; ++_v, ++m )
+                        ddN[m] = c * ( ddN[m] * W - N * ddW[m]
+                                       - dN[_u] * dW[_v] - dN[_v] * dW[_u]
+                                       + 2 * N * dW[_u] * dW[_v] * iW );
+            }
         }
-        // End weight function computation
 
-        result.col(i) = W * ev[1].col(i);  // N_i'W
-
-        for ( index_t k = 0; k != act.rows() ; ++k) // for all basis functions
+        if ( n > 0 )
         {
-            const index_t kd = k * Dim;
-
-            result.template block<Dim,1>(kd,i).noalias() -=  
-                ev[0](k,i) * dW; // - N_i W'
-            
-            result.template block<Dim,1>(kd,i) *= m_weights.at( act(k,i) ) / (W * W);
+            for ( index_t k = 0; k != numAct; ++k )
+            {
+                const T N = result[0](k,i);
+                const T c = lw[k] * iW * iW;
+                result[1].template block<Dim,1>(k*Dim,i) =
+                    c * ( W * result[1].template block<Dim,1>(k*Dim,i) - N * dW );
+            }
         }
+
+        for ( index_t k = 0; k != numAct; ++k )
+            result[0](k,i) *= lw[k] * iW;
     }
 }
 
+template<class SrcT>
+void gsRationalBasis<SrcT>::deriv_into(const gsMatrix<T> & u, 
+                                       gsMatrix<T>& result) const
+{ 
+    std::vector<gsMatrix<T> > ev;
+    evalAllDers_into(u, 1, ev);
+    result.swap(ev[1]);
+}
+
 template<class SrcT>
 void gsRationalBasis<SrcT>::deriv2_into(const gsMatrix<T> & u, gsMatrix<T>& result ) const
 {   
-    // Formula:
-    // ( W^2 / w_k) * R_k'' = ( N_k'' W - N_k W'' ) - 2 N_k' W' + 2 N_k (W')^2 / W
-    // ( W^2 / w_k) * d_ud_vR_k = ( d_ud_vN_k W - N_k d_ud_vW ) 
-    //                          - d_uN_k d_vW - d_vN_k d_uW + 2 N_k d_uW d_vW / W
-    
-    static const int str = Dim * (Dim+1) / 2;
-
-    gsMatrix<index_t> act;
-    m_src->active_into(u,act);
-
-    result.resize( act.rows()*str, u.cols() );
-
-    T W;
-    gsMatrix<T> dW(Dim,1), ddW(str,1);
-    std::vector<gsMatrix<T> > ev(3);
-    m_src->evalAllDers_into(u, 2, ev); 
-
-    for ( index_t i = 0; i!= u.cols(); ++i ) // for all points
-    {
-        // Start weight function computation
-        W = 0.0;
-        dW .setZero();
-        ddW.setZero();
-        for ( index_t k = 0; k != act.rows(); ++k ) // for all basis functions
-        {
-            //to do with lweights (local weights)
-            const T curw = m_weights.at(act(k,i));
-            W   += curw * ev[0](k,i);
-            dW  += curw * ev[1].template block<Dim,1>(k*Dim,i);
-            ddW += curw * ev[2].template block<str,1>(k*str,i);
-        }
-        // End weight function computation
-
-        result.col(i) = W * ev[2].col(i); // N_k'' W
-
-        for ( index_t k=0; k != act.rows() ; ++k ) // for all basis functions
-        {
-            const index_t kstr = k * str;
-            const index_t kd   = k * Dim;
-
-            result.template block<str,1>(kstr,i) -= 
-                ev[0](k,i) * ddW; // - N_k * W''
-
-            result.template block<Dim,1>(kstr,i) += 
-                // - 2 N_k' W' + 2 N_k (W')^2 / W 
-                ( 2 * ev[0](k,i) / W ) * dW.cwiseProduct(dW)
-                - 2 * ev[1].template block<Dim,1>(kd,i).cwiseProduct(dW);
-
-            int m = Dim;
-            for ( int _u=0; _u != Dim; ++_u ) // for all mixed derivatives
-                for ( int _v=_u+1; _v != Dim; ++_v )
-                {
-                    result(kstr + m++, i) += 
-                        - ev[1](kd+_u,i) * dW.at(_v) // - du N_k * dv W
-                        - ev[1](kd+_v,i) * dW.at(_u) // - dv N_k * du W
-                        // + 2 * N_k * du W * dv W / W
-                        + 2 * ev[0](k,i) * dW.at(_u) * dW.at(_v) / W;
-                }
-
-            result.template block<str,1>(kstr,i) *= 
-                m_weights.at( act(k,i) ) / (W*W); // * (w_k / W^2)
-        }
-    }
+    std::vector<gsMatrix<T> > ev;
+    evalAllDers_into(u, 2, ev);
+    result.swap(ev[2]);
 }
 
 
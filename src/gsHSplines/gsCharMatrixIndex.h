@@ -0,0 +1,154 @@
+/** @file gsCharMatrixIndex.h
+
+    @brief Constant-time position lookup in the characteristic
+    matrices of hierarchical bases
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsForwardDeclarations.h>
+
+namespace gismo
+{
+
+/**
+   \brief Finds the position of a tensor index in a characteristic
+   matrix (a sorted vector of tensor indices) in constant time
+
+   When the indices of the level are dense, the index is a bitmap
+   over all tensor indices of the level with the running count of
+   set bits stored once per word, so the position is a rank query.
+   Otherwise the positions are kept in an open-addressing hash table
+   of size proportional to the number of indices.
+
+   The index is a snapshot: it has to be initialized again when the
+   characteristic matrix changes.
+
+   \ingroup HSplines
+*/
+class gsCharMatrixIndex
+{
+public:
+
+    /// Empty constructor
+    gsCharMatrixIndex() : m_dense(true), m_mask(0)
+    { }
+
+    /// \brief Initializes the index for the sorted, unique indices
+    /// in [\a begin, \a end), which are all smaller than \a size.
+    template<class Iter>
+    void init(Iter begin, Iter end, const index_t size)
+    {
+        const index_t n = static_cast<index_t>(end - begin);
+        m_bits.clear();
+        m_rank.clear();
+        m_keys.clear();
+        m_vals.clear();
+
+        // The bitmap costs about 3/8 bytes per tensor index, the
+        // table at most 4 entries per active index
+        m_dense = ( size <= 64 * n + 1024 );
+        if ( m_dense )
+        {
+            const index_t nw = size / 32 + 1;
+            m_bits.resize(nw, 0u);
+            m_rank.resize(nw);
+            for (Iter it = begin; it != end; ++it)
+                m_bits[*it / 32] |= (1u << (*it % 32));
+            index_t r = 0;
+            for (index_t w = 0; w != nw; ++w)
+            {
+                m_rank[w] = r;
+                r += popCount(m_bits[w]);
+            }
+            return;
+        }
+
+        index_t cap = 1;
+        while ( cap < 2 * n )
+            cap *= 2;
+        m_mask = cap - 1;
+        m_keys.resize(cap, -1);
+        m_vals.resize(cap);
+        index_t pos = 0;
+        for (Iter it = begin; it != end; ++it, ++pos)
+        {
+            index_t s = slot(*it);
+            while ( m_keys[s] != -1 )
+                s = (s + 1) & m_mask;
+            m_keys[s] = *it;
+            m_vals[s] = pos;
+        }
+    }
+
+    /// Returns the position of \a key, or -1 if \a key is not stored
+    index_t find(const index_t key) const
+    {
+        if ( m_dense )
+        {
+            const index_t w = key / 32;
+            if ( key < 0 || w >= static_cast<index_t>(m_bits.size()) )
+                return -1;
+            const unsigned bit = 1u << (key % 32);
+            if ( ! (m_bits[w] & bit) )
+                return -1;
+            return m_rank[w] + popCount( m_bits[w] & (bit - 1) );
+        }
+
+        for (index_t s = slot(key); m_keys[s] != -1; s = (s + 1) & m_mask)
+            if ( m_keys[s] == key )
+                return m_vals[s];
+        return -1;
+    }
+
+    /// Returns true if the index is a bitmap
+    bool isDense() const { return m_dense; }
+
+    /// Returns the memory used by the index, in bytes
+    size_t memoryUsage() const
+    {
+        return sizeof(*this) + m_bits.capacity() * sizeof(unsigned)
+            + ( m_rank.capacity() + m_keys.capacity() + m_vals.capacity() )
+            * sizeof(index_t);
+    }
+
+private:
+
+    static index_t popCount(unsigned x)
+    {
+        x = x - ((x >> 1) & 0x55555555u);
+        x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+        return static_cast<index_t>( (((x + (x >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24 );
+    }
+
+    index_t slot(const index_t key) const
+    {
+        // Mix the bits, tensor indices have regular strides
+        size_t x = static_cast<size_t>(key);
+        x ^= x >> 16; x *= 0x45d9f3bu;
+        x ^= x >> 16; x *= 0x45d9f3bu;
+        x ^= x >> 16;
+        return static_cast<index_t>(x & static_cast<size_t>(m_mask));
+    }
+
+private:
+
+    bool m_dense;
+
+    // Bitmap and running counts of the set bits before each word
+    std::vector<unsigned> m_bits;
+    std::vector<index_t>  m_rank;
+
+    // Hash table with linear probing, -1 marks an empty slot
+    std::vector<index_t> m_keys;
+    std::vector<index_t> m_vals;
+    index_t m_mask;
+};
+
+} // namespace gismo
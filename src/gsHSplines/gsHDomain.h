@@ -88,6 +88,9 @@ private:
 
 private:
 
+    /// Storage of the nodes of the tree
+    kdnodePool<d,T> m_pool;
+
     /// Pointer to the root node of the tree
     node * m_root;
 
@@ -103,6 +106,25 @@ private:
 
     unsigned m_maxPath;
 
+    /// Node of the flat layout of the tree used by the queries
+    struct flatNode
+    {
+        /// Split coordinate (split nodes only)
+        T pos;
+        /// Split axis, or -1 for a leaf
+        int axis;
+        /// Position of the right child of a split node, or level of
+        /// a leaf. The left child of a split node is the next node.
+        int link;
+    };
+
+    /// \brief The tree in pre-order as a contiguous array, built by
+    /// makeCompressed() and cleared by any modification of the tree.
+    ///
+    /// While it is available the queries and levelOf() walk this
+    /// array instead of the linked nodes.
+    std::vector<flatNode> m_flat;
+
 public:
 
     gsHDomain() : m_indexLevel(0)
@@ -133,9 +155,10 @@ public:
         m_upperIndex(o.m_upperIndex),
         m_indexLevel(o.m_indexLevel),
         m_maxInsLevel(o.m_maxInsLevel),
-        m_maxPath(o.m_maxPath)
+        m_maxPath(o.m_maxPath),
+        m_flat(o.m_flat)
     {
-        m_root = new node(*o.m_root);
+        m_root = o.m_root ? m_pool.copyTree(*o.m_root) : nullptr;
     }
 
     /// Assignment operator (makes a deep copy)
@@ -144,12 +167,14 @@ public:
         if ( this == &o )
             return *this;
         
-        m_root = new node(*o.m_root);
+        m_pool.clear();
+        m_root = o.m_root ? m_pool.copyTree(*o.m_root) : nullptr;
 
         m_upperIndex  = o.m_upperIndex;
         m_indexLevel  = o.m_indexLevel;
         m_maxInsLevel = o.m_maxInsLevel;
         m_maxPath    = o.m_maxPath;
+        m_flat       = o.m_flat;
 
         return *this;
     }
@@ -160,18 +185,23 @@ public:
     m_upperIndex(std::move(o.m_upperIndex)),
     m_indexLevel(o.m_indexLevel),
     m_maxInsLevel(o.m_maxInsLevel),
-    m_maxPath(o.m_maxPath)
+    m_maxPath(o.m_maxPath),
+    m_flat(std::move(o.m_flat))
     {
+        m_pool.swap(o.m_pool);
         o.m_root = nullptr;
     }
 
     gsHDomain & operator=(gsHDomain&& o)
     {
-        delete m_root; m_root = o.m_root; o.m_root = nullptr;
+        m_pool.clear();
+        m_pool.swap(o.m_pool);
+        m_root = o.m_root; o.m_root = nullptr;
         m_upperIndex  = std::move(o.m_upperIndex);
         m_indexLevel  = o.m_indexLevel;
         m_maxInsLevel = o.m_maxInsLevel;
         m_maxPath     = o.m_maxPath;
+        m_flat        = std::move(o.m_flat);
         return *this;
     }
 #endif
@@ -182,18 +212,18 @@ public:
         m_indexLevel = index_level;
         m_maxInsLevel = 0;
 
-        if ( m_root )
-            delete m_root;
+        m_pool.clear();
 
         for (short_t i=0; i<d; ++i)
             m_upperIndex[i] = (upp[i]<< m_indexLevel);
 
-        m_root = new node(m_upperIndex);
+        m_root = m_pool.newLeaf(point::Zero(), m_upperIndex);
         m_maxPath = 1;
+        m_flat.clear();
     }
 
-    /// Destructor deletes the whole tree
-    ~gsHDomain() { delete m_root; }
+    /// Destructor deletes the whole tree (with the pool)
+    ~gsHDomain() { }
 
     /// Clones the object
     gsHDomain * clone() const;
@@ -414,7 +444,10 @@ public:
 
     /// Returns the level of the point \a p
     int levelOf(point const & p, int level) const
-    { return pointSearch(p,level,m_root)->level;}
+    {
+        return m_flat.empty() ? pointSearch(p,level,m_root)->level
+                              : flatPointSearch(p,level);
+    }
 
     // to do: move to the hpp file do avoid need for instantization
     void incrementLevel()
@@ -425,6 +458,7 @@ public:
         "Problem with indices, increase number of levels (to do).");
 
         leafSearch< levelUp_visitor >(); 
+        m_flat.clear();
     }
 
     /// Multiply all coordinates by two
@@ -432,6 +466,7 @@ public:
     {
         m_upperIndex *= 2;
         nodeSearch< liftCoordsOneLevel_visitor >();
+        m_flat.clear();
     }
 
     // to do: move to the hpp file do avoid need for instantization
@@ -439,6 +474,7 @@ public:
     {
         m_maxInsLevel--;
         leafSearch< levelDown_visitor >(); 
+        m_flat.clear();
     }
 
     literator beginLeafIterator()
@@ -451,7 +487,13 @@ public:
         return const_literator(m_root, m_indexLevel);
     }
 
+    /// Merges sibling leaves of the same level and builds the flat
+    /// layout of the tree used by the queries
     void makeCompressed();
+
+    /// Returns the memory used by the nodes of the tree and by its
+    /// flat layout, in bytes
+    size_t memoryUsage() const;
     
     /// Returns the number of nodes in the tree
     int size() const
@@ -659,6 +701,18 @@ private:
     /// considered half-open, i.e. in 2D they are of the form
     /// [a_1,b_1) x [a_2,b_2)
     node * pointSearch(const point & p, int level, node  *_node) const;
+
+    /// Same as boxSearch starting at the root, on the flat layout
+    template<typename visitor>
+    typename visitor::return_type
+    flatBoxSearch(point const & k1, point const & k2, int level) const;
+
+    /// Returns the level of the leaf containing \a p, on the flat
+    /// layout
+    int flatPointSearch(const point & p, int level) const;
+
+    /// Builds gsHDomain::m_flat from the linked nodes
+    void makeFlat();
     
     // Increases the level by 1 for all leaves
     struct levelUp_visitor
@@ -50,9 +50,12 @@ namespace {
 
         template<short_t d, class T >
         static void visitLeaf(gismo::kdnode<d,T> * leafNode , int level, return_type & res)
+        { visitLevel(leafNode->level, level, res); }
+
+        static void visitLevel(int leafLevel, int level, return_type & res)
         {
             //if ( (!isDegenerate(*leafNode->box)) && leafNode->level != level )
-            if ( leafNode->level != level )
+            if ( leafLevel != level )
                 // if (leafNode->level != level )
                 res = false;
         }
@@ -68,9 +71,12 @@ namespace {
 
         template<short_t d, class T >
         static void visitLeaf(gismo::kdnode<d,T> * leafNode , int level, return_type & res)
+        { visitLevel(leafNode->level, level, res); }
+
+        static void visitLevel(int leafLevel, int level, return_type & res)
         {
             //if ( (!isDegenerate(*leafNode->box)) && leafNode->level <= level )
-            if ( leafNode->level <= level )
+            if ( leafLevel <= level )
                 res = false;
         }
     };
@@ -85,11 +91,14 @@ namespace {
         static const return_type init = 1000000;
 
         template<short_t d, class T >
-        static void visitLeaf(gismo::kdnode<d,T> * leafNode , int , return_type & res)
+        static void visitLeaf(gismo::kdnode<d,T> * leafNode , int level, return_type & res)
+        { visitLevel(leafNode->level, level, res); }
+
+        static void visitLevel(int leafLevel, int , return_type & res)
         {
             //if ( (!isDegenerate(*leafNode->box)) && leafNode->level < res )
-            if ( leafNode->level < res )
-                res = leafNode->level;
+            if ( leafLevel < res )
+                res = leafLevel;
         }
     };
     
@@ -103,11 +112,14 @@ namespace {
         static const return_type init = -1;
 
         template<short_t d, class T >
-        static void visitLeaf(gismo::kdnode<d,T> * leafNode , int , return_type & res)
+        static void visitLeaf(gismo::kdnode<d,T> * leafNode , int level, return_type & res)
+        { visitLevel(leafNode->level, level, res); }
+
+        static void visitLevel(int leafLevel, int , return_type & res)
         {
             //if ( (!isDegenerate(*leafNode->box)) && leafNode->level > res )
-            if ( leafNode->level > res )
-                res = leafNode->level;
+            if ( leafLevel > res )
+                res = leafLevel;
         }
     };
 
@@ -216,6 +228,9 @@ gsHDomain<d,T>::insertBox ( point const & k1, point const & k2,
         gsWarn<<" Invalid box coordinate "<<  k1.transpose() <<" at level" <<lvl<<".\n";
         return;
     }
+
+    // The flat layout is rebuilt by makeCompressed()
+    m_flat.clear();
     
     // Initialize stack
     std::vector<node*> stack;
@@ -241,7 +256,7 @@ gsHDomain<d,T>::insertBox ( point const & k1, point const & k2,
             }
             else if ( haveOverlap(*curNode->box, iBox) )
             {
-                curNode->nextMidSplit();
+                curNode->nextMidSplit(m_pool);
                 stack.push_back(curNode);
             }
         }
@@ -257,7 +272,7 @@ gsHDomain<d,T>::insertBox ( point const & k1, point const & k2,
 
             // Split the leaf (if possible)
             //node * newLeaf = curNode->adaptiveSplit(iBox);
-            node * newLeaf = curNode->adaptiveAlignedSplit(iBox, m_indexLevel);
+            node * newLeaf = curNode->adaptiveAlignedSplit(iBox, m_indexLevel, m_pool);
             
             // If curNode is still a leaf, its domain is almost
             // contained in iBox
@@ -316,6 +331,8 @@ gsHDomain<d,T>::sinkBox ( point const & k1,
         //gsWarn<<" Invalid box coordinate "<<  k1.transpose() <<" at level" <<lvl<<".\n";
         return;
     }
+
+    m_flat.clear();
     
     // Initialize stack
     std::stack<node*, std::vector<node*> > stack;
@@ -332,7 +349,7 @@ gsHDomain<d,T>::sinkBox ( point const & k1,
         {
             // Since we reached a leaf, it should overlap with iBox.
             // Split the leaf (if possible)
-            node * newLeaf = curNode->adaptiveAlignedSplit(iBox, m_indexLevel);
+            node * newLeaf = curNode->adaptiveAlignedSplit(iBox, m_indexLevel, m_pool);
             
             // If curNode is still a leaf, its domain is almost
             // contained in iBox
@@ -400,7 +417,7 @@ gsHDomain<d,T>::makeCompressed()
         if (curNode->left->level == curNode->right->level) 
         {
             // Merge left and right
-            curNode->merge();
+            curNode->merge(m_pool);
             if ( !curNode->isRoot() &&
                   curNode->parent->isTerminal() )
                 tstack.push(curNode->parent );
@@ -409,17 +426,69 @@ gsHDomain<d,T>::makeCompressed()
     
     // Store the max path length
     m_maxPath = minMaxPath().second;
+
+    makeFlat();
+}
+
+template<short_t d, class T > void
+gsHDomain<d,T>::makeFlat()
+{
+    m_flat.clear();
+    m_flat.reserve( size() );
+
+    // Pre-order traversal, the left child of a split node is the next
+    // node in the array. Each stack entry keeps the position of the
+    // parent of a right child, or -1
+    std::vector<std::pair<node*,int> > stack;
+    stack.reserve( 2 * m_maxPath );
+    stack.push_back( std::make_pair(m_root, -1) );
+    while ( ! stack.empty() )
+    {
+        const node * curNode = stack.back().first;
+        const int parent     = stack.back().second;
+        stack.pop_back();
+
+        const int cur = static_cast<int>(m_flat.size());
+        if ( -1 != parent )
+            m_flat[parent].link = cur;
+
+        flatNode fn;
+        fn.axis = curNode->axis;
+        if ( curNode->isLeaf() )
+        {
+            fn.pos  = 0;
+            fn.link = curNode->level;
+        }
+        else
+        {
+            fn.pos  = curNode->pos;
+            fn.link = -1; // set when the right child is visited
+            stack.push_back( std::make_pair(curNode->right, cur) );
+            stack.push_back( std::make_pair(curNode->left , -1 ) );
+        }
+        m_flat.push_back(fn);
+    }
+}
+
+template<short_t d, class T >
+size_t gsHDomain<d,T>::memoryUsage() const
+{
+    return sizeof(*this) + m_pool.memoryUsage()
+        + m_flat.capacity() * sizeof(flatNode);
 }
 
 template<short_t d, class T >
 bool gsHDomain<d,T>::query1(point const & lower, point const & upper,
                int level, node  *_node) const
-{ return boxSearch< query1_visitor >(upper,lower,level,_node); }
+{ return boxSearch< query1_visitor >(lower,upper,level,_node); }
 
 template<short_t d, class T >
 bool gsHDomain<d,T>::query1(point const & lower, point const & upper,
                int level) const
-{ return boxSearch< query1_visitor >(upper,lower,level,m_root); }
+{
+    return m_flat.empty() ? boxSearch< query1_visitor >(lower,upper,level,m_root)
+                          : flatBoxSearch< query1_visitor >(lower,upper,level);
+}
 
 template<short_t d, class T >
 bool gsHDomain<d,T>::query2(point const & lower, point const & upper,
@@ -429,7 +498,10 @@ bool gsHDomain<d,T>::query2(point const & lower, point const & upper,
 template<short_t d, class T >
 bool gsHDomain<d,T>::query2 (point const & lower, point const & upper,
                  int level) const
-{ return boxSearch< query2_visitor >(lower,upper,level,m_root); }
+{
+    return m_flat.empty() ? boxSearch< query2_visitor >(lower,upper,level,m_root)
+                          : flatBoxSearch< query2_visitor >(lower,upper,level);
+}
 
 template<short_t d, class T >
 int gsHDomain<d,T>::query3(point const & lower, point const & upper,
@@ -439,7 +511,10 @@ int gsHDomain<d,T>::query3(point const & lower, point const & upper,
 template<short_t d, class T >
 int gsHDomain<d,T>::query3(point const & lower, point const & upper,
                int level) const
-{ return boxSearch< query3_visitor >(lower,upper,level,m_root); }
+{
+    return m_flat.empty() ? boxSearch< query3_visitor >(lower,upper,level,m_root)
+                          : flatBoxSearch< query3_visitor >(lower,upper,level);
+}
 
 template<short_t d, class T >
 int gsHDomain<d,T>::query4(point const & lower, point const & upper,
@@ -449,7 +524,10 @@ int gsHDomain<d,T>::query4(point const & lower, point const & upper,
 template<short_t d, class T >
 int gsHDomain<d,T>::query4(point const & lower, point const & upper,
                int level) const
-{ return boxSearch< query4_visitor >(lower,upper,level,m_root); }
+{
+    return m_flat.empty() ? boxSearch< query4_visitor >(lower,upper,level,m_root)
+                          : flatBoxSearch< query4_visitor >(lower,upper,level);
+}
 
 template<short_t d, class T >
 std::pair<typename gsHDomain<d,T>::point, typename gsHDomain<d,T>::point>
@@ -605,6 +683,67 @@ gsHDomain<d,T>::boxSearch(point const & k1, point const & k2,
 
 
 
+template<short_t d, class T>
+template<typename visitor>
+typename visitor::return_type
+gsHDomain<d,T>::flatBoxSearch(point const & k1, point const & k2, int level) const
+{
+    // Make a box
+    box qBox(k1,k2);
+    local2globalIndex( qBox.first , static_cast<unsigned>(level), qBox.first );
+    local2globalIndex( qBox.second, static_cast<unsigned>(level), qBox.second);
+
+    GISMO_ASSERT( !isDegenerate(qBox),
+                  "boxSearch: Wrong order of points defining the box (or empty box): "
+                  << qBox.first.transpose() <<", "<< qBox.second.transpose() <<".\n" );
+
+    typename visitor::return_type res = visitor::init;
+
+    // At most one pending right child per tree level
+    STACK_ARRAY(int, stack, m_maxPath + 1);
+    int top = 0;
+    int cur = 0;
+    while ( true )
+    {
+        const flatNode & fn = m_flat[cur];
+        if ( -1 == fn.axis ) // leaf
+        {
+            visitor::visitLevel(fn.link, level, res);
+            if ( 0 == top )
+                break;
+            cur = stack[--top];
+        }
+        else if ( qBox.second[fn.axis] <= fn.pos )
+            // qBox overlaps only left child of this split-node
+            ++cur;
+        else if ( qBox.first[fn.axis] >= fn.pos )
+            // qBox overlaps only right child of this split-node
+            cur = fn.link;
+        else
+        {
+            // qBox overlaps both children of this split-node
+            stack[top++] = fn.link;
+            ++cur;
+        }
+    }
+    return res;
+}
+
+template<short_t d, class T>
+int gsHDomain<d,T>::flatPointSearch(const point & p, int level) const
+{
+    point pp;
+    local2globalIndex(p, static_cast<unsigned>(level), pp);
+
+    GISMO_ASSERT( ( pp.array() <= m_upperIndex.array() ).all(),
+        "pointSearch: Wrong input: "<< p.transpose()<<", level "<<level<<".\n" );
+
+    int cur = 0;
+    while ( -1 != m_flat[cur].axis )
+        cur = ( pp[m_flat[cur].axis] < m_flat[cur].pos ? cur + 1 : m_flat[cur].link );
+    return m_flat[cur].link;
+}
+
 template<short_t d, class T>
 typename gsHDomain<d,T>::node *
 gsHDomain<d,T>::pointSearch(const point & p, int level, node  *_node ) const
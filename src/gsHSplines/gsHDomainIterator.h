@@ -123,6 +123,22 @@ public:
         return m_leaf.level();
     }
 
+    /// \brief Returns the indices of the basis functions which are
+    /// active on the current element.
+    ///
+    /// They are computed on the first call for each element and
+    /// shared by all points of the element.
+    const gsMatrix<index_t> & activeFunctions()
+    {
+        if ( ! m_activesValid )
+        {
+            static_cast<const gsHTensorBasis<d,T>*>(m_basis)
+                ->elementActive_into(center, m_leaf.level(), m_actives);
+            m_activesValid = true;
+        }
+        return m_actives;
+    }
+
 private:
 
     gsHDomainIterator();
@@ -179,6 +195,8 @@ private:
     /// active functions.
     void updateElement()
     {
+        m_activesValid = false;
+
         // Update cell data
         for (unsigned i = 0; i < d ; ++i)
         {
@@ -216,6 +234,10 @@ private:
 
     // parameter coordinates of current grid cell
     gsVector<T> m_lower, m_upper;
+
+    // Active functions of the current element, see activeFunctions()
+    gsMatrix<index_t> m_actives;
+    bool m_activesValid;
 };
 
 } // end namespace gismo
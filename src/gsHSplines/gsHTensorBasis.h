@@ -23,6 +23,8 @@
 
 #include <gsNurbs/gsTensorBSplineBasis.h>
 #include <gsNurbs/gsBSplineBasis.h> // for gsBasis::component(short_t)
+#include <gsNurbs/gsKnotLocator.h>
+#include <gsHSplines/gsCharMatrixIndex.h>
 
 #include <gsUtils/gsSortedVector.h>
 
@@ -220,8 +222,7 @@ public:
                 k2[j] = m_bases[levels[i]]->knots(j).uFind(boxes(j,2*i+1)).uIndex()+1;
             }
 
-            /* m_boxHistory.push_back( box(k1,k2,levels[i]) );  */
-            this->m_tree.insertBox(k1,k2, levels[i]);
+            insert_box(k1,k2, levels[i]);
 
             // Build the characteristic matrices (note: call is non-vritual)
             update_structure();
@@ -242,6 +243,10 @@ public:
             m_deg            = o.m_deg;
             m_tree           = o.m_tree;
             m_xmatrix        = o.m_xmatrix;
+            m_xindex         = o.m_xindex;
+            for (short_t i = 0; i != d; ++i)
+                m_spanLocator[i] = o.m_spanLocator[i];
+            m_newBoxes       = o.m_newBoxes;
 
             freeAll( m_bases );
             m_bases.resize( o.m_bases.size() );
@@ -261,8 +266,12 @@ public:
         m_deg     = std::move(other.m_deg);
         m_bases   = std::move(other.m_bases);
         m_xmatrix = std::move(other.m_xmatrix);
+        m_xindex  = std::move(other.m_xindex);
         m_tree    = std::move(other.m_tree);
         m_xmatrix_offset = std::move(other.m_xmatrix_offset);
+        for (short_t i = 0; i != d; ++i)
+            m_spanLocator[i] = std::move(other.m_spanLocator[i]);
+        m_newBoxes = std::move(other.m_newBoxes);
         return *this;
     }
 #endif
@@ -309,6 +318,10 @@ protected:
     /// These indices are stored as the global indices in \f$B^k\f$.
     std::vector< CMatrix > m_xmatrix;
 
+    /// \brief Position lookup in the characteristic matrices,
+    /// updated by update_structure()
+    std::vector<gsCharMatrixIndex> m_xindex;
+
     /// The tree structure of the index space
     hdomain_type m_tree;
 
@@ -334,6 +347,17 @@ public:
     /// level \em k (i.e., those taken from \f$ B^k \f$) start.
     std::vector<index_t> m_xmatrix_offset;
 
+    /// \brief Knot-span lookup in each direction of the finest
+    /// inserted level, updated by update_structure()
+    gsKnotLocator<T> m_spanLocator[d];
+
+    /// \brief The boxes inserted since the last update_structure(),
+    /// in the format of refineElements()
+    ///
+    /// If non-empty, update_structure() recomputes only the functions
+    /// whose support overlaps these boxes.
+    std::vector<index_t> m_newBoxes;
+
     //------------------------------------
 
 public:
@@ -469,6 +493,13 @@ public:
     // Look at gsBasis.h for the documentation of this function
     void active_into(const gsMatrix<T> & u, gsMatrix<index_t>& result) const;
 
+    /// \brief Returns the indices of the functions active on the
+    /// element of \a level which contains the point \a center.
+    ///
+    /// Unlike active_into, the level of the element is known, so the
+    /// tree is not searched. Used by gsHDomainIterator.
+    void elementActive_into(const gsVector<T> & center, const int level,
+                            gsMatrix<index_t>& result) const;
 
     // Look at gsBasis.h for the documentation of this function
     gsMatrix<index_t> allBoundary( ) const;
@@ -848,6 +879,12 @@ protected:
     /// in the hierarachy
     void needLevel(int maxLevel) const;
 
+    /// @brief Returns in \a result the sorted tensor indices of the
+    /// functions of \a level whose support overlaps one of \a boxes,
+    /// given in the format of refineElements()
+    void functionsOverlapping(const std::vector<index_t> & boxes, const int level,
+                              std::vector<index_t> & result) const;
+
     /// @brief Creates \a numLevels extra grids in the hierarchy
     void createMoreLevels(int numLevels) const;
 
@@ -866,11 +903,20 @@ private:
     /// \brief Returns the basis functions of \a level which have support on \a
     /// box, represented as an index box
     void functionOverlap(const point & boxLow, const point & boxUpp,
-                         const int level, point & actLow, point & actUpp);
+                         const int level, point & actLow, point & actUpp) const;
 
     // \brief Sets all functions of \a level to active or passive- one by one
     void set_activ1(int level);
 
+    // \brief Sets the functions of \a level overlapping the boxes in
+    // m_newBoxes to active or passive, keeping the others
+    void update_activ(int level);
+
+    // \brief Appends to \a result the active functions of the levels
+    // up to \a lvl which are non-zero at the point \a pt
+    void appendActive(const gsMatrix<T> & pt, const int lvl,
+                      std::vector<index_t> & result) const;
+
     // \brief Computes the set of active basis functions in the basis
     void setActive();
 
@@ -47,7 +47,7 @@ index_t gsHTensorBasis<d,T>::getLevelAtPoint(const gsMatrix<T> & Pt) const
     const int maxLevel = m_tree.getMaxInsLevel();
 
     for( int i =0; i < Dim; i++)
-        loIdx[i] = m_bases[maxLevel]->knots(i).uFind( Pt(i,0) ).uIndex();
+        loIdx[i] = m_spanLocator[i].uIndex( Pt(i,0) );
 
     return m_tree.levelOf( loIdx, maxLevel);
 }
@@ -81,7 +81,7 @@ void gsHTensorBasis<d,T>::numActive_into(const gsMatrix<T> & u, gsVector<index_t
     for(index_t p = 0; p < u.cols(); p++ ) //for all input points
     {
         for(short_t i = 0; i != d; ++i)
-            low[i] = m_bases[maxLevel]->knots(i).uFind(u(i,p)).uIndex();
+            low[i] = m_spanLocator[i].uIndex( u(i,p) );
 
         // Identify the level of the point
         const int lvl = m_tree.levelOf(low, maxLevel);
@@ -92,10 +92,7 @@ void gsHTensorBasis<d,T>::numActive_into(const gsMatrix<T> & u, gsVector<index_t
             cur = low;
             do //iterate over all points in [low,upp]
             {
-                CMatrix::const_iterator it =
-                    m_xmatrix[i].find_it_or_fail( m_bases[i]->index(cur) );
-                
-                if( it != m_xmatrix[i].end() )// if index is found
+                if( m_xindex[i].find( m_bases[i]->index(cur) ) != -1 )
                     result[p]++;
             }
             while( nextCubePoint(cur,low,upp) );
@@ -346,9 +343,7 @@ void gsHTensorBasis<d,T>::refine(gsMatrix<T> const & boxes, int refExt)
         // ...and refine
         this->refineElements( refVector );
     }
-
-    // Update the basis
-    update_structure();
+    // Note: both branches have updated the basis
 }
 
 template<short_t d, class T>
@@ -399,8 +394,19 @@ void gsHTensorBasis<d,T>::refine(gsMatrix<T> const & boxes)
         //const tensorBasis & tb = tensorLevel(level);
         //GISMO_UNUSED(tb);
 
+        // A leaf of level L is raised on whole cells of level L, so
+        // the changed region is the box rounded outwards to the
+        // coarsest level it overlaps
+        const int cLevel = m_tree.query3(k1, k2, fLevel);
+        const int s = fLevel - cLevel;
+
         // Sink box
         m_tree.sinkBox(k1, k2, fLevel);
+        m_newBoxes.push_back(cLevel);
+        for (short_t j = 0; j != d; ++j)
+            m_newBoxes.push_back( k1[j] >> s );
+        for (short_t j = 0; j != d; ++j)
+            m_newBoxes.push_back( ( k2[j] + (1 << s) - 1 ) >> s );
         // Make sure we have enough levels
         needLevel( m_tree.getMaxInsLevel() );
     }
@@ -604,7 +610,7 @@ void gsHTensorBasis<d,T>::set_activ1(int level)
 
 template<short_t d, class T>
 void gsHTensorBasis<d,T>::functionOverlap(const point & boxLow, const point & boxUpp,
-                                          const int level, point & actLow, point & actUpp)
+                                          const int level, point & actLow, point & actUpp) const
 {
     const tensorBasis & tb = *m_bases[level];
     for(short_t i = 0; i != d; ++i)
@@ -618,6 +624,102 @@ void gsHTensorBasis<d,T>::functionOverlap(const point & boxLow, const point & bo
     }
 }
 
+template<short_t d, class T>
+void gsHTensorBasis<d,T>::functionsOverlapping(const std::vector<index_t> & boxes,
+                                               const int level,
+                                               std::vector<index_t> & result) const
+{
+    result.clear();
+    const tensorBasis & tb = *m_bases[level];
+    point low, upp, actLow, actUpp;
+    for (size_t b = 0; b < boxes.size(); b += 2*d+1)
+    {
+        // Box in the unique knot indices of level
+        const int bLevel = boxes[b];
+        bool empty = false;
+        for (short_t i = 0; i != d; ++i)
+        {
+            if ( level >= bLevel )
+            {
+                low[i] = boxes[b+1+i]   << (level - bLevel);
+                upp[i] = boxes[b+1+d+i] << (level - bLevel);
+            }
+            else // round outwards
+            {
+                const int s = bLevel - level;
+                low[i] =   boxes[b+1+i] >> s;
+                upp[i] = ( boxes[b+1+d+i] + (1 << s) - 1 ) >> s;
+            }
+            upp[i] = math::min(upp[i], static_cast<index_t>(tb.knots(i).uSize()) - 1);
+            empty = empty || low[i] >= upp[i];
+        }
+        if ( empty )
+            continue;
+
+        functionOverlap(low, upp, level, actLow, actUpp);
+        for (short_t i = 0; i != d; ++i)
+        {
+            actLow[i] = math::max(actLow[i], (index_t)0);
+            actUpp[i] = math::min(actUpp[i], tb.size(i) - 1);
+            empty = empty || actLow[i] > actUpp[i];
+        }
+        if ( empty )
+            continue;
+
+        point cur = actLow;
+        do
+        {
+            result.push_back( tb.index(cur) );
+        }
+        while( nextCubePoint(cur, actLow, actUpp) );
+    }
+
+    std::sort(result.begin(), result.end());
+    result.erase( std::unique(result.begin(), result.end()), result.end() );
+}
+
+template<short_t d, class T>
+void gsHTensorBasis<d,T>::update_activ(int level)
+{
+    CMatrix & cmat = m_xmatrix[level];
+
+    if ( level > static_cast<int>(m_tree.getMaxInsLevel() ) )
+    {
+        cmat.clear();
+        return;
+    }
+
+    // The activity of a function depends only on the domain inside
+    // its support, so only the functions overlapping the new boxes
+    // need to be checked
+    std::vector<index_t> cand;
+    functionsOverlapping(m_newBoxes, level, cand);
+    if ( cand.empty() )
+        return;
+
+    const tensorBasis & tb = *m_bases[level];
+    gsMatrix<index_t,d,2> elSupp;
+    CMatrix result;
+    result.reserve( cmat.size() + cand.size() );
+    CMatrix::const_iterator it = cmat.begin();
+    for (std::vector<index_t>::const_iterator c = cand.begin(); c != cand.end(); ++c)
+    {
+        // Keep the entries which are not candidates
+        for (; it != cmat.end() && *it < *c; ++it)
+            result.push_unsorted(*it);
+        if ( it != cmat.end() && *it == *c )
+            ++it;
+
+        tb.elementSupport_into(*c, elSupp);
+        if ( m_tree.query3(elSupp.col(0), elSupp.col(1), level) == level) //if active
+            result.push_unsorted(*c);
+    }
+    for (; it != cmat.end(); ++it)
+        result.push_unsorted(*it);
+    cmat.swap(result);
+    cmat.SetSorted();
+}
+
 template<short_t d, class T>
 void gsHTensorBasis<d,T>::setActive()
 {
@@ -741,6 +843,11 @@ void gsHTensorBasis<d,T>::insert_box(typename gsHTensorBasis<d,T>::point const &
 
     m_tree.insertBox(k1,k2, lvl);
     needLevel( m_tree.getMaxInsLevel() );
+
+    // Remember the box for the update of the structure
+    m_newBoxes.push_back(lvl);
+    m_newBoxes.insert(m_newBoxes.end(), k1.data(), k1.data() + d);
+    m_newBoxes.insert(m_newBoxes.end(), k2.data(), k2.data() + d);
 }
 
 template<short_t d, class T>
@@ -755,6 +862,7 @@ void gsHTensorBasis<d,T>::makeCompressed()
         m_bases.erase( m_bases.begin() );
         m_tree.decrementLevel();
         m_xmatrix.erase( m_xmatrix.begin() );
+        m_xindex .erase( m_xindex .begin() );
         m_xmatrix_offset.erase( m_xmatrix_offset.begin() );
     }
     // Note/to do: cleaning up empty levels at the end as well.
@@ -802,11 +910,8 @@ int gsHTensorBasis<d,T>::flatTensorIndexToHierachicalIndex(index_t index,const i
 {
     if( m_xmatrix.size()<=static_cast<size_t>(level) )
         return -1;
-    CMatrix::const_iterator it = std::lower_bound(m_xmatrix[level].begin(), m_xmatrix[level].end(), index );
-    if(it == m_xmatrix[level].end() || *it != index)
-        return -1;
-    else
-        return m_xmatrix_offset[level] + ( it - m_xmatrix[level].begin() );
+    const index_t pos = m_xindex[level].find(index);
+    return ( pos == -1 ? -1 : m_xmatrix_offset[level] + pos );
 }
 
 template<short_t d, class T>
@@ -838,15 +943,33 @@ void gsHTensorBasis<d,T>::update_structure() // to do: rename as updateHook
     // Make sure we have computed enough levels
     needLevel( m_tree.getMaxInsLevel() );
 
-    // Setup the characteristic matrices
-    m_xmatrix.clear();
-    m_xmatrix.resize( m_bases.size() );
-
     // Compress the tree
     m_tree.makeCompressed();
 
+    // Setup the characteristic matrices
+    if ( m_newBoxes.empty() || m_xmatrix.empty() )
+    {
+        m_xmatrix.clear();
+        m_xmatrix.resize( m_bases.size() );
+        for(size_t i = 0; i != m_xmatrix.size(); i ++)
+            set_activ1(i);
+    }
+    else // only boxes were inserted since the last update
+    {
+        m_xmatrix.resize( m_bases.size() );
+        for(size_t i = 0; i != m_xmatrix.size(); i ++)
+            update_activ(i);
+    }
+    m_newBoxes.clear();
+
+    // Constant-time lookup in the characteristic matrices
+    m_xindex.resize( m_xmatrix.size() );
     for(size_t i = 0; i != m_xmatrix.size(); i ++)
-        set_activ1(i);
+        m_xindex[i].init(m_xmatrix[i].begin(), m_xmatrix[i].end(), m_bases[i]->size());
+
+    // Knot-span lookup on the finest level
+    for(short_t i = 0; i != d; ++i)
+        m_spanLocator[i].init( m_bases[m_tree.getMaxInsLevel()]->knots(i) );
 
     // Store all indices of active basis functions to m_matrix
     //setActive();
@@ -919,54 +1042,34 @@ template<short_t d, class T>
 void gsHTensorBasis<d,T>::active_into(const gsMatrix<T> & u, gsMatrix<index_t>& result) const
 {
     gsMatrix<T> currPoint;
-    point low, upp, cur;
-    const int maxLevel = m_tree.getMaxInsLevel();
+    point low, prev;
 
     std::vector<std::vector<index_t> > temp_output;//collects the outputs
     temp_output.resize( u.cols() );
     size_t sz = 0;
 
-    //gsMatrix<index_t> activesLvl;
+    // Knot spans on the finest level, one sweep per direction
+    gsVector<index_t> span[d];
+    for(short_t i = 0; i != d; ++i)
+        m_spanLocator[i].uIndex_into(u.row(i), span[i]);
 
     for(index_t p = 0; p < u.cols(); p++) //for all input points
     {
-        currPoint = u.col(p);
-        
         for(short_t i = 0; i != d; ++i)
-            low[i] = m_bases[maxLevel]->knots(i).uFind( currPoint(i,0) ).uIndex();
-        
-        // Identify the level of the point
-        const int lvl = m_tree.levelOf(low, maxLevel);
+            low[i] = span[i][p];
 
-        for(int i = 0; i <= lvl; i++)
+        if ( p != 0 && low == prev )
         {
-            /*
-              m_bases[i]->active_into(currPoint, activesLvl);
-              
-              std::set_intersection(m_xmatrix[i].begin(), m_xmatrix[i].end(),
-              activesLvl.data(), activesLvl.data() + activesLvl.size(),
-              std::back_inserter( temp_output[p] ) );
-              +++ Renumbering to H-basis indexing
-            // */                                 
-
-            // /*
-            m_bases[i]->active_cwise(currPoint, low, upp);
-            cur = low;
-            do
-            {
-                CMatrix::const_iterator it =
-                    m_xmatrix[i].find_it_or_fail( m_bases[i]->index(cur) );
-
-                if( it != m_xmatrix[i].end() )// if index is found
-                {
-                    temp_output[p].push_back(
-                        this->m_xmatrix_offset[i] + (it - m_xmatrix[i].begin() )
-                        );
-                }
-            }
-            while( nextCubePoint(cur,low,upp) );
-            //*/
+            // Same element as the previous point, same actives
+            temp_output[p] = temp_output[p-1];
+            continue;
         }
+        prev = low;
+
+        // Identify the level of the point
+        currPoint = u.col(p);
+        appendActive(currPoint, m_tree.levelOf(low, m_tree.getMaxInsLevel()),
+                     temp_output[p]);
 
         // update result size
         if ( temp_output[p].size() > sz )
@@ -982,6 +1085,34 @@ void gsHTensorBasis<d,T>::active_into(const gsMatrix<T> & u, gsMatrix<index_t>&
     }
 }
 
+template<short_t d, class T>
+void gsHTensorBasis<d,T>::elementActive_into(const gsVector<T> & center, const int level,
+                                             gsMatrix<index_t>& result) const
+{
+    std::vector<index_t> act;
+    appendActive(center, level, act);
+    result = gsAsConstVector<index_t>(act);
+}
+
+template<short_t d, class T>
+void gsHTensorBasis<d,T>::appendActive(const gsMatrix<T> & pt, const int lvl,
+                                       std::vector<index_t> & result) const
+{
+    point low, upp, cur;
+    for(int i = 0; i <= lvl; i++)
+    {
+        m_bases[i]->active_cwise(pt, low, upp);
+        cur = low;
+        do
+        {
+            const index_t pos = m_xindex[i].find( m_bases[i]->index(cur) );
+            if( pos != -1 )// if index is found
+                result.push_back( m_xmatrix_offset[i] + pos );
+        }
+        while( nextCubePoint(cur,low,upp) );
+    }
+}
+
 template<short_t d, class T>
 gsMatrix<index_t>  gsHTensorBasis<d,T>::allBoundary( ) const
 {
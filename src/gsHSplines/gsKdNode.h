@@ -31,6 +31,8 @@ struct gsAabb
 public:
     typedef gsVector<Z,d> point;
 
+    gsAabb() { }
+
     gsAabb(const point & l, const point & u)
     {
         first  = l;
@@ -51,6 +53,8 @@ public:
     EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 };
 
+template<short_t d, class Z> class kdnodePool;
+
 /**
     @brief Struct representing a kd-tree node
 
@@ -58,6 +62,9 @@ public:
     - Split nodes
     - Leaf nodes
 
+    The nodes and their boxes are taken from a kdnodePool, which
+    owns them; a node does not free its children.
+
     Template parameters
     \param d is the dimension
     \param Z is the box-coordinate index type
@@ -101,68 +108,6 @@ struct kdnode
                parent(0), left(0), right(0)
     { }
 
-    /// Constructor (root node)
-    kdnode(point const & upp) : axis(-1) , level(0),
-                                parent(0), left(0) , right(0)
-    { 
-        // Initial box, upp is expected to be indexed in finest level
-        box = new kdBox( point::Zero(), upp);
-    }
-
-    /// Constructor (leaf node)
-    kdnode(kdBox const & bb) 
-        : axis(-1) , level(0),
-          parent(0), left(0) , right(0)
-    { 
-        // ..
-    }
-    
-    /// Recursively copies the whole subtree under \a o, and sets it's
-    /// parent to \a parentNode
-    kdnode(const kdnode & o, kdnode * parentNode = NULL) : 
-        axis(o.axis), level(o.level)
-    {
-        parent = parentNode;
-        if ( axis == -1 )
-        {
-            GISMO_ASSERT( (o.left == 0) && (o.right == 0), 
-                          "Problem: leaf with children." );
-            box  = new kdBox(*o.box);
-            left = right = NULL;
-        }
-        else
-        {
-            GISMO_ASSERT( o.box == 0, 
-                          "Problem: split node with box." );
-            pos   = o.pos;
-            left  = new kdnode(*o.left , this);
-            right = new kdnode(*o.right, this);
-            box   = NULL;
-        }
-    }
-
-    /// Recursively deletes the whole subtree under this node
-    ~kdnode()
-    {
-        // to do: non-reccursive
-
-        if ( isLeaf() ) 
-        {
-            // No throw in destructor
-            //GISMO_ASSERT( (left == 0) && (right == 0), 
-            //              "Problem: leaf with children." );
-                delete box;
-        }
-        else
-        {
-            // No throw in destructor
-            //GISMO_ASSERT( box == 0, 
-            //              "Problem: split node with box." );
-            delete left;
-            delete right;
-        }
-    }
-
     // Box Accessors
     const point & lowCorner() const 
     { 
@@ -206,16 +151,17 @@ struct kdnode
         }
     }
 
-    // Splits the node (ie. two children are added)
-    inline void split()
+    // Splits the node (ie. two children are added), the children
+    // are taken from \a pool
+    inline void split(kdnodePool<d,Z> & pool)
     {
         GISMO_ASSERT( (left == 0) && (right == 0),
                       "Can only split leaf nodes.");
         GISMO_ASSERT( axis > -1, "Split axis not prescribed.");
 
         // Make new left and right children
-        left          = new kdnode;
-        right         = new kdnode;
+        left          = pool.newNode();
+        right         = pool.newNode();
         // Set axis to -1 (since they are leaves)
         left ->axis   =
         right->axis   = -1;
@@ -227,7 +173,7 @@ struct kdnode
         right->level  = level;
         // Set box
         left ->box    = box;    
-        right->box    = new kdBox(*box);
+        right->box    = pool.newBox(*box);
         // Detach box from parent (is now at left child)
         box = NULL;
         // Resize properly the box coordinates
@@ -235,8 +181,9 @@ struct kdnode
         right->box->first [axis] = pos;
     }
 
-    // Merges terminal node (ie. two children are joined)
-    inline void merge()
+    // Merges terminal node (ie. two children are joined), the
+    // children are returned to \a pool
+    inline void merge(kdnodePool<d,Z> & pool)
     {
         GISMO_ASSERT( (left->isLeaf()) && (right->isLeaf()),
                       "Can only merge terminal nodes.");
@@ -249,36 +196,36 @@ struct kdnode
         level = left->level;
 
         // Delete children
-        delete  left;
+        pool.deleteNode(left);
         left  = NULL;
-        delete right;
+        pool.deleteNode(right);
         right = NULL;
     }
 
 
     // Splits the node (ie. two children are added)
-    void split(int splitAxis, Z splitPos)
+    void split(int splitAxis, Z splitPos, kdnodePool<d,Z> & pool)
     {
         GISMO_ASSERT( box->second[splitAxis] != splitPos, "Degenerate split");
         GISMO_ASSERT( box->first [splitAxis] != splitPos, "Degenerate split");
         axis = splitAxis;
         pos  = splitPos;
-        split();
+        split(pool);
     }
 
     /// Splits the node in the middle (ie. two children are added)
     // to do: remove
-    void nextMidSplit()
+    void nextMidSplit(kdnodePool<d,Z> & pool)
     {        
         axis = ( parent == 0 ? 0 : (parent->axis+1)%d );        
         pos  = box->first [axis] + 
             (box->second[axis] - box->first[axis])/2 ;
-        split(); // Can be degenerate
+        split(pool); // Can be degenerate
     }
 
     /// Splits the node in the middle (ie. two children are added)
     /// If non-degenerate split is impossible, then this is a no-op
-    void anyMidSplit(int index_level)
+    void anyMidSplit(int index_level, kdnodePool<d,Z> & pool)
     {        
         const unsigned h = 1 << (index_level - level) ;
         const unsigned mask = ~(h - 1);
@@ -288,7 +235,7 @@ struct kdnode
                 (box->first [i] + (box->second[i] - box->first[i])/2) & mask ;
             if ( c != box->first [i] ) // avoid degenerate split
             {
-                split(i, c);
+                split(i, c, pool);
                 return;
             }
         }
@@ -300,7 +247,8 @@ struct kdnode
     /// then this is a no-op.
     /// Splitting is done on a coordinate of the current \a level (aligned)
     /// returns the child that intersects \a insBox or NULL (if no split)
-    kdnode * adaptiveAlignedSplit(kdBox const & insBox, int index_level)
+    kdnode * adaptiveAlignedSplit(kdBox const & insBox, int index_level,
+                                  kdnodePool<d,Z> & pool)
     {
         const unsigned h = 1 << (index_level - level) ;
         //const unsigned mask = ~(h - 1);
@@ -317,13 +265,13 @@ struct kdnode
             if ( c1 > box->first[i] )
             {
                 // right child intersects insBox
-                split(i, c1 );
+                split(i, c1, pool);
                 return right;
             }
             else if ( c2 < box->second[i]  )
             {
                 // left child intersects insBox
-                split(i, c2 );
+                split(i, c2, pool);
                 return left;
             }
         }
@@ -334,7 +282,7 @@ struct kdnode
     /// according to \a insBox.  If non-degenerate split is impossible,
     /// then this is a no-op
     // to do: remove
-    kdnode * adaptiveSplit(kdBox const & insBox)
+    kdnode * adaptiveSplit(kdBox const & insBox, kdnodePool<d,Z> & pool)
     {
         // assumption: insBox intersects box
         for ( unsigned i = 0; i < d; ++i )
@@ -345,14 +293,14 @@ struct kdnode
             {
                 axis = i;
                 pos  = insBox.first[i];
-                split();
+                split(pool);
                 return right;
             }
             else if ( insBox.second[i] < box->second[i] )
             {
                 axis = i;
                 pos  = insBox.second[i];
-                split();
+                split(pool);
                 return left ;
             }
         }
@@ -379,4 +327,183 @@ struct kdnode
 };
 
 
+
+/**
+    @brief Pool of the nodes of a kd-tree and of their boxes
+
+    The nodes and boxes are taken from chunks of contiguous storage,
+    so that the nodes created by consecutive splits, e.g. by
+    gsHDomain::insertBox, are close in memory, and released nodes are
+    reused before the storage grows. All nodes and boxes are freed
+    together with the pool.
+
+    Template parameters
+    \param d is the dimension
+    \param Z is the box-coordinate index type
+
+    \ingroup HSplines
+*/
+template<short_t d, class Z = index_t>
+class kdnodePool
+{
+public:
+    typedef kdnode<d,Z> node;
+    typedef typename node::kdBox kdBox;
+    typedef typename node::point point;
+
+    kdnodePool() : m_usedNodes(chunkSize), m_usedBoxes(chunkSize) { }
+
+    ~kdnodePool() { clear(); }
+
+private:
+    // Nodes refer to each other, so the pool is not copied
+    kdnodePool(const kdnodePool &);
+    kdnodePool & operator=(const kdnodePool &);
+
+public:
+
+    /// Returns an empty node
+    node * newNode()
+    {
+        node * n = take(m_nodeChunks, m_freeNodes, m_usedNodes);
+        *n = node();
+        return n;
+    }
+
+    /// Returns a copy of the box \a b
+    kdBox * newBox(const kdBox & b)
+    {
+        kdBox * result = take(m_boxChunks, m_freeBoxes, m_usedBoxes);
+        *result = b;
+        return result;
+    }
+
+    /// Returns a leaf node with the box [\a lower, \a upper]
+    node * newLeaf(const point & lower, const point & upper)
+    {
+        node * n = newNode();
+        n->axis = -1;
+        n->box  = newBox( kdBox(lower, upper) );
+        return n;
+    }
+
+    /// Releases the node \a n and its box, but not its children
+    void deleteNode(node * n)
+    {
+        if ( n->box )
+            m_freeBoxes.push_back(n->box);
+        m_freeNodes.push_back(n);
+    }
+
+    /// Releases the subtree under \a n
+    void deleteTree(node * n)
+    {
+        std::vector<node*> stack(1, n);
+        while ( ! stack.empty() )
+        {
+            n = stack.back();
+            stack.pop_back();
+            if ( ! n->isLeaf() )
+            {
+                stack.push_back(n->right);
+                stack.push_back(n->left );
+            }
+            deleteNode(n);
+        }
+    }
+
+    /// Copies the subtree under \a o into this pool, in pre-order
+    node * copyTree(const node & o)
+    {
+        node * result = newNode();
+        std::vector<std::pair<const node*, node*> > stack(1, std::make_pair(&o, result));
+        while ( ! stack.empty() )
+        {
+            const node * src = stack.back().first;
+            node * n = stack.back().second;
+            stack.pop_back();
+            n->axis  = src->axis;
+            n->level = src->level;
+            if ( src->isLeaf() )
+                n->box = newBox(*src->box);
+            else
+            {
+                n->pos   = src->pos;
+                n->left  = newNode();
+                n->right = newNode();
+                n->left ->parent =
+                n->right->parent = n;
+                stack.push_back(std::make_pair(src->right, n->right));
+                stack.push_back(std::make_pair(src->left , n->left ));
+            }
+        }
+        return result;
+    }
+
+    /// Frees all nodes and boxes
+    void clear()
+    {
+        for (size_t i = 0; i != m_nodeChunks.size(); ++i)
+            delete[] m_nodeChunks[i];
+        for (size_t i = 0; i != m_boxChunks.size(); ++i)
+            delete[] m_boxChunks[i];
+        m_nodeChunks.clear();
+        m_boxChunks .clear();
+        m_freeNodes .clear();
+        m_freeBoxes .clear();
+        m_usedNodes = m_usedBoxes = chunkSize;
+    }
+
+    /// Swaps the storage with \a other, the nodes keep their addresses
+    void swap(kdnodePool & other)
+    {
+        m_nodeChunks.swap(other.m_nodeChunks);
+        m_boxChunks .swap(other.m_boxChunks );
+        m_freeNodes .swap(other.m_freeNodes );
+        m_freeBoxes .swap(other.m_freeBoxes );
+        std::swap(m_usedNodes, other.m_usedNodes);
+        std::swap(m_usedBoxes, other.m_usedBoxes);
+    }
+
+    /// Memory allocated for nodes and boxes, in bytes
+    size_t memoryUsage() const
+    {
+        return chunkSize * ( m_nodeChunks.size() * sizeof(node) + m_boxChunks.size() * sizeof(kdBox) )
+            + ( m_freeNodes.capacity() + m_nodeChunks.capacity() ) * sizeof(node*)
+            + ( m_freeBoxes.capacity() + m_boxChunks .capacity() ) * sizeof(kdBox*);
+    }
+
+private:
+
+    // Takes an object from the free list, or the next one of the
+    // last chunk, allocating a new chunk if it is full
+    template<class Obj>
+    static Obj * take(std::vector<Obj*> & chunks, std::vector<Obj*> & freeList, size_t & used)
+    {
+        if ( ! freeList.empty() )
+        {
+            Obj * result = freeList.back();
+            freeList.pop_back();
+            return result;
+        }
+        if ( static_cast<size_t>(chunkSize) == used )
+        {
+            chunks.push_back(new Obj[chunkSize]);
+            used = 0;
+        }
+        return chunks.back() + used++;
+    }
+
+private:
+
+    // Number of objects per chunk
+    enum { chunkSize = 256 };
+
+    std::vector<node*>  m_nodeChunks, m_freeNodes;
+    std::vector<kdBox*> m_boxChunks , m_freeBoxes;
+
+    // Objects taken from the last chunk
+    size_t m_usedNodes, m_usedBoxes;
+};
+
 }// namespace gismo
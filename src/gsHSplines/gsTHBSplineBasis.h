@@ -92,6 +92,20 @@ public:
     : gsHTensorBasis<d,T>(tbasis, boxes)
     { representBasis(); }
 
+    /// @brief Constructor out of a tensor B-spline basis, the boxes
+    /// of the refinement and the representations of the truncated
+    /// basis functions, as given by truncationLevels() and truncation().
+    ///
+    /// The representations are computed anew if their structure does
+    /// not fit the basis, see representBasis(const gsVector<int>&, const gsSparseMatrix<T,RowMajor>&).
+    /// The values of the coefficients are trusted.
+    gsTHBSplineBasis(gsTensorBSplineBasis<d,T> const&  tbasis,
+                     const std::vector<index_t> & boxes,
+                     const gsVector<int> & truncLevels,
+                     const gsSparseMatrix<T,RowMajor> & trunc)
+    : gsHTensorBasis<d,T>(tbasis, boxes)
+    { representBasis(truncLevels, trunc); }
+
     gsTHBSplineBasis(gsTensorBSplineBasis<d,T> const&  tbasis, 
                      gsMatrix<T> const & boxes)
     : gsHTensorBasis<d,T>(tbasis, boxes) 
@@ -137,209 +151,21 @@ public:
                              const gsMatrix<T> & u,
                           gsMatrix<T>& result) const;
 
-    // look at eval_into
+    /// @brief Same as eval_into(), which evaluates the tensor basis
+    /// of every level once for all points
     void fastEval_into(const gsMatrix<T>& u,
                        gsMatrix<T>& result) const
-    {
-        gsMatrix<index_t> indices;
-        this->active_into(u, indices);
-
-        result.setZero(indices.rows(), u.cols());
-
-        const unsigned maxLvl = this->m_tree.getMaxInsLevel() + 1;
-        std::vector< gsMatrix<T> > tmpResults(maxLvl, gsMatrix<T>());
-        std::vector< gsMatrix<index_t> > tmpActive(maxLvl, gsMatrix<index_t>());
-        gsVector<int> processed(maxLvl);
+    { eval_into(u, result); }
 
-        for (int pt = 0; pt != u.cols(); pt++)
-        {
-            processed.setZero();
-
-            for (int ind = 0; ind != indices.rows(); ind++)
-            {
-                unsigned index = indices(ind, pt);
-                if (ind != 0 && index == 0)
-                    break;
-
-                unsigned lvl = getPresLevelOfBasisFun(index);
-
-                if (processed(lvl) == 0)
-                {
-                    this->m_bases[lvl]->eval_into(u.col(pt), tmpResults[lvl]);
-                    this->m_bases[lvl]->active_into(u.col(pt), tmpActive[lvl]);
-                    processed(lvl) = 1;
-                }
-
-                if (m_is_truncated[index] == -1)
-                {
-                    index_t flatTenIndx = this->flatTensorIndexOf(index, lvl);
-                    int localIndex = -1;
-                    for (int row = 0; row != tmpActive[lvl].rows(); ++row)
-                    {
-                        if (tmpActive[lvl](row, 0) == flatTenIndx)
-                        {
-                            localIndex = row;
-                            break;
-                        }
-                    }
-                    result(ind, pt) = tmpResults[lvl](localIndex, 0);
-                }
-                else // basis function is truncated
-                {
-                    const gsMatrix<T>& basis = tmpResults[lvl];
-                    const gsMatrix<index_t>& active = tmpActive[lvl];
-
-
-                    const gsSparseVector<T>& coefs = getCoefs(index);
-                    T tmp = coefs(active(0, 0)) * basis(0, 0);
-                    for (int i = 1; i < active.rows(); i++)
-                    {
-                        tmp += coefs(active(i, 0)) * basis(i, 0);
-                    }
-                    result(ind, pt) = tmp;
-                }
-            }
-        }
-    }
-
-    // look at deriv_into
+    /// @brief Same as deriv_into()
     void fastDeriv_into(const gsMatrix<T>& u,
                         gsMatrix<T>& result) const
-    {
-        gsMatrix<index_t> indices;
-        this->active_into(u, indices);
+    { deriv_into(u, result); }
 
-        result.setZero(indices.rows() * d, u.cols());
-
-        const unsigned maxLvl = this->m_tree.getMaxInsLevel() + 1;
-        std::vector< gsMatrix<T> > tmpDeriv( maxLvl, gsMatrix<T>());
-        std::vector< gsMatrix<index_t> > tmpActive(maxLvl, gsMatrix<index_t>());
-        gsVector<int> processed(maxLvl);
-
-        for (index_t pt = 0; pt != u.cols(); pt++)
-        {
-            processed.setZero();
-
-            for (int ind = 0; ind != indices.rows(); ind++)
-            {
-                index_t index = indices(ind, pt);
-                if (ind != 0 && index == 0)
-                    break;
-
-                unsigned lvl = getPresLevelOfBasisFun(index);
-
-                if (processed(lvl) == 0)
-                {
-                    this->m_bases[lvl]->deriv_into(u.col(pt), tmpDeriv[lvl]);
-                    this->m_bases[lvl]->active_into(u.col(pt), tmpActive[lvl]);
-                    processed(lvl) = 1;
-                }
-
-                if (m_is_truncated[index] == -1)
-                {
-                    index_t flatTenIndx = this->flatTensorIndexOf(index, lvl);
-                    int localIndex = -1;
-                    for (int row = 0; row != tmpActive[lvl].rows(); ++row)
-                    {
-                        if (tmpActive[lvl](row, 0) == flatTenIndx)
-                        {
-                            localIndex = row;
-                            break;
-                        }
-                    }
-
-                    result.block(ind * d, pt, d, 1) =
-                            tmpDeriv[lvl].block(localIndex * d, 0, d, 1);
-                }
-                else // basis function is truncated
-                {
-                    const gsMatrix<T>& basis = tmpDeriv[lvl];
-                    const gsMatrix<index_t>& active = tmpActive[lvl];
-                    const gsSparseVector<T>& coefs = getCoefs(index);
-
-                    for (unsigned dim = 0; dim != d; dim++) // for all deric
-                    {
-                        for (index_t i = 0; i != active.rows(); ++i)
-                        {
-                            result(ind * d + dim, pt) +=
-                                    coefs(active(i, 0)) * basis(i * d + dim, 0);
-                        }
-                    }
-                }
-            }
-        }
-    }
-
-    // look at deriv2_into
+    /// @brief Same as deriv2_into()
     void fastDeriv2_into(const gsMatrix<T>& u,
                          gsMatrix<T>& result) const
-    {
-        gsMatrix<index_t> indices;
-        this->active_into(u, indices);
-        const unsigned numDers = (d * (d + 1)) / 2;
-
-        result.setZero(indices.rows() * numDers, u.cols());
-
-        const unsigned maxLvl = this->m_tree.getMaxInsLevel() + 1;
-        std::vector< gsMatrix<T> > tmpDeriv2(maxLvl, gsMatrix<T>());
-        std::vector< gsMatrix<index_t> > tmpActive(maxLvl, gsMatrix<index_t>());
-        gsVector<int> processed(maxLvl);
-
-        for (int pt = 0; pt != u.cols(); pt++)
-        {
-            processed.setZero();
-
-            for (int ind = 0; ind != indices.rows(); ind++)
-            {
-
-                unsigned index = indices(ind, pt);
-                if (ind != 0 && index == 0)
-                    break;
-
-                unsigned lvl = getPresLevelOfBasisFun(index);
-
-                if (processed(lvl) == 0)
-                {
-                    this->m_bases[lvl]->deriv2_into(u.col(pt), tmpDeriv2[lvl]);
-                    this->m_bases[lvl]->active_into(u.col(pt), tmpActive[lvl]);
-                    processed(lvl) = 1;
-                }
-
-                if (m_is_truncated[index] == -1)
-                {
-                    index_t flatTenIndx = this->flatTensorIndexOf(index, lvl);
-                    int localIndx = -1;
-                    for (int row = 0; row != tmpActive[lvl].rows(); ++row)
-                    {
-                        if (tmpActive[lvl](row, 0) == flatTenIndx)
-                        {
-                            localIndx = row;
-                            break;
-                        }
-                    }
-
-                    result.block(ind * numDers, pt, numDers, 1) =
-                            tmpDeriv2[lvl].block(localIndx * numDers, 0, numDers, 1);
-                }
-                else // basis function is truncated
-                {
-                    const gsMatrix<T>& basis = tmpDeriv2[lvl];
-                    const gsMatrix<index_t>& active = tmpActive[lvl];
-                    const gsSparseVector<T>& coefs = getCoefs(index);
-
-                    for (unsigned der = 0; der != numDers; der++)
-                    {
-                        for (index_t i = 0; i != active.rows(); ++i)
-                        {
-                            result(ind * numDers + der, pt) +=
-                                    coefs(active(i, 0)) *
-                                    basis(i * numDers + der, 0);
-                        }
-                    }
-                }
-            }
-        }
-    }
+    { deriv2_into(u, result); }
 
     // Look at gsBasis class for documentation
     void eval_into(const gsMatrix<T> & u, gsMatrix<T>& result) const;
@@ -353,35 +179,50 @@ public:
     // eval_into from the base class.
     using gsBasis<T>::eval_into;
 
+    // Look at gsBasis class for documentation
+    void evalAllDers_into(const gsMatrix<T> & u, int n,
+                          std::vector<gsMatrix<T> >& result) const;
+
     /// @brief Returns the number of truncated basis functions
     unsigned numTruncated() const
-    { return m_presentation.size(); }
+    { return (m_is_truncated.array() != -1).count(); }
 
     bool isTruncated(unsigned i) const
     {
         return (this->m_is_truncated[i] != -1);
     }
 
-    /// @brief Returns an iterator to the representation of the first truncated basis function
-    typename std::map<index_t, gsSparseVector<T> >::const_iterator truncatedBegin() const
-    { return m_presentation.begin(); }
-
-    /// @brief Returns an iterator past the last truncated basis function
-    typename std::map<index_t, gsSparseVector<T> >::const_iterator truncatedEnd() const
-    { return m_presentation.end(); }
-
-    /// @brief Returns sparse representation of the i-th basis function.
-    const gsSparseVector<T>& getCoefs(unsigned i) const
+    /// @brief Returns the representations of the truncated basis
+    /// functions.
+    ///
+    /// Row \a i contains the coefficients of the i-th basis function
+    /// with respect to the B-splines of level
+    /// getPresLevelOfBasisFun(i), the rows of the basis functions
+    /// which are not truncated are empty.
+    const gsSparseMatrix<T,RowMajor> & truncation() const
+    { return m_presentation; }
+
+    /// @brief Returns the levels of the representations of the
+    /// basis functions, -1 for the functions which are not truncated
+    const gsVector<int> & truncationLevels() const
+    { return m_is_truncated; }
+
+    /// @brief Returns a copy of the sparse representation of the i-th
+    /// basis function, i.e., of row \a i of truncation().
+    gsSparseVector<T> getCoefs(unsigned i) const
     {
         if (this->m_is_truncated[i] == -1)
         {
             GISMO_ERROR("This basis function has no sparse representation. "
                         "It is not truncated.");
         }
-        else
-        {
-            return this->m_presentation.find(i)->second;
-        }
+
+        gsSparseVector<T> result(this->m_bases[m_is_truncated[i]]->size());
+        result.reserve(m_presentation.row(i).nonZeros());
+        for (typename gsSparseMatrix<T,RowMajor>::InnerIterator
+                 it(m_presentation, i); it; ++it)
+            result.insertBack(it.index()) = it.value();
+        return result;
     }
 
 
@@ -403,9 +244,58 @@ private:
         }
     }
 
+    /// @brief Evaluates the derivatives of order \a n (all orders up
+    /// to \a n, if \a all is true) of the active functions at the
+    /// points \a u into \a result[n] (\a result[0..n]).
+    ///
+    /// The tensor basis of every level is evaluated once on all
+    /// points; the functions which are truncated are then combined
+    /// from these values with their coefficients in m_presentation.
+    void evalBatched_into(const gsMatrix<T> & u, const int n, const bool all,
+                          std::vector<gsMatrix<T> >& result) const;
+
+    /// @brief Evaluates the derivatives of order \a n of the truncated
+    /// function \a i at the points \a u, by combining the tensor
+    /// functions of its level with the coefficients of its row of
+    /// m_presentation (without copying them).
+    void truncatedSingle_into(const index_t i, const gsMatrix<T> & u, const int n,
+                              gsMatrix<T>& result) const;
+
     /// @brief Computes and saves representation of all basis functions.
     void representBasis(); // rename: precompute coeffs
 
+    /// @brief Updates the representation of the basis functions after
+    /// the insertion of \a boxes. Only the functions whose support
+    /// overlaps the boxes are computed, the others are moved to their
+    /// new index.
+    ///
+    /// @param boxes the inserted boxes, in the format of refineElements()
+    /// @param oldIndex position lookup of the characteristic matrices
+    ///        before the insertion
+    /// @param oldOffset level offsets before the insertion
+    void representBasis(const std::vector<index_t> & boxes,
+                        const std::vector<gsCharMatrixIndex> & oldIndex,
+                        const std::vector<index_t> & oldOffset);
+
+    /// @brief Takes the given representation of the basis functions,
+    /// as given by truncationLevels() and truncation(), if it fits
+    /// the basis; otherwise it is computed anew.
+    ///
+    /// The level of every truncated function is checked against the
+    /// domain inside its support, and the columns of its row against
+    /// the size of the tensor basis of that level. Functions which
+    /// are not truncated must have empty rows.
+    ///
+    /// The values of the coefficients are trusted: checking them
+    /// costs as much as computing them. A truncation stored for
+    /// other knot values, with the same numbers of knots, is
+    /// therefore taken as it is.
+    void representBasis(const gsVector<int> & truncLevels,
+                        const gsSparseMatrix<T,RowMajor> & trunc);
+
+    /// @brief Computes and saves representation of the j-th basis function.
+    void _representBasisFunction(const index_t j);
+
 
     /// @brief Computes representation of j-th basis function on pres_level and
     /// saves it.
@@ -599,12 +489,11 @@ private:
     /**
      * @brief Initialize the characteristic and coefficient
      * matrices and the internal bspline representations.
+     *
+     * After an insertion of boxes only the functions around the
+     * boxes are represented anew.
     **/
-    void update_structure() 
-    {
-        gsHTensorBasis<d,T>::update_structure(); 
-        representBasis();
-    }
+    void update_structure();
 
     /**
       @brief Returns a representation of \a thbCoefs as tensor-product
@@ -711,12 +600,16 @@ private:
     gsVector<int> m_is_truncated;
 
 
-    // m_presentation[j] is presentation of the j-th basis function in terms of
-    // B-Splines at level m_is_truncated[j]
+    // row j of m_presentation is presentation of the j-th basis
+    // function in terms of B-Splines at level m_is_truncated[j]
+    //
+    // if m_is_truncated[j] is equal to -1, then the row j is empty
     //
-    // if m_is_truncated[j] is equal to -1, then there is no entry
-    // m_presentation[j]
-    std::map<index_t, gsSparseVector<T> > m_presentation;
+    // The rows are filled in order with the low-level API of
+    // gsSparseMatrix (startVec/insertBack/finalize), so that the
+    // storage is compressed and the row of a function is found in
+    // constant time
+    gsSparseMatrix<T,RowMajor> m_presentation;
 
     using gsHTensorBasis<d,T>::m_bases;
     using gsHTensorBasis<d,T>::m_xmatrix;
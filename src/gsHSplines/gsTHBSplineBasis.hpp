@@ -23,6 +23,8 @@
 
 #include <gsTensor/gsTensorTools.h>
 
+#include <gsUtils/gsCombinatorics.h>
+
 namespace gismo
 {
 
@@ -46,45 +48,161 @@ typename gsTHBSplineBasis<d,T>::BoundaryBasisType * gsTHBSplineBasis<d,T>::basis
     return bBasis;
 }
 
+template<short_t d, class T>
+void gsTHBSplineBasis<d,T>::update_structure()
+{
+    // Without a previous representation all functions are
+    // represented anew
+    if ( this->m_newBoxes.empty() || m_xmatrix_offset.empty() ||
+         m_is_truncated.size() != m_xmatrix_offset.back() )
+    {
+        gsHTensorBasis<d,T>::update_structure();
+        representBasis();
+        return;
+    }
+
+    // Keep the old positions of the functions
+    const std::vector<index_t> boxes = this->m_newBoxes;
+    const std::vector<index_t> oldOffset = m_xmatrix_offset;
+    std::vector<gsCharMatrixIndex> oldIndex;
+    oldIndex.swap(this->m_xindex);
+
+    gsHTensorBasis<d,T>::update_structure();
+    representBasis(boxes, oldIndex, oldOffset);
+}
+
 template<short_t d, class T>
 void gsTHBSplineBasis<d,T>::representBasis()
 {
     // Cleanup previous basis
     this->m_is_truncated.resize(this->size());
-    m_presentation.clear();
+    m_presentation.resize(this->size(), this->m_bases.back()->size());
 
     for (index_t j = 0; j < this->size(); ++j)
     {
-        unsigned level = this->levelOf(j);
-        index_t tensor_index = this->flatTensorIndexOf(j, level);
-
-        // element indices
-        gsMatrix<index_t, d, 2> element_ind(d, 2);
-        this->m_bases[level]->elementSupport_into(tensor_index, element_ind);
-
-        // I tried with block, I can not trick the compiler to use references
-        gsVector<index_t, d> low = element_ind.col(0); //block<d, 1>(0, 0);
-        gsVector<index_t, d> high = element_ind.col(1); //block<d, 1>(0, 1);gsMatrix<index_t> element_ind =
-
-        // Finds coarsest level that function, with supports given with
-        // support indices of the coarsest level (low & high), has presentation
-        // based only on B-Splines (and not THB-Splines).
-        // this is not the same as query 3
-        unsigned clevel = this->m_tree.query4(low, high, level);
+        m_presentation.startVec(j);
+        _representBasisFunction(j);
+    }
+    m_presentation.finalize();
+}
 
-        if (level != clevel) // we must compute its presentation
+template<short_t d, class T>
+void gsTHBSplineBasis<d,T>::representBasis(const std::vector<index_t> & boxes,
+                                          const std::vector<gsCharMatrixIndex> & oldIndex,
+                                          const std::vector<index_t> & oldOffset)
+{
+    gsVector<int> oldTruncated;
+    oldTruncated.swap(m_is_truncated);
+    gsSparseMatrix<T,RowMajor> oldPresentation;
+    oldPresentation.swap(m_presentation);
+    m_is_truncated.resize(this->size());
+    m_presentation.resize(this->size(), this->m_bases.back()->size());
+    m_presentation.reserve(oldPresentation.nonZeros());
+
+    // The truncation of a function depends only on the domain inside
+    // its support
+    std::vector<index_t> cand;
+    for (size_t lvl = 0; lvl != m_xmatrix.size(); ++lvl)
+    {
+        this->functionsOverlapping(boxes, lvl, cand);
+        std::vector<index_t>::const_iterator c = cand.begin();
+        index_t j = m_xmatrix_offset[lvl];
+        for (cmatIterator it = m_xmatrix[lvl].begin();
+             it != m_xmatrix[lvl].end(); ++it, ++j)
         {
-            this->m_tree.computeFinestIndex(low, level, low);
-            this->m_tree.computeFinestIndex(high, level, high);
+            m_presentation.startVec(j);
+            for (; c != cand.end() && *c < *it; ++c) ;
+            if ( c != cand.end() && *c == *it )
+            {
+                _representBasisFunction(j);
+                continue;
+            }
 
-            this->m_is_truncated[j] = clevel;
-            _representBasisFunction(j, clevel, low, high);
+            // The function was active before, move its presentation
+            GISMO_ASSERT( lvl < oldIndex.size() && oldIndex[lvl].find(*it) != -1,
+                          "Function "<< *it <<" of level "<< lvl <<" was not active.");
+            const index_t oj = oldOffset[lvl] + oldIndex[lvl].find(*it);
+            m_is_truncated[j] = oldTruncated[oj];
+            for (typename gsSparseMatrix<T,RowMajor>::InnerIterator
+                     pit(oldPresentation, oj); pit; ++pit)
+                m_presentation.insertBack(j, pit.index()) = pit.value();
         }
+    }
+    m_presentation.finalize();
+}
+
+template<short_t d, class T>
+void gsTHBSplineBasis<d,T>::representBasis(const gsVector<int> & truncLevels,
+                                          const gsSparseMatrix<T,RowMajor> & trunc)
+{
+    bool valid = truncLevels.size() == this->size() && trunc.rows() == this->size()
+        && trunc.cols() == this->m_bases.back()->size();
+
+    gsMatrix<index_t, d, 2> element_ind(d, 2);
+    for (index_t j = 0; valid && j < this->size(); ++j)
+    {
+        const unsigned level = this->levelOf(j);
+        const index_t tensor_index = this->flatTensorIndexOf(j, level);
+        this->m_bases[level]->elementSupport_into(tensor_index, element_ind);
+        const gsVector<index_t, d> low  = element_ind.col(0);
+        const gsVector<index_t, d> high = element_ind.col(1);
+        const unsigned clevel = this->m_tree.query4(low, high, level);
+
+        typename gsSparseMatrix<T,RowMajor>::InnerIterator it(trunc, j);
+        if (level == clevel)
+            valid = -1 == truncLevels[j] && !it;
+        else if (truncLevels[j] != static_cast<int>(clevel))
+            valid = false;
         else
         {
-            this->m_is_truncated[j] = -1;
+            const index_t ncols = this->m_bases[clevel]->size();
+            for (; valid && it; ++it)
+                valid = it.index() < ncols;
         }
     }
+
+    if (valid)
+    {
+        m_is_truncated = truncLevels;
+        m_presentation = trunc;
+        m_presentation.makeCompressed();
+    }
+    else
+        representBasis();
+}
+
+template<short_t d, class T>
+void gsTHBSplineBasis<d,T>::_representBasisFunction(const index_t j)
+{
+    unsigned level = this->levelOf(j);
+    index_t tensor_index = this->flatTensorIndexOf(j, level);
+
+    // element indices
+    gsMatrix<index_t, d, 2> element_ind(d, 2);
+    this->m_bases[level]->elementSupport_into(tensor_index, element_ind);
+
+    // I tried with block, I can not trick the compiler to use references
+    gsVector<index_t, d> low = element_ind.col(0); //block<d, 1>(0, 0);
+    gsVector<index_t, d> high = element_ind.col(1); //block<d, 1>(0, 1);gsMatrix<index_t> element_ind =
+
+    // Finds coarsest level that function, with supports given with
+    // support indices of the coarsest level (low & high), has presentation
+    // based only on B-Splines (and not THB-Splines).
+    // this is not the same as query 3
+    unsigned clevel = this->m_tree.query4(low, high, level);
+
+    if (level != clevel) // we must compute its presentation
+    {
+        this->m_tree.computeFinestIndex(low, level, low);
+        this->m_tree.computeFinestIndex(high, level, high);
+
+        this->m_is_truncated[j] = clevel;
+        _representBasisFunction(j, clevel, low, high);
+    }
+    else
+    {
+        this->m_is_truncated[j] = -1;
+    }
 }
 
 template<short_t d, class T>
@@ -210,12 +328,8 @@ void gsTHBSplineBasis<d,T>::_saveNewBasisFunPresentation(
     gsVector<index_t, d> last_point(d);
     bspline::getLastIndexLocal<d>(act_size_of_coefs, last_point);
 
-    this->m_presentation[j] =
-        gsSparseVector<T>(this->m_bases[pres_level]->size());
-
-    gsSparseVector<T>& presentation = this->m_presentation[j];
-    //presentation.reserve(coefs.rows()); // reserve memory ?
-
+    // The row of j is the current row of m_presentation, the tensor
+    // indices are visited in increasing order
     do
     {
         // ten_index - (tensor) index of a bspline function with respect to
@@ -232,7 +346,7 @@ void gsTHBSplineBasis<d,T>::_saveNewBasisFunPresentation(
         unsigned coef_index = bspline::getIndex<d>(act_coefs_strides, position);
 
         if (coefs(coef_index) != 0)
-            presentation(ten_index) = coefs(coef_index);
+            m_presentation.insertBack(j, ten_index) = coefs(coef_index);
 
     } while(nextCubePoint<gsVector<index_t, d> > (position, first_point,
                                                    last_point));
@@ -1025,18 +1139,7 @@ void gsTHBSplineBasis<d,T>::evalSingle_into(index_t i,
         this->m_bases[level]->evalSingle_into(tensor_index, u, result);
     }
     else
-    {
-        
-        unsigned level = this->m_is_truncated[i];
-        
-        const gsSparseVector<T>& coefs = getCoefs(i);
-        
-        const gsTensorBSplineBasis<d, T>& base =
-            *this->m_bases[level];
-        
-        gsTensorDeboor<d, T, gsKnotVector<T>, gsSparseVector<T> >
-            (u, base, coefs, result);
-    }
+        truncatedSingle_into(i, u, 0, result);
 }
 
 template<short_t d, class T>
@@ -1052,94 +1155,157 @@ void gsTHBSplineBasis<d,T>::deriv2Single_into(index_t i,
         this->m_bases[level]->deriv2Single_into(fl_tensor_index, u, result);
     }
     else
-    {
-        const unsigned level = this->m_is_truncated[i];
-        const gsSparseVector<T>& coefs = this->getCoefs(i);
-        const gsTensorBSplineBasis<d, T> & base =
-            *this->m_bases[level];
-        
-        gsTensorDeriv2_into<d, T, gsKnotVector<T>,
-                            gsSparseVector<T> >(u, base, coefs, result);
-    }
+        truncatedSingle_into(i, u, 2, result);
 }
 
 template<short_t d, class T>
 void gsTHBSplineBasis<d,T>::eval_into(const gsMatrix<T> & u, gsMatrix<T>& result) const
 {
-    gsMatrix<index_t> indices;
-    gsMatrix<T> res(1, 1);
-    this->active_into(u, indices);
+    std::vector<gsMatrix<T> > tmp;
+    evalBatched_into(u, 0, false, tmp);
+    result.swap(tmp[0]);
+}
 
-    result.setZero(indices.rows(), u.cols());
+template<short_t d, class T>
+void gsTHBSplineBasis<d,T>::deriv_into(const gsMatrix<T>& u, gsMatrix<T>& result) const
+{
+    std::vector<gsMatrix<T> > tmp;
+    evalBatched_into(u, 1, false, tmp);
+    result.swap(tmp[1]);
+}
 
-    for (index_t i = 0; i < indices.cols(); i++)
-    {
-        for (index_t j = 0; j < indices.rows(); j++)
-        {
-            const index_t index = indices(j, i);
-            if (j != 0 && index == 0)
-                break;
-            
-            evalSingle_into(index, u.col(i), res);
-            result(j, i) = res.value();
-        }
-    }
+template<short_t d, class T>
+void gsTHBSplineBasis<d,T>::deriv2_into(const gsMatrix<T>& u, gsMatrix<T>& result) const
+{
+    std::vector<gsMatrix<T> > tmp;
+    evalBatched_into(u, 2, false, tmp);
+    result.swap(tmp[2]);
 }
 
+template<short_t d, class T>
+void gsTHBSplineBasis<d,T>::evalAllDers_into(const gsMatrix<T> & u, int n,
+                                             std::vector<gsMatrix<T> >& result) const
+{
+    evalBatched_into(u, n, true, result);
+}
 
 template<short_t d, class T>
-void gsTHBSplineBasis<d,T>::deriv2_into(const gsMatrix<T>& u, gsMatrix<T>& result)const
+void gsTHBSplineBasis<d,T>::evalBatched_into(const gsMatrix<T> & u, const int n, const bool all,
+                                             std::vector<gsMatrix<T> >& result) const
 {
+    GISMO_ASSERT( all || n <= 2, "Derivatives of order "<< n <<" are only available with evalAllDers_into");
     gsMatrix<index_t> indices;
     this->active_into(u, indices);
-
-    static const short_t numDers = (d * (d + 1)) / 2;
-    gsMatrix<T> res(numDers, 1); // result of deriv2Single_into
-
-    result.setZero(indices.rows() * numDers, u.cols());
-
-    for (int i = 0; i < indices.cols(); i++)
-    {
-        for (int j = 0; j < indices.rows(); j++)
+    const index_t numPts = u.cols(), numAct = indices.rows();
+    const int k0 = all ? 0 : n;
+
+    // Levels on which the active functions are represented
+    const size_t numLevels = this->m_bases.size();
+    std::vector<bool> used(numLevels, false);
+    for (index_t i = 0; i < numPts; i++)
+        for (index_t j = 0; j < numAct; j++)
         {
             const index_t index = indices(j, i);
             if (j != 0 && index == 0)
                 break;
+            used[getPresLevelOfBasisFun(index)] = true;
+        }
 
-            this->deriv2Single_into(index, u.col(i), res);
-
-            result.template block<numDers, 1>(j * numDers, i) = res;
+    // Evaluate the tensor basis of each of these levels once on all
+    // points
+    std::vector<std::vector<gsMatrix<T> > > lvlVals(numLevels);
+    std::vector<gsMatrix<index_t> > lvlActive(numLevels);
+    for (size_t lvl = 0; lvl != numLevels; ++lvl)
+    {
+        if (!used[lvl]) continue;
+        const gsTensorBSplineBasis<d,T> & base = *this->m_bases[lvl];
+        base.active_into(u, lvlActive[lvl]);
+        if (all)
+        {
+            base.evalAllDers_into(u, n, lvlVals[lvl]);
+            continue;
+        }
+        lvlVals[lvl].resize(n + 1);
+        switch (n)
+        {
+        case 0:
+            base.eval_into(u, lvlVals[lvl][0]);
+            break;
+        case 1:
+            base.deriv_into(u, lvlVals[lvl][1]);
+            break;
+        default:
+            base.deriv2_into(u, lvlVals[lvl][2]);
+            break;
         }
     }
-}
-
-
-template<short_t d, class T>
-void gsTHBSplineBasis<d,T>::deriv_into(const gsMatrix<T>& u, gsMatrix<T>& result) const
-{
-
-    gsMatrix<index_t> indices;
-    this->active_into(u, indices);
-    gsMatrix<T> res(d, 1);
 
-    result.setZero(indices.rows() * d, u.cols());
+    // Number of partial derivatives of each order
+    gsVector<index_t> stride(n + 1);
+    result.resize(n + 1);
+    for (int k = k0; k <= n; ++k)
+    {
+        stride[k] = binomial<index_t>(d + k - 1, k);
+        result[k].setZero(numAct * stride[k], numPts);
+    }
 
-    for (int i = 0; i < indices.cols(); i++)
+    // Combine the tensor evaluations, applying the truncation
+    // coefficients of the truncated functions
+    for (index_t i = 0; i < numPts; i++)
     {
-        for (int j = 0; j < indices.rows(); j++)
+        for (index_t j = 0; j < numAct; j++)
         {
-
-            const unsigned index = indices(j, i);
+            const index_t index = indices(j, i);
             if (j != 0 && index == 0)
                 break;
 
-            this->derivSingle_into(index, u.col(i), res);
-            result.template block<d,1>(j * d, i) = res;
+            const unsigned lvl = getPresLevelOfBasisFun(index);
+            const gsMatrix<index_t> & act = lvlActive[lvl];
+            const index_t * actBegin = act.col(i).data();
+            const index_t * actEnd   = actBegin + act.rows();
+            const std::vector<gsMatrix<T> > & vals = lvlVals[lvl];
+
+            if (this->m_is_truncated[index] == -1) // basis function not truncated
+            {
+                // The active tensor functions are sorted
+                const index_t t = flatTensorIndexOf(index, lvl);
+                const index_t * it = std::lower_bound(actBegin, actEnd, t);
+                if (it == actEnd || *it != t)
+                    continue;
+                const index_t r = it - actBegin;
+                for (int k = k0; k <= n; ++k)
+                    std::copy(vals[k].col(i).data() + r * stride[k],
+                              vals[k].col(i).data() + (r + 1) * stride[k],
+                              result[k].col(i).data() + j * stride[k]);
+            }
+            else
+            {
+                // Merge the (sorted) active tensor functions with the
+                // non-zero coefficients
+                const index_t * cInd = m_presentation.innerIndexPtr();
+                const T       * cVal = m_presentation.valuePtr();
+                const index_t * cEnd = cInd + m_presentation.outerIndexPtr()[index + 1];
+                const index_t * c = std::lower_bound(cInd + m_presentation.outerIndexPtr()[index],
+                                                     cEnd, *actBegin);
+                for (const index_t * it = actBegin; it != actEnd && c != cEnd; ++it)
+                {
+                    while (c != cEnd && *c < *it) ++c;
+                    if (c == cEnd || *c != *it) continue;
+                    const T coef = cVal[c - cInd];
+                    const index_t r = it - actBegin;
+                    for (int k = k0; k <= n; ++k)
+                    {
+                        const T * in = vals[k].col(i).data() + r * stride[k];
+                        T * out = result[k].col(i).data() + j * stride[k];
+                        for (index_t l = 0; l != stride[k]; ++l)
+                            out[l] += coef * in[l];
+                    }
+                }
+            }
         }
     }
 }
 
-
 template<short_t d, class T>
 void gsTHBSplineBasis<d,T>::derivSingle_into(index_t i,
                                              const gsMatrix<T> & u,
@@ -1153,13 +1319,48 @@ void gsTHBSplineBasis<d,T>::derivSingle_into(index_t i,
         this->m_bases[level]->derivSingle_into(fl_tensor_index, u, result);
     }
     else
+        truncatedSingle_into(i, u, 1, result);
+}
+
+template<short_t d, class T>
+void gsTHBSplineBasis<d,T>::truncatedSingle_into(const index_t i,
+                                                 const gsMatrix<T> & u,
+                                                 const int n,
+                                                 gsMatrix<T>& result) const
+{
+    const gsTensorBSplineBasis<d,T> & base = *this->m_bases[m_is_truncated[i]];
+
+    // Values of the active tensor functions
+    gsMatrix<T> vals;
+    gsMatrix<index_t> act;
+    switch (n)
     {
-        unsigned level = this->m_is_truncated[i];
-        const gsSparseVector<T>& coefs = this->getCoefs(i);
-        const gsTensorBSplineBasis<d,T>& base =
-            *this->m_bases[level];
-        gsTensorDeriv_into<d, T, gsKnotVector<T>,
-                           gsSparseVector<T> >(u, base, coefs, result);
+    case 0 : base.eval_into  (u, vals); break;
+    case 1 : base.deriv_into (u, vals); break;
+    default: base.deriv2_into(u, vals); break;
+    }
+    base.active_into(u, act);
+    const index_t stride = 0 == n ? 1 : ( 1 == n ? d : d * (d + 1) / 2 );
+
+    // Merge the (sorted) active tensor functions of every point with
+    // the non-zero coefficients of row i
+    const index_t * cInd   = m_presentation.innerIndexPtr();
+    const T       * cVal   = m_presentation.valuePtr();
+    const index_t * cBegin = cInd + m_presentation.outerIndexPtr()[i];
+    const index_t * cEnd   = cInd + m_presentation.outerIndexPtr()[i + 1];
+    result.setZero(stride, u.cols());
+    for (index_t p = 0; p != u.cols(); ++p)
+    {
+        const index_t * actBegin = act.col(p).data();
+        const index_t * actEnd   = actBegin + act.rows();
+        const index_t * c = std::lower_bound(cBegin, cEnd, *actBegin);
+        for (const index_t * it = actBegin; it != actEnd && c != cEnd; ++it)
+        {
+            while (c != cEnd && *c < *it) ++c;
+            if (c == cEnd || *c != *it) continue;
+            result.col(p) += cVal[c - cInd] *
+                vals.col(p).segment((it - actBegin) * stride, stride);
+        }
     }
 }
 
@@ -2024,13 +2225,56 @@ public:
 
     static gsTHBSplineBasis<d,T> * get (gsXmlNode * node)
     {
-        return getHTensorBasisFromXml< gsTHBSplineBasis<d,T> > (node);
+        gsXmlNode * trNode  = node->first_node("truncation");
+        gsXmlNode * lvlNode = node->first_node("truncationLevels");
+        if ( ! (trNode && lvlNode) )
+            return getHTensorBasisFromXml< gsTHBSplineBasis<d,T> > (node);
+
+        // Read the stored representations of the truncated functions
+        // instead of computing them
+        gsXmlNode * tmp = node->first_node("Basis");
+        GISMO_ASSERT( tmp , "Expected to find a basis node.");
+        gsTensorBSplineBasis<d,T> * tp =
+            gsXml<gsTensorBSplineBasis<d,T> >::get(tmp);
+
+        std::vector<index_t> boxes;
+        getHTensorBoxesFromXml(node, d, boxes);
+
+        const index_t rows = atoi( trNode->first_attribute("rows")->value() );
+        const index_t cols = atoi( trNode->first_attribute("cols")->value() );
+        gsSparseEntries<T> entries;
+        getSparseEntriesFromXml<T>(trNode, entries);
+        gsSparseMatrix<T,RowMajor> trunc(rows, cols);
+        trunc.setFrom(entries);
+
+        gsMatrix<index_t> lvl;
+        getMatrixFromXml<index_t>(lvlNode, rows, 1, lvl);
+        const gsVector<int> truncLevels = lvl.col(0).template cast<int>();
+
+        gsTHBSplineBasis<d,T> * result =
+            new gsTHBSplineBasis<d,T>(*tp, boxes, truncLevels, trunc);
+        delete tp;
+        return result;
     }
 
     static gsXmlNode * put (const gsTHBSplineBasis<d,T> & obj,
                             gsXmlTree & data )
     {
-        return putHTensorBasisToXml< gsTHBSplineBasis<d,T> > (obj, data);
+        gsXmlNode * node =
+            putHTensorBasisToXml< gsTHBSplineBasis<d,T> > (obj, data);
+
+        // Store the representations of the truncated functions, so
+        // that reading the basis does not need to compute them
+        const gsSparseMatrix<T> trunc = obj.truncation();
+        gsXmlNode * tmp = putSparseMatrixToXml(trunc, data, "truncation");
+        tmp->append_attribute( makeAttribute("rows", trunc.rows(), data) );
+        tmp->append_attribute( makeAttribute("cols", trunc.cols(), data) );
+        node->append_node(tmp);
+
+        const gsMatrix<index_t> lvl = obj.truncationLevels().template cast<index_t>();
+        tmp = putMatrixToXml(lvl, data, "truncationLevels");
+        node->append_node(tmp);
+        return node;
     }
 };
 
@@ -344,10 +344,16 @@ void writeSinglePatchField(const gsFunction<T> & geometry,
     gsVector<T> b = ab.col(1);
 
     gsVector<unsigned> np = uniformSampleCount(a, b, npts);
-    gsMatrix<T> pts = gsPointGrid(a, b, np);
-
-    gsMatrix<T> eval_geo = geometry.eval(pts);//pts
-    gsMatrix<T>  eval_field = isParam ? parField.eval(pts) : parField.eval(eval_geo);
+    std::vector<gsVector<T> > grid;
+    uniformGridCoordinates(a, b, np, grid);
+
+    // Tensor-product functions are evaluated direction by direction
+    gsMatrix<T> eval_geo, eval_field;
+    geometry.evalGrid_into(grid, eval_geo);
+    if ( isParam )
+        parField.evalGrid_into(grid, eval_field);
+    else
+        parField.eval_into(eval_geo, eval_field);
 
     if ( 3 - d > 0 )
     {
@@ -472,9 +478,11 @@ void writeSingleGeometry(gsFunction<T> const& func,
     gsVector<T> a = supp.col(0);
     gsVector<T> b = supp.col(1);
     gsVector<unsigned> np = uniformSampleCount(a,b, npts );
-    gsMatrix<T> pts = gsPointGrid(a,b,np) ;
+    std::vector<gsVector<T> > grid;
+    uniformGridCoordinates(a, b, np, grid);
 
-    gsMatrix<T>  eval_func = func.eval  ( pts ) ;//pts
+    gsMatrix<T> eval_func;
+    func.evalGrid_into(grid, eval_func);
 
     if ( 3 - d > 0 )
     {
@@ -491,7 +499,7 @@ void writeSingleGeometry(gsFunction<T> const& func,
         {
             //std::swap( eval_geo.row(d),  eval_geo.row(0) );
             eval_func.row(d) = eval_func.row(0);
-            eval_func.topRows(d) = pts;
+            eval_func.topRows(d) = gsPointGrid<T>(grid);
         }
     }
 
@@ -101,6 +101,28 @@ Object * getRationalBasisFromXml ( gsXmlNode * node)
 }
 
 
+/// Reads the boxes of a hierarchical basis node, in the format of
+/// gsHTensorBasis::refineElements
+inline void getHTensorBoxesFromXml ( gsXmlNode * node, const int d,
+                                     std::vector<index_t> & boxes)
+{
+    std::istringstream str;
+    unsigned c;
+    boxes.clear();
+    for (gsXmlNode * tmp = node->first_node("box");
+         tmp; tmp = tmp->next_sibling("box"))
+    {
+        boxes.push_back(atoi( tmp->first_attribute("level")->value() ));
+        str.clear();
+        str.str( tmp->value() );
+        for( int i = 0; i < 2*d; i++)
+        {
+            str>> c;
+            boxes.push_back(c);
+        }
+    }
+}
+
 template<class Object>
 Object * getHTensorBasisFromXml ( gsXmlNode * node)
 {
@@ -122,24 +144,9 @@ Object * getHTensorBasisFromXml ( gsXmlNode * node)
     gsTensorBSplineBasis<d,T> * tp = 
         gsXml<gsTensorBSplineBasis<d,T> >::get(tmp);
     
-    // Initialize the HBSplineBasis
-    std::istringstream str;
-    
     // Insert all boxes
-    unsigned c;
     std::vector<index_t> all_boxes;
-    for (tmp = node->first_node("box"); 
-         tmp; tmp = tmp->next_sibling("box"))
-    {
-        all_boxes.push_back(atoi( tmp->first_attribute("level")->value() ));
-        str.clear();
-        str.str( tmp->value() );
-        for( unsigned i = 0; i < 2*d; i++)
-        {
-            str>> c;
-            all_boxes.push_back(c);
-        }
-    }
+    getHTensorBoxesFromXml(node, d, all_boxes);
     Object * hbs = new Object(*tp, all_boxes);
     delete tp;
     return hbs;
@@ -678,6 +678,57 @@ public:
         std::copy(in, in+len, out);
         return;
     }
+
+    /**
+     * @brief Compute something over all processes for each component
+     * of an array and return the result in every process (non-blocking)
+     *
+     * The result is available after the request has been waited for.
+     *
+     * @param inout The array to compute on.
+     * @param len The number of components in the array
+     * @param[out] req communication request
+     */
+    template<typename BinaryFunction, typename Type>
+    static int iallreduce(Type*, int, const MPI_Request*)
+    {
+        return 0;
+    }
+
+    /**
+     * @brief Compute something over all processes for each component
+     * of an array and return the result in every process (non-blocking)
+     *
+     * @param in The array to compute on.
+     * @param out The array to store the results in.
+     * @param len The number of components in the array
+     * @param[out] req communication request
+     */
+    template<typename BinaryFunction, typename Type>
+    static int iallreduce(Type* in, Type* out, int len, const MPI_Request*)
+    {
+        std::copy(in, in+len, out);
+        return 0;
+    }
+
+    /** @brief Compute the sum over all processes for each component
+        of an array and return the result in every process (non-blocking)
+    */
+    template<typename T>
+    static int isum (T*, int, const MPI_Request*)
+    {
+        return 0;
+    }
+
+    /** @brief Compute the sum over all processes for each component
+        of an array and return the result in every process (non-blocking)
+    */
+    template<typename T>
+    static int isum (T* in, T* out, int len, const MPI_Request*)
+    {
+        std::copy(in, in+len, out);
+        return 0;
+    }
 };
 
 #ifdef GISMO_WITH_MPI
@@ -302,6 +302,15 @@ public:
     virtual void evalAllDers_into(const gsMatrix<T> & u, int n,
                                   std::vector<gsMatrix<T> >& result) const;
 
+    /// @brief Same as evalAllDers_into, by the algorithm for arbitrary
+    /// degrees.
+    ///
+    /// evalAllDers_into, eval_into and deriv_into use the kernels of
+    /// gsBSplineKernels.h for the degrees 1 to 5 and this algorithm
+    /// otherwise.
+    void evalAllDersGeneric_into(const gsMatrix<T> & u, int n,
+                                 std::vector<gsMatrix<T> >& result) const;
+
     // Look at gsBasis class for a description
     virtual void evalAllDersSingle_into(index_t i, const gsMatrix<T> & u,
                                         int n, gsMatrix<T>& result) const;
@@ -15,6 +15,7 @@
 
 #include <gsNurbs/gsBSpline.h>
 #include <gsNurbs/gsBSplineAlgorithms.h>
+#include <gsNurbs/gsBSplineKernels.h>
 
 #include <gsNurbs/gsDeboor.hpp>
 #include <gsNurbs/gsBoehm.h>
@@ -121,9 +122,13 @@ void gsTensorBSplineBasis<1,T>::active_into(const gsMatrix<T>& u,
     }
     else
     {
+        // One sweep over the knots for all the points
+        gsVector<index_t> span;
+        m_knots.uFind_into(u, span);
+        const index_t * mSum = m_knots.multSumData();
         for (index_t j = 0; j < u.cols(); ++j)
         {
-            unsigned first = firstActive(u(0,j));
+            index_t first = ( inDomain(u(0,j)) ? mSum[span[j]] - 1 - m_p : 0 );
             for (int i = 0; i != m_p+1; ++i)
                 result(i,j) = first++;
         }
@@ -238,6 +243,11 @@ void gsTensorBSplineBasis<1,T>::eval_into(const gsMatrix<T> & u, gsMatrix<T>& re
 {
     result.resize(m_p+1, u.cols() );
 
+    // Fixed-degree kernels for the usual degrees
+    if ( bspline::evalAllDersFixedDegree(m_knots, m_p, domainStart(), domainEnd(),
+                                         u, 0, &result) )
+        return;
+
 #if (FALSE)
 
     typename KnotVectorType::const_iterator kspan;
@@ -581,6 +591,17 @@ void gsTensorBSplineBasis<1,T>::deriv_into(const gsMatrix<T> & u, gsMatrix<T>& r
 
     result.resize( m_p + 1, u.cols() ) ;
 
+    // Fixed-degree kernels for the usual degrees, the values are
+    // computed on the way
+    gsMatrix<T> ders[2];
+    ders[0].resize( m_p + 1, u.cols() );
+    ders[1].swap(result);
+    const bool done = bspline::evalAllDersFixedDegree(m_knots, m_p, domainStart(), domainEnd(),
+                                                      u, 1, ders);
+    ders[1].swap(result);
+    if ( done )
+        return;
+
     for (index_t v = 0; v < u.cols(); ++v) // for all columns of u
     {
         // Check if the point is in the domain
@@ -867,6 +888,23 @@ template <class T>
 void gsTensorBSplineBasis<1,T>::
 evalAllDers_into(const gsMatrix<T> & u, int n,
                  std::vector<gsMatrix<T> >& result) const
+{
+    GISMO_ASSERT( u.rows() == 1 , "gsBSplineBasis accepts points with one coordinate.");
+
+    result.resize(n+1);
+    for(int k=0; k<=n; k++)
+        result[k].resize(m_p + 1, u.cols());
+
+    // Fixed-degree kernels for the usual degrees
+    if ( ! bspline::evalAllDersFixedDegree(m_knots, m_p, domainStart(), domainEnd(),
+                                           u, n, &result[0]) )
+        evalAllDersGeneric_into(u, n, result);
+}
+
+template <class T>
+void gsTensorBSplineBasis<1,T>::
+evalAllDersGeneric_into(const gsMatrix<T> & u, int n,
+                        std::vector<gsMatrix<T> >& result) const
 {
     // TO DO : Use less memory proportionally to n
     // Only last n+1 columns and last n rows of ndu are needed
@@ -0,0 +1,166 @@
+/** @file gsBSplineKernels.h
+
+    @brief Evaluation kernels for B-spline bases of fixed degree
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsNurbs/gsKnotVector.h>
+
+namespace gismo
+{
+
+namespace bspline
+{
+
+/// Number of points evaluated together by evalAllDersKernel()
+enum { kernelWidth = 8 };
+
+/**
+   \brief Evaluates the non-zero B-splines of degree \a P and their
+   derivatives up to order \a n at the points \a u
+
+   The points are processed in blocks of kernelWidth points. Within a
+   block, the Cox-de Boor recursion and the derivative recursion run
+   over the points in the innermost loop on fixed-size arrays, so the
+   compiler can unroll the loops over the degree and vectorize the
+   ones over the points. The derivatives of order k are obtained by
+   raising the functions of degree P-k to degree P with the
+   derivative recursion, which only divides by knot differences
+   spanning the knot span of the point.
+
+   Points outside the interval [\a a, \a b] get zero values.
+
+   \param knots knot vector of degree \a P
+   \param a start of the domain
+   \param b end of the domain
+   \param u the points (one row)
+   \param n highest order of the derivatives
+   \param result array of \a n+1 matrices of size (P+1) x u.cols()
+   (resized beforehand), result[k] receives the derivatives of order k
+
+   \ingroup Nurbs
+*/
+template<short_t P, class T>
+void evalAllDersKernel(const gsKnotVector<T> & knots, const T a, const T b,
+                       const gsMatrix<T> & u, const int n, gsMatrix<T> result[])
+{
+    const int W = kernelWidth;
+    const index_t numPts = u.cols();
+
+    // L[j] = u - t_{s+1-j}, R[j] = t_{s+j} - u, where [t_s,t_{s+1})
+    // is the knot span of the point
+    T L[P+1][W], R[P+1][W];
+    // B-splines of all degrees, N[q][r] is the r-th non-zero
+    // function of degree q
+    T N[P+1][P+1][W];
+    // Derivatives
+    T D[P+1][W];
+    bool valid[W];
+
+    for (index_t v0 = 0; v0 < numPts; v0 += W)
+    {
+        const int numW = static_cast<int>( std::min<index_t>(W, numPts - v0) );
+
+        for (int w = 0; w != W; ++w)
+        {
+            // The last block is padded with its last point
+            const T x = u(0, v0 + std::min(w, numW - 1));
+            valid[w] = ( x >= a && x <= b );
+            const T xx = ( valid[w] ? x : a );
+            typename gsKnotVector<T>::iterator span = knots.iFind(xx);
+            for (int j = 1; j <= P; ++j)
+            {
+                L[j][w] = xx - *(span + 1 - j);
+                R[j][w] = *(span + j) - xx;
+            }
+        }
+
+        // Cox-de Boor recursion
+        for (int w = 0; w != W; ++w)
+            N[0][0][w] = T(1);
+        for (int q = 1; q <= P; ++q)
+        {
+            T saved[W];
+            for (int w = 0; w != W; ++w)
+                saved[w] = T(0);
+            for (int r = 0; r != q; ++r)
+                for (int w = 0; w != W; ++w)
+                {
+                    const T temp = N[q-1][r][w] / ( R[r+1][w] + L[q-r][w] );
+                    N[q][r][w] = saved[w] + R[r+1][w] * temp;
+                    saved[w] = L[q-r][w] * temp;
+                }
+            for (int w = 0; w != W; ++w)
+                N[q][q][w] = saved[w];
+        }
+
+        for (int k = 0; k <= n; ++k)
+        {
+            T * out = result[k].data() + v0 * (P+1);
+            if ( k > P )
+            {
+                std::fill(out, out + numW * (P+1), T(0));
+                continue;
+            }
+
+            // Start from degree P-k and apply the derivative
+            // recursion N'_{i,q} = q ( N_{i,q-1} / (t_{i+q}-t_i)
+            //                        - N_{i+1,q-1} / (t_{i+q+1}-t_{i+1}) )
+            for (int r = 0; r <= P-k; ++r)
+                for (int w = 0; w != W; ++w)
+                    D[r][w] = N[P-k][r][w];
+            for (int q = P-k+1; q <= P; ++q)
+            {
+                for (int r = 0; r != q; ++r)
+                    for (int w = 0; w != W; ++w)
+                        D[r][w] /= ( R[r+1][w] + L[q-r][w] );
+                for (int w = 0; w != W; ++w)
+                    D[q][w] = q * D[q-1][w];
+                for (int r = q-1; r > 0; --r)
+                    for (int w = 0; w != W; ++w)
+                        D[r][w] = q * ( D[r-1][w] - D[r][w] );
+                for (int w = 0; w != W; ++w)
+                    D[0][w] *= -q;
+            }
+
+            for (int w = 0; w != numW; ++w, out += P+1)
+                for (int r = 0; r <= P; ++r)
+                    out[r] = ( valid[w] ? D[r][w] : T(0) );
+        }
+    }
+}
+
+/**
+   \brief Calls evalAllDersKernel() for the degree \a p, returns false
+   if there is no kernel for this degree
+
+   Kernels are available for the degrees 1 to 5.
+
+   \ingroup Nurbs
+*/
+template<class T>
+bool evalAllDersFixedDegree(const gsKnotVector<T> & knots, const short_t p,
+                            const T a, const T b,
+                            const gsMatrix<T> & u, const int n, gsMatrix<T> result[])
+{
+    switch (p)
+    {
+    case 1: evalAllDersKernel<1,T>(knots, a, b, u, n, result); return true;
+    case 2: evalAllDersKernel<2,T>(knots, a, b, u, n, result); return true;
+    case 3: evalAllDersKernel<3,T>(knots, a, b, u, n, result); return true;
+    case 4: evalAllDersKernel<4,T>(knots, a, b, u, n, result); return true;
+    case 5: evalAllDersKernel<5,T>(knots, a, b, u, n, result); return true;
+    default: return false;
+    }
+}
+
+} // namespace bspline
+
+} // namespace gismo
@@ -0,0 +1,196 @@
+/** @file gsKnotLocator.h
+
+    @brief Knot-span lookup in constant time for large knot vectors
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsNurbs/gsKnotVector.h>
+
+namespace gismo
+{
+
+/**
+   \brief Finds the knot interval of a parameter value in constant
+   expected time
+
+   The locator keeps a copy of the unique knots of the domain of a
+   knot vector. If the knots are uniformly spaced, the interval is
+   obtained by scaling the parameter value. Otherwise the domain is
+   cut into buckets of equal length, each one storing the first knot
+   interval it intersects, and the lookup is a binary search among
+   the (few) intervals of one bucket.
+
+   The locator does not follow changes of the knot vector, it has to
+   be initialized again after the knot vector is modified.
+
+   \tparam T coefficient type
+
+   \ingroup Nurbs
+*/
+template<class T>
+class gsKnotLocator
+{
+public:
+
+    /// Empty constructor
+    gsKnotLocator() : m_offset(0), m_a(0), m_scale(0), m_uniform(false)
+    { }
+
+    /// Constructs the locator of the knot vector \a kv
+    explicit gsKnotLocator(const gsKnotVector<T> & kv)
+    { init(kv); }
+
+    /// Initializes the locator for the knot vector \a kv
+    void init(const gsKnotVector<T> & kv)
+    {
+        m_knots.clear();
+        m_bucket.clear();
+        if ( kv.uSize() < 2 || kv.size() < static_cast<size_t>(2*kv.degree()+2) )
+            return; // no domain
+
+        typename gsKnotVector<T>::uiterator ubeg = kv.domainUBegin();
+        m_offset = ubeg.uIndex();
+        m_knots.assign(ubeg, kv.domainUEnd() + 1);
+
+        const index_t ne = numElements();
+        m_a = m_knots.front();
+        const T len = m_knots.back() - m_a;
+
+        // Detect uniform spacing
+        const T h   = len / ne;
+        const T tol = 16 * std::numeric_limits<T>::epsilon() * math::abs(len);
+        m_uniform = true;
+        for (index_t i = 1; i < ne && m_uniform; ++i)
+            m_uniform = ( math::abs(m_knots[i] - m_a - i * h) <= tol );
+
+        if ( m_uniform )
+        {
+            m_scale = ne / len;
+            return;
+        }
+
+        // Two buckets per element on average
+        const index_t nb = 2 * ne;
+        m_scale = nb / len;
+        m_bucket.resize(nb + 1);
+        index_t i = 0;
+        for (index_t k = 0; k != nb; ++k)
+        {
+            const T x = m_a + k * len / nb;
+            while ( i + 1 < ne && m_knots[i+1] <= x )
+                ++i;
+            m_bucket[k] = i;
+        }
+        m_bucket[nb] = ne - 1;
+    }
+
+    /// Returns true if the locator is not initialized
+    bool empty() const { return m_knots.empty(); }
+
+    /// Returns true if the knots of the domain are uniformly spaced
+    bool isUniform() const { return m_uniform; }
+
+    /// Number of knot intervals in the domain
+    index_t numElements() const
+    { return static_cast<index_t>(m_knots.size()) - 1; }
+
+    /// \brief Returns the same index as gsKnotVector::uFind(u).uIndex().
+    ///
+    /// Values outside the domain are mapped to the first or the last
+    /// knot interval.
+    index_t uIndex(const T u) const
+    { return m_offset + localIndex(u); }
+
+    /// \brief Writes in \a result the indices uIndex(u(j)) for all
+    /// entries of the row \a u.
+    ///
+    /// The interval of the previous entry is tried first, so rows of
+    /// quadrature points grouped by elements cost one comparison per
+    /// entry.
+    template<class Derived>
+    void uIndex_into(const Eigen::DenseBase<Derived> & u,
+                     gsVector<index_t> & result) const
+    {
+        const index_t ne = numElements();
+        result.resize(u.size());
+        index_t i = 0;
+        for (index_t j = 0; j != u.size(); ++j)
+        {
+            const T x = u(j);
+            if ( x < m_knots[i] ||
+                 ( x >= m_knots[i+1] && i + 1 != ne ) )
+            {
+                if ( i + 2 < ne && x >= m_knots[i+1] && x < m_knots[i+2] )
+                    ++i;
+                else
+                    i = localIndex(x);
+            }
+            result[j] = m_offset + i;
+        }
+    }
+
+    /// Returns the memory used by the locator, in bytes
+    size_t memoryUsage() const
+    {
+        return sizeof(*this) + m_knots.capacity() * sizeof(T)
+            + m_bucket.capacity() * sizeof(index_t);
+    }
+
+private:
+
+    // Index of the interval containing u, counted from the start of
+    // the domain
+    index_t localIndex(const T u) const
+    {
+        const index_t ne = numElements();
+        if ( ! (u > m_a) ) // also catches NaN
+            return 0;
+        if ( u >= m_knots.back() )
+            return ne - 1;
+
+        const index_t k = static_cast<index_t>( (u - m_a) * m_scale );
+        index_t i;
+        if ( m_uniform )
+            i = math::min(k, ne - 1);
+        else
+        {
+            const index_t kk = math::min(k, static_cast<index_t>(m_bucket.size()) - 2);
+            i = std::upper_bound(m_knots.begin() + m_bucket[kk] + 1,
+                                 m_knots.begin() + m_bucket[kk+1] + 1, u)
+                - m_knots.begin() - 1;
+        }
+
+        // Correct the rounding of the bucket index
+        while ( u < m_knots[i] )
+            --i;
+        while ( u >= m_knots[i+1] )
+            ++i;
+        return i;
+    }
+
+private:
+
+    // Unique knots of the domain
+    std::vector<T> m_knots;
+
+    // m_bucket[k] is the interval containing the start of bucket k
+    std::vector<index_t> m_bucket;
+
+    // Unique index of the starting knot of the domain
+    index_t m_offset;
+
+    // Start of the domain and number of buckets (or elements) per
+    // unit length
+    T m_a, m_scale;
+
+    bool m_uniform;
+};
+
+} // namespace gismo
@@ -300,7 +300,43 @@ public: // Findspan and value query
      *  greater.
      */
     uiterator uLowerBound( const T u ) const;
-    
+
+    /** \brief Writes in \a result the indices `uFind(u(j)).uIndex()`
+     * for all entries of the row \a u.
+     *
+     * The interval of the previous entry is tried first, so sorted
+     * rows, or rows of quadrature points grouped by element, are
+     * processed in one linear sweep. Values outside the domain are
+     * mapped to the first or the last knot interval. For repeated
+     * lookups in a fixed knot vector see also gsKnotLocator.
+     */
+    template<class Derived>
+    void uFind_into(const Eigen::DenseBase<Derived> & u,
+                    gsVector<index_t> & result) const
+    {
+        result.resize(u.size());
+        const uiterator ubeg = domainUBegin();
+        const uiterator uend = domainUEnd();
+        const mult_t last = uend.uIndex() - 1;
+        uiterator it = ubeg;
+        for (index_t j = 0; j != u.size(); ++j)
+        {
+            const T x = u(j);
+            if ( x < *it || ( x >= *(it+1) && it.uIndex() != last ) )
+            {
+                if ( it.uIndex() + 1 < last && x >= *(it+1) && x < *(it+2) )
+                    ++it;
+                else if ( x <= *ubeg )
+                    it = ubeg;
+                else if ( x >= *uend )
+                    it = uend - 1;
+                else
+                    it = std::upper_bound(ubeg, uend, x) - 1;
+            }
+            result[j] = it.uIndex();
+        }
+    }
+
 public: // miscellaneous
 
     /// Print the knot vector to the given stream.
@@ -0,0 +1,109 @@
+/** @file gsBlockConjugateGradient.h
+
+    @brief Block conjugate gradient solver for several right-hand sides
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsSolver/gsIterativeSolver.h>
+
+namespace gismo
+{
+
+/// @brief The block conjugate gradient method for systems with several
+/// right-hand sides.
+///
+/// All columns of the right-hand side are solved for at once in a
+/// common Krylov space, so every step applies the matrix and the
+/// preconditioner to a block of vectors. The block of search
+/// directions is orthonormalized in every step and dependent
+/// directions are dropped (breakdown-free block CG, Ji and Li 2017).
+///
+/// Every column has its own relative residual error; a column is
+/// removed from the block (deflated) as soon as it reaches the
+/// tolerance. error() is the largest error over all columns.
+///
+/// \ingroup Solver
+template<class T = real_t>
+class gsBlockConjugateGradient : public gsIterativeSolver<T>
+{
+public:
+    typedef gsIterativeSolver<T> Base;
+
+    typedef gsMatrix<T>  VectorType;
+
+    typedef typename Base::LinOpPtr LinOpPtr;
+
+    typedef memory::shared_ptr<gsBlockConjugateGradient> Ptr;
+    typedef memory::unique_ptr<gsBlockConjugateGradient> uPtr;
+
+    /// @brief Constructor using a matrix (operator) and optionally a preconditionner
+    ///
+    /// @param mat     The operator to be solved for, see gsIterativeSolver for details
+    /// @param precond The preconditioner, defaulted to the identity
+    template< typename OperatorType >
+    explicit gsBlockConjugateGradient( const OperatorType& mat,
+                                       const LinOpPtr& precond = LinOpPtr() )
+    : Base(mat, precond) {}
+
+    /// @brief Make function using a matrix (operator) and optionally a preconditionner
+    ///
+    /// @param mat     The operator to be solved for, see gsIterativeSolver for details
+    /// @param precond The preconditioner, defaulted to the identity
+    template< typename OperatorType >
+    static uPtr make( const OperatorType& mat, const LinOpPtr& precond = LinOpPtr() )
+    { return uPtr( new gsBlockConjugateGradient(mat, precond) ); }
+
+    bool initIteration( const VectorType& rhs, VectorType& x );
+    bool step( VectorType& x );
+    void finalizeIteration( VectorType& x );
+
+    /// @brief The relative residual error of every column of the current iterate
+    const gsVector<T> & columnErrors() const      { return m_errors; }
+
+    /// @brief The number of iterations after which every column reached
+    /// the tolerance, or the total number of iterations
+    const gsVector<index_t> & columnIterations() const { return m_iters; }
+
+    /// Prints the object as a string.
+    std::ostream &print(std::ostream &os) const
+    {
+        os << "gsBlockConjugateGradient\n";
+        return os;
+    }
+
+private:
+
+    /// Removes the columns which reached the tolerance from the block
+    void deflate();
+
+private:
+    using Base::m_mat;
+    using Base::m_precond;
+    using Base::m_max_iters;
+    using Base::m_tol;
+    using Base::m_num_iter;
+    using Base::m_rhs_norm;
+    using Base::m_error;
+
+    VectorType m_res;      // residuals of the active columns
+    VectorType m_dir;      // orthonormal block of search directions
+    VectorType m_Adir;     // the operator applied to m_dir
+    VectorType m_tmp;
+
+    gsVector<T>          m_rhsNorms, m_errors;
+    gsVector<index_t>    m_iters;
+    std::vector<index_t> m_active; // the columns not converged yet
+};
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsBlockConjugateGradient.hpp)
+#endif
@@ -0,0 +1,141 @@
+/** @file gsBlockConjugateGradient.hpp
+
+    @brief Block conjugate gradient solver for several right-hand sides
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gsSolver/gsSolverUtils.h>
+
+namespace gismo
+{
+
+template<class T>
+bool gsBlockConjugateGradient<T>::initIteration( const typename gsBlockConjugateGradient<T>::VectorType& rhs,
+                                                 typename gsBlockConjugateGradient<T>::VectorType& x )
+{
+    GISMO_ASSERT( rhs.rows() == m_mat->rows(),
+                  "The right-hand side does not match the matrix: "
+                  << rhs.rows() <<"!="<< m_mat->rows() );
+
+    const index_t n = rhs.rows();
+    const index_t s = rhs.cols();
+    m_num_iter = 0;
+    m_rhs_norm = rhs.norm();
+
+    if ( 0 == x.size() ) // if no initial solution, start with zeros
+        x.setZero(n, s);
+    else
+    {
+        GISMO_ASSERT( x.rows() == m_mat->cols() && x.cols() == s,
+                      "The initial guess does not match the system: "
+                      << x.rows() <<"x"<< x.cols() <<"!="<< m_mat->cols() <<"x"<< s );
+    }
+
+    m_rhsNorms = rhs.colwise().norm().transpose();
+    m_iters.setConstant(s, -1);
+    m_errors.resize(s);
+
+    m_mat->apply(x,m_tmp);
+    m_res = rhs - m_tmp;                                                // initial residuals
+
+    m_active.clear();
+    for (index_t j = 0; j != s; ++j)
+    {
+        if (0 == m_rhsNorms[j]) // zero is a solution
+        {
+            x.col(j).setZero();
+            m_errors[j] = 0;
+        }
+        else
+            m_errors[j] = m_res.col(j).norm() / m_rhsNorms[j];
+        m_active.push_back(j);
+    }
+    deflate();
+
+    m_error = ( s == 0 ? T(0) : m_errors.maxCoeff() );
+    if (m_active.empty())
+        return true;
+
+    m_precond->apply(m_res,m_dir);                                      // initial search directions
+    gsSolverUtils<T>::orthonormalizeColumns(m_dir);
+    return 0 == m_dir.cols();
+}
+
+template<class T>
+bool gsBlockConjugateGradient<T>::step( typename gsBlockConjugateGradient<T>::VectorType& x )
+{
+    m_mat->apply(m_dir,m_Adir);                                         // apply system matrix to all directions
+
+    gsMatrix<T> PtAP = m_dir.transpose() * m_Adir;
+    PtAP = (PtAP + PtAP.transpose()) / 2;
+    const Eigen::LDLT<typename gsMatrix<T>::Base> PtAPinv(PtAP);
+
+    const gsMatrix<T> alpha = PtAPinv.solve(m_dir.transpose() * m_res); // the amounts we travel on the directions
+    m_tmp.noalias() = m_dir * alpha;
+    for (size_t k = 0; k != m_active.size(); ++k)
+        x.col(m_active[k]) += m_tmp.col(k);                             // update solutions
+    m_res.noalias() -= m_Adir * alpha;                                  // update residuals
+
+    for (size_t k = 0; k != m_active.size(); ++k)
+        m_errors[m_active[k]] = m_res.col(k).norm() / m_rhsNorms[m_active[k]];
+    deflate();
+
+    m_error = m_errors.maxCoeff();
+    if (m_active.empty())
+        return true;
+
+    m_precond->apply(m_res, m_tmp);                                     // approximately solve for "A tmp = residual"
+
+    // New directions, A-orthogonal to the current ones
+    const gsMatrix<T> beta = PtAPinv.solve(m_Adir.transpose() * m_tmp);
+    m_tmp.noalias() -= m_dir * beta;
+    m_dir.swap(m_tmp);
+    gsSolverUtils<T>::orthonormalizeColumns(m_dir);
+
+    return 0 == m_dir.cols();                                           // stagnation
+}
+
+template<class T>
+void gsBlockConjugateGradient<T>::finalizeIteration( typename gsBlockConjugateGradient<T>::VectorType& )
+{
+    for (index_t j = 0; j != m_iters.size(); ++j)
+        if (-1 == m_iters[j])
+            m_iters[j] = m_num_iter;
+
+    // cleanup temporaries
+    m_res.clear();
+    m_dir.clear();
+    m_Adir.clear();
+    m_tmp.clear();
+    m_active.clear();
+}
+
+template<class T>
+void gsBlockConjugateGradient<T>::deflate()
+{
+    size_t k = 0;
+    for (size_t i = 0; i != m_active.size(); ++i)
+    {
+        const index_t j = m_active[i];
+        if (m_errors[j] < m_tol)
+        {
+            m_iters[j] = m_num_iter;
+            continue;
+        }
+        if (k != i)
+            m_res.col(k) = m_res.col(i);
+        m_active[k++] = j;
+    }
+    if (k != m_active.size())
+    {
+        m_active.resize(k);
+        m_res.conservativeResize(Eigen::NoChange, k);
+    }
+}
+
+} // end namespace gismo
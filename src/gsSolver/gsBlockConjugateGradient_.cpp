@@ -0,0 +1,9 @@
+#include <gsSolver/gsBlockConjugateGradient.h>
+#include <gsSolver/gsBlockConjugateGradient.hpp>
+
+namespace gismo
+{
+
+CLASS_TEMPLATE_INST gsBlockConjugateGradient<real_t>;
+
+} // namespace gismo
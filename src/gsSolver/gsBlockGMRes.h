@@ -0,0 +1,145 @@
+/** @file gsBlockGMRes.h
+
+    @brief Block generalized minimal residual method for several
+    right-hand sides
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#pragma once
+
+#include <gsSolver/gsIterativeSolver.h>
+
+namespace gismo
+{
+
+/// @brief The restarted block generalized minimal residual (GMRES)
+/// method for systems with several right-hand sides.
+///
+/// All columns of the right-hand side are solved for at once: each
+/// step extends a common block Krylov space by applying the matrix and
+/// the preconditioner to a block of vectors, and the iterates minimize
+/// the residuals over the whole space. Dependent directions of the
+/// Arnoldi blocks are dropped. As in gsGMRes, the preconditioner is
+/// applied from the left and the error of a column is the norm of its
+/// preconditioned residual divided by the norm of its right-hand side.
+///
+/// Every column has its own error. The iteration is restarted after
+/// \a Restart steps; columns which reached the tolerance are removed
+/// from the block (deflated) at the restarts.
+///
+/// \ingroup Solver
+template<class T = real_t>
+class gsBlockGMRes : public gsIterativeSolver<T>
+{
+public:
+    typedef gsIterativeSolver<T> Base;
+
+    typedef gsMatrix<T>  VectorType;
+
+    typedef typename Base::LinOpPtr LinOpPtr;
+
+    typedef memory::shared_ptr<gsBlockGMRes> Ptr;
+    typedef memory::unique_ptr<gsBlockGMRes> uPtr;
+
+    /// @brief Constructor using a matrix (operator) and optionally a preconditionner
+    ///
+    /// @param mat     The operator to be solved for, see gsIterativeSolver for details
+    /// @param precond The preconditioner, defaulted to the identity
+    template< typename OperatorType >
+    explicit gsBlockGMRes( const OperatorType& mat, const LinOpPtr& precond = LinOpPtr() )
+    : Base(mat, precond), m_restart(50) {}
+
+    /// @brief Make function using a matrix (operator) and optionally a preconditionner
+    ///
+    /// @param mat     The operator to be solved for, see gsIterativeSolver for details
+    /// @param precond The preconditioner, defaulted to the identity
+    template< typename OperatorType >
+    static uPtr make( const OperatorType& mat, const LinOpPtr& precond = LinOpPtr() )
+    { return uPtr( new gsBlockGMRes(mat, precond) ); }
+
+    /// @brief Returns a list of default options
+    static gsOptionList defaultOptions()
+    {
+        gsOptionList opt = Base::defaultOptions();
+        opt.addInt("Restart", "Number of block steps before a restart", 50 );
+        return opt;
+    }
+
+    /// @brief Set the options based on a gsOptionList
+    gsBlockGMRes& setOptions(const gsOptionList& opt)
+    {
+        Base::setOptions(opt);
+        m_restart = opt.askInt("Restart", m_restart);
+        return *this;
+    }
+
+    bool initIteration( const VectorType& rhs, VectorType& x );
+    bool step( VectorType& x );
+    void finalizeIteration( VectorType& x );
+
+    /// Set the number of block steps before a restart (default: 50)
+    void setRestart(index_t restart)                 { m_restart = restart; }
+
+    /// @brief The relative (preconditioned) residual error of every column
+    const gsVector<T> & columnErrors() const         { return m_errors; }
+
+    /// @brief The number of iterations after which every column reached
+    /// the tolerance, or the total number of iterations
+    const gsVector<index_t> & columnIterations() const { return m_iters; }
+
+    /// Prints the object as a string.
+    std::ostream &print(std::ostream &os) const
+    {
+        os << "gsBlockGMRes\n";
+        return os;
+    }
+
+private:
+
+    /// Computes the residuals, deflates the converged columns and
+    /// starts a new Krylov space. Returns true if all columns converged.
+    bool startCycle(const VectorType& x);
+
+    /// Adds the update of the current cycle to \a x
+    void updateSolution(VectorType& x);
+
+    /// Sets the errors of the active columns and the convergence
+    /// iterations
+    void setErrors(const gsMatrix<T> & res);
+
+private:
+    using Base::m_mat;
+    using Base::m_precond;
+    using Base::m_max_iters;
+    using Base::m_tol;
+    using Base::m_num_iter;
+    using Base::m_rhs_norm;
+    using Base::m_error;
+
+    index_t m_restart;
+
+    gsMatrix<T> m_rhs;
+    typedef Eigen::HouseholderQR<typename gsMatrix<T>::Base> QRSolver;
+
+    gsMatrix<T> m_basis;              // orthonormal basis of the Krylov space
+    gsMatrix<T> m_hess;               // triangular factor of the block Hessenberg matrix
+    std::vector<QRSolver> m_qr;       // reflections of the block columns
+    gsMatrix<T> m_g, m_y;             // least squares right-hand side and solution
+    gsMatrix<T> m_tmp, m_w;
+    std::vector<index_t> m_blocks;    // first column of each block of m_basis
+    index_t m_cycleSteps;
+
+    gsVector<T>          m_rhsNorms, m_errors;
+    gsVector<index_t>    m_iters;
+    std::vector<index_t> m_active;    // the columns of the current cycle
+};
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsBlockGMRes.hpp)
+#endif
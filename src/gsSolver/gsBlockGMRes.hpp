@@ -0,0 +1,222 @@
+/** @file gsBlockGMRes.hpp
+
+    @brief Block generalized minimal residual method for several
+    right-hand sides
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gsSolver/gsSolverUtils.h>
+
+namespace gismo
+{
+
+template<class T>
+bool gsBlockGMRes<T>::initIteration( const typename gsBlockGMRes<T>::VectorType& rhs,
+                                     typename gsBlockGMRes<T>::VectorType& x )
+{
+    GISMO_ASSERT( rhs.rows() == m_mat->rows(),
+                  "The right-hand side does not match the matrix: "
+                  << rhs.rows() <<"!="<< m_mat->rows() );
+    GISMO_ASSERT( m_restart > 0, "The restart length has to be positive." );
+
+    const index_t n = rhs.rows();
+    const index_t s = rhs.cols();
+    m_num_iter = 0;
+    m_rhs_norm = rhs.norm();
+
+    if ( 0 == x.size() ) // if no initial solution, start with zeros
+        x.setZero(n, s);
+    else
+    {
+        GISMO_ASSERT( x.rows() == m_mat->cols() && x.cols() == s,
+                      "The initial guess does not match the system: "
+                      << x.rows() <<"x"<< x.cols() <<"!="<< m_mat->cols() <<"x"<< s );
+    }
+
+    m_rhs = rhs;
+    m_rhsNorms = rhs.colwise().norm().transpose();
+    m_iters.setConstant(s, -1);
+    m_errors.setZero(s);
+
+    m_active.clear();
+    for (index_t j = 0; j != s; ++j)
+    {
+        if (0 == m_rhsNorms[j]) // zero is a solution
+        {
+            x.col(j).setZero();
+            m_iters[j] = 0;
+        }
+        else
+            m_active.push_back(j);
+    }
+
+    return startCycle(x);
+}
+
+template<class T>
+bool gsBlockGMRes<T>::startCycle( const typename gsBlockGMRes<T>::VectorType& x )
+{
+    m_cycleSteps = 0;
+    const index_t n = m_rhs.rows();
+    const index_t s = m_active.size();
+
+    // Preconditioned residuals of the active columns
+    m_w.resize(n, s);
+    for (index_t k = 0; k != s; ++k)
+        m_w.col(k) = x.col(m_active[k]);
+    m_mat->apply(m_w, m_tmp);
+    for (index_t k = 0; k != s; ++k)
+        m_tmp.col(k) = m_rhs.col(m_active[k]) - m_tmp.col(k);
+    m_precond->apply(m_tmp, m_w);
+    setErrors(m_w);
+
+    // Deflate the converged columns
+    index_t k = 0;
+    for (index_t i = 0; i != s; ++i)
+    {
+        if (m_errors[m_active[i]] < m_tol)
+            continue;
+        if (k != i)
+            m_w.col(k) = m_w.col(i);
+        m_active[k++] = m_active[i];
+    }
+    m_active.resize(k);
+    m_w.conservativeResize(Eigen::NoChange, k);
+
+    m_error = ( 0 == m_errors.size() ? T(0) : m_errors.maxCoeff() );
+    if (m_active.empty())
+        return true;
+
+    // First block of the Krylov space; the storage for the basis and
+    // the triangular factor is reserved for the whole cycle
+    m_basis.resize(n, (m_restart + 1) * m_active.size());
+    m_tmp = m_w;
+    const index_t r = gsSolverUtils<T>::orthonormalizeColumns(m_tmp);
+    m_basis.leftCols(r) = m_tmp;
+    m_g.noalias() = m_tmp.transpose() * m_w;
+    m_hess.setZero(m_restart * m_active.size(), m_restart * m_active.size());
+    m_qr.clear();
+    m_blocks.clear();
+    m_blocks.push_back(0);
+    m_blocks.push_back(r);
+
+    return 0 == r;
+}
+
+template<class T>
+void gsBlockGMRes<T>::setErrors(const gsMatrix<T> & res)
+{
+    for (size_t k = 0; k != m_active.size(); ++k)
+    {
+        const index_t j = m_active[k];
+        m_errors[j] = res.col(k).norm() / m_rhsNorms[j];
+        if (m_errors[j] >= m_tol)
+            m_iters[j] = -1;
+        else if (-1 == m_iters[j])
+            m_iters[j] = m_num_iter;
+    }
+}
+
+template<class T>
+void gsBlockGMRes<T>::updateSolution( typename gsBlockGMRes<T>::VectorType& x )
+{
+    if (0 == m_cycleSteps)
+        return;
+    // Back substitution with the triangular factor of the Hessenberg matrix
+    const index_t b = m_blocks[m_blocks.size() - 2];
+    m_y = m_hess.topLeftCorner(b, b).template triangularView<Eigen::Upper>().solve(m_g.topRows(b));
+    m_tmp.noalias() = m_basis.leftCols(b) * m_y;
+    for (size_t k = 0; k != m_active.size(); ++k)
+        x.col(m_active[k]) += m_tmp.col(k);
+    m_cycleSteps = 0;
+}
+
+template<class T>
+void gsBlockGMRes<T>::finalizeIteration( typename gsBlockGMRes<T>::VectorType& x )
+{
+    updateSolution(x);
+
+    for (index_t j = 0; j != m_iters.size(); ++j)
+        if (-1 == m_iters[j])
+            m_iters[j] = m_num_iter;
+
+    // cleanup temporaries
+    m_rhs.clear();
+    m_basis.clear();
+    m_hess.clear();
+    m_qr.clear();
+    m_g.clear();
+    m_y.clear();
+    m_tmp.clear();
+    m_w.clear();
+    m_blocks.clear();
+    m_active.clear();
+}
+
+template<class T>
+bool gsBlockGMRes<T>::step( typename gsBlockGMRes<T>::VectorType& x )
+{
+    // The iterate x is only updated at restarts! Use finalizeIteration to obtain x.
+    const index_t b0 = m_blocks[m_blocks.size() - 2];
+    const index_t b1 = m_blocks.back();
+
+    const index_t sk = b1 - b0;
+
+    m_w = m_basis.middleCols(b0, sk);
+    m_mat->apply(m_w, m_tmp);
+    m_precond->apply(m_tmp, m_w);
+
+    // Block Gram-Schmidt against the basis, twice for stability
+    gsMatrix<T> h = m_basis.leftCols(b1).transpose() * m_w;
+    m_w.noalias() -= m_basis.leftCols(b1) * h;
+    const gsMatrix<T> h2 = m_basis.leftCols(b1).transpose() * m_w;
+    m_w.noalias() -= m_basis.leftCols(b1) * h2;
+    h += h2;
+
+    // Next block, dropping dependent directions
+    m_tmp = m_w;
+    const index_t r = gsSolverUtils<T>::orthonormalizeColumns(m_w);
+    m_basis.middleCols(b1, r) = m_w;
+    m_blocks.push_back(b1 + r);
+    ++m_cycleSteps;
+
+    // New block column of the Hessenberg matrix
+    h.conservativeResize(b1 + r, Eigen::NoChange);
+    h.bottomRows(r).noalias() = m_w.transpose() * m_tmp;
+
+    // Update the QR factorization of the Hessenberg matrix: apply the
+    // reflections of the previous blocks to the new block column and
+    // factorize its subdiagonal part
+    for (size_t k = 0; k != m_qr.size(); ++k)
+        h.middleRows(m_blocks[k], m_blocks[k+2] - m_blocks[k])
+            .applyOnTheLeft(m_qr[k].householderQ().adjoint());
+    m_qr.push_back( QRSolver(h.bottomRows(b1 + r - b0)) );
+    m_hess.block(0, b0, b0, sk) = h.topRows(b0);
+    m_hess.block(b0, b0, sk, sk) =
+        m_qr.back().matrixQR().topRows(sk).template triangularView<Eigen::Upper>();
+
+    // The residuals of the least squares problems are the components
+    // of the rotated right-hand side below the triangular factor
+    m_g.conservativeResize(b1 + r, Eigen::NoChange);
+    m_g.bottomRows(r).setZero();
+    m_g.bottomRows(b1 + r - b0).applyOnTheLeft(m_qr.back().householderQ().adjoint());
+    setErrors(m_g.bottomRows(r));
+
+    m_error = m_errors.maxCoeff();
+    if (m_error < m_tol)
+        return true;
+
+    if (0 == r || m_cycleSteps == m_restart) // invariant subspace or restart
+    {
+        updateSolution(x);
+        return startCycle(x);
+    }
+    return false;
+}
+
+} // end namespace gismo
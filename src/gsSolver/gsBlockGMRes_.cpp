@@ -0,0 +1,9 @@
+#include <gsSolver/gsBlockGMRes.h>
+#include <gsSolver/gsBlockGMRes.hpp>
+
+namespace gismo
+{
+
+CLASS_TEMPLATE_INST gsBlockGMRes<real_t>;
+
+} // namespace gismo
@@ -0,0 +1,273 @@
+/** @file gsChebyshevOp.h
+
+    @brief Chebyshev polynomial smoother and preconditioner
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsSolver/gsSimplePreconditioners.h>
+#include <gsSolver/gsConjugateGradient.h>
+
+namespace gismo
+{
+
+namespace internal
+{
+template<typename T, int _Options>
+void chebyshevSweep(const Eigen::SparseMatrix<T,_Options,index_t> & A, gsMatrix<T>& x, const gsMatrix<T>& f,
+                    const gsVector<T> & dinv, gsMatrix<T>& d, T a, T b,
+                    bool zeroGuess, index_t numThreads);
+} // namespace internal
+
+/// @brief Chebyshev polynomial smoother
+///
+/// One step applies the Chebyshev iteration of the given degree to
+/// the (Jacobi preconditioned) system, i.e., it reduces the error by
+/// the Chebyshev polynomial that is smallest on the interval
+/// [\a lowerBound, \a upperBound] of the spectrum of \f$ D^{-1}A \f$.
+/// Every degree costs one matrix-vector product and some vector
+/// updates; there are no scalar products. The rows are distributed
+/// over \a NumThreads threads.
+///
+/// By default, the upper bound is the largest eigenvalue, estimated
+/// with \a LanczosSteps steps of the conjugate gradient method, times
+/// \a SafetyFactor. The lower bound is the upper bound divided by
+/// \a EigenvalueRatio, such that the high frequencies are smoothed.
+/// For using the operator as a preconditioner, both bounds can be set
+/// with setBounds().
+///
+/// Requires a symmetric positive definite gsSparseMatrix, which is
+/// used in its own storage order. The resulting operator is
+/// symmetric.
+///
+/// \ingroup Solver
+template <typename MatrixType>
+class gsChebyshevOp GISMO_FINAL : public gsPreconditionerOp<typename MatrixType::Scalar>
+{
+    typedef memory::shared_ptr<MatrixType>          MatrixPtr;
+    typedef typename MatrixType::Nested             NestedMatrix;
+
+public:
+    /// Scalar type
+    typedef typename MatrixType::Scalar T;
+
+    /// Shared pointer for gsChebyshevOp
+    typedef memory::shared_ptr< gsChebyshevOp > Ptr;
+
+    /// Unique pointer for gsChebyshevOp
+    typedef memory::unique_ptr< gsChebyshevOp > uPtr;
+
+    /// Base class
+    typedef gsPreconditionerOp<T> Base;
+
+    /// @brief Constructor with given matrix
+    explicit gsChebyshevOp(const MatrixType& _mat, index_t _degree = 3)
+    : m_mat(), m_expr(_mat.derived()), m_degree(_degree)
+    { init(); }
+
+    /// @brief Constructor with shared pointer to matrix
+    explicit gsChebyshevOp(const MatrixPtr& _mat, index_t _degree = 3)
+    : m_mat(_mat), m_expr(m_mat->derived()), m_degree(_degree)
+    { init(); }
+
+    static uPtr make(const MatrixType& _mat, index_t _degree = 3)
+    { return memory::make_unique( new gsChebyshevOp(_mat, _degree) ); }
+
+    static uPtr make(const MatrixPtr& _mat, index_t _degree = 3)
+    { return memory::make_unique( new gsChebyshevOp(_mat, _degree) ); }
+
+    void step(const gsMatrix<T> & rhs, gsMatrix<T> & x) const
+    {
+        GISMO_ASSERT( m_expr.rows() == rhs.rows() && rhs.rows() == x.rows() && rhs.cols() == x.cols(),
+                      "Dimensions do not match.");
+        iterate(rhs, x, false);
+    }
+
+    // We use our own apply implementation as we can save one multiplication
+    // for the zero initial guess.
+    void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const
+    {
+        GISMO_ASSERT( m_expr.rows() == input.rows(), "Dimensions do not match.");
+
+        x.resize(input.rows(), input.cols());
+        iterate(input, x, true);
+        for (index_t k = 1; k < m_num_of_sweeps; ++k)
+            iterate(input, x, false);
+    }
+
+    index_t rows() const {return m_expr.rows();}
+    index_t cols() const {return m_expr.cols();}
+
+    /// Set the degree of the polynomial (number of matrix-vector products per step)
+    void setDegree(const index_t degree)
+    {
+        GISMO_ASSERT ( degree > 0, "The degree needs to be positive." );
+        m_degree = degree;
+    }
+
+    /// Get the degree of the polynomial
+    index_t degree() const         { return m_degree; }
+
+    /// @brief Sets the interval of the spectrum of the preconditioned
+    /// matrix to be damped, overriding the estimated bounds
+    void setBounds(const T lower, const T upper)
+    {
+        GISMO_ASSERT ( 0 < lower && lower < upper, "The bounds are not feasible." );
+        m_lower = lower;
+        m_upper = upper;
+    }
+
+    /// Lower end of the interval to be damped
+    T lowerBound() const           { return m_lower; }
+
+    /// Upper end of the interval to be damped
+    T upperBound() const           { return m_upper; }
+
+    /// Set the number of threads
+    void setNumThreads(const index_t nt) { m_num_threads = nt; }
+
+    /// Get the default options as gsOptionList object
+    static gsOptionList defaultOptions()
+    {
+        gsOptionList opt = Base::defaultOptions();
+        opt.addInt   ( "Degree", "Degree of the Chebyshev polynomial", 3 );
+        opt.addInt   ( "LanczosSteps", "Number of Lanczos steps for estimating the largest eigenvalue", 10 );
+        opt.addReal  ( "SafetyFactor", "Factor applied to the estimated largest eigenvalue", 1.1 );
+        opt.addReal  ( "EigenvalueRatio", "Ratio of the upper and the lower bound", 30 );
+        opt.addSwitch( "Jacobi", "Use Jacobi as inner preconditioner", true );
+        opt.addInt   ( "NumThreads", "Number of threads", 1 );
+        return opt;
+    }
+
+    /// Set options based on a gsOptionList object
+    virtual void setOptions(const gsOptionList & opt)
+    {
+        Base::setOptions(opt);
+        setDegree( opt.askInt( "Degree", m_degree ) );
+        m_num_threads = opt.askInt( "NumThreads", m_num_threads );
+
+        const index_t steps  = opt.askInt   ( "LanczosSteps", m_lanczos_steps );
+        const bool    jacobi = opt.askSwitch( "Jacobi", m_jacobi );
+        const T       safety = opt.askReal  ( "SafetyFactor", m_safety );
+        const T       ratio  = opt.askReal  ( "EigenvalueRatio", m_ratio );
+        if ( steps != m_lanczos_steps || jacobi != m_jacobi || safety != m_safety || ratio != m_ratio )
+        {
+            m_lanczos_steps = steps;
+            m_jacobi        = jacobi;
+            m_safety        = safety;
+            m_ratio         = ratio;
+            estimateBounds();
+        }
+    }
+
+    /// Returns the matrix
+    NestedMatrix matrix() const { return m_expr; }
+
+    /// Returns a shared pinter to the matrix
+    MatrixPtr    matrixPtr() const {
+        GISMO_ENSURE( m_mat, "A shared pointer is only available if it was provided to gsChebyshevOp." );
+        return m_mat;
+    }
+
+    typename gsLinearOperator<T>::Ptr underlyingOp() const { return makeMatrixOp(m_mat); }
+
+private:
+    void init()
+    {
+        GISMO_ASSERT ( m_degree > 0, "The degree needs to be positive." );
+        m_lanczos_steps = 10;
+        m_safety        = 1.1;
+        m_ratio         = 30;
+        m_jacobi        = true;
+        m_num_threads   = 1;
+        estimateBounds();
+    }
+
+    /// Estimates the largest eigenvalue of the preconditioned matrix
+    /// from the Lanczos matrix of some steps of the conjugate
+    /// gradient method
+    void estimateBounds()
+    {
+        if (m_jacobi)
+            m_dinv = m_expr.diagonal().cwiseInverse();
+        else
+            m_dinv.setOnes(m_expr.rows());
+
+        gsConjugateGradient<T> cg(m_expr, m_jacobi ? typename gsLinearOperator<T>::Ptr(makeJacobiOp(m_expr))
+                                                   : typename gsLinearOperator<T>::Ptr());
+        cg.setMaxIterations(m_lanczos_steps);
+        cg.setTolerance(std::numeric_limits<T>::epsilon());
+        cg.setCalcEigenvalues(true);
+
+        gsMatrix<T> rhs, x;
+        rhs.setRandom(m_expr.rows(), 1);
+        x.setZero(m_expr.rows(), 1);
+        cg.solve(rhs, x);
+
+        gsMatrix<T> eigs;
+        cg.getEigenvalues(eigs);
+        m_upper = m_safety * eigs.maxCoeff();
+        m_lower = m_upper / m_ratio;
+    }
+
+    void iterate(const gsMatrix<T> & rhs, gsMatrix<T> & x, bool zeroGuess) const
+    {
+        // Chebyshev iteration for the interval [lower, upper]
+        const T theta = (m_upper + m_lower) / 2;
+        const T delta = (m_upper - m_lower) / 2;
+        const T sigma = theta / delta;
+        T rho = 1 / sigma;
+
+        m_d.resize(rhs.rows(), rhs.cols());
+        internal::chebyshevSweep<T>(m_expr, x, rhs, m_dinv, m_d, 0, 1 / theta,
+                                    zeroGuess, m_num_threads);
+        for (index_t k = 1; k < m_degree; ++k)
+        {
+            const T rhoNew = 1 / (2 * sigma - rho);
+            internal::chebyshevSweep<T>(m_expr, x, rhs, m_dinv, m_d, rhoNew * rho,
+                                        2 * rhoNew / delta, false, m_num_threads);
+            rho = rhoNew;
+        }
+    }
+
+private:
+    const MatrixPtr m_mat;  ///< Shared pointer to matrix (if needed)
+    NestedMatrix    m_expr; ///< Nested Eigen expression
+
+    using Base::m_num_of_sweeps;
+    index_t m_degree;
+    index_t m_lanczos_steps;
+    T m_safety, m_ratio;
+    bool m_jacobi;
+    index_t m_num_threads;
+
+    T m_lower, m_upper;     ///< Interval of the spectrum to be damped
+    gsVector<T> m_dinv;     ///< Inverse of the diagonal (or ones)
+    mutable gsMatrix<T> m_d;///< Update of the last Chebyshev step
+};
+
+/**
+   \brief Returns a smart pointer to a Chebyshev smoother referring on \a mat
+*/
+template <class Derived>
+typename gsChebyshevOp<Derived>::uPtr makeChebyshevOp(const Eigen::EigenBase<Derived>& mat, index_t degree = 3)
+{ return gsChebyshevOp<Derived>::make(mat.derived(), degree); }
+
+/**
+   \brief Returns a smart pointer to a Chebyshev smoother referring on \a mat
+*/
+template <class Derived>
+typename gsChebyshevOp<Derived>::uPtr makeChebyshevOp(const memory::shared_ptr<Derived>& mat, index_t degree = 3)
+{ return gsChebyshevOp<Derived>::make(mat, degree); }
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsChebyshevOp.hpp)
+#endif
@@ -0,0 +1,58 @@
+/** @file gsChebyshevOp.hpp
+
+    @brief Chebyshev polynomial smoother and preconditioner
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+namespace gismo
+{
+
+namespace internal
+{
+
+template<typename T, int _Options>
+void chebyshevSweep(const Eigen::SparseMatrix<T,_Options,index_t> & A, gsMatrix<T>& x, const gsMatrix<T>& f,
+                    const gsVector<T> & dinv, gsMatrix<T>& d, T a, T b,
+                    bool zeroGuess, index_t numThreads)
+{
+    GISMO_ASSERT( A.rows() == x.rows() && x.rows() == f.rows() && A.cols() == A.rows() && x.cols() == f.cols()
+                  && dinv.rows() == A.rows() && d.rows() == f.rows() && d.cols() == f.cols(),
+        "Dimensions do not match.");
+
+    // Computes d = a d + b D^{-1} (f - A x) and x = x + d, where x is
+    // considered as zero if zeroGuess is set.
+    // The rows are read in the storage order of A, so that it is never
+    // copied; for column-major storage, the outer vector i is column i,
+    // which is row i since A is supposed to be symmetric.
+    const index_t n = A.outerSize();
+    const index_t m = f.cols();
+#   pragma omp parallel num_threads(numThreads) if(numThreads > 1)
+    {
+#       pragma omp for schedule(static)
+        for (index_t i = 0; i < n; ++i)
+            for (index_t j = 0; j < m; ++j)
+            {
+                T sum = 0;
+                if (!zeroGuess)
+                    for (typename Eigen::SparseMatrix<T,_Options,index_t>::InnerIterator it(A,i); it; ++it)
+                        sum += it.value() * x( it.index(), j );    // compute A.x
+                const T r = dinv[i] * ( f(i,j) - sum );
+                d(i,j) = ( 0 == a ) ? b * r : a * d(i,j) + b * r;
+            }
+
+        // The update of x has to wait until all rows have read x
+#       pragma omp for schedule(static)
+        for (index_t i = 0; i < n; ++i)
+            for (index_t j = 0; j < m; ++j)
+                x(i,j) = zeroGuess ? d(i,j) : x(i,j) + d(i,j);
+    }
+}
+
+} // namespace internal
+
+} // namespace gismo
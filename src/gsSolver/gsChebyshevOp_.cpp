@@ -0,0 +1,19 @@
+#include <gsSolver/gsChebyshevOp.h>
+#include <gsSolver/gsChebyshevOp.hpp>
+
+namespace gismo
+{
+
+namespace internal
+{
+
+TEMPLATE_INST void chebyshevSweep(const gsSparseMatrix<real_t,ColMajor>::Base & A, gsMatrix<real_t>& x, const gsMatrix<real_t>& f,
+                                  const gsVector<real_t> & dinv, gsMatrix<real_t>& d, real_t a, real_t b,
+                                  bool zeroGuess, index_t numThreads);
+TEMPLATE_INST void chebyshevSweep(const gsSparseMatrix<real_t,RowMajor>::Base & A, gsMatrix<real_t>& x, const gsMatrix<real_t>& f,
+                                  const gsVector<real_t> & dinv, gsMatrix<real_t>& d, real_t a, real_t b,
+                                  bool zeroGuess, index_t numThreads);
+
+} // namespace internal
+
+} // namespace gismo
@@ -100,6 +100,9 @@ private:
     using Base::m_num_iter;
     using Base::m_rhs_norm;
     using Base::m_error;
+    using Base::m_num_threads;
+
+    typedef gsKrylovKernels<T> Kernels;
 
 
     VectorType m_res;
@@ -26,7 +26,7 @@ bool gsGMRes<T>::initIteration( const typename gsGMRes<T>::VectorType& rhs,
     m_mat->apply(x,tmp);
     tmp = rhs - tmp;
     m_precond->apply(tmp, residual);
-    beta = residual.norm(); // This is  ||r||
+    beta = Kernels::norm(residual, m_num_threads); // This is  ||r||
 
     m_error = beta/m_rhs_norm;
     if(m_error < m_tol)
@@ -98,10 +98,10 @@ bool gsGMRes<T>::step( typename gsGMRes<T>::VectorType& )
 
     for (index_t i = 0; i< k+1; ++i)
     {
-        h_tmp(i,0) = (w.transpose()*v[i]).value(); //Typo h_l,k
-        w = w - h_tmp(i,0)*v[i];
+        h_tmp(i,0) = Kernels::dot(w, v[i], m_num_threads); //Typo h_l,k
+        Kernels::axpy(-h_tmp(i,0), v[i], w, m_num_threads);
     }
-    h_tmp(k+1,0) = w.norm();
+    h_tmp(k+1,0) = Kernels::norm(w, m_num_threads);
 
   //  if (math::abs(h_tmp(k+1,0)) < 1e-16) //If exact solution
   //      return true;
@@ -24,7 +24,7 @@ bool gsGradientMethod<T>::initIteration( const typename gsGradientMethod<T>::Vec
     m_mat->apply(x,m_tmp);
     m_res = rhs - m_tmp;
 
-    m_error = m_res.norm() / m_rhs_norm;
+    m_error = Kernels::norm(m_res, m_num_threads) / m_rhs_norm;
     return m_error < m_tol;
 
 }
@@ -37,13 +37,14 @@ bool gsGradientMethod<T>::step( typename gsGradientMethod<T>::VectorType& x )
 
     T step_size;
     if (m_adapt_step_size)
-        step_size = m_tmp.col(0).dot(m_res.col(0)) / m_tmp.col(0).dot(m_tmp.col(0));
+        step_size = Kernels::dot(m_tmp, m_res, m_num_threads)
+                  / Kernels::squaredNorm(m_tmp, m_num_threads);
     else
         step_size = m_step_size;
 
-    x += step_size * m_update;
-    m_res -= step_size * m_tmp;
-    m_error = m_res.norm() / m_rhs_norm;
+    Kernels::axpy(step_size, m_update, x, m_num_threads);
+    m_error = math::sqrt( Kernels::axpyDot(-step_size, m_tmp, m_res, m_res, m_num_threads) )
+            / m_rhs_norm;
     return m_error < m_tol;
 }
 
@@ -15,6 +15,7 @@
 #include <gsCore/gsExport.h>
 #include <gsCore/gsLinearAlgebra.h>
 #include <gsSolver/gsMatrixOp.h>
+#include <gsSolver/gsKrylovKernels.h>
 #include <gsIO/gsOptionList.h>
 
 namespace gismo
@@ -46,7 +47,8 @@ public:
       m_tol(1e-10),
       m_num_iter(-1),
       m_rhs_norm(-1),
-      m_error(-1)
+      m_error(-1),
+      m_num_threads(1)
     {
         GISMO_ASSERT(m_mat->rows()     == m_mat->cols(),     "The matrix is not square."                     );
 
@@ -76,7 +78,8 @@ public:
       m_tol(1e-10),
       m_num_iter(-1),
       m_rhs_norm(-1),
-      m_error(-1)
+      m_error(-1),
+      m_num_threads(1)
     {
         GISMO_ASSERT(m_mat->rows()     == m_mat->cols(),     "The matrix is not square."                     );
 
@@ -95,6 +98,9 @@ public:
         opt.addInt   ("MaxIterations"    , "Maximum number of iterations", 1000       );
         opt.addReal  ("Tolerance"        , "Tolerance for the error criteria on the "
                                            "relative residual error",      1e-10      );
+        opt.addInt   ("NumThreads"       , "Number of threads for the vector operations", 1 );
+        opt.addSwitch("ThreadedMatrix"   , "Pass NumThreads on to the matrix (changes the "
+                                           "operator, which may be shared)", false     );
         return opt;
     }
 
@@ -103,6 +109,8 @@ public:
     {
         m_max_iters        = opt.askInt   ("MaxIterations"    , m_max_iters        );
         m_tol              = opt.askReal  ("Tolerance"        , m_tol              );
+        setNumThreads(       opt.askInt   ("NumThreads"       , m_num_threads      ),
+                             opt.askSwitch("ThreadedMatrix"   , false              ) );
         return *this;
     }
 
@@ -179,7 +187,7 @@ public:
 
         m_num_iter = 0;
 
-        m_rhs_norm = rhs.norm();
+        m_rhs_norm = gsKrylovKernels<T>::norm(rhs, m_num_threads);
 
         if (0 == m_rhs_norm) // special case of zero rhs
         {
@@ -222,6 +230,28 @@ public:
     /// Set the tolerance for the error criteria on the relative residual error (default: 1e-10)
     void setTolerance(T tol)                                   { m_tol = tol; }
 
+    /// @brief Set the number of threads for the vector operations of
+    /// the solver (default: 1)
+    ///
+    /// If \a toMatrix is true, the number is also passed on to the
+    /// matrix as option \a NumThreads; gsMatrixOp uses it for row-major
+    /// sparse matrices. This changes the operator, also for the other
+    /// users of it. For a fixed number of threads, the results do not
+    /// depend on the scheduling.
+    void setNumThreads(index_t nt, bool toMatrix = false)
+    {
+        m_num_threads = nt;
+        if ( toMatrix )
+        {
+            gsOptionList opt;
+            opt.addInt("NumThreads", "Number of threads", nt);
+            m_mat->setOptions(opt);
+        }
+    }
+
+    /// The number of threads for the vector operations
+    index_t numThreads() const                                 { return m_num_threads; }
+
     /// The number of iterations needed to reach the error criteria
     index_t iterations() const                                 { return m_num_iter; }
 
@@ -256,6 +286,7 @@ protected:
     index_t        m_num_iter;        ///< The number of iterations performed
     T              m_rhs_norm;        ///< The norm of the right-hand-side
     T              m_error;           ///< The relative error as absolute_error/m_rhs_norm
+    index_t        m_num_threads;     ///< The number of threads for the vector operations
 };
 
 /// \brief Print (as string) operator for iterative solvers
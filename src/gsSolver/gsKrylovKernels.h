@@ -0,0 +1,212 @@
+/** @file gsKrylovKernels.h
+
+    @brief Multithreaded vector kernels and sparse matrix-vector
+    product for the iterative solvers
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsLinearAlgebra.h>
+
+namespace gismo
+{
+
+/// @brief Multithreaded vector kernels and sparse matrix-vector
+/// product used by the iterative solvers.
+///
+/// The vectors are split into \a nt contiguous chunks which are
+/// processed by OpenMP threads, if G+Smo is compiled with OpenMP.
+/// Reductions add up the partial results of the chunks in a fixed
+/// order, so the results depend on \a nt but not on the scheduling of
+/// the threads. For \a nt < 2 the plain (serial) Eigen expressions are
+/// used.
+///
+/// Matrices with several columns are treated as one long vector.
+///
+/// \ingroup Solver
+template<class T>
+class gsKrylovKernels
+{
+public:
+
+    /// Returns the scalar product of \a x and \a y
+    static T dot(const gsMatrix<T> & x, const gsMatrix<T> & y, index_t nt = 1)
+    {
+        GISMO_ASSERT( x.size() == y.size(), "The sizes do not match." );
+        if (nt < 2)
+            return asVec(x).dot(asVec(y));
+
+        const index_t n = x.size();
+        gsVector<T> part(nt);
+#       pragma omp parallel for num_threads(nt) schedule(static)
+        for (index_t c = 0; c < nt; ++c)
+        {
+            const index_t b = chunk(n, nt, c), l = chunk(n, nt, c+1) - b;
+            part[c] = asVec(x).segment(b, l).dot( asVec(y).segment(b, l) );
+        }
+        return sum(part);
+    }
+
+    /// Returns the squared Euclidean norm of \a x
+    static T squaredNorm(const gsMatrix<T> & x, index_t nt = 1)
+    {
+        if (nt < 2)
+            return x.squaredNorm();
+
+        const index_t n = x.size();
+        gsVector<T> part(nt);
+#       pragma omp parallel for num_threads(nt) schedule(static)
+        for (index_t c = 0; c < nt; ++c)
+        {
+            const index_t b = chunk(n, nt, c), l = chunk(n, nt, c+1) - b;
+            part[c] = asVec(x).segment(b, l).squaredNorm();
+        }
+        return sum(part);
+    }
+
+    /// Returns the Euclidean norm of \a x
+    static T norm(const gsMatrix<T> & x, index_t nt = 1)
+    {
+        if (nt < 2)
+            return x.norm();
+        return math::sqrt( squaredNorm(x, nt) );
+    }
+
+    /// Computes \a y += \a a * \a x
+    static void axpy(const T a, const gsMatrix<T> & x, gsMatrix<T> & y, index_t nt = 1)
+    {
+        GISMO_ASSERT( x.rows() == y.rows() && x.cols() == y.cols(), "The sizes do not match." );
+        if (nt < 2)
+        {
+            y.noalias() += a * x;
+            return;
+        }
+
+        const index_t n = x.size();
+#       pragma omp parallel for num_threads(nt) schedule(static)
+        for (index_t c = 0; c < nt; ++c)
+        {
+            const index_t b = chunk(n, nt, c), l = chunk(n, nt, c+1) - b;
+            asVec(y).segment(b, l) += a * asVec(x).segment(b, l);
+        }
+    }
+
+    /// Computes \a y = \a x + \a b * \a y
+    static void xpby(const gsMatrix<T> & x, const T b, gsMatrix<T> & y, index_t nt = 1)
+    {
+        GISMO_ASSERT( x.rows() == y.rows() && x.cols() == y.cols(), "The sizes do not match." );
+        if (nt < 2)
+        {
+            y = x + b * y;
+            return;
+        }
+
+        const index_t n = x.size();
+#       pragma omp parallel for num_threads(nt) schedule(static)
+        for (index_t c = 0; c < nt; ++c)
+        {
+            const index_t s = chunk(n, nt, c), l = chunk(n, nt, c+1) - s;
+            asVec(y).segment(s, l) = asVec(x).segment(s, l) + b * asVec(y).segment(s, l);
+        }
+    }
+
+    /// @brief Computes \a y += \a a * \a x and returns the scalar
+    /// product of the updated \a y with \a z in the same pass.
+    ///
+    /// \a z may be \a y itself, then the squared norm of the updated
+    /// vector is returned.
+    static T axpyDot(const T a, const gsMatrix<T> & x, gsMatrix<T> & y,
+                     const gsMatrix<T> & z, index_t nt = 1)
+    {
+        GISMO_ASSERT( x.rows() == y.rows() && x.cols() == y.cols()
+                      && y.size() == z.size(), "The sizes do not match." );
+        if (nt < 2)
+        {
+            y.noalias() += a * x;
+            return asVec(y).dot(asVec(z));
+        }
+
+        const index_t n = x.size();
+        gsVector<T> part(nt);
+#       pragma omp parallel for num_threads(nt) schedule(static)
+        for (index_t c = 0; c < nt; ++c)
+        {
+            const index_t b = chunk(n, nt, c), l = chunk(n, nt, c+1) - b;
+            asVec(y).segment(b, l) += a * asVec(x).segment(b, l);
+            part[c] = asVec(y).segment(b, l).dot( asVec(z).segment(b, l) );
+        }
+        return sum(part);
+    }
+
+    /// Computes \a y = \a A * \a x for any matrix or matrix expression
+    template<class MatrixType>
+    static void apply(const MatrixType & A, const gsMatrix<T> & x, gsMatrix<T> & y,
+                      index_t = 1)
+    { y.noalias() = A * x; }
+
+    /// @brief Computes \a y = \a A * \a x for a row-major sparse
+    /// matrix, the rows are distributed over \a nt threads
+    template<typename _Index>
+    static void apply(const Eigen::SparseMatrix<T,RowMajor,_Index> & A,
+                      const gsMatrix<T> & x, gsMatrix<T> & y, index_t nt = 1)
+    {
+        GISMO_ASSERT( A.cols() == x.rows(), "The sizes do not match." );
+        if (nt < 2)
+        {
+            y.noalias() = A * x;
+            return;
+        }
+
+        typedef typename Eigen::SparseMatrix<T,RowMajor,_Index>::InnerIterator InnerIterator;
+        const index_t n = A.rows();
+        const index_t m = x.cols();
+        y.resize(n, m);
+#       pragma omp parallel for num_threads(nt) schedule(static)
+        for (index_t i = 0; i < n; ++i)
+            for (index_t j = 0; j != m; ++j)
+            {
+                T s = 0;
+                for (InnerIterator it(A, i); it; ++it)
+                    s += it.value() * x(it.index(), j);
+                y(i, j) = s;
+            }
+    }
+
+    /// @brief Computes \a y = \a A * \a x for a row-major sparse
+    /// matrix, the rows are distributed over \a nt threads
+    template<typename _Index>
+    static void apply(const gsSparseMatrix<T,RowMajor,_Index> & A,
+                      const gsMatrix<T> & x, gsMatrix<T> & y, index_t nt = 1)
+    {
+        apply(static_cast<const typename gsSparseMatrix<T,RowMajor,_Index>::Base &>(A),
+              x, y, nt);
+    }
+
+private:
+
+    // First index of chunk \a c of \a nt chunks of [0,n)
+    static index_t chunk(const index_t n, const index_t nt, const index_t c)
+    { return c * (n / nt) + std::min(c, n % nt); }
+
+    static T sum(const gsVector<T> & part)
+    {
+        T s = 0;
+        for (index_t c = 0; c != part.size(); ++c)
+            s += part[c];
+        return s;
+    }
+
+    static gsAsConstVector<T> asVec(const gsMatrix<T> & x)
+    { return gsAsConstVector<T>(x.data(), x.size()); }
+
+    static gsAsVector<T> asVec(gsMatrix<T> & x)
+    { return gsAsVector<T>(x.data(), x.size()); }
+};
+
+} // namespace gismo
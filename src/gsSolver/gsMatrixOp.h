@@ -14,10 +14,23 @@
 
 #include <gsCore/gsLinearAlgebra.h>
 #include <gsSolver/gsLinearOperator.h>
+#include <gsSolver/gsKrylovKernels.h>
 
 namespace gismo
 {
 
+/// @brief Type of the (nested) expression stored by gsMatrixOp
+///
+/// Symmetric views on sparse matrices, which only refer to the stored
+/// triangle, are kept by value.
+template <class MatrixType>
+struct gsMatrixOpNested
+{ typedef typename MatrixType::Nested type; };
+
+template <class MatType, unsigned int Mode>
+struct gsMatrixOpNested< Eigen::SparseSelfAdjointView<MatType,Mode> >
+{ typedef const Eigen::SparseSelfAdjointView<MatType,Mode> type; };
+
 // left here for debugging purposes
 // template<typename T> struct is_ref { static const bool value = false; };
 // template<typename T> struct is_ref<T&> { static const bool value = true; };
@@ -33,7 +46,7 @@ template <class MatrixType>
 class gsMatrixOp GISMO_FINAL : public gsLinearOperator<typename MatrixType::Scalar>
 {
     typedef memory::shared_ptr<MatrixType> MatrixPtr;
-    typedef typename MatrixType::Nested NestedMatrix;
+    typedef typename gsMatrixOpNested<MatrixType>::type NestedMatrix;
 
 public:
     typedef typename MatrixType::Scalar T;
@@ -50,14 +63,14 @@ public:
     /// is not deleted too early (alternatively use constructor by
     /// shared pointer)
     gsMatrixOp(const MatrixType& mat)
-    : m_mat(), m_expr(mat.derived())
+    : m_mat(), m_expr(mat.derived()), m_num_threads(1)
     {
         //gsDebug<<typeid(m_expr).name()<<" Ref: "<<is_ref<NestedMatrix>::value<<"\n";
     }
 
     /// @brief Constructor taking a shared pointer
     gsMatrixOp(MatrixPtr mat)
-    : m_mat(give(mat)), m_expr(m_mat->derived())
+    : m_mat(give(mat)), m_expr(m_mat->derived()), m_num_threads(1)
     { }
 
     /// @brief Make function returning a smart pointer
@@ -72,7 +85,22 @@ public:
     { return uPtr( new gsMatrixOp(give(mat)) ); }
 
     void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const
-    { x.noalias() = m_expr * input; }
+    { gsKrylovKernels<T>::apply(m_expr, input, x, m_num_threads); }
+
+    /// @brief Returns a list of default options
+    ///
+    /// A row-major sparse matrix is applied with \a NumThreads
+    /// threads; all other matrices are applied serially.
+    static gsOptionList defaultOptions()
+    {
+        gsOptionList opt;
+        opt.addInt("NumThreads", "Number of threads for the matrix-vector product", 1);
+        return opt;
+    }
+
+    /// @brief Set the options based on a gsOptionList
+    void setOptions(const gsOptionList & opt)
+    { m_num_threads = opt.askInt("NumThreads", m_num_threads); }
 
     index_t rows() const
     { return m_expr.rows(); }
@@ -93,6 +121,7 @@ public:
 private:
     const MatrixPtr m_mat; ///< Shared pointer to matrix (if needed)
     NestedMatrix   m_expr; ///< Nested Eigen expression
+    index_t m_num_threads; ///< Number of threads for the product
 };
 
 /** @brief This essentially just calls the gsMatrixOp constructor, but
@@ -109,6 +138,13 @@ private:
   * gsLinearOperator<>::Ptr opB = makeMatrixOp(M.block(0,0,5,5) );
   * \endcode
   *
+  * A sparse matrix that stores only its lower triangular part, e.g.
+  * assembled with gsSparseSystem::setSymmetric(), is applied by
+  * \code
+  * gsLinearOperator<>::Ptr opS = makeMatrixOp(A.selfadjointView<Lower>());
+  * \endcode
+  * or by makeSymmetricMatrixOp(A).
+  *
   * Note that
   * \code
   * gsLinearOperator<>::Ptr opInv = makeMatrixOp(M.inverse());
@@ -162,6 +198,21 @@ typename gsMatrixOp<Derived>::uPtr makeMatrixOp(memory::unique_ptr<Derived> mat)
     return memory::make_unique(new gsMatrixOp<Derived>(memory::shared_ptr<Derived>(mat.release())));
 }
 
+/** @brief Returns an operator applying the symmetric matrix whose
+  * lower triangular part is stored in \a mat, cf.
+  * gsSparseSystem::setSymmetric()
+  *
+  * @note Only a reference to the matrix is stored.
+  *
+  * \ingroup Solver
+  */
+template <class T, int _Options, typename _Index>
+typename gsMatrixOp<Eigen::SparseSelfAdjointView<const Eigen::SparseMatrix<T,_Options,_Index>,Lower> >::uPtr
+makeSymmetricMatrixOp(const gsSparseMatrix<T,_Options,_Index> & mat)
+{
+    return makeMatrixOp(mat.template selfadjointView<Lower>());
+}
+
 /** @brief Simple adapter class to use an Eigen solver (having a
  * compute() and a solve() method) as a linear operator.
  *
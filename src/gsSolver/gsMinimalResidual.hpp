@@ -31,14 +31,14 @@ bool gsMinimalResidual<T>::initIteration( const typename gsMinimalResidual<T>::V
     m_mat->apply(x,negResidual);
     negResidual -= rhs;
 
-    m_error = negResidual.norm() / m_rhs_norm;
+    m_error = Kernels::norm(negResidual, m_num_threads) / m_rhs_norm;
     if (m_error < m_tol)
         return true;
 
     v = -negResidual;
     m_precond->apply(v, z);
 
-    gammaPrev = 1; gamma = math::sqrt(z.col(0).dot(v.col(0))); gammaNew = 1;
+    gammaPrev = 1; gamma = math::sqrt(Kernels::dot(z, v, m_num_threads)); gammaNew = 1;
     eta = gamma;
     sPrev = 0; s = 0; sNew = 0;
     cPrev = 1; c = 1; cNew = 1;
@@ -52,10 +52,10 @@ bool gsMinimalResidual<T>::step( typename gsMinimalResidual<T>::VectorType& x )
     z /= gamma;
     m_mat->apply(z,Az);
 
-    T delta = z.col(0).dot(Az.col(0));
+    T delta = Kernels::dot(z, Az, m_num_threads);
     vNew = Az - (delta/gamma)*v - (gamma/gammaPrev)*vPrev;
     m_precond->apply(vNew, zNew);
-    gammaNew = math::sqrt(zNew.col(0).dot(vNew.col(0)));
+    gammaNew = math::sqrt(Kernels::dot(zNew, vNew, m_num_threads));
     const T a0 = c*delta - cPrev*s*gamma;
     const T a1 = math::sqrt(a0*a0 + gammaNew*gammaNew);
     const T a2 = s*delta + cPrev*c*gamma;
@@ -65,14 +65,14 @@ bool gsMinimalResidual<T>::step( typename gsMinimalResidual<T>::VectorType& x )
     wNew = (z - a3*wPrev - a2*w)/a1;
     if (!m_inexact_residual)
         AwNew = (Az - a3*AwPrev - a2*Aw)/a1;
-    x += cNew*eta*wNew;
+    Kernels::axpy(cNew*eta, wNew, x, m_num_threads);
     if (!m_inexact_residual)
-        negResidual += cNew*eta*AwNew;
+        Kernels::axpy(cNew*eta, AwNew, negResidual, m_num_threads);
 
     if (m_inexact_residual)
         m_error *= math::abs(sNew); // see https://eigen.tuxfamily.org/dox-devel/unsupported/MINRES_8h_source.html
     else
-        m_error = negResidual.norm() / m_rhs_norm;
+        m_error = Kernels::norm(negResidual, m_num_threads) / m_rhs_norm;
 
     eta = -sNew*eta;
 
@@ -0,0 +1,160 @@
+/** @file gsPipelinedConjugateGradient.h
+
+    @brief Pipelined conjugate gradient solver
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsSolver/gsIterativeSolver.h>
+#include <gsMpi/gsMpi.h>
+
+namespace gismo
+{
+
+/// @brief The pipelined conjugate gradient method (Ghysels and
+/// Vanroose 2014).
+///
+/// Mathematically equivalent to gsConjugateGradient, but the
+/// recurrences are rearranged such that every step has a single
+/// global reduction (the scalar products needed for the step length,
+/// the search direction and the residual norm). This reduction is
+/// started non-blocking and overlaps with the application of the
+/// preconditioner and of the matrix. The price are four more vector
+/// updates per step and a larger rounding error in the recursively
+/// updated residual, which is recomputed every \a ResidualReplacement
+/// steps.
+///
+/// If a communicator with more than one process is set by
+/// setCommunicator(), the vectors are understood as the local parts
+/// of a distributed vector, i.e., every process owns the given rows,
+/// and the operator and the preconditioner have to do the necessary
+/// communication. The scalar products are then summed up with the
+/// non-blocking \a iallreduce of gsMpiComm. Otherwise the local
+/// scalar products are the global ones.
+///
+/// \ingroup Solver
+template<class T = real_t>
+class gsPipelinedConjugateGradient : public gsIterativeSolver<T>
+{
+public:
+    typedef gsIterativeSolver<T> Base;
+
+    typedef gsMatrix<T>  VectorType;
+
+    typedef typename Base::LinOpPtr LinOpPtr;
+
+    typedef memory::shared_ptr<gsPipelinedConjugateGradient> Ptr;
+    typedef memory::unique_ptr<gsPipelinedConjugateGradient> uPtr;
+
+    /// @brief Constructor using a matrix (operator) and optionally a preconditionner
+    ///
+    /// @param mat     The operator to be solved for, see gsIterativeSolver for details
+    /// @param precond The preconditioner, defaulted to the identity
+    template< typename OperatorType >
+    explicit gsPipelinedConjugateGradient( const OperatorType& mat,
+                                           const LinOpPtr& precond = LinOpPtr() )
+    : Base(mat, precond), m_replace(20), m_rhs(NULL) {}
+
+    /// @brief Make function using a matrix (operator) and optionally a preconditionner
+    ///
+    /// @param mat     The operator to be solved for, see gsIterativeSolver for details
+    /// @param precond The preconditioner, defaulted to the identity
+    template< typename OperatorType >
+    static uPtr make( const OperatorType& mat, const LinOpPtr& precond = LinOpPtr() )
+    { return uPtr( new gsPipelinedConjugateGradient(mat, precond) ); }
+
+    /// @brief Returns a list of default options
+    static gsOptionList defaultOptions()
+    {
+        gsOptionList opt = Base::defaultOptions();
+        opt.addInt("ResidualReplacement", "Number of steps after which the recursively "
+                   "updated vectors are recomputed (0: never)", 20 );
+        return opt;
+    }
+
+    /// @brief Set the options based on a gsOptionList
+    gsPipelinedConjugateGradient& setOptions(const gsOptionList& opt)
+    {
+        Base::setOptions(opt);
+        m_replace = opt.askInt("ResidualReplacement", m_replace);
+        return *this;
+    }
+
+    bool initIteration( const VectorType& rhs, VectorType& x );
+    bool step( VectorType& x );
+    void finalizeIteration( VectorType& x );
+
+    /// @brief Sets the communicator of a distributed solve
+    ///
+    /// The rows of the vectors are distributed over the processes
+    /// of \a comm. By default, the solve is not distributed.
+    void setCommunicator(const gsMpiComm & comm)     { m_comm = comm; }
+
+    /// @brief Set the number of steps after which the residual and
+    /// the other recursively updated vectors are recomputed from their
+    /// definition (default: 20, 0 for never)
+    ///
+    /// The replacement costs four applications of the matrix and two
+    /// of the preconditioner. It avoids that the accuracy of the
+    /// solution stagnates for ill-conditioned problems.
+    void setResidualReplacement(index_t steps)      { m_replace = steps; }
+
+    /// Prints the object as a string.
+    std::ostream &print(std::ostream &os) const
+    {
+        os << "gsPipelinedConjugateGradient\n";
+        return os;
+    }
+
+private:
+
+    /// Computes the local scalar products of the current vectors and
+    /// starts their global summation
+    void startReduction();
+
+    /// Waits until the global scalar products are available
+    void finishReduction();
+
+    /// Recomputes the residual and the vectors derived from it
+    void replaceResidual(const VectorType& x);
+
+private:
+    using Base::m_mat;
+    using Base::m_precond;
+    using Base::m_max_iters;
+    using Base::m_tol;
+    using Base::m_num_iter;
+    using Base::m_rhs_norm;
+    using Base::m_error;
+    using Base::m_num_threads;
+
+    typedef gsKrylovKernels<T> Kernels;
+
+    index_t m_replace;
+
+    gsMpiComm    m_comm;
+    gsMpiRequest m_request;
+
+    const VectorType * m_rhs;
+    VectorType m_res;      // residual r
+    VectorType m_u;        // preconditioned residual u = M r
+    VectorType m_w;        // w = A u
+    VectorType m_m;        // m = M w
+    VectorType m_n;        // n = A m
+    VectorType m_p, m_s, m_q, m_z; // search direction p and s = A p, q = M s, z = A q
+
+    gsVector<T,3> m_dots;  // (r,u), (w,u) and (r,r)
+    T m_gamma_old, m_alpha_old;
+};
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsPipelinedConjugateGradient.hpp)
+#endif
@@ -0,0 +1,165 @@
+/** @file gsPipelinedConjugateGradient.hpp
+
+    @brief Pipelined conjugate gradient solver
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+namespace gismo
+{
+
+template<class T>
+bool gsPipelinedConjugateGradient<T>::initIteration( const typename gsPipelinedConjugateGradient<T>::VectorType& rhs,
+                                                     typename gsPipelinedConjugateGradient<T>::VectorType& x )
+{
+    GISMO_ASSERT( rhs.cols() == 1,
+                  "Iterative solvers only work for single column right-hand side." );
+    GISMO_ASSERT( rhs.rows() == m_mat->rows(),
+                  "The right-hand side does not match the matrix: "
+                  << rhs.rows() <<"!="<< m_mat->rows() );
+
+    m_num_iter = 0;
+
+    // All processes have to take the same decisions, so the norm of
+    // the right-hand side is a global one
+    T rhs2 = Kernels::squaredNorm(rhs, m_num_threads);
+    if (m_comm.size() > 1)
+        rhs2 = m_comm.sum(rhs2);
+    m_rhs_norm = math::sqrt(rhs2);
+
+    if (0 == m_rhs_norm) // special case of zero rhs
+    {
+        x.setZero(rhs.rows(),rhs.cols()); // for sure zero is a solution
+        m_error = 0.;
+        return true;
+    }
+
+    if ( 0 == x.size() ) // if no initial solution, start with zeros
+        x.setZero(rhs.rows(), rhs.cols());
+    else
+    {
+        GISMO_ASSERT( x.cols() == 1,
+                      "Iterative solvers only work for single right-hand side and solution." );
+        GISMO_ASSERT( x.rows() == m_mat->cols(),
+                      "The initial guess does not match the matrix: "
+                      << x.rows() <<"!="<< m_mat->cols() );
+    }
+
+    m_rhs = &rhs;
+    m_mat->apply(x,m_w);
+    m_res = rhs - m_w;                                                  // initial residual
+    m_precond->apply(m_res,m_u);
+    m_mat->apply(m_u,m_w);
+
+    startReduction();
+    m_precond->apply(m_w,m_m);                                          // overlaps with the reduction
+    m_mat->apply(m_m,m_n);
+    finishReduction();
+
+    m_error = math::sqrt(m_dots[2]) / m_rhs_norm;
+    if (m_error < m_tol)
+        return true;
+
+    m_p.setZero(m_res.rows(),1);
+    m_s.setZero(m_res.rows(),1);
+    m_q.setZero(m_res.rows(),1);
+    m_z.setZero(m_res.rows(),1);
+    m_gamma_old = 0;
+    m_alpha_old = 0;
+    return false;
+}
+
+template<class T>
+bool gsPipelinedConjugateGradient<T>::step( typename gsPipelinedConjugateGradient<T>::VectorType& x )
+{
+    // step length and direction from the scalar products of the last reduction
+    const T gamma = m_dots[0];
+    const T delta = m_dots[1];
+    T alpha, beta;
+    if (1 == m_num_iter)
+    {
+        beta  = 0;
+        alpha = gamma / delta;
+    }
+    else
+    {
+        beta  = gamma / m_gamma_old;
+        alpha = gamma / (delta - beta * gamma / m_alpha_old);
+    }
+    m_gamma_old = gamma;
+    m_alpha_old = alpha;
+
+    Kernels::xpby(m_n, beta, m_z, m_num_threads);                       // z = n + beta z
+    Kernels::xpby(m_m, beta, m_q, m_num_threads);                       // q = m + beta q
+    Kernels::xpby(m_w, beta, m_s, m_num_threads);                       // s = w + beta s
+    Kernels::xpby(m_u, beta, m_p, m_num_threads);                       // p = u + beta p
+
+    Kernels::axpy( alpha, m_p, x,     m_num_threads);                   // update solution
+    Kernels::axpy(-alpha, m_s, m_res, m_num_threads);                   // update residual
+    Kernels::axpy(-alpha, m_q, m_u,   m_num_threads);                   // u = M r
+    Kernels::axpy(-alpha, m_z, m_w,   m_num_threads);                   // w = A u
+
+    if (m_replace > 0 && 0 == m_num_iter % m_replace)
+        replaceResidual(x);
+
+    startReduction();
+    m_precond->apply(m_w,m_m);                                          // overlaps with the reduction
+    m_mat->apply(m_m,m_n);
+    finishReduction();
+
+    m_error = math::sqrt(m_dots[2]) / m_rhs_norm;
+    return m_error < m_tol;
+}
+
+template<class T>
+void gsPipelinedConjugateGradient<T>::finalizeIteration( typename gsPipelinedConjugateGradient<T>::VectorType& )
+{
+    // cleanup temporaries
+    m_rhs = NULL;
+    m_res.clear();
+    m_u.clear();
+    m_w.clear();
+    m_m.clear();
+    m_n.clear();
+    m_p.clear();
+    m_s.clear();
+    m_q.clear();
+    m_z.clear();
+}
+
+template<class T>
+void gsPipelinedConjugateGradient<T>::replaceResidual( const typename gsPipelinedConjugateGradient<T>::VectorType& x )
+{
+    // r = b - A x, u = M r, w = A u, s = A p, q = M s, z = A q; the
+    // four matrix products act on four different vectors
+    m_mat->apply(x,m_w);
+    m_res = *m_rhs - m_w;
+    m_precond->apply(m_res,m_u);
+    m_mat->apply(m_u,m_w);
+    m_mat->apply(m_p,m_s);
+    m_precond->apply(m_s,m_q);
+    m_mat->apply(m_q,m_z);
+}
+
+template<class T>
+void gsPipelinedConjugateGradient<T>::startReduction()
+{
+    m_dots[0] = Kernels::dot(m_res, m_u, m_num_threads);
+    m_dots[1] = Kernels::dot(m_w,   m_u, m_num_threads);
+    m_dots[2] = Kernels::squaredNorm(m_res, m_num_threads);
+    if (m_comm.size() > 1)
+        m_comm.isum(m_dots.data(), 3, &m_request);
+}
+
+template<class T>
+void gsPipelinedConjugateGradient<T>::finishReduction()
+{
+    if (m_comm.size() > 1)
+        m_request.wait();
+}
+
+} // end namespace gismo
@@ -24,6 +24,12 @@ template<typename T>
 void gaussSeidelSweep(const gsSparseMatrix<T> & A, gsMatrix<T>& x, const gsMatrix<T>& f);
 template<typename T>
 void reverseGaussSeidelSweep(const gsSparseMatrix<T> & A, gsMatrix<T>& x, const gsMatrix<T>& f);
+template<typename T, int _Options>
+void greedyColoring(const Eigen::SparseMatrix<T,_Options,index_t> & A, std::vector<index_t> & colorPtr, std::vector<index_t> & colorRows);
+template<typename T, int _Options>
+void multicolorGaussSeidelSweep(const Eigen::SparseMatrix<T,_Options,index_t> & A, gsMatrix<T>& x, const gsMatrix<T>& f,
+                                const std::vector<index_t> & colorPtr, const std::vector<index_t> & colorRows,
+                                T omega, bool reverse, index_t numThreads);
 } // namespace internal
 
 /// @brief Richardson preconditioner
@@ -184,9 +190,8 @@ public:
         GISMO_ASSERT( m_expr.rows() == rhs.rows() && m_expr.cols() == m_expr.rows(),
                       "Dimensions do not match.");
 
-        GISMO_ASSERT( rhs.cols() == 1, "This operator is only implemented for a single right-hand side." );
-
-        x.array() += m_tau * ( rhs - m_expr * x ).array() / m_expr.diagonal().array();
+        const gsVector<T> diag = m_expr.diagonal();
+        x.array() += m_tau * ( ( rhs - m_expr * x ).array().colwise() / diag.array() );
     }
 
     // We use our own apply implementation as we can save one multiplication. This is important if the number
@@ -196,13 +201,13 @@ public:
         GISMO_ASSERT( m_expr.rows() == input.rows() && m_expr.cols() == m_expr.rows(),
                       "Dimensions do not match.");
 
-        GISMO_ASSERT( input.cols() == 1, "This operator is only implemented for a single right-hand side." );
+        const gsVector<T> diag = m_expr.diagonal();
 
         // For the first sweep, we do not need to multiply with the matrix
-        x.array() = m_tau * input.array() / m_expr.diagonal().array();
+        x.array() = m_tau * ( input.array().colwise() / diag.array() );
 
         for (index_t k = 1; k < m_num_of_sweeps; ++k)
-            x.array() += m_tau * ( input - m_expr * x ).array() / m_expr.diagonal().array();
+            x.array() += m_tau * ( ( input - m_expr * x ).array().colwise() / diag.array() );
     }
 
     index_t rows() const {return m_expr.rows();}
@@ -402,6 +407,175 @@ template <class Derived>
 typename gsGaussSeidelOp<Derived,gsGaussSeidel::symmetric>::uPtr makeSymmetricGaussSeidelOp(const memory::shared_ptr<Derived>& mat)
 { return gsGaussSeidelOp<Derived,gsGaussSeidel::symmetric>::make(mat); }
 
+/// @brief Multicolor Gauss-Seidel and SOR preconditioner
+///
+/// The unknowns are grouped into colors such that no two unknowns of
+/// the same color are coupled by the matrix (greedy coloring of the
+/// symmetrized sparsity pattern, computed once in the constructor).
+/// A sweep visits the colors one after the other; the updates within
+/// a color are independent and distributed over \a NumThreads
+/// threads. The result does not depend on the number of threads.
+///
+/// With damping parameter \a omega, this is the SOR method (the
+/// Gauss-Seidel method for \a omega = 1). The symmetric ordering
+/// performs a forward and a backward sweep (SSOR), which gives a
+/// symmetric preconditioner for use in the conjugate gradient method.
+///
+/// The convergence differs from gsGaussSeidelOp since the unknowns
+/// are visited in a different order.
+///
+/// Requires a positive definite gsSparseMatrix, which is used in its
+/// own storage order. A column-major matrix has to be symmetric.
+///
+/// \ingroup Solver
+template <typename MatrixType, gsGaussSeidel::ordering ordering = gsGaussSeidel::forward>
+class gsMulticolorGaussSeidelOp GISMO_FINAL : public gsPreconditionerOp<typename MatrixType::Scalar>
+{
+    typedef memory::shared_ptr<MatrixType>          MatrixPtr;
+    typedef typename MatrixType::Nested             NestedMatrix;
+
+public:
+    /// Scalar type
+    typedef typename MatrixType::Scalar T;
+
+    /// Shared pointer for gsMulticolorGaussSeidelOp
+    typedef memory::shared_ptr< gsMulticolorGaussSeidelOp > Ptr;
+
+    /// Unique pointer for gsMulticolorGaussSeidelOp
+    typedef memory::unique_ptr< gsMulticolorGaussSeidelOp > uPtr;
+
+    /// Base class
+    typedef gsPreconditionerOp<T> Base;
+
+    /// @brief Constructor with given matrix
+    explicit gsMulticolorGaussSeidelOp(const MatrixType& _mat, T _omega = 1)
+    : m_mat(), m_expr(_mat.derived()), m_omega(_omega), m_num_threads(1)
+    { internal::greedyColoring<T>(m_expr, m_colorPtr, m_colorRows); }
+
+    /// @brief Constructor with shared pointer to matrix
+    explicit gsMulticolorGaussSeidelOp(const MatrixPtr& _mat, T _omega = 1)
+    : m_mat(_mat), m_expr(m_mat->derived()), m_omega(_omega), m_num_threads(1)
+    { internal::greedyColoring<T>(m_expr, m_colorPtr, m_colorRows); }
+
+    static uPtr make(const MatrixType& _mat, T _omega = 1)
+    { return memory::make_unique( new gsMulticolorGaussSeidelOp(_mat, _omega) ); }
+
+    static uPtr make(const MatrixPtr& _mat, T _omega = 1)
+    { return memory::make_unique( new gsMulticolorGaussSeidelOp(_mat, _omega) ); }
+
+    void step(const gsMatrix<T> & rhs, gsMatrix<T> & x) const
+    {
+        if (ordering != gsGaussSeidel::reverse )
+            sweep(rhs, x, false);
+        if (ordering != gsGaussSeidel::forward )
+            sweep(rhs, x, true);
+    }
+
+    void stepT(const gsMatrix<T> & rhs, gsMatrix<T> & x) const
+    {
+        if (ordering != gsGaussSeidel::forward )
+            sweep(rhs, x, false);
+        if (ordering != gsGaussSeidel::reverse )
+            sweep(rhs, x, true);
+    }
+
+    index_t rows() const {return m_expr.rows();}
+    index_t cols() const {return m_expr.cols();}
+
+    /// Set damping parameter
+    void setDamping(const T omega) { m_omega = omega;  }
+
+    /// Get damping parameter
+    T getDamping() const           { return m_omega; }
+
+    /// Set the number of threads for the sweeps
+    void setNumThreads(const index_t nt) { m_num_threads = nt; }
+
+    /// Returns the number of colors
+    index_t numColors() const      { return m_colorPtr.size() - 1; }
+
+    /// Returns the color of every unknown
+    gsVector<index_t> colors() const
+    {
+        gsVector<index_t> result(rows());
+        for (index_t c = 0; c != numColors(); ++c)
+            for (index_t k = m_colorPtr[c]; k != m_colorPtr[c+1]; ++k)
+                result[m_colorRows[k]] = c;
+        return result;
+    }
+
+    /// Get the default options as gsOptionList object
+    static gsOptionList defaultOptions()
+    {
+        gsOptionList opt = Base::defaultOptions();
+        opt.addReal( "Damping", "Damping (relaxation) parameter of the SOR iteration", 1 );
+        opt.addInt ( "NumThreads", "Number of threads for the sweeps", 1 );
+        return opt;
+    }
+
+    /// Set options based on a gsOptionList object
+    virtual void setOptions(const gsOptionList & opt)
+    {
+        Base::setOptions(opt);
+        m_omega       = opt.askReal( "Damping", m_omega );
+        m_num_threads = opt.askInt ( "NumThreads", m_num_threads );
+    }
+
+    /// Returns the matrix
+    NestedMatrix matrix() const { return m_expr; }
+
+    /// Returns a shared pinter to the matrix
+    MatrixPtr    matrixPtr() const {
+        GISMO_ENSURE( m_mat, "A shared pointer is only available if it was provided to gsMulticolorGaussSeidelOp." );
+        return m_mat;
+    }
+
+    typename gsLinearOperator<T>::Ptr underlyingOp() const { return makeMatrixOp(m_mat); }
+
+private:
+    void sweep(const gsMatrix<T> & rhs, gsMatrix<T> & x, bool reverse) const
+    {
+        internal::multicolorGaussSeidelSweep<T>(m_expr, x, rhs, m_colorPtr, m_colorRows,
+                                                m_omega, reverse, m_num_threads);
+    }
+
+private:
+    const MatrixPtr m_mat;  ///< Shared pointer to matrix (if needed)
+    NestedMatrix    m_expr; ///< Nested Eigen expression
+    T m_omega;
+    index_t m_num_threads;
+    std::vector<index_t> m_colorPtr;  ///< First entry of every color in m_colorRows
+    std::vector<index_t> m_colorRows; ///< The unknowns, sorted by color
+};
+
+/**
+   \brief Returns a smart pointer to a multicolor Gauss-Seidel (or SOR) operator referring on \a mat
+*/
+template <class Derived>
+typename gsMulticolorGaussSeidelOp<Derived>::uPtr makeMulticolorGaussSeidelOp(const Eigen::EigenBase<Derived>& mat, typename Derived::Scalar omega = 1)
+{ return gsMulticolorGaussSeidelOp<Derived>::make(mat.derived(), omega); }
+
+/**
+   \brief Returns a smart pointer to a multicolor Gauss-Seidel (or SOR) operator referring on \a mat
+*/
+template <class Derived>
+typename gsMulticolorGaussSeidelOp<Derived>::uPtr makeMulticolorGaussSeidelOp(const memory::shared_ptr<Derived>& mat, typename Derived::Scalar omega = 1)
+{ return gsMulticolorGaussSeidelOp<Derived>::make(mat, omega); }
+
+/**
+   \brief Returns a smart pointer to a multicolor symmetric Gauss-Seidel (or SSOR) operator referring on \a mat
+*/
+template <class Derived>
+typename gsMulticolorGaussSeidelOp<Derived,gsGaussSeidel::symmetric>::uPtr makeMulticolorSymmetricGaussSeidelOp(const Eigen::EigenBase<Derived>& mat, typename Derived::Scalar omega = 1)
+{ return gsMulticolorGaussSeidelOp<Derived,gsGaussSeidel::symmetric>::make(mat.derived(), omega); }
+
+/**
+   \brief Returns a smart pointer to a multicolor symmetric Gauss-Seidel (or SSOR) operator referring on \a mat
+*/
+template <class Derived>
+typename gsMulticolorGaussSeidelOp<Derived,gsGaussSeidel::symmetric>::uPtr makeMulticolorSymmetricGaussSeidelOp(const memory::shared_ptr<Derived>& mat, typename Derived::Scalar omega = 1)
+{ return gsMulticolorGaussSeidelOp<Derived,gsGaussSeidel::symmetric>::make(mat, omega); }
+
 } // namespace gismo
 
 #ifndef GISMO_BUILD_LIB
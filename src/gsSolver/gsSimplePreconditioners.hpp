@@ -23,23 +23,46 @@ void gaussSeidelSweep(const gsSparseMatrix<T> & A, gsMatrix<T>& x, const gsMatri
     GISMO_ASSERT( A.rows() == x.rows() && x.rows() == f.rows() && A.cols() == A.rows() && x.cols() == f.cols(),
         "Dimensions do not match.");
 
-    GISMO_ASSERT( f.cols() == 1, "This operator is only implemented for a single right-hand side." );
-
     // A is supposed to be symmetric, so it doesn't matter if it's stored in row- or column-major order
+    if (f.cols() == 1)
+    {
+        for (int i = 0; i < A.outerSize(); ++i)
+        {
+            T diag = 0;
+            T sum  = 0;
+
+            for (typename gsSparseMatrix<T>::InnerIterator it(A,i); it; ++it)
+            {
+                sum += it.value() * x( it.index() );        // compute A.x
+                if (it.index() == i)
+                    diag = it.value();
+            }
+
+            x(i) += (f(i) - sum) / diag;
+        }
+        return;
+    }
+
+    // Several right-hand sides: one pass over the matrix for all
+    // columns, on transposed copies such that the rows are contiguous
+    gsMatrix<T> xt = x.transpose();
+    const gsMatrix<T> ft = f.transpose();
+    gsVector<T> sum(f.cols());
     for (int i = 0; i < A.outerSize(); ++i)
     {
         T diag = 0;
-        T sum  = 0;
+        sum.setZero();
 
         for (typename gsSparseMatrix<T>::InnerIterator it(A,i); it; ++it)
         {
-            sum += it.value() * x( it.index() );        // compute A.x
+            sum.noalias() += it.value() * xt.col( it.index() ); // compute A.x
             if (it.index() == i)
                 diag = it.value();
         }
 
-        x(i) += (f(i) - sum) / diag;
+        xt.col(i) += (ft.col(i) - sum) / diag;
     }
+    x = xt.transpose();
 }
 
 template<typename T>
@@ -48,22 +71,131 @@ void reverseGaussSeidelSweep(const gsSparseMatrix<T> & A, gsMatrix<T>& x, const
     GISMO_ASSERT( A.rows() == x.rows() && x.rows() == f.rows() && A.cols() == A.rows() && x.cols() == f.cols(),
         "Dimensions do not match.");
 
-    GISMO_ASSERT( f.cols() == 1, "This operator is only implemented for a single right-hand side." );
-
     // A is supposed to be symmetric, so it doesn't matter if it's stored in row- or column-major order
+    if (f.cols() == 1)
+    {
+        for (int i = A.outerSize() - 1; i >= 0; --i)
+        {
+            T diag = 0;
+            T sum = 0;
+
+            for (typename gsSparseMatrix<T>::InnerIterator it(A,i); it; ++it)
+            {
+                sum += it.value() * x( it.index() );        // compute A.x
+                if (it.index() == i)
+                    diag = it.value();
+            }
+
+            x(i) += (f(i) - sum) / diag;
+        }
+        return;
+    }
+
+    // Several right-hand sides: one pass over the matrix for all
+    // columns, on transposed copies such that the rows are contiguous
+    gsMatrix<T> xt = x.transpose();
+    const gsMatrix<T> ft = f.transpose();
+    gsVector<T> sum(f.cols());
     for (int i = A.outerSize() - 1; i >= 0; --i)
     {
         T diag = 0;
-        T sum = 0;
+        sum.setZero();
 
         for (typename gsSparseMatrix<T>::InnerIterator it(A,i); it; ++it)
         {
-            sum += it.value() * x( it.index() );        // compute A.x
+            sum.noalias() += it.value() * xt.col( it.index() ); // compute A.x
             if (it.index() == i)
                 diag = it.value();
         }
 
-        x(i) += (f(i) - sum) / diag;
+        xt.col(i) += (ft.col(i) - sum) / diag;
+    }
+    x = xt.transpose();
+}
+
+template<typename T, int _Options>
+void greedyColoring(const Eigen::SparseMatrix<T,_Options,index_t> & A, std::vector<index_t> & colorPtr,
+                    std::vector<index_t> & colorRows)
+{
+    typedef Eigen::SparseMatrix<T,_Options,index_t> SparseMatrix;
+    GISMO_ASSERT( A.rows() == A.cols(), "The matrix is not square.");
+    const index_t n = A.outerSize();
+
+    // Symmetrized sparsity pattern, such that the unknowns of one color
+    // are not coupled in either direction
+    const SparseMatrix At = A.transpose();
+    const SparseMatrix S = A.cwiseAbs() + At.cwiseAbs();
+
+    std::vector<index_t> color(n, -1);
+    std::vector<index_t> mark;  // mark[c]==i: color c is taken by a neighbor of i
+    index_t numColors = 0;
+    for (index_t i = 0; i < n; ++i)
+    {
+        for (typename SparseMatrix::InnerIterator it(S,i); it; ++it)
+            if (-1 != color[it.index()])
+                mark[color[it.index()]] = i;
+
+        index_t c = 0;
+        while (c < numColors && mark[c] == i)
+            ++c;
+        if (c == numColors)
+        {
+            ++numColors;
+            mark.push_back(-1);
+        }
+        color[i] = c;
+    }
+
+    // Sort the unknowns by color
+    colorPtr.assign(numColors + 1, 0);
+    for (index_t i = 0; i < n; ++i)
+        ++colorPtr[color[i] + 1];
+    for (index_t c = 0; c < numColors; ++c)
+        colorPtr[c+1] += colorPtr[c];
+    colorRows.resize(n);
+    std::vector<index_t> pos(colorPtr.begin(), colorPtr.end() - 1);
+    for (index_t i = 0; i < n; ++i)
+        colorRows[pos[color[i]]++] = i;
+}
+
+template<typename T, int _Options>
+void multicolorGaussSeidelSweep(const Eigen::SparseMatrix<T,_Options,index_t> & A, gsMatrix<T>& x, const gsMatrix<T>& f,
+                                const std::vector<index_t> & colorPtr, const std::vector<index_t> & colorRows,
+                                T omega, bool reverse, index_t numThreads)
+{
+    GISMO_ASSERT( A.rows() == x.rows() && x.rows() == f.rows() && A.cols() == A.rows() && x.cols() == f.cols(),
+        "Dimensions do not match.");
+    GISMO_ASSERT( (size_t)A.outerSize() == colorRows.size(), "The coloring does not match the matrix.");
+
+    // The sweep takes the matrix in its own storage order, so that it
+    // is never copied. The outer vector i is row i of A for row-major
+    // storage; for column-major storage it is column i, which is row i
+    // only since A is supposed to be symmetric.
+    const index_t numColors = colorPtr.size() - 1;
+    const index_t m = f.cols();
+    for (index_t l = 0; l < numColors; ++l)
+    {
+        const index_t c = reverse ? numColors - 1 - l : l;
+        const index_t end = colorPtr[c+1];
+
+        // The unknowns of one color are independent of each other
+#       pragma omp parallel for num_threads(numThreads) schedule(static) if(numThreads > 1)
+        for (index_t k = colorPtr[c]; k < end; ++k)
+        {
+            const index_t i = colorRows[k];
+            for (index_t j = 0; j < m; ++j)
+            {
+                T diag = 0;
+                T sum  = 0;
+                for (typename Eigen::SparseMatrix<T,_Options,index_t>::InnerIterator it(A,i); it; ++it)
+                {
+                    sum += it.value() * x( it.index(), j );    // compute A.x
+                    if (it.index() == i)
+                        diag = it.value();
+                }
+                x(i,j) += omega * (f(i,j) - sum) / diag;
+            }
+        }
     }
 }
 
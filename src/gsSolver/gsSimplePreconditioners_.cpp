@@ -9,6 +9,14 @@ namespace internal
 
 TEMPLATE_INST void gaussSeidelSweep(const gsSparseMatrix<real_t> & A, gsMatrix<real_t>& x, const gsMatrix<real_t>& f);
 TEMPLATE_INST void reverseGaussSeidelSweep(const gsSparseMatrix<real_t> & A, gsMatrix<real_t>& x, const gsMatrix<real_t>& f);
+TEMPLATE_INST void greedyColoring(const gsSparseMatrix<real_t,ColMajor>::Base & A, std::vector<index_t> & colorPtr, std::vector<index_t> & colorRows);
+TEMPLATE_INST void greedyColoring(const gsSparseMatrix<real_t,RowMajor>::Base & A, std::vector<index_t> & colorPtr, std::vector<index_t> & colorRows);
+TEMPLATE_INST void multicolorGaussSeidelSweep(const gsSparseMatrix<real_t,ColMajor>::Base & A, gsMatrix<real_t>& x, const gsMatrix<real_t>& f,
+                                              const std::vector<index_t> & colorPtr, const std::vector<index_t> & colorRows,
+                                              real_t omega, bool reverse, index_t numThreads);
+TEMPLATE_INST void multicolorGaussSeidelSweep(const gsSparseMatrix<real_t,RowMajor>::Base & A, gsMatrix<real_t>& x, const gsMatrix<real_t>& f,
+                                              const std::vector<index_t> & colorPtr, const std::vector<index_t> & colorRows,
+                                              real_t omega, bool reverse, index_t numThreads);
 
 } // namespace internal
 
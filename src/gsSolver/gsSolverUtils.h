@@ -128,6 +128,45 @@ public:
         return conditionNumber(matrixDense);
     }
 
+    /// \brief Orthonormalizes the columns of a tall block in place and
+    /// returns its numerical rank.
+    ///
+    /// Uses two passes of Cholesky-QR via the eigendecomposition of the
+    /// small Gram matrix, so the work is done by matrix-matrix products.
+    /// The columns are scaled to unit length first; directions whose
+    /// singular value is below \a tol times the largest one are dropped,
+    /// hence \a W has rank() columns on return.
+    /// \param[in,out] W the block to be orthonormalized
+    /// \param[in] tol relative threshold for the singular values
+    static index_t orthonormalizeColumns(gsMatrix<T> & W, T tol = 1e-8)
+    {
+        for (index_t j = 0; j != W.cols(); ++j)
+        {
+            const T nrm = W.col(j).norm();
+            if (0 != nrm)
+                W.col(j) /= nrm;
+        }
+
+        for (int pass = 0; pass != 2 && 0 != W.cols(); ++pass)
+        {
+            const gsMatrix<T> G = W.transpose() * W;
+            typename gsMatrix<T>::SelfAdjEigenSolver eig(G);
+            const index_t m = G.rows();
+            const T lmax = eig.eigenvalues()[m-1]; // ascending order
+            index_t first = 0;
+            while (first != m && eig.eigenvalues()[first] <= tol * tol * lmax)
+                ++first;
+            if ( lmax <= 0 )
+                first = m;
+
+            const index_t r = m - first;
+            const gsMatrix<T> C = eig.eigenvectors().rightCols(r)
+                * eig.eigenvalues().tail(r).cwiseSqrt().cwiseInverse().asDiagonal();
+            W = W * C;
+        }
+        return W.cols();
+    }
+
 private:
     gsSolverUtils() {} // No objects of this class
 
@@ -260,7 +260,33 @@ public:
     // Evaluates the second derivatives of the non-zero basis functions at value u.
     virtual void deriv2_into(const gsMatrix<T> & u, gsMatrix<T>& result ) const;
 
+    // see gsBasis for doxygen documentation
+    // The univariate bases are evaluated only on the coordinates of
+    // every direction. The evaluation functions above take this path
+    // as well if their points form a Cartesian grid (e.g. the nodes
+    // of a tensor-product quadrature rule).
+    virtual void evalAllDersGrid_into(const std::vector<gsVector<T> > & grid, int n,
+                                      std::vector<gsMatrix<T> >& result) const;
+
+    // see gsBasis for doxygen documentation
+    virtual void activeGrid_into(const std::vector<gsVector<T> > & grid,
+                                 gsMatrix<index_t>& result) const;
+
 private:
+    // Evaluates the univariate bases and their derivatives up to
+    // order n on the coordinates grid[i] of every direction i
+    void evalCwise(const std::vector<gsVector<T> > & grid, int n,
+                   std::vector< gsMatrix<T> > values[]) const;
+
+    // Forms the derivatives of order k of the tensor-product
+    // functions on the grid from the univariate values (see
+    // evalCwise), in the format of evalAllDers_into. For every grid
+    // line in the first direction, the products of the other
+    // directions are formed once and scaled by the values of the
+    // first direction, writing the result column by column.
+    static void gridProduct_into(const std::vector< gsMatrix<T> > values[], int k,
+                                 gsMatrix<T>& result);
+
     // Internal function
     //
     // values: array of std::vectors of gsMatrix<T>
@@ -20,6 +20,7 @@
 #include <gsCore/gsBoundary.h>
 #include <gsUtils/gsMesh/gsMesh.h>
 #include <gsCore/gsGeometry.h>
+#include <gsUtils/gsPointGrid.h>
 //#include <gsUtils/gsSortedVector.h>
 
 
@@ -505,7 +506,14 @@ void gsTensorBasis<d,T>::eval_into(const gsMatrix<T> & u,
     GISMO_ASSERT( u.rows() == d, 
                   "Attempted to evaluate the tensor-basis on points with the wrong dimension" );
 
-    /// \todo more efficient ?
+    std::vector<gsVector<T> > grid;
+    if ( u.cols() > 1 && cartesianGridCoordinates(u, grid) )
+    {
+        std::vector< gsMatrix<T> > values[d];
+        evalCwise(grid, 0, values);
+        gridProduct_into(values, 0, result);
+        return;
+    }
 
     gsMatrix<T> ev[d];
     gsVector<unsigned, d> v, size;
@@ -594,6 +602,15 @@ template<short_t d, class T>
 void gsTensorBasis<d,T>::deriv_into(const gsMatrix<T> & u,
                                           gsMatrix<T>& result) const
 {
+    std::vector<gsVector<T> > grid;
+    if ( u.cols() > 1 && cartesianGridCoordinates(u, grid) )
+    {
+        std::vector< gsMatrix<T> > values[d];
+        evalCwise(grid, 1, values);
+        gridProduct_into(values, 1, result);
+        return;
+    }
+
     std::vector<gsMatrix<T> > values[d];
 
     gsVector<unsigned, d> v, size;
@@ -641,6 +658,13 @@ void gsTensorBasis<d,T>::evalAllDers_into(const gsMatrix<T> & u, int n,
         return;
     }
 
+    std::vector<gsVector<T> > grid;
+    if ( u.cols() > 1 && cartesianGridCoordinates(u, grid) )
+    {
+        evalAllDersGrid_into(grid, n, result);
+        return;
+    }
+
     std::vector< gsMatrix<T> >values[d];
     gsVector<unsigned, d> v, nb_cwise;
     result.resize(n+1);
@@ -730,6 +754,15 @@ template<short_t d, class T>
 void gsTensorBasis<d,T>::deriv2_into(const gsMatrix<T> & u,
                                            gsMatrix<T> & result ) const
 {
+    std::vector<gsVector<T> > grid;
+    if ( u.cols() > 1 && cartesianGridCoordinates(u, grid) )
+    {
+        std::vector< gsMatrix<T> > values[d];
+        evalCwise(grid, 2, values);
+        gridProduct_into(values, 2, result);
+        return;
+    }
+
     std::vector< gsMatrix<T> >values[d];
     gsVector<unsigned, d> v, nb_cwise;
 
@@ -747,6 +780,168 @@ void gsTensorBasis<d,T>::deriv2_into(const gsMatrix<T> & u,
 
 
 
+template<short_t d, class T>
+void gsTensorBasis<d,T>::evalAllDersGrid_into(const std::vector<gsVector<T> > & grid, int n,
+                                              std::vector<gsMatrix<T> >& result) const
+{
+    GISMO_ASSERT(n>-2, "gsTensorBasis::evalAllDersGrid() requires n>-2: -1 means no value, 0 values only, ... " );
+    if (n==-1)
+    {
+        result.resize(0);
+        return;
+    }
+
+    std::vector< gsMatrix<T> > values[d];
+    evalCwise(grid, n, values);
+    result.resize(n+1);
+    for (int k = 0; k <= n; ++k)
+        gridProduct_into(values, k, result[k]);
+}
+
+template<short_t d, class T>
+void gsTensorBasis<d,T>::activeGrid_into(const std::vector<gsVector<T> > & grid,
+                                         gsMatrix<index_t>& result) const
+{
+    GISMO_ASSERT( static_cast<short_t>(grid.size()) == d,
+                  "Expecting "<< d <<" coordinate vectors" );
+
+    gsMatrix<index_t> act[d];
+    gsVector<index_t, d> nb, np, str;
+    index_t stride = 1;
+    for (short_t i = 0; i < d; ++i)
+    {
+        m_bases[i]->active_into(grid[i].transpose(), act[i]);
+        nb [i] = act[i].rows();
+        np [i] = act[i].cols();
+        str[i] = stride;
+        stride *= m_bases[i]->size();
+    }
+
+    result.resize( nb.prod(), np.prod() );
+    gsVector<index_t, d> q, v;
+    q.setZero();
+    index_t c = 0;
+    do // for all points
+    {
+        v.setZero();
+        index_t r = 0;
+        do // for all active functions
+        {
+            index_t ind = 0;
+            for (short_t i = 0; i < d; ++i)
+                ind += str[i] * act[i](v[i], q[i]);
+            result(r++, c) = ind;
+        } while (nextLexicographic(v, nb));
+        ++c;
+    } while (nextLexicographic(q, np));
+}
+
+template<short_t d, class T>
+void gsTensorBasis<d,T>::evalCwise(const std::vector<gsVector<T> > & grid, int n,
+                                   std::vector< gsMatrix<T> > values[]) const
+{
+    GISMO_ASSERT( static_cast<short_t>(grid.size()) == d,
+                  "Expecting "<< d <<" coordinate vectors" );
+    for (short_t i = 0; i < d; ++i)
+        m_bases[i]->evalAllDers_into( grid[i].transpose(), n, values[i] );
+}
+
+template<short_t d, class T>
+void gsTensorBasis<d,T>::gridProduct_into(const std::vector< gsMatrix<T> > values[], int k,
+                                          gsMatrix<T>& result)
+{
+    // Orders of the partial derivatives, as in evalAllDers_into
+    gsMatrix<index_t> orders;
+    switch (k)
+    {
+    case 0:
+        orders.setZero(d, 1);
+        break;
+    case 1:
+        orders.setIdentity(d, d);
+        break;
+    case 2: // pure second derivatives first, then the mixed ones (cf. deriv2_tp)
+    {
+        orders.setZero(d, d*(d+1)/2);
+        index_t c = d;
+        for (short_t i = 0; i < d; ++i)
+        {
+            orders(i, i) = 2;
+            for (short_t j = i+1; j < d; ++j, ++c)
+                orders(i, c) = orders(j, c) = 1;
+        }
+        break;
+    }
+    default:
+    {
+        orders.resize(d, numCompositions(k, d));
+        gsVector<index_t> cc;
+        firstComposition(k, d, cc);
+        index_t c = 0;
+        do { orders.col(c++) = cc; } while (nextComposition(cc));
+    }
+    }
+    const index_t numDers = orders.cols();
+
+    gsVector<index_t, d> nb, np;
+    for (short_t i = 0; i < d; ++i)
+    {
+        nb[i] = values[i][0].rows();
+        np[i] = values[i][0].cols();
+    }
+    const index_t n0 = nb[0], N0 = np[0], numOuter = nb.prod() / n0;
+    result.resize( nb.prod() * numDers, np.prod() );
+
+    gsVector<T> outer(numOuter);
+    gsVector<index_t, d> q; // grid line, q[0] is unused
+    q.setZero();
+    for (index_t col = 0; ; col += N0)
+    {
+        for (index_t c = 0; c != numDers; ++c)
+        {
+            // Products of the directions 1,..,d-1, first one running fastest
+            outer[0] = T(1);
+            index_t len = 1;
+            for (short_t i = 1; i < d; ++i)
+            {
+                const gsMatrix<T> & vi = values[i][orders(i, c)];
+                for (index_t a = nb[i] - 1; a >= 0; --a)
+                {
+                    const T val = vi(a, q[i]);
+                    for (index_t j = len - 1; j >= 0; --j)
+                        outer[a * len + j] = outer[j] * val;
+                }
+                len *= nb[i];
+            }
+
+            // Scale by the values of the first direction, point by point
+            const gsMatrix<T> & v0 = values[0][orders(0, c)];
+            for (index_t q0 = 0; q0 != N0; ++q0)
+            {
+                const T * first = v0.data() + q0 * n0;
+                T * out = result.data() + (col + q0) * result.rows() + c;
+                for (index_t j = 0; j != numOuter; ++j)
+                {
+                    const T o = outer[j];
+                    for (index_t a = 0; a != n0; ++a, out += numDers)
+                        *out = o * first[a];
+                }
+            }
+        }
+
+        // Next grid line
+        short_t i = 1;
+        for (; i < d; ++i)
+        {
+            if ( ++q[i] < np[i] )
+                break;
+            q[i] = 0;
+        }
+        if ( i == d )
+            break;
+    }
+}
+
 template<short_t d, class T>
 void gsTensorBasis<d,T>::deriv2_tp(const std::vector< gsMatrix<T> > values[],
                                    const gsVector<unsigned, d> & nb_cwise,
@@ -110,6 +110,36 @@ gsMatrix<T> gsPointGrid(CwiseContainer const & cwise)
     return rvo;
 }
 
+/**
+ * \brief Coordinate vectors of the uniform grid gsPointGrid(a, b, np),
+ * one vector per direction
+ *
+ * The coordinates are exactly the ones of the points of
+ * gsPointGrid(a, b, np), hence the grid can be evaluated direction by
+ * direction (e.g. gsFunction::evalGrid_into()).
+ *
+ * \ingroup Utils
+ */
+template<class T>
+void uniformGridCoordinates(gsVector<T> const & a, gsVector<T> const & b,
+                            gsVector<unsigned> const & np,
+                            std::vector<gsVector<T> > & cwise);
+
+/**
+ * \brief Recovers the coordinate vectors of a Cartesian grid of points
+ *
+ * Returns true if the columns of \a points are the Cartesian product
+ * of the coordinate vectors \a cwise in the order of gsPointGrid (the
+ * first coordinate running fastest), e.g. the nodes of a
+ * tensor-product quadrature rule. Returns false otherwise, in which
+ * case \a cwise is undefined.
+ *
+ * \ingroup Utils
+ */
+template<class T>
+bool cartesianGridCoordinates(gsMatrix<T> const & points,
+                              std::vector<gsVector<T> > & cwise);
+
 
 } // namespace gismo
 
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <gsUtils/gsCombinatorics.h>
 
 namespace gismo 
 {
@@ -90,6 +91,69 @@ gsMatrix<T> gsPointGrid( gsVector<T> const & a,
     return res;
 }
 
+template<class T>
+void uniformGridCoordinates(gsVector<T> const & a, gsVector<T> const & b,
+                            gsVector<unsigned> const & np,
+                            std::vector<gsVector<T> > & cwise)
+{
+    const index_t d = a.rows();
+    GISMO_ASSERT( d == b.rows() && d == np.rows(), "Dimensions do not match" );
+    cwise.resize(d);
+    for (index_t i = 0; i != d; ++i)
+    {
+        // Same values as gsGridIterator<T,CUBE>
+        const index_t n = np[i];
+        const T step = (b[i] - a[i]) / static_cast<T>( math::max(n - 1, (index_t)1) );
+        cwise[i].resize(n);
+        for (index_t j = 0; j != n; ++j)
+            cwise[i][j] = ( 0 == j ? a[i] : ( n - 1 == j ? b[i] : a[i] + j * step ) );
+    }
+}
+
+template<class T>
+bool cartesianGridCoordinates(gsMatrix<T> const & points,
+                              std::vector<gsVector<T> > & cwise)
+{
+    const index_t d = points.rows(), N = points.cols();
+    if ( 0 == N )
+        return false;
+    cwise.resize(d);
+
+    // Direction i varies with stride n_0*..*n_{i-1}, as long as the
+    // higher coordinates keep the ones of the first point
+    index_t stride = 1;
+    for (index_t i = 0; i != d; ++i)
+    {
+        index_t n = 1;
+        while ( (n + 1) * stride <= N &&
+                points.col(n * stride).bottomRows(d - i - 1) ==
+                points.col(0).bottomRows(d - i - 1) )
+            ++n;
+        cwise[i].resize(n);
+        for (index_t j = 0; j != n; ++j)
+            cwise[i][j] = points(i, j * stride);
+        stride *= n;
+    }
+    if ( stride != N )
+        return false;
+
+    // Check all points
+    gsVector<index_t> cur(d), size(d);
+    for (index_t i = 0; i != d; ++i)
+        size[i] = cwise[i].size();
+    cur.setZero();
+    index_t c = 0;
+    do
+    {
+        for (index_t i = 0; i != d; ++i)
+            if ( points(i, c) != cwise[i][cur[i]] )
+                return false;
+        ++c;
+    }
+    while ( nextLexicographic(cur, size) );
+    return true;
+}
+
 template<typename T>
 gsMatrix<T> uniformPointGrid(const gsVector<T>& lower, 
                              const gsVector<T>& upper, 
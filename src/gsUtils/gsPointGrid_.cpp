@@ -22,6 +22,15 @@ TEMPLATE_INST
 gsMatrix<T> gsPointGrid( gsVector<T> const & a, gsVector<T> const & b, 
                          gsVector<unsigned> const & np );
 
+TEMPLATE_INST
+void uniformGridCoordinates(gsVector<T> const & a, gsVector<T> const & b,
+                            gsVector<unsigned> const & np,
+                            std::vector<gsVector<T> > & cwise);
+
+TEMPLATE_INST
+bool cartesianGridCoordinates(gsMatrix<T> const & points,
+                              std::vector<gsVector<T> > & cwise);
+
 TEMPLATE_INST
 void uniformIntervals(const gsVector<T>& lower, 
                       const gsVector<T>& upper, 
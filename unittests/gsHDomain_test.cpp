@@ -0,0 +1,174 @@
+/** @file gsHDomain_test.cpp
+
+    @brief Tests for the kd-tree of hierarchical domains.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+**/
+
+#include "gismo_unittest.h"
+
+using namespace gismo;
+
+SUITE(gsHDomain_test)
+{
+    typedef gsHDomain<2> hDomain;
+    typedef hDomain::point point;
+
+    // Inserts overlapping boxes of the levels 1 to 4 in a domain of 8x8
+    // elements on level 0
+    void insertBoxes(hDomain & tree, int shift)
+    {
+        point lower, upper;
+        for (int k = 0; k != 24; ++k)
+        {
+            const int lvl = 1 + k % 4;
+            const index_t n = 8 << lvl;
+            lower[0] = (7 * k + shift) * (1 << lvl) % n;
+            lower[1] = (11 * k + 3 * shift) * (1 << lvl) % n;
+            upper[0] = math::min(n, lower[0] + 3 + (k % 5) * (1 << lvl) / 2);
+            upper[1] = math::min(n, lower[1] + 2 + (k % 3) * (1 << lvl) / 2);
+            tree.insertBox(lower, upper, lvl);
+        }
+    }
+
+    // The answers of all queries on the boxes of width one and three of
+    // every level
+    std::vector<int> allQueries(const hDomain & tree)
+    {
+        std::vector<int> result;
+        point lower, upper;
+        for (int lvl = 0; lvl <= 4; ++lvl)
+        {
+            const index_t n = 8 << lvl;
+            for (lower[0] = 0; lower[0] != n; ++lower[0])
+                for (lower[1] = 0; lower[1] != n; ++lower[1])
+                {
+                    result.push_back( tree.levelOf(lower, lvl) );
+                    for (index_t w = 1; w <= 3; w += 2)
+                    {
+                        upper[0] = math::min(n, lower[0] + w);
+                        upper[1] = math::min(n, lower[1] + w);
+                        result.push_back( tree.query1(lower, upper, lvl) );
+                        result.push_back( tree.query2(lower, upper, lvl) );
+                        result.push_back( tree.query3(lower, upper, lvl) );
+                        result.push_back( tree.query4(lower, upper, lvl) );
+                    }
+                }
+        }
+        return result;
+    }
+
+    TEST(compressed_queries)
+    {
+        point upp;
+        upp.setConstant(8);
+        hDomain tree(upp);
+        tree.init(upp, 5);
+        insertBoxes(tree, 0);
+        const std::vector<int> linked = allQueries(tree);
+
+        hDomain flat(tree);
+        flat.makeCompressed();
+        CHECK( flat.size() <= tree.size() );
+        CHECK( allQueries(flat) == linked );
+
+        // Every leaf reports its own level
+        for (hDomain::literator it = flat.beginLeafIterator(); it.good(); it.next())
+            CHECK_EQUAL( it.level(), flat.levelOf(it.lowerCorner(), it.level()) );
+
+        // A modification drops the flat layout
+        point lower, upper;
+        lower.setConstant(5);
+        upper.setConstant(9);
+        tree.insertBox(lower, upper, 2);
+        flat.insertBox(lower, upper, 2);
+        CHECK( allQueries(flat) == allQueries(tree) );
+        tree.sinkBox(lower, upper, 3);
+        flat.makeCompressed();
+        flat.sinkBox(lower, upper, 3);
+        CHECK( allQueries(flat) == allQueries(tree) );
+    }
+
+    TEST(assignment)
+    {
+        point upp;
+        upp.setConstant(8);
+        hDomain a(upp), b(upp);
+        a.init(upp, 5);
+        insertBoxes(a, 0);
+        b.init(upp, 5);
+        insertBoxes(b, 5);
+        insertBoxes(b, 9);
+        const std::vector<int> ref = allQueries(a);
+        CHECK( allQueries(b) != ref );
+
+        // The previous tree of b is released, the copy is deep
+        b = a;
+        CHECK_EQUAL( a.size(), b.size() );
+        CHECK_EQUAL( a.leafSize(), b.leafSize() );
+        CHECK( allQueries(b) == ref );
+        const size_t mem = b.memoryUsage();
+        for (int k = 0; k != 10; ++k)
+            b = a;
+        CHECK_EQUAL( mem, b.memoryUsage() );
+
+        insertBoxes(a, 2);
+        CHECK( allQueries(b) == ref );
+
+        // Assignment of a compressed tree
+        b.makeCompressed();
+        a = b;
+        CHECK( allQueries(a) == ref );
+    }
+
+    TEST(node_pool)
+    {
+        typedef kdnodePool<2, index_t> pool_t;
+        typedef pool_t::node node;
+        pool_t pool;
+        point lower, upper;
+        lower.setZero();
+        upper.setConstant(8);
+        node * root = pool.newLeaf(lower, upper);
+        root->axis = 0;
+        root->pos  = 4;
+        root->split(pool);
+        node * left  = root->left;
+        node * right = root->right;
+        CHECK( left->isLeaf() && right->isLeaf() );
+        CHECK_EQUAL( 4, left->uppCorner()[0] );
+        CHECK_EQUAL( 4, right->lowCorner()[0] );
+
+        // The nodes keep their addresses, the pool is left empty
+        pool_t other;
+        const size_t mem = pool.memoryUsage();
+        other.swap(pool);
+        CHECK_EQUAL( mem, other.memoryUsage() );
+        CHECK_EQUAL( pool_t().memoryUsage(), pool.memoryUsage() );
+        CHECK( root->left == left && root->right == right );
+        CHECK( left->parent == root && right->parent == root );
+        CHECK_EQUAL( 4, left->uppCorner()[0] );
+        CHECK_EQUAL( 8, right->uppCorner()[0] );
+
+        // The released nodes are reused
+        root->merge(other);
+        CHECK( root->isLeaf() );
+        CHECK_EQUAL( 8, root->uppCorner()[0] );
+        const size_t memMerged = other.memoryUsage();
+        node * n1 = other.newNode();
+        node * n2 = other.newNode();
+        CHECK( (n1 == left && n2 == right) || (n1 == right && n2 == left) );
+        CHECK_EQUAL( memMerged, other.memoryUsage() );
+
+        // A copy lives in the other pool
+        node * copy = pool.copyTree(*root);
+        CHECK( copy != root );
+        CHECK( copy->isLeaf() );
+        CHECK( copy->lowCorner() == root->lowCorner() );
+        CHECK( copy->uppCorner() == root->uppCorner() );
+    }
+}
@@ -224,6 +224,33 @@ SUITE(gsIterativeSolvers_test)
         CHECK( (mat*x-rhs).norm()/rhs.norm() <= tol );
     }
 
+    TEST(PipelinedCG_Jacobi_test)
+    {
+        index_t          N = 100;
+        real_t           tol = std::pow(10.0, - REAL_DIG * 0.75);
+
+        gsSparseMatrix<> mat;
+        gsMatrix<>       rhs;
+        gsMatrix<>       x;
+
+        poissonDiscretization(mat, rhs, N);
+
+        gsOptionList opt = gsPipelinedConjugateGradient<>::defaultOptions();
+        opt.setInt ("MaxIterations", N  );
+        opt.setReal("Tolerance"    , tol);
+
+        gsLinearOperator<>::Ptr preConMat = makeJacobiOp(mat);
+        gsPipelinedConjugateGradient<> solver(mat,preConMat);
+        solver.setOptions(opt);
+
+        x.setZero(N,1);
+        solver.solve(rhs,x);
+
+        // The recursively updated residual differs slightly from the true one
+        CHECK( solver.error() <= tol );
+        CHECK( (mat*x-rhs).norm()/rhs.norm() <= 10*tol );
+    }
+
     TEST(CG_SGS_test)
     {
         index_t          N = 100;
@@ -249,6 +276,99 @@ SUITE(gsIterativeSolvers_test)
         CHECK( (mat*x-rhs).norm()/rhs.norm() <= tol );
     }
 
+    TEST(CG_MulticolorSSOR_test)
+    {
+        index_t          N = 100;
+        real_t           tol = std::pow(10.0, - REAL_DIG * 0.75);
+
+        gsSparseMatrix<> mat;
+        gsMatrix<>       rhs;
+        gsMatrix<>       x;
+
+        poissonDiscretization(mat, rhs, N);
+
+        gsOptionList opt = gsConjugateGradient<>::defaultOptions();
+        opt.setInt ("MaxIterations", N  );
+        opt.setReal("Tolerance"    , tol);
+
+        gsMulticolorGaussSeidelOp<gsSparseMatrix<>,gsGaussSeidel::symmetric>::Ptr precon
+            = gsMulticolorGaussSeidelOp<gsSparseMatrix<>,gsGaussSeidel::symmetric>::make(mat, 1.5);
+        precon->setNumThreads(2);
+
+        // A tridiagonal matrix needs two colors, neighbors differ in color
+        CHECK_EQUAL( 2, precon->numColors() );
+        const gsVector<index_t> colors = precon->colors();
+        for (index_t k = 1; k < N; ++k)
+            CHECK( colors[k] != colors[k-1] );
+
+        gsConjugateGradient<> solver(mat,precon);
+        solver.setOptions(opt);
+
+        x.setZero(N,1);
+        solver.solve(rhs,x);
+
+        CHECK( (mat*x-rhs).norm()/rhs.norm() <= tol );
+
+        // A row-major matrix is swept in its own storage order, with
+        // the same result
+        const gsSparseMatrix<real_t,RowMajor> matRM = mat;
+        gsConjugateGradient<> solverRM(mat, makeMulticolorSymmetricGaussSeidelOp(matRM, (real_t)1.5));
+        solverRM.setOptions(opt);
+
+        gsMatrix<> y;
+        y.setZero(N,1);
+        solverRM.solve(rhs,y);
+        CHECK( x == y );
+    }
+
+    TEST(CG_Chebyshev_test)
+    {
+        index_t          N = 100;
+        real_t           tol = std::pow(10.0, - REAL_DIG * 0.75);
+
+        gsSparseMatrix<> mat;
+        gsMatrix<>       rhs;
+        gsMatrix<>       x, y;
+
+        poissonDiscretization(mat, rhs, N);
+
+        gsOptionList opt = gsConjugateGradient<>::defaultOptions();
+        opt.setInt ("MaxIterations", N  );
+        opt.setReal("Tolerance"    , tol);
+
+        gsChebyshevOp<gsSparseMatrix<> >::Ptr precon = gsChebyshevOp<gsSparseMatrix<> >::make(mat, 4);
+
+        // The largest eigenvalue of the Jacobi preconditioned matrix is
+        // almost 2, the Lanczos estimate is a lower bound
+        CHECK( precon->upperBound() > 1.8 && precon->upperBound() < 2.2 );
+        CHECK_CLOSE( precon->upperBound() / 30, precon->lowerBound(), 1e-12 );
+
+        gsConjugateGradient<> solver(mat,precon);
+        solver.setOptions(opt);
+
+        x.setZero(N,1);
+        solver.solve(rhs,x);
+
+        CHECK( (mat*x-rhs).norm()/rhs.norm() <= tol );
+
+        // The result does not depend on the number of threads
+        precon->setNumThreads(3);
+        y.setZero(N,1);
+        solver.solve(rhs,y);
+        CHECK( x == y );
+
+        // A row-major matrix is swept in its own storage order
+        const gsSparseMatrix<real_t,RowMajor> matRM = mat;
+        gsChebyshevOp<gsSparseMatrix<real_t,RowMajor> >::Ptr preconRM
+            = gsChebyshevOp<gsSparseMatrix<real_t,RowMajor> >::make(matRM, 4);
+        preconRM->setBounds(precon->lowerBound(), precon->upperBound());
+        gsConjugateGradient<> solverRM(mat, preconRM);
+        solverRM.setOptions(opt);
+        y.setZero(N,1);
+        solverRM.solve(rhs,y);
+        CHECK( x == y );
+    }
+
     TEST(GMRES_GS_test)
     {
         index_t          N = 100;
@@ -327,4 +447,103 @@ SUITE(gsIterativeSolvers_test)
         CHECK( (mat*x-rhs).norm()/rhs.norm() <= tol );
     }
 
+    TEST(BlockCG_test)
+    {
+        index_t          N = 100;
+        real_t           tol = std::pow(10.0, - REAL_DIG * 0.75);
+
+        gsSparseMatrix<> mat;
+        gsMatrix<>       rhs;
+        gsMatrix<>       x;
+
+        poissonDiscretization(mat, rhs, N);
+
+        // Several right-hand sides, one of them zero
+        gsMatrix<> rhs4(N,4);
+        rhs4.col(0) = rhs;
+        rhs4.col(1).setRandom();
+        rhs4.col(2).setZero();
+        rhs4.col(3) = 2 * rhs;
+
+        gsOptionList opt = gsBlockConjugateGradient<>::defaultOptions();
+        opt.setInt ("MaxIterations", N  );
+        opt.setReal("Tolerance"    , tol);
+
+        gsBlockConjugateGradient<> solver(mat, makeJacobiOp(mat));
+        solver.setOptions(opt);
+
+        solver.solve(rhs4,x);
+
+        CHECK( x.col(2).isZero() );
+        for (index_t j = 0; j != 4; ++j)
+            if (j != 2)
+                CHECK( (mat*x.col(j)-rhs4.col(j)).norm()/rhs4.col(j).norm() <= tol );
+    }
+
+    TEST(BlockGMRes_test)
+    {
+        index_t          N = 100;
+        real_t           tol = std::pow(10.0, - REAL_DIG * 0.75);
+
+        gsSparseMatrix<> mat;
+        gsMatrix<>       rhs;
+        gsMatrix<>       x;
+
+        poissonDiscretization(mat, rhs, N);
+
+        gsMatrix<> rhs3(N,3);
+        rhs3.col(0) = rhs;
+        rhs3.col(1).setRandom();
+        rhs3.col(2) = rhs + rhs3.col(1);
+
+        gsOptionList opt = gsBlockGMRes<>::defaultOptions();
+        opt.setInt ("MaxIterations", N  );
+        opt.setReal("Tolerance"    , tol);
+        opt.setInt ("Restart"      , N  );
+
+        gsLinearOperator<>::Ptr precon = makeGaussSeidelOp(mat);
+        gsBlockGMRes<> solver(mat,precon);
+        solver.setOptions(opt);
+
+        solver.solve(rhs3,x);
+
+        gsMatrix<> res;
+        for (index_t j = 0; j != 3; ++j)
+        {
+            precon->apply(mat*x.col(j)-rhs3.col(j), res);
+            CHECK( res.norm()/rhs3.col(j).norm() <= tol );
+        }
+    }
+
+    TEST(CG_NumThreads_test)
+    {
+        index_t          N = 100;
+        real_t           tol = std::pow(10.0, - REAL_DIG * 0.75);
+
+        gsSparseMatrix<> mat;
+        gsMatrix<>       rhs;
+        gsMatrix<>       x, y;
+
+        poissonDiscretization(mat, rhs, N);
+        const gsSparseMatrix<real_t,RowMajor> matRM = mat;
+
+        gsOptionList opt = gsConjugateGradient<>::defaultOptions();
+        opt.setInt ("MaxIterations", N  );
+        opt.setReal("Tolerance"    , tol);
+        opt.setInt ("NumThreads"   , 3  );
+        opt.setSwitch("ThreadedMatrix", true);
+
+        gsConjugateGradient<> solver(matRM, makeJacobiOp(mat));
+        solver.setOptions(opt);
+
+        x.setZero(N,1);
+        solver.solve(rhs,x);
+        CHECK( (mat*x-rhs).norm()/rhs.norm() <= tol );
+
+        // The result does not depend on the scheduling of the threads
+        y.setZero(N,1);
+        solver.solve(rhs,y);
+        CHECK( x == y );
+    }
+
 }
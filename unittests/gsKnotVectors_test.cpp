@@ -1284,4 +1284,73 @@ SUITE(gsKnotVectors_test_gsKnotIterator)
                 CHECK( unique[i] == corrUnique[i] );
         }
     }
+
+    // Compares gsKnotLocator and gsKnotVector::uFind_into with
+    // uFind(), values outside the domain are clamped to it
+    void checkSpans(const gsKnotVector<real_t> & KV, const gsMatrix<real_t> & u)
+    {
+        const real_t a = *KV.domainBegin(), b = *KV.domainEnd();
+        gsVector<index_t> ref(u.cols());
+        for (index_t j = 0; j != u.cols(); ++j)
+            ref[j] = KV.uFind( math::min(math::max(u(0, j), a), b) ).uIndex();
+
+        gsKnotLocator<real_t> loc(KV);
+        gsVector<index_t> res;
+        loc.uIndex_into(u.row(0), res);
+        CHECK( res == ref );
+        KV.uFind_into(u.row(0), res);
+        CHECK( res == ref );
+        for (index_t j = 0; j != u.cols(); ++j)
+            CHECK_EQUAL( ref[j], loc.uIndex(u(0, j)) );
+    }
+
+    TEST( knotLocator )
+    {
+        // uniform, graded, repeated knots, and a domain which is
+        // smaller than the range of the knots
+        std::vector<gsKnotVector<real_t> > kvs;
+        kvs.push_back( gsKnotVector<real_t>(0, 1, 9, 3) );
+        std::vector<real_t> graded(3, 0);
+        for (index_t i = 10; i != 0; --i)
+            graded.push_back( math::pow(0.5, (real_t)i) );
+        graded.resize(graded.size() + 3, 1);
+        kvs.push_back( gsKnotVector<real_t>(graded, 2) );
+        real_t repeated[] = {0, 0, 0, .1, .1, .3, .3, .3, .35, .7, 1, 1, 1};
+        kvs.push_back( gsKnotVector<real_t>(2, repeated, repeated + 13) );
+        real_t open[] = {0, .1, .2, .3, .45, .5, .6, .8, .9, 1};
+        kvs.push_back( gsKnotVector<real_t>(2, open, open + 10) );
+
+        CHECK(  gsKnotLocator<real_t>(kvs[0]).isUniform() );
+        CHECK( !gsKnotLocator<real_t>(kvs[1]).isUniform() );
+
+        for (size_t k = 0; k != kvs.size(); ++k)
+        {
+            const gsKnotVector<real_t> & KV = kvs[k];
+            std::vector<real_t> pts;
+            // all knots, their neighbours and the midpoints
+            for (gsKnotVector<real_t>::uiterator it = KV.ubegin(); it != KV.uend(); ++it)
+            {
+                pts.push_back(*it);
+                pts.push_back(*it - 1e-12);
+                pts.push_back(*it + 1e-12);
+                if ( it + 1 != KV.uend() )
+                    pts.push_back( (*it + *(it + 1)) / 2 );
+            }
+            // the domain end points and values outside the domain
+            pts.push_back( *KV.domainBegin() );
+            pts.push_back( *KV.domainEnd() );
+            pts.push_back( -1 );
+            pts.push_back(  2 );
+            std::sort(pts.begin(), pts.end());
+
+            // sorted, reversed and unsorted rows
+            gsMatrix<real_t> u = gsAsConstMatrix<real_t>(pts).transpose();
+            checkSpans(KV, u);
+            checkSpans(KV, u.rowwise().reverse());
+            gsMatrix<real_t> rnd(1, 100);
+            rnd.setRandom();
+            rnd.array() = 0.6 * rnd.array() + 0.5;
+            checkSpans(KV, rnd);
+        }
+    }
 }
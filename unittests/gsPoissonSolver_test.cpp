@@ -142,6 +142,48 @@ void runPoissonSolverTest( dirichlet::strategy Dstrategy, iFace::strategy Istrat
     h_list.clear();
 }
 
+// Assembles with the option ExactPattern, twice and after refinement,
+// and compares with the default assembly
+void runExactPatternTest( dirichlet::strategy Dstrategy, iFace::strategy Istrategy )
+{
+    gsFunctionExpr<> f("((pi*1)^2 + (pi*2)^2)*sin(pi*x*1)*sin(pi*y*2)",2);
+    gsFunctionExpr<> g("sin(pi*x*1)*sin(pi*y*2)+pi/10",2);
+    gsMultiPatch<> patches = gsNurbsCreator<>::BSplineSquareGrid(2, 2, 0.5);
+
+    gsBoundaryConditions<> bcInfo;
+    for (gsMultiPatch<>::const_biterator it = patches.bBegin(); it != patches.bEnd(); ++it)
+        bcInfo.addCondition(*it, condition_type::dirichlet, &g);
+
+    gsMultiBasis<> bases( patches );
+    bases.uniformRefine();
+
+    gsPoissonAssembler<real_t> exact(patches,bases,bcInfo,f,Dstrategy,Istrategy);
+    exact.options().setSwitch("ExactPattern", true);
+    for (int i = 0; i < 2; ++i)
+    {
+        gsPoissonAssembler<real_t> poisson(patches,exact.multiBasis(),bcInfo,f,Dstrategy,Istrategy);
+        poisson.assemble();
+
+        // The second assembly re-uses the pattern
+        exact.assemble();
+        exact.assemble();
+
+        CHECK_EQUAL( poisson.matrix().rows(), exact.matrix().rows() );
+        CHECK( (poisson.matrix() - exact.matrix()).norm() <= 1e-10 * poisson.matrix().norm() );
+        CHECK( (poisson.rhs() - exact.rhs()).norm() <= 1e-10 * poisson.rhs().norm() );
+
+        exact.multiBasis().uniformRefine();
+        exact.refresh();
+    }
+
+    // Mass matrix of the generic assembler
+    gsGenericAssembler<real_t> generic(patches, bases);
+    const gsSparseMatrix<> mass = generic.assembleMass();
+    generic.options().setSwitch("ExactPattern", true);
+    generic.assembleMass();
+    CHECK( (mass - generic.assembleMass()).norm() <= 1e-10 * mass.norm() );
+}
+
 
 SUITE(gsPoissonSolver_test)
 {
@@ -160,6 +202,12 @@ SUITE(gsPoissonSolver_test)
     {
         runPoissonSolverTest(dirichlet::nitsche, iFace::dg);
     }
+
+    TEST(ExactPattern_test)
+    {
+        runExactPatternTest(dirichlet::elimination, iFace::glue);
+        runExactPatternTest(dirichlet::nitsche, iFace::dg);
+    }
     
 }
 
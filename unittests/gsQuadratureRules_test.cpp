@@ -26,6 +26,38 @@ real_t calcPoly(gsVector<index_t> const &deg,
 
 const char *addPlus(const index_t d, index_t i);
 
+void testWeighted(const gsKnotVector<real_t> & kv);
+
+// Rule defined on the whole parameter domain, with nodes only in
+// [0,1/2]^d, so that the other elements have no quadrature nodes
+class gsHalfDomainRule : public gsQuadRule<real_t>
+{
+public:
+    explicit gsHalfDomainRule(const gsBasis<real_t> & basis)
+    {
+        const gsGaussRule<real_t> gauss(basis.maxDegree() + 1);
+        gsMatrix<real_t> nodes;
+        gsVector<real_t> weights;
+        gauss.mapTo(0.0, 0.5, nodes, weights);
+        gsMatrix<real_t> table(weights.size(), 2);
+        table.col(0) = nodes.transpose();
+        table.col(1) = weights;
+        m_global.assign(basis.dim(), memory::make_shared(new gsMatrix<real_t>(table)));
+    }
+};
+
+// Mass visitor using gsHalfDomainRule
+class gsVisitorHalfMass : public gsVisitorMass<real_t>
+{
+public:
+    void initialize(const gsBasis<real_t> & basis, const index_t patchIndex,
+                    const gsOptionList & options, gsQuadRule<real_t> & rule)
+    {
+        gsVisitorMass<real_t>::initialize(basis, patchIndex, options, rule);
+        rule = gsHalfDomainRule(basis);
+    }
+};
+
 TEST(tensor_quad_3)
 {
     index_t array[] = {3};
@@ -110,6 +142,36 @@ TEST(tensor_quad_22)
     testWork(array, 1);
 }
 
+TEST(weighted_quad_repeated_knot)
+{
+    for (short_t p = 1; p <= 4; ++p)
+        for (index_t m = 1; m <= p; ++m)
+        {
+            gsKnotVector<real_t> kv(0.0, 1.0, 0, p+1);
+            kv.insert(0.25);
+            kv.insert(0.5, m);
+            kv.insert(0.75);
+            testWeighted(kv);
+        }
+}
+
+TEST(elements_without_nodes)
+{
+    // The elements outside of [0,1/2]^2 are skipped, the mass matrix
+    // is the one of [0,1/2]^2
+    gsMultiPatch<real_t> patches(*gsNurbsCreator<real_t>::BSplineSquare());
+    gsMultiBasis<real_t> bases(patches);
+    bases.uniformRefine();
+    bases.uniformRefine();
+
+    gsGenericAssembler<real_t> ga(patches, bases);
+    ga.refresh();
+    ga.reserveMatrix();
+    ga.push(gsVisitorHalfMass());
+    ga.finalize();
+    CHECK_CLOSE(0.25, ga.matrix().toDense().sum(), 1e-12);
+}
+
 void testWork(const index_t nodes[], const size_t dim)
 {
     gsVector<index_t> numNodes = gsAsConstVector<index_t>(nodes, dim);
@@ -208,4 +270,47 @@ real_t calcPoly(gsVector<index_t> const &deg,
 const char *addPlus(const index_t d, index_t i)
 { return (i == d - 1 ? "" : "+"); }
 
+// Checks that the weighted quadrature integrates the products of the
+// basis functions and their derivatives exactly
+void testWeighted(const gsKnotVector<real_t> & kv)
+{
+    gsBSplineBasis<real_t> basis(kv);
+    gsWeightedQuadRule<real_t> rule(basis);
+    const index_t n = basis.size();
+
+    // Exact integrals, by a Gauss rule on every element
+    gsMatrix<real_t> I[4];
+    for (index_t ab = 0; ab != 4; ++ab)
+        I[ab].setZero(n, n);
+    gsGaussRule<real_t> gauss(kv.degree() + 1);
+    gsMatrix<real_t> gNodes;
+    gsVector<real_t> gWeights;
+    std::vector<gsMatrix<real_t> > ders;
+    gsMatrix<index_t> act;
+    const std::vector<real_t> br = kv.breaks();
+    for (size_t e = 0; e + 1 < br.size(); ++e)
+    {
+        gauss.mapTo(br[e], br[e+1], gNodes, gWeights);
+        basis.evalAllDers_into(gNodes, 1, ders);
+        basis.active_into(gNodes.col(0), act);
+        for (index_t g = 0; g != gWeights.size(); ++g)
+            for (index_t ab = 0; ab != 4; ++ab)
+                for (index_t ki = 0; ki != act.rows(); ++ki)
+                    for (index_t kj = 0; kj != act.rows(); ++kj)
+                        I[ab](act(ki,0), act(kj,0)) +=
+                            gWeights[g] * ders[ab/2](ki,g) * ders[ab%2](kj,g);
+    }
+
+    for (index_t i = 0; i != n; ++i)
+        for (index_t ab = 0; ab != 4; ++ab)
+            for (index_t j = 0; j != n; ++j)
+            {
+                const real_t * w = rule.weights(i, ab/2, ab%2);
+                real_t sum = 0;
+                for (index_t q = 0; q != rule.numNodes(i); ++q)
+                    sum += w[q] * rule.value(j, rule.firstNode(i) + q, ab%2);
+                CHECK_CLOSE(I[ab](i,j), sum, 1e-10);
+            }
+}
+
 }
@@ -0,0 +1,125 @@
+/** @file gsRationalBasis_test.cpp
+
+    @brief Tests for the derivatives of rational bases.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+**/
+
+#include "gismo_unittest.h"
+
+using namespace gismo;
+
+SUITE(gsRationalBasis_test)
+{
+    // Position of the second derivative along a and c in the rows of
+    // one function: the pure derivatives first, then the mixed ones
+    index_t secondIndex(short_t a, short_t c, short_t d)
+    {
+        if ( a == c )
+            return a;
+        if ( a > c )
+            std::swap(a, c);
+        index_t m = d;
+        for (short_t i = 0; i != a; ++i)
+            m += d - 1 - i;
+        return m + c - a - 1;
+    }
+
+    // Compares evalAllDers_into with central differences of the
+    // values and of the first derivatives, and with the evaluation of
+    // each order alone
+    template<short_t d>
+    void checkRationalDers(const gsTensorNurbsBasis<d> & b, const gsMatrix<> & u)
+    {
+        const index_t str = d * (d + 1) / 2;
+        const real_t h = 1e-6;
+        std::vector<gsMatrix<> > ev;
+        b.evalAllDers_into(u, 2, ev);
+        gsMatrix<> val, der, der2;
+        b.eval_into(u, val);
+        b.deriv_into(u, der);
+        b.deriv2_into(u, der2);
+        CHECK_MATRIX_CLOSE( val , ev[0], EPSILON );
+        CHECK_MATRIX_CLOSE( der , ev[1], EPSILON );
+        CHECK_MATRIX_CLOSE( der2, ev[2], EPSILON );
+
+        // Partition of unity
+        CHECK_MATRIX_PARTITION_OF_UNIT_CLOSE( ev[0], EPSILON );
+
+        gsMatrix<> up, um, vp, vm, dp, dm;
+        for (index_t j = 0; j != u.cols(); ++j)
+            for (short_t i = 0; i != d; ++i)
+            {
+                up = um = u.col(j);
+                up(i, 0) += h;
+                um(i, 0) -= h;
+                b.eval_into (up, vp);
+                b.eval_into (um, vm);
+                b.deriv_into(up, dp);
+                b.deriv_into(um, dm);
+                for (index_t k = 0; k != ev[0].rows(); ++k)
+                {
+                    CHECK_CLOSE( ev[1](k * d + i, j),
+                                 (vp(k, 0) - vm(k, 0)) / (2 * h), 1e-6 );
+                    for (short_t a = 0; a != d; ++a)
+                        CHECK_CLOSE( ev[2](k * str + secondIndex(a, i, d), j),
+                                     (dp(k * d + a, 0) - dm(k * d + a, 0)) / (2 * h),
+                                     1e-4 );
+                }
+            }
+    }
+
+    // Random points which are not close to the knots of kv, a
+    // uniform knot vector of four elements
+    gsMatrix<> pointsAwayFromKnots(short_t d, index_t n)
+    {
+        gsMatrix<> u(d, n);
+        u.setRandom();
+        u.array() = 2 + 1.999 * u.array();
+        u.array() = ( u.array().floor() + 0.1 + 0.8 * (u.array() - u.array().floor()) ) / 4;
+        return u;
+    }
+
+    TEST(evalAllDers_fused)
+    {
+        gsKnotVector<> kv(0, 1, 3, 4);
+
+        gsTensorNurbsBasis<2> b2( gsTensorBSplineBasis<2>(kv, kv) );
+        b2.weights().setRandom();
+        b2.weights().array() = 1.25 + 0.75 * b2.weights().array();
+        checkRationalDers(b2, pointsAwayFromKnots(2, 20));
+
+        gsTensorNurbsBasis<3> b3( gsTensorBSplineBasis<3>(kv, kv, kv) );
+        b3.weights().setRandom();
+        b3.weights().array() = 1.25 + 0.75 * b3.weights().array();
+        checkRationalDers(b3, pointsAwayFromKnots(3, 10));
+
+        // Mixed derivatives of a product of univariate functions
+        gsTensorNurbsBasis<2> p2( gsTensorBSplineBasis<2>(kv, kv) );
+        gsMatrix<> w(7, 1);
+        w << 1, 2, 1.5, 1, 0.5, 1, 3;
+        for (index_t i = 0; i != 7; ++i)
+            for (index_t k = 0; k != 7; ++k)
+                p2.weights()(i + 7 * k, 0) = w(i, 0) * w(k, 0);
+        const gsMatrix<> u = pointsAwayFromKnots(2, 10);
+        std::vector<gsMatrix<> > ev;
+        p2.evalAllDers_into(u, 2, ev);
+        gsNurbsBasis<> p1(kv, w);
+        gsMatrix<> ux, uy;
+        std::vector<gsMatrix<> > ex, ey;
+        ux = u.row(0);
+        uy = u.row(1);
+        p1.evalAllDers_into(ux, 1, ex);
+        p1.evalAllDers_into(uy, 1, ey);
+        // the actives of p2 run over the first direction fastest
+        for (index_t j = 0; j != u.cols(); ++j)
+            for (index_t ky = 0; ky != 4; ++ky)
+                for (index_t kx = 0; kx != 4; ++kx)
+                    CHECK_CLOSE( ev[2](3 * (kx + 4 * ky) + 2, j),
+                                 ex[1](kx, j) * ey[1](ky, j), 1e-10 );
+    }
+}
@@ -130,6 +130,99 @@ std::vector<index_t> random_refinement(int lvl, int max_nb,
     return q;
 }
 
+// Compares the evaluation of all active functions at once
+// (eval_into, deriv_into, deriv2_into) with the evaluation of the
+// functions one by one
+template<short_t d>
+void checkSingleEvaluation(const gsTHBSplineBasis<d> & thb, const gsMatrix<> & pts)
+{
+    gsMatrix<> vals, ders, ders2, single;
+    gsMatrix<index_t> act;
+    thb.active_into(pts, act);
+    thb.eval_into  (pts, vals );
+    thb.deriv_into (pts, ders );
+    thb.deriv2_into(pts, ders2);
+    const index_t nd = d, nd2 = d * (d + 1) / 2;
+    CHECK_EQUAL( act.rows()      , vals .rows() );
+    CHECK_EQUAL( act.rows() * nd , ders .rows() );
+    CHECK_EQUAL( act.rows() * nd2, ders2.rows() );
+
+    for (index_t p = 0; p != pts.cols(); ++p)
+        for (index_t k = 0; k != act.rows(); ++k)
+        {
+            const index_t i = act(k, p);
+            if (0 != k && 0 == i) // end of the actives of the point
+                break;
+            thb.evalSingle_into(i, pts.col(p), single);
+            CHECK_CLOSE( single(0, 0), vals(k, p), EPSILON );
+            thb.derivSingle_into(i, pts.col(p), single);
+            CHECK_MATRIX_CLOSE( single, ders.block(k * nd, p, nd, 1), EPSILON );
+            thb.deriv2Single_into(i, pts.col(p), single);
+            CHECK_MATRIX_CLOSE( single, ders2.block(k * nd2, p, nd2, 1), EPSILON );
+        }
+}
+
+// Compares a basis updated after every refinement with a basis
+// constructed from all boxes at once
+template<short_t d>
+void checkSameBasis(const gsTHBSplineBasis<d> & thb, const gsTHBSplineBasis<d> & full)
+{
+    CHECK_EQUAL( full.size(), thb.size() );
+    if ( full.size() != thb.size() )
+        return;
+    CHECK( full.getXmatrix() == thb.getXmatrix() );
+    // the offsets of the levels
+    for (index_t i = 0; i != full.size(); ++i)
+    {
+        CHECK_EQUAL( full.levelOf(i), thb.levelOf(i) );
+        CHECK_EQUAL( full.flatTensorIndexOf(i), thb.flatTensorIndexOf(i) );
+    }
+    CHECK( full.truncationLevels() == thb.truncationLevels() );
+    CHECK( full.truncation().isApprox(thb.truncation()) );
+}
+
+// Returns the active functions at the point \a u, found level by
+// level with a binary search in the characteristic matrices
+template<short_t d>
+std::vector<index_t> activeReference(const gsTHBSplineBasis<d> & thb, const gsVector<> & u)
+{
+    const index_t maxLvl = thb.maxLevel();
+    gsVector<index_t, d> span;
+    for (short_t i = 0; i != d; ++i)
+        span[i] = thb.tensorLevel(maxLvl).knots(i).uFind(u[i]).uIndex();
+    const int lvl = thb.tree().levelOf(span, maxLvl);
+
+    std::vector<index_t> result;
+    gsMatrix<index_t> act;
+    index_t offset = 0;
+    for (int l = 0; l <= lvl; ++l)
+    {
+        const gsSortedVector<index_t> & cmat = thb.getXmatrix()[l];
+        thb.tensorLevel(l).active_into(u, act);
+        for (index_t k = 0; k != act.rows(); ++k)
+        {
+            gsSortedVector<index_t>::const_iterator it =
+                std::lower_bound(cmat.begin(), cmat.end(), act(k, 0));
+            if ( it != cmat.end() && *it == act(k, 0) )
+                result.push_back( offset + (it - cmat.begin()) );
+        }
+        offset += cmat.size();
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+// Returns the non-zero entries of column \a j of \a act, sorted
+std::vector<index_t> sortedColumn(const gsMatrix<index_t> & act, index_t j)
+{
+    std::vector<index_t> result(act.data() + j * act.rows(),
+                                act.data() + (j + 1) * act.rows());
+    // the column is padded with zeros, function 0 can only come first
+    while ( result.size() > 1 && 0 == result.back() )
+        result.pop_back();
+    std::sort(result.begin(), result.end());
+    return result;
+}
 
 SUITE(gsThbs_geometry_test)
 {
@@ -208,4 +301,236 @@ SUITE(gsThbs_geometry_test)
 
     }
 
+    TEST(gsThbs_stored_truncation)
+    {
+        gsKnotVector<> kv(0, 1, 3, 3);
+        gsTensorBSplineBasis<2> tbasis(kv, kv);
+        index_t b[] = {1, 0, 0, 4, 4,   2, 0, 0, 4, 4};
+        const std::vector<index_t> boxes(b, b + 10);
+        gsTHBSplineBasis<2> thb(tbasis, boxes);
+
+        const gsVector<int> levels = thb.truncationLevels();
+        const gsSparseMatrix<real_t,RowMajor> trunc = thb.truncation();
+
+        // A fitting representation is taken as it is
+        gsTHBSplineBasis<2> same(tbasis, boxes, levels, trunc);
+        CHECK( same.truncationLevels() == levels );
+        CHECK( same.truncation().isApprox(trunc) );
+
+        // A function truncated below the finest level
+        index_t j = 0;
+        while (j < thb.size() && (-1 == levels[j] || levels[j] == static_cast<int>(thb.maxLevel())))
+            ++j;
+        CHECK( j < thb.size() );
+
+        // A wrong level is recomputed
+        gsVector<int> wrongLevels = levels;
+        wrongLevels[j] = thb.maxLevel();
+        gsTHBSplineBasis<2> fromLevels(tbasis, boxes, wrongLevels, trunc);
+        CHECK( fromLevels.truncationLevels() == levels );
+        CHECK( fromLevels.truncation().isApprox(trunc) );
+
+        // A column outside the basis of the level is recomputed
+        gsSparseMatrix<real_t,RowMajor> wrongTrunc = trunc;
+        wrongTrunc.coeffRef(j, trunc.cols() - 1) = 1;
+        gsTHBSplineBasis<2> fromTrunc(tbasis, boxes, levels, wrongTrunc);
+        CHECK( fromTrunc.truncationLevels() == levels );
+        CHECK( fromTrunc.truncation().isApprox(trunc) );
+
+        // The values of the coefficients are trusted, e.g. a
+        // truncation stored for other knot values is kept
+        gsSparseMatrix<real_t,RowMajor> otherTrunc = trunc;
+        otherTrunc.valuePtr()[otherTrunc.outerIndexPtr()[j]] += 0.5;
+        gsTHBSplineBasis<2> fromValues(tbasis, boxes, levels, otherTrunc);
+        CHECK( fromValues.truncationLevels() == levels );
+        CHECK( fromValues.truncation().isApprox(otherTrunc) );
+        CHECK( !fromValues.truncation().isApprox(trunc) );
+    }
+
+    TEST(gsThbs_incremental_update)
+    {
+        gsKnotVector<> kv(0, 1, 3, 3);
+        gsTensorBSplineBasis<2> tp(kv, kv);
+
+        // refineElements(): the elements around a point moving along
+        // the diagonal, up to level 3
+        gsTHBSplineBasis<2> thb(tp);
+        std::vector<index_t> boxes, allBoxes;
+        gsVector<> ctr(2);
+        for (index_t s = 0; s != 6; ++s)
+        {
+            ctr.setConstant(0.1 + 0.16 * s);
+            boxes.clear();
+            gsBasis<>::domainIter domIt = thb.makeDomainIterator();
+            for (; domIt->good(); domIt->next())
+            {
+                const gsVector<> & c = domIt->centerPoint();
+                const int lvl = thb.getLevelAtPoint(c);
+                if ( lvl >= 3 || (c - ctr).norm() > 0.2 )
+                    continue;
+                boxes.push_back(lvl + 1);
+                for (short_t i = 0; i != 2; ++i)
+                    boxes.push_back( 2 * thb.tensorLevel(lvl).knots(i).uFind(c[i]).uIndex() );
+                for (short_t i = 0; i != 2; ++i)
+                    boxes.push_back( boxes[boxes.size() - 2] + 2 );
+            }
+            allBoxes.insert(allBoxes.end(), boxes.begin(), boxes.end());
+
+            thb.refineElements(boxes);
+            checkSameBasis(thb, gsTHBSplineBasis<2>(tp, allBoxes));
+        }
+
+        // refine(): overlapping boxes, which sink the domain by one
+        // level; the reference is built from the resulting leaves
+        gsTHBSplineBasis<2> sunk(tp);
+        const real_t corners[] = {0  , 0  , 0.5, 0.5,
+                                  0.25, 0.25, 0.75, 0.5,
+                                  0.3, 0.1, 0.6, 0.4,
+                                  0  , 0.6, 0.2, 1  };
+        gsMatrix<> box(2, 2);
+        gsMatrix<index_t> b1, b2;
+        gsVector<index_t> level;
+        for (index_t k = 0; k != 4; ++k)
+        {
+            box << corners[4*k], corners[4*k+2], corners[4*k+1], corners[4*k+3];
+            sunk.refine(box);
+
+            sunk.tree().getBoxesInLevelIndex(b1, b2, level);
+            boxes.clear();
+            for (index_t i = 0; i != level.size(); ++i)
+            {
+                if (0 == level[i])
+                    continue;
+                boxes.push_back(level[i]);
+                for (short_t j = 0; j != 2; ++j)
+                    boxes.push_back(b1(i, j));
+                for (short_t j = 0; j != 2; ++j)
+                    boxes.push_back(b2(i, j));
+            }
+            checkSameBasis(sunk, gsTHBSplineBasis<2>(tp, boxes));
+        }
+        CHECK( 2 < sunk.maxLevel() );
+    }
+
+    TEST(gsThbs_single_evaluation)
+    {
+        // Three levels, the grid of the points contains the element
+        // boundaries of the coarsest level
+        gsKnotVector<> kv(0, 1, 3, 3);
+        const gsVector<> zero2 = gsVector<>::Zero(2), one2 = gsVector<>::Ones(2);
+        const gsVector<> zero3 = gsVector<>::Zero(3), one3 = gsVector<>::Ones(3);
+        gsMatrix<> pts2 = uniformPointGrid(zero2, one2, 81);
+        gsMatrix<> pts3 = uniformPointGrid(zero3, one3, 125);
+
+        index_t b2[] = {1, 0, 0, 6, 4,   2, 2, 2, 8, 6};
+        gsTHBSplineBasis<2> thb2(gsTensorBSplineBasis<2>(kv, kv),
+                                 std::vector<index_t>(b2, b2 + 10));
+        CHECK( 2 == thb2.maxLevel() );
+        checkSingleEvaluation(thb2, pts2);
+        pts2.setRandom();
+        pts2.array() = (pts2.array() + 1) / 2;
+        checkSingleEvaluation(thb2, pts2);
+
+        index_t b3[] = {1, 0, 0, 0, 6, 4, 4,   2, 2, 2, 2, 8, 6, 6};
+        gsTHBSplineBasis<3> thb3(gsTensorBSplineBasis<3>(kv, kv, kv),
+                                 std::vector<index_t>(b3, b3 + 14));
+        CHECK( 2 == thb3.maxLevel() );
+        checkSingleEvaluation(thb3, pts3);
+        pts3.setRandom();
+        pts3.array() = (pts3.array() + 1) / 2;
+        checkSingleEvaluation(thb3, pts3);
+    }
+
+    TEST(gsThbs_char_matrix_index)
+    {
+        // Dense level: a bitmap, sparse level: a hash table
+        const index_t sizes[] = {1000, 1000000};
+        const index_t counts[] = {400, 50};
+        for (index_t t = 0; t != 2; ++t)
+        {
+            gsSortedVector<index_t> cmat;
+            gsVector<index_t> rnd = gsVector<index_t>::Random(counts[t]);
+            for (index_t k = 0; k != rnd.size(); ++k)
+                cmat.push_sorted_unique( math::abs(rnd[k]) % sizes[t] );
+            cmat.push_sorted_unique( 0 );
+            cmat.push_sorted_unique( sizes[t] - 1 );
+
+            gsCharMatrixIndex index;
+            index.init(cmat.begin(), cmat.end(), sizes[t]);
+            CHECK_EQUAL( 0 == t, index.isDense() );
+
+            // All stored keys, their neighbours and keys out of range
+            std::vector<index_t> keys(cmat.begin(), cmat.end());
+            for (size_t k = 0; k != cmat.size(); ++k)
+            {
+                keys.push_back(cmat[k] - 1);
+                keys.push_back(cmat[k] + 1);
+            }
+            if ( 0 == t )
+                for (index_t k = 0; k != sizes[t]; ++k)
+                    keys.push_back(k);
+            keys.push_back(sizes[t] + 31);
+            keys.push_back(sizes[t] + 33);
+
+            for (size_t k = 0; k != keys.size(); ++k)
+            {
+                gsSortedVector<index_t>::const_iterator it =
+                    std::lower_bound(cmat.begin(), cmat.end(), keys[k]);
+                const index_t pos = ( it != cmat.end() && *it == keys[k] ) ?
+                    static_cast<index_t>(it - cmat.begin()) : -1;
+                CHECK_EQUAL( pos, index.find(keys[k]) );
+            }
+        }
+    }
+
+    TEST(gsThbs_active_functions)
+    {
+        // Graded towards the corner (0,0)
+        gsKnotVector<> kv(0, 1, 3, 3);
+        index_t b[] = {1, 0, 0, 4, 4,   2, 0, 0, 4, 4,   3, 0, 0, 4, 4};
+        gsTHBSplineBasis<2> thb(gsTensorBSplineBasis<2>(kv, kv),
+                                std::vector<index_t>(b, b + 15));
+        CHECK( 3 == thb.maxLevel() );
+
+        // The knot lines of the finest level, the element boundaries
+        // of every level, and random points; half of them unsorted
+        const gsVector<> zero = gsVector<>::Zero(2), one = gsVector<>::Ones(2);
+        gsMatrix<> grid = uniformPointGrid(zero, one, 33 * 33);
+        gsMatrix<> pts(2, grid.cols() + 200);
+        pts.leftCols(grid.cols()) = grid;
+        pts.rightCols(200).setRandom();
+        pts.rightCols(200).array() = (pts.rightCols(200).array() + 1) / 2;
+        std::vector<index_t> perm(pts.cols());
+        for (size_t k = 0; k != perm.size(); ++k)
+            perm[k] = k;
+        std::reverse(perm.begin() + grid.cols() / 2, perm.end());
+        gsMatrix<> u(2, pts.cols());
+        for (size_t k = 0; k != perm.size(); ++k)
+            u.col(k) = pts.col(perm[k]);
+
+        gsMatrix<index_t> act, single;
+        thb.active_into(u, act);
+        for (index_t j = 0; j != u.cols(); ++j)
+        {
+            const std::vector<index_t> ref = activeReference(thb, u.col(j));
+            CHECK( ref == sortedColumn(act, j) );
+            thb.active_into(u.col(j), single);
+            CHECK( ref == sortedColumn(single, 0) );
+        }
+
+        // The actives of an element are those at its lower corner
+        gsMatrix<index_t> elAct;
+        gsBasis<>::domainIter domIt = thb.makeDomainIterator();
+        gsHDomainIterator<real_t, 2> * hIt =
+            dynamic_cast<gsHDomainIterator<real_t, 2> *>(domIt.get());
+        CHECK( NULL != hIt );
+        for (; domIt->good(); domIt->next())
+        {
+            const gsVector<> & c = domIt->centerPoint();
+            thb.elementActive_into(c, hIt->getLevel(), elAct);
+            const std::vector<index_t> ref = activeReference(thb, domIt->lowerCorner());
+            CHECK( ref == sortedColumn(elAct, 0) );
+            CHECK( ref == activeReference(thb, c) );
+        }
+    }
 }